@@ -0,0 +1,175 @@
+#include "animationexportdialog.h"
+
+#include "oled_carray.h"
+
+#include <QComboBox>
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QSignalBlocker>
+#include <QSpinBox>
+#include <QTableWidget>
+
+AnimationExportDialog::AnimationExportDialog(const OledPanelGeometry &geometry,
+                                             std::vector<std::vector<uint8_t>> frames, QWidget *parent)
+    : QDialog(parent), m_geometry(geometry), m_frames(std::move(frames)) {
+    setupUi();
+    recalculate();
+}
+
+void AnimationExportDialog::setupUi() {
+    setWindowTitle("匯出動畫");
+    resize(640, 360);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    // 格式與條件
+    QFormLayout *form = new QFormLayout();
+    m_modeComboBox = new QComboBox(this);
+    m_modeComboBox->addItem("自動 (flash 上限內送出最快的格式)", -1);
+    for (OledAnimationEncoder::Mode mode : OledAnimationEncoder::modes()) {
+        m_modeComboBox->addItem(OledAnimationEncoder::modeName(mode), mode);
+    }
+    form->addRow("格式", m_modeComboBox);
+
+    m_budgetSpinBox = new QSpinBox(this);
+    m_budgetSpinBox->setRange(0, 16384);
+    m_budgetSpinBox->setSuffix(" KB");
+    m_budgetSpinBox->setSpecialValueText("不限制");
+    m_budgetSpinBox->setToolTip("可以放動畫的 flash (不含解碼函式)；以要支援的最小 MCU 為準");
+    form->addRow("flash 上限", m_budgetSpinBox);
+
+    m_keyframeSpinBox = new QSpinBox(this);
+    m_keyframeSpinBox->setRange(0, 1000);
+    m_keyframeSpinBox->setValue(16);
+    m_keyframeSpinBox->setSpecialValueText("只有第一個");
+    m_keyframeSpinBox->setToolTip("keyframe-xor：每幾個影格一個完整的關鍵影格 (可以從這裡開始播放)");
+    form->addRow("關鍵影格間隔", m_keyframeSpinBox);
+
+    m_busComboBox = new QComboBox(this);
+    m_busComboBox->addItem("I2C 400 kHz", OledBusEstimator::Bus::I2c);
+    m_busComboBox->addItem("SPI 8 MHz", OledBusEstimator::Bus::Spi);
+    form->addRow("匯流排", m_busComboBox);
+    layout->addLayout(form);
+
+    // 每種格式的報告；最差影格為第 0 個之後送到面板成本最高的影格
+    m_reportTable = new QTableWidget(0, 7, this);
+    m_reportTable->setHorizontalHeaderLabels({"格式", "flash", "資料", "位置表", "第一個影格", "最差影格", "每次播放"});
+    m_reportTable->verticalHeader()->setVisible(false);
+    m_reportTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_reportTable->setSelectionMode(QAbstractItemView::NoSelection);
+    m_reportTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    layout->addWidget(m_reportTable, 1);
+
+    m_resultLabel = new QLabel(this);
+    m_resultLabel->setWordWrap(true);
+    layout->addWidget(m_resultLabel);
+
+    QPushButton *saveButton = new QPushButton("匯出 .h", this);
+    layout->addWidget(saveButton);
+
+    connect(m_modeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &AnimationExportDialog::updateSelection);
+    connect(m_budgetSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &AnimationExportDialog::updateSelection);
+    connect(m_keyframeSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &AnimationExportDialog::recalculate);
+    connect(m_busComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &AnimationExportDialog::recalculate);
+    connect(saveButton, &QPushButton::clicked, this, &AnimationExportDialog::onSaveClicked);
+}
+
+OledAnimationEncoder::Options AnimationExportDialog::options() const {
+    OledAnimationEncoder::Options options;
+    options.keyframeInterval = m_keyframeSpinBox->value();
+    options.bus = m_busComboBox->currentData().toInt() == OledBusEstimator::Bus::Spi
+                      ? OledBusEstimator::Bus::spi(8000000)
+                      : OledBusEstimator::Bus::i2c(400000);
+    return options;
+}
+
+OledAnimationEncoder::Mode AnimationExportDialog::selectedMode() const {
+    const int mode = m_modeComboBox->currentData().toInt();
+    if (mode < 0) {
+        return OledAnimationEncoder::recommend(m_reports, qint64(m_budgetSpinBox->value()) * 1024);
+    }
+    return static_cast<OledAnimationEncoder::Mode>(mode);
+}
+
+void AnimationExportDialog::recalculate() {
+    // 每種格式各編碼一次 (影格多時平行計算)，只留下報告
+    m_reports = OledAnimationEncoder::compare(m_geometry, m_frames, options());
+
+    const QSignalBlocker blocker(m_reportTable);
+    m_reportTable->setRowCount(static_cast<int>(m_reports.size()));
+    for (int row = 0; row < static_cast<int>(m_reports.size()); ++row) {
+        const OledAnimationEncoder::Report &report = m_reports[static_cast<size_t>(row)];
+        const QStringList cells{OledAnimationEncoder::modeName(report.mode),
+                                QString::number(report.flashBytes()),
+                                QString::number(report.dataBytes),
+                                QString::number(report.tableBytes),
+                                QString::number(report.first.busBytes()),
+                                QString("%1 (#%2，%3 ms)").arg(report.worst.busBytes()).arg(report.worstFrame)
+                                    .arg(report.worst.seconds * 1000.0, 0, 'f', 2),
+                                QString::number(report.totalBusBytes)};
+        for (int column = 0; column < cells.size(); ++column) {
+            m_reportTable->setItem(row, column, new QTableWidgetItem(cells.at(column)));
+        }
+    }
+    m_reportTable->resizeColumnsToContents();
+    updateSelection();
+}
+
+void AnimationExportDialog::updateSelection() {
+    const OledAnimationEncoder::Mode mode = selectedMode();
+    const qint64 budget = qint64(m_budgetSpinBox->value()) * 1024;
+    QString result = QString("%1 個影格 (%2x%3)。").arg(m_frames.size()).arg(m_geometry.width).arg(m_geometry.height);
+    for (int row = 0; row < static_cast<int>(m_reports.size()); ++row) {
+        const OledAnimationEncoder::Report &report = m_reports[static_cast<size_t>(row)];
+        const bool fits = budget <= 0 || report.flashBytes() <= budget;
+        const bool selected = report.mode == mode;
+        for (int column = 0; column < m_reportTable->columnCount(); ++column) {
+            QTableWidgetItem *item = m_reportTable->item(row, column);
+            QFont font = item->font();
+            font.setBold(selected);
+            item->setFont(font);
+            item->setForeground(fits ? palette().text() : QBrush(Qt::gray));
+        }
+        if (selected) {
+            result += QString("將匯出 %1：flash %2 bytes").arg(OledAnimationEncoder::modeName(mode)).arg(report.flashBytes());
+            if (!fits) {
+                result += "，超過 flash 上限";
+            }
+            result += "。";
+        }
+    }
+    m_resultLabel->setText(result);
+}
+
+void AnimationExportDialog::onSaveClicked() {
+    const OledAnimationEncoder::Options encoderOptions = options();
+    const OledAnimationEncoder::Mode mode = selectedMode();
+    OledAnimationEncoder::Result result;
+    if (!OledAnimationEncoder::encode(mode, m_geometry, m_frames, encoderOptions, &result)) {
+        QMessageBox::information(this, "提示", QString("這個面板無法使用 %1 格式。").arg(OledAnimationEncoder::modeName(mode)));
+        return;
+    }
+
+    const QString filePath = QFileDialog::getSaveFileName(this, "匯出動畫", "animation.h", "C header (*.h)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::critical(this, "错误", QString("无法写入档案:\n%1").arg(filePath));
+        return;
+    }
+
+    OledCArrayWriter::Options writerOptions;
+    writerOptions.type = "const unsigned char";
+    writerOptions.upperCase = false;
+    OledCArrayWriter writer(&file, writerOptions);
+    writer.writeComment("File generated by OLED GUI Designer");
+    OledAnimationEncoder::writeArrays(&writer, "animation", result, m_geometry, encoderOptions);
+
+    if (writer.flush()) {
+        QMessageBox::information(this, "成功", QString("%1 個影格已匯出至:\n%2").arg(m_frames.size()).arg(filePath));
+    } else {
+        QMessageBox::critical(this, "错误", QString("无法写入档案:\n%1").arg(filePath));
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef ANIMATIONEXPORTDIALOG_H
+#define ANIMATIONEXPORTDIALOG_H
+
+#include "config.h"
+#include "oled_animation.h"
+#include <vector>
+#include <cstdint> // for uint8_t
+
+
+// 前置宣告，加快編譯速度
+class QComboBox;
+class QSpinBox;
+class QLabel;
+class QTableWidget;
+
+/**
+ * @brief 匯出動畫：列出每種格式 (OledAnimationEncoder) 的 flash 大小與每個影格送到面板的 byte 數，
+ *        選好格式後寫出 .h (資料、位置表與 C 解碼函式)。
+ *
+ * 「自動」在 flash 上限內選之後的影格送到面板最快的格式，上限設成最小的 MCU 的剩餘 flash 即可。
+ */
+class AnimationExportDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    // frames 為硬體格式 (bufferSize() bytes)，通常來自 OledTimeline::frame()
+    AnimationExportDialog(const OledPanelGeometry &geometry, std::vector<std::vector<uint8_t>> frames,
+                          QWidget *parent = nullptr);
+
+private slots:
+    void recalculate();
+    void updateSelection();
+    void onSaveClicked();
+
+private:
+    QComboBox *m_modeComboBox;      // 第一項為自動
+    QSpinBox *m_keyframeSpinBox;
+    QSpinBox *m_budgetSpinBox;      // KB，0 為不限制
+    QComboBox *m_busComboBox;
+    QTableWidget *m_reportTable;
+    QLabel *m_resultLabel;
+
+    OledPanelGeometry m_geometry;
+    std::vector<std::vector<uint8_t>> m_frames;
+    std::vector<OledAnimationEncoder::Report> m_reports;
+
+    // 初始化 UI 的 helper
+    void setupUi();
+    OledAnimationEncoder::Options options() const;
+    OledAnimationEncoder::Mode selectedMode() const;
+};
+
+#endif // ANIMATIONEXPORTDIALOG_H
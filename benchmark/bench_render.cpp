@@ -0,0 +1,95 @@
+/* ******************Copyright (C) 2025 Ethan Yang *****************************
+ * @file    bench_render.cpp
+ * @brief   updateImageFromModel 全畫面刷新的微型效能測試。
+ *
+ * @details 比較兩種把 OledDataModel 轉成顯示用 QImage 的方法：
+ *          - legacy：RGB888 圖片 + 每個像素呼叫 setPixelColor (舊版 updateImageFromModel)
+ *          - indexed：Format_Indexed8 調色盤圖片 + 查表寫入 scanLine()
+ *
+ *          不需要 QApplication，QImage 在沒有 GUI 的情況下也能使用。
+ *          用法：bench_render [次數]，預設 2000 次。
+ *
+ * @note    本專案使用 GPLv3 授權，詳情請見 LICENSE 檔案。
+ * *****************Copyright (C) 2025*****************************************
+ */
+
+#include "../oled_datamodel.h"
+#include "../oled_dataconverter.h"
+
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// 舊版 updateImageFromModel 的寫法，保留在這裡作為比較基準
+void renderLegacy(const OledDataModel &model, QImage &image)
+{
+    const QColor pixelOnColor = QColor(135, 206, 250);
+    const QColor pixelOffColor = Qt::black;
+
+    for (int y = 0; y < OledConfig::DISPLAY_HEIGHT; ++y) {
+        for (int x = 0; x < OledConfig::DISPLAY_WIDTH; ++x) {
+            image.setPixelColor(x, y, model.getPixel(x, y) ? pixelOnColor : pixelOffColor);
+        }
+    }
+}
+
+// 畫一些線條與圓形，讓畫面不是全黑 (全黑的分支預測太理想，不具代表性)
+void fillTestPattern(OledDataModel &model)
+{
+    for (int i = 0; i < OledConfig::DISPLAY_WIDTH; i += 6) {
+        model.drawLine(i, 0, OledConfig::DISPLAY_WIDTH - 1 - i, OledConfig::DISPLAY_HEIGHT - 1, true, 1);
+    }
+    model.drawCircle(QPoint(20, 8), QPoint(108, 56), 2);
+    model.drawRectangle(40, 20, 30, 16, true, true, 1);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    const int iterations = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 2000;
+    const QRect fullFrame(0, 0, OledConfig::DISPLAY_WIDTH, OledConfig::DISPLAY_HEIGHT);
+
+    OledDataModel model;
+    fillTestPattern(model);
+
+    QImage legacyImage(OledConfig::DISPLAY_WIDTH, OledConfig::DISPLAY_HEIGHT, QImage::Format_RGB888);
+    QImage indexedImage = OledDataConverter::createIndexedImage(QColor(135, 206, 250), Qt::black);
+
+    QElapsedTimer timer;
+
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        renderLegacy(model, legacyImage);
+    }
+    const qint64 legacyNs = timer.nsecsElapsed();
+
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        OledDataConverter::renderModelToIndexedImage(model, &indexedImage, fullFrame);
+    }
+    const qint64 indexedNs = timer.nsecsElapsed();
+
+    // 確認兩種方法的結果一致，避免量到錯誤的程式碼
+    for (int y = 0; y < OledConfig::DISPLAY_HEIGHT; ++y) {
+        for (int x = 0; x < OledConfig::DISPLAY_WIDTH; ++x) {
+            if (legacyImage.pixel(x, y) != indexedImage.pixel(x, y)) {
+                std::fprintf(stderr, "mismatch at (%d, %d)\n", x, y);
+                return 1;
+            }
+        }
+    }
+
+    const double legacyPerFrame = double(legacyNs) / iterations;
+    const double indexedPerFrame = double(indexedNs) / iterations;
+
+    std::printf("full-frame refresh, %d iterations\n", iterations);
+    std::printf("  legacy  (RGB888 + setPixelColor) : %10.1f ns/frame\n", legacyPerFrame);
+    std::printf("  indexed (Indexed8 + scanLine LUT): %10.1f ns/frame\n", indexedPerFrame);
+    std::printf("  speedup                          : %10.1fx\n",
+                indexedPerFrame > 0.0 ? legacyPerFrame / indexedPerFrame : 0.0);
+    return 0;
+}
@@ -0,0 +1,738 @@
+/* ******************Copyright (C) 2025 Ethan Yang *****************************
+ * @file    bench_suite.cpp
+ * @brief   編輯器熱點路徑的效能測試集 (模型、轉換、繪製、歷史、匯出)。
+ *
+ * @details 每個測試項目會自動增加執行次數，直到總時間超過 --min-time，
+ *          再回報每次操作的時間、每秒次數，以及每次操作的 operator new 次數與 byte 數。
+ *
+ *          用法：bench_suite [--json | --csv] [--filter 子字串] [--min-time 毫秒]
+ *                bench_suite --codecs
+ *          - 預設輸出對齊的表格，--json / --csv 輸出機器可讀格式，方便 CI 比對前後版本。
+ *          - --codecs 只印出各壓縮格式在幾種典型畫面上的大小、壓縮比、估計的 MCU 解碼週期與往返檢查。
+ *          - 配置次數只統計 operator new / delete；QImage 的像素資料是用 malloc 配置的，不在統計內。
+ *
+ *          只依賴 oledcore，不需要 QApplication。
+ *
+ * @note    本專案使用 GPLv3 授權，詳情請見 LICENSE 檔案。
+ * *****************Copyright (C) 2025*****************************************
+ */
+
+#include "../commandhistory.h"
+#include "../historymanager.h"
+#include "../oled_animation.h"
+#include "../oled_assetcatalog.h"
+#include "../oled_assetio.h"
+#include "../oled_busestimator.h"
+#include "../oled_carray.h"
+#include "../oled_codec.h"
+#include "../oled_dataconverter.h"
+#include "../oled_datamodel.h"
+#include "../oled_dither.h"
+#include "../oled_font.h"
+#include "../oled_patch.h"
+#include "../oled_timeline.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// 配置統計：取代全域 operator new / delete
+// ---------------------------------------------------------------------------
+
+namespace {
+std::atomic<unsigned long long> g_allocCount{0};
+std::atomic<unsigned long long> g_allocBytes{0};
+}
+
+void* operator new(std::size_t size)
+{
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+// 防止編譯器把沒有用到結果的運算整個最佳化掉
+volatile uint64_t g_sink = 0;
+
+struct BenchResult {
+    QString name;
+    long long iterations = 0;
+    double nsPerOp = 0.0;
+    double allocsPerOp = 0.0;
+    double bytesPerOp = 0.0;
+};
+
+struct BenchCase {
+    QString name;
+    std::function<void(long long)> run; // 參數是迴圈索引，讓每次操作的座標/內容不同
+};
+
+BenchResult measure(const BenchCase& bench, qint64 minNs)
+{
+    // 先跑一次暖身 (第一次配置、快取)
+    bench.run(0);
+
+    long long batch = 1;
+    for (;;) {
+        const unsigned long long allocBefore = g_allocCount.load();
+        const unsigned long long bytesBefore = g_allocBytes.load();
+
+        QElapsedTimer timer;
+        timer.start();
+        for (long long i = 0; i < batch; ++i) {
+            bench.run(i);
+        }
+        const qint64 elapsed = timer.nsecsElapsed();
+
+        if (elapsed >= minNs || batch >= (1LL << 30)) {
+            BenchResult result;
+            result.name = bench.name;
+            result.iterations = batch;
+            result.nsPerOp = double(elapsed) / batch;
+            result.allocsPerOp = double(g_allocCount.load() - allocBefore) / batch;
+            result.bytesPerOp = double(g_allocBytes.load() - bytesBefore) / batch;
+            return result;
+        }
+
+        // 依目前速度估計需要的次數，至少加倍
+        const double scale = elapsed > 0 ? double(minNs) / elapsed * 1.2 : 10.0;
+        batch = std::max(batch * 2, static_cast<long long>(batch * std::min(scale, 100.0)));
+    }
+}
+
+// 畫一些線條與圓形，讓畫面不是全黑 (全黑的分支預測太理想，不具代表性)
+void fillTestPattern(OledDataModel& model)
+{
+    for (int i = 0; i < model.width(); i += 6) {
+        model.drawLine(i, 0, model.width() - 1 - i, model.height() - 1, true, 1);
+    }
+    model.drawCircle(QPoint(20, 8), QPoint(model.width() - 20, model.height() - 8), 2);
+    model.drawRectangle(40, 20, 30, 16, true, true, 1);
+    model.takeDirtyRegion();
+}
+
+// 壓縮格式比較用的典型畫面 (頁面格式)：空白、線條圖、多圖層、有序混色的漸層
+std::vector<std::pair<QString, std::vector<uint8_t>>> codecScreens()
+{
+    std::vector<std::pair<QString, std::vector<uint8_t>>> screens;
+
+    OledDataModel blank;
+    screens.emplace_back("blank", blank.getHardwareBuffer());
+
+    OledDataModel pattern;
+    fillTestPattern(pattern);
+    screens.emplace_back("pattern", pattern.getHardwareBuffer());
+
+    OledDataModel layered;
+    fillTestPattern(layered);
+    layered.setActiveLayer(layered.addLayer("widgets", OledDataModel::BlendXor));
+    layered.drawRectangle(8, 8, 60, 30, true, true, 1);
+    layered.setActiveLayer(layered.addLayer("text", OledDataModel::BlendMask));
+    layered.drawCircle(QPoint(70, 10), QPoint(120, 60), 3);
+    screens.emplace_back("layered", layered.getHardwareBuffer());
+
+    // 4x4 Bayer 門檻的水平漸層
+    static const int kBayer4[4][4] = {{0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+    OledDataModel gradient;
+    for (int y = 0; y < gradient.height(); ++y) {
+        for (int x = 0; x < gradient.width(); ++x) {
+            const int level = x * 16 / gradient.width();
+            gradient.setPixel(x, y, level > kBayer4[y & 3][x & 3], 1);
+        }
+    }
+    screens.emplace_back("dither", gradient.getHardwareBuffer());
+    return screens;
+}
+
+// 舊版 MainWindow::exportData 的 C 陣列字串組法 (QString 逐項 +=)
+QString legacyExportString(const std::vector<uint8_t>& buffer)
+{
+    QString c_array = QString("const unsigned char screen_data[%1] = {\n    ").arg(buffer.size());
+    int line_break_count = 0;
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        c_array += QString("0x%1,").arg(buffer[i], 2, 16, QChar('0'));
+        line_break_count++;
+        if (line_break_count == 16 && i < buffer.size() - 1) {
+            c_array += "\n    ";
+            line_break_count = 0;
+        }
+    }
+    if (c_array.endsWith(", ")) {
+        c_array.chop(2);
+    }
+    c_array += "\n};";
+    return c_array;
+}
+
+// 舊版 MainWindow::saveData 的寫法 (QTextStream 寫入 QString)
+QString legacySaveString(const std::vector<uint8_t>& buffer)
+{
+    QString content;
+    QTextStream out(&content);
+    out << QString("const unsigned char image_%1[%2] = {\n    ").arg("bench").arg(buffer.size());
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        out << QString("0x%1, ").arg(buffer[i], 2, 16, QChar('0'));
+        if ((i + 1) % 16 == 0 && i < buffer.size() - 1) {
+            out << "\n    ";
+        }
+    }
+    out.flush();
+    return content;
+}
+
+// 舊版 OledAssetIO::parseHexArray (QRegularExpression 掃過第一個 '{' 到最後一個 '}')
+std::vector<uint8_t> legacyParseHexArray(const QString& text)
+{
+    QString dataContent = text;
+    const int startBrace = text.indexOf('{');
+    const int endBrace = text.lastIndexOf('}');
+    if (startBrace != -1 && endBrace != -1 && endBrace > startBrace) {
+        dataContent = text.mid(startBrace, endBrace - startBrace + 1);
+    }
+    static const QRegularExpression hexRegex("0x[0-9a-fA-F]+|[0-9a-fA-F]{2}");
+    auto matches = hexRegex.globalMatch(dataContent);
+    std::vector<uint8_t> bytes;
+    while (matches.hasNext()) {
+        bool ok;
+        const int val = matches.next().captured().toInt(&ok, 16);
+        if (ok) bytes.push_back(static_cast<uint8_t>(val));
+    }
+    return bytes;
+}
+
+std::vector<BenchCase> buildCases()
+{
+    std::vector<BenchCase> cases;
+    const QRect fullFrame(0, 0, OledConfig::DISPLAY_WIDTH, OledConfig::DISPLAY_HEIGHT);
+
+    // 共用的測試資料 (lambda 以 shared_ptr 持有，生命週期跟著 cases)
+    auto pattern = std::make_shared<OledDataModel>();
+    fillTestPattern(*pattern);
+    auto scratch = std::make_shared<OledDataModel>();
+    auto hardware = std::make_shared<std::vector<uint8_t>>(pattern->getHardwareBuffer());
+    auto logical = std::make_shared<QImage>(pattern->copyRegionToLogicalFormat(fullFrame));
+    auto importImage = std::make_shared<QImage>(*logical);
+    importImage->invertPixels(); // updateModelFromImage 以索引 0 為亮點
+    auto indexed = std::make_shared<QImage>(OledDataConverter::createIndexedImage(QColor(135, 206, 250), Qt::black));
+    auto pages = std::make_shared<std::vector<uint8_t>>();
+    {
+        const QVector<uint8_t> converted = OledDataModel::convertLogicalToHardwareFormat(*logical);
+        pages->assign(converted.cbegin(), converted.cend());
+    }
+
+    // --- 模型：畫點 / 直線 / 圓形，每種筆刷大小 ---
+    for (int brush = 1; brush <= 6; ++brush) {
+        cases.push_back({QString("model/setPixel/brush%1").arg(brush), [scratch, brush](long long i) {
+            scratch->setPixel(int(i * 37 % OledConfig::DISPLAY_WIDTH), int(i * 11 % OledConfig::DISPLAY_HEIGHT),
+                              (i & 1) == 0, brush);
+        }});
+    }
+    for (int brush = 1; brush <= 6; ++brush) {
+        cases.push_back({QString("model/drawLine/brush%1").arg(brush), [scratch, brush](long long i) {
+            scratch->drawLine(0, int(i % OledConfig::DISPLAY_HEIGHT), OledConfig::DISPLAY_WIDTH - 1,
+                              OledConfig::DISPLAY_HEIGHT - 1 - int(i % OledConfig::DISPLAY_HEIGHT), (i & 1) == 0, brush);
+        }});
+    }
+    for (int brush = 1; brush <= 6; ++brush) {
+        cases.push_back({QString("model/drawCircle/brush%1").arg(brush), [scratch, brush](long long i) {
+            const int inset = int(i % 8);
+            scratch->drawCircle(QPoint(10 + inset, 5 + inset), QPoint(117 - inset, 58 - inset), brush);
+        }});
+    }
+
+    // --- 模型：整個 buffer 的交換 ---
+    cases.push_back({"model/getHardwareBuffer", [pattern](long long) {
+        const std::vector<uint8_t> buffer = pattern->getHardwareBuffer();
+        g_sink += buffer[buffer.size() / 2];
+    }});
+    cases.push_back({"model/setFromHardwareBuffer", [scratch, hardware](long long) {
+        scratch->setFromHardwareBuffer(hardware->data());
+    }});
+    cases.push_back({"model/copyRegionToLogicalFormat/full", [pattern, fullFrame](long long) {
+        const QImage image = pattern->copyRegionToLogicalFormat(fullFrame);
+        g_sink += image.width();
+    }});
+
+    // --- 轉換 ---
+    cases.push_back({"convert/convertLogicalToHardwareFormat/full", [logical](long long) {
+        const QVector<uint8_t> data = OledDataModel::convertLogicalToHardwareFormat(*logical);
+        g_sink += data.size();
+    }});
+    cases.push_back({"convert/updateModelFromImage/full", [scratch, importImage](long long) {
+        OledDataConverter::updateModelFromImage(scratch.get(), *importImage);
+    }});
+
+    // --- 繪製 (OLEDWidget::updateImageFromModel 的核心) ---
+    cases.push_back({"render/updateImageFromModel/full", [pattern, indexed, fullFrame](long long) {
+        OledDataConverter::renderModelToIndexedImage(*pattern, indexed.get(), fullFrame);
+    }});
+    cases.push_back({"render/updateImageFromModel/dirty8x8", [pattern, indexed](long long i) {
+        const QRect dirty(int(i * 8 % 120), int(i * 8 % 56), 8, 8);
+        OledDataConverter::renderModelToIndexedImage(*pattern, indexed.get(), dirty);
+    }});
+
+    // --- 圖層合成：背景 + 兩個圖層，全畫面與 8x8 髒區域 ---
+    auto layered = std::make_shared<OledDataModel>();
+    fillTestPattern(*layered);
+    layered->setActiveLayer(layered->addLayer("widgets", OledDataModel::BlendXor));
+    layered->drawRectangle(8, 8, 60, 30, true, true, 1);
+    layered->setActiveLayer(layered->addLayer("text", OledDataModel::BlendMask));
+    layered->drawCircle(QPoint(70, 10), QPoint(120, 60), 3);
+    layered->getBuffer();
+    cases.push_back({"layers/composite/full", [layered](long long) {
+        layered->markAllDirty();
+        layered->getBuffer();
+        layered->takeDirtyRegion();
+    }});
+    cases.push_back({"layers/composite/dirty8x8", [layered](long long i) {
+        layered->setPixel(int(i * 8 % 120), int(i * 8 % 56), (i & 1) == 0, 1);
+        layered->getBuffer();
+        layered->takeDirtyRegion();
+    }});
+
+    // --- 混色：每種方法在 128x64 (一個畫面) 與 1024x512 (大張照片) 的亮度平面上 ---
+    const QSize ditherSizes[] = {QSize(128, 64), QSize(1024, 512)};
+    for (const QSize& size : ditherSizes) {
+        // 水平漸層加上一點雜訊，避免全部落在同一個門檻
+        auto luma = std::make_shared<std::vector<uint8_t>>(size_t(size.width()) * size.height());
+        for (int y = 0; y < size.height(); ++y) {
+            for (int x = 0; x < size.width(); ++x) {
+                (*luma)[size_t(y) * size.width() + x] =
+                    static_cast<uint8_t>(x * 255 / (size.width() - 1) ^ ((x * 7 + y * 13) & 15));
+            }
+        }
+        const int bitsStride = (size.width() + 7) / 8;
+        auto bits = std::make_shared<std::vector<uint8_t>>(size_t(bitsStride) * size.height());
+        for (int m = OledDither::Threshold; m <= OledDither::BlueNoise; ++m) {
+            OledDither::Options options;
+            options.method = static_cast<OledDither::Method>(m);
+            options.gamma = 1.2;
+            cases.push_back({QString("dither/%1/%2x%3").arg(OledDither::methodName(options.method))
+                                 .arg(size.width()).arg(size.height()),
+                             [luma, bits, size, bitsStride, options](long long) {
+                OledDither::ditherPlane(luma->data(), size.width(), size.height(), size.width(), options,
+                                        bits->data(), bitsStride);
+                g_sink += (*bits)[0];
+            }});
+        }
+    }
+
+    // --- 面板：每款面板的特化 kernel 與通用 kernel ---
+    for (const OledPanelProfile& profile : OledPanel::profiles()) {
+        const OledPanelGeometry geometry = profile.geometry;
+        auto panelModel = std::make_shared<OledDataModel>(geometry);
+        fillTestPattern(*panelModel);
+        auto panelImage = std::make_shared<QImage>(OledDataConverter::createIndexedImage(
+            QColor(135, 206, 250), Qt::black, QSize(geometry.width, geometry.height)));
+        auto panelFrame = std::make_shared<std::vector<uint8_t>>(panelModel->getHardwareBuffer());
+        auto panelScratch = std::make_shared<OledDataModel>(geometry);
+        const QRect panelRect(0, 0, geometry.width, geometry.height);
+        const QString prefix = QString("panel/%1/").arg(QString::fromLatin1(profile.id));
+
+        cases.push_back({prefix + "render/full", [panelModel, panelImage, panelRect](long long) {
+            OledDataConverter::renderModelToIndexedImage(*panelModel, panelImage.get(), panelRect);
+        }});
+        cases.push_back({prefix + "render/full/generic", [panelModel, panelImage, panelRect](long long) {
+            OledPanel::genericKernels().renderIndexed(panelModel->geometry(), panelModel->getBuffer(),
+                                                      panelImage.get(), panelRect);
+        }});
+        cases.push_back({prefix + "setFromHardwareBuffer", [panelScratch, panelFrame](long long) {
+            panelScratch->setFromHardwareBuffer(panelFrame->data());
+            panelScratch->takeDirtyRegion();
+        }});
+    }
+
+    // --- 歷史紀錄 ---
+    // 先放入一些狀態，單獨執行 undo/redo 測試時也有東西可以走
+    auto history = std::make_shared<HistoryManager>();
+    auto historyModel = std::make_shared<OledDataModel>();
+    for (int i = 0; i < 32; ++i) {
+        historyModel->drawLine(0, i * 2, 127, 63 - i * 2, true, 1);
+        const std::vector<uint8_t> buffer = historyModel->getHardwareBuffer();
+        history->pushState(QByteArray(reinterpret_cast<const char*>(buffer.data()), int(buffer.size())));
+    }
+    cases.push_back({"history/HistoryManager/pushState", [history, historyModel](long long i) {
+        historyModel->drawLine(0, int(i % 64), 127, int(i * 7 % 64), true, 1);
+        const std::vector<uint8_t> buffer = historyModel->getHardwareBuffer();
+        history->pushState(QByteArray(reinterpret_cast<const char*>(buffer.data()), int(buffer.size())));
+    }});
+    cases.push_back({"history/HistoryManager/undoRedo", [history](long long i) {
+        const QByteArray state = (i & 1) ? history->redo() : history->undo();
+        g_sink += state.size();
+    }});
+
+    auto commands = std::make_shared<CommandHistory>();
+    auto commandModel = std::make_shared<OledDataModel>();
+    for (int i = 0; i < 32; ++i) {
+        commandModel->beginCommand();
+        commandModel->drawLine(0, i * 2, 127, 63 - i * 2, true, 2);
+        OledEditCommand command;
+        if (commandModel->endCommand(OledEditCommand::Stroke, &command)) {
+            commands->push(std::move(command));
+        }
+    }
+    cases.push_back({"history/CommandHistory/recordStroke", [commands, commandModel](long long i) {
+        commandModel->beginCommand();
+        commandModel->drawLine(int(i % 100), int(i % 64), int(i % 100) + 20, int(i * 3 % 64), (i & 1) == 0, 2);
+        OledEditCommand command;
+        if (commandModel->endCommand(OledEditCommand::Stroke, &command)) {
+            commands->push(std::move(command));
+        }
+    }});
+    cases.push_back({"history/CommandHistory/undoRedo", [commands, commandModel](long long i) {
+        const bool undo = (i & 1) == 0;
+        if (const OledEditCommand* command = undo ? commands->undo() : commands->redo()) {
+            commandModel->applyCommand(*command, undo);
+        }
+    }});
+
+    // --- 匯出字串 ---
+    cases.push_back({"export/legacy/exportData", [hardware](long long) {
+        g_sink += legacyExportString(*hardware).size();
+    }});
+    cases.push_back({"export/legacy/saveData", [hardware](long long) {
+        g_sink += legacySaveString(*hardware).size();
+    }});
+    cases.push_back({"export/OledAssetIO/formatCArray", [pages](long long) {
+        g_sink += OledAssetIO::formatCArray("imageData", *pages).size();
+    }});
+    cases.push_back({"export/OledCArrayWriter/QByteArray", [hardware](long long) {
+        QByteArray out;
+        OledCArrayWriter writer(&out);
+        writer.writeArray("screen_data", hardware->data(), hardware->size());
+        g_sink += out.size();
+    }});
+
+    // 批次匯出 64 個影格的動畫 (每個影格一個陣列)，串流到 QIODevice
+    auto frameSink = std::make_shared<QByteArray>();
+    auto frameDevice = std::make_shared<QBuffer>(frameSink.get());
+    frameDevice->open(QIODevice::WriteOnly);
+    cases.push_back({"export/legacy/exportData x64 frames", [hardware](long long) {
+        qint64 total = 0;
+        for (int frame = 0; frame < 64; ++frame) {
+            total += legacyExportString(*hardware).size();
+        }
+        g_sink += total;
+    }});
+    cases.push_back({"export/OledCArrayWriter/QIODevice x64 frames", [hardware, frameSink, frameDevice](long long) {
+        frameDevice->seek(0);
+        frameSink->resize(0);
+        OledCArrayWriter::Options options;
+        options.attribute = "PROGMEM";
+        options.sizeMacros = true;
+        OledCArrayWriter writer(frameDevice.get(), options);
+        for (int frame = 0; frame < 64; ++frame) {
+            writer.writeArray("frame_" + QByteArray::number(frame), hardware->data(), hardware->size(), QSize(128, 64));
+        }
+        writer.flush();
+        g_sink += frameSink->size();
+    }});
+
+    // --- 匯入：解析 64 KB 的字型 / 動畫標頭檔 (每行 16 個 byte 加行尾註解) ---
+    auto header = std::make_shared<QByteArray>("// Font data (8x16 glyphs)\nconst uint8_t font_2024[65536] PROGMEM = {\n");
+    for (int i = 0; i < 65536; ++i) {
+        *header += QByteArray("0x") + QByteArray::number(0x10 + (i * 7) % 0xF0, 16) + ", ";
+        if (i % 16 == 15) *header += "// row " + QByteArray::number(i / 16) + "\n";
+    }
+    *header += "};\n";
+    auto headerText = std::make_shared<QString>(QString::fromUtf8(*header));
+    cases.push_back({"import/legacy/parseHexArray/64KB", [headerText](long long) {
+        g_sink += legacyParseHexArray(*headerText).size();
+    }});
+    cases.push_back({"import/OledAssetIO/parseHexArray/64KB", [headerText](long long) {
+        g_sink += OledAssetIO::parseHexArray(*headerText).size();
+    }});
+    cases.push_back({"import/OledCArrayReader/64KB", [header](long long) {
+        OledCArrayReader reader(*header);
+        OledCArrayReader::Array array;
+        uint8_t value;
+        while (reader.nextArray(&array)) {
+            while (reader.nextValue(&value)) g_sink += value;
+        }
+    }});
+
+    // --- 匯入：256 個 16x16 圖示的標頭檔 (選一個素材 = 索引 + 延遲載入；重開檔案 = 快取命中) ---
+    auto icons = std::make_shared<QByteArray>("#define ICON_WIDTH 16\n#define ICON_HEIGHT 16\n");
+    for (int n = 0; n < 256; ++n) {
+        *icons += "// icon " + QByteArray::number(n) + " (16x16, vertical page)\n";
+        *icons += "const uint8_t icon_" + QByteArray::number(n) + "[32] PROGMEM = {\n";
+        for (int i = 0; i < 32; ++i) {
+            *icons += QByteArray("0x") + QByteArray::number((n * 31 + i * 7) & 0xFF, 16) + (i % 16 == 15 ? ",\n" : ", ");
+        }
+        *icons += "};\n";
+    }
+    auto iconEntries = std::make_shared<std::vector<OledAssetCatalog::Entry>>(
+        OledAssetCatalog::index(icons->constData(), size_t(icons->size())));
+    cases.push_back({"import/OledAssetCatalog/index/256 icons", [icons](long long) {
+        g_sink += OledAssetCatalog::index(icons->constData(), size_t(icons->size())).size();
+    }});
+    cases.push_back({"import/OledAssetCatalog/load/256 icons", [icons, iconEntries](long long i) {
+        const OledAssetCatalog::Entry& entry = (*iconEntries)[size_t(i) % iconEntries->size()];
+        g_sink += OledAssetCatalog::load(icons->constData(), size_t(icons->size()), entry).size();
+    }});
+    const QString iconPath = QDir::temp().filePath("bench_suite_icons.h");
+    QFile iconFile(iconPath);
+    if (iconFile.open(QIODevice::WriteOnly)) {
+        iconFile.write(*icons);
+        iconFile.close();
+        cases.push_back({"import/OledAssetCatalog/open (cached)/256 icons", [iconPath](long long) {
+            const std::shared_ptr<const OledAssetCatalog> catalog = OledAssetCatalog::open(iconPath);
+            g_sink += catalog ? catalog->count() : 0;
+        }});
+        cases.push_back({"import/OledAssetCatalog/open (uncached)/256 icons", [iconPath](long long) {
+            OledAssetCatalog::clearCache();
+            const std::shared_ptr<const OledAssetCatalog> catalog = OledAssetCatalog::open(iconPath);
+            g_sink += catalog ? catalog->count() : 0;
+        }});
+    }
+
+    // --- 傳輸估計：線條圖畫面上改了一個小圖示 (局部更新) 與整個畫面都不同 ---
+    auto busAfter = std::make_shared<std::vector<uint8_t>>(*hardware);
+    {
+        OledDataModel edited(pattern->geometry());
+        edited.setFromHardwareBuffer(hardware->data());
+        edited.drawRectangle(90, 4, 12, 12, true, true, 1);
+        *busAfter = edited.getHardwareBuffer();
+    }
+    auto busBlank = std::make_shared<std::vector<uint8_t>>(hardware->size(), 0);
+    const OledPanelGeometry busGeometry = pattern->geometry();
+    cases.push_back({"bus/OledBusEstimator/plan/icon", [hardware, busAfter, busGeometry](long long) {
+        g_sink += OledBusEstimator::plan(busGeometry, hardware->data(), busAfter->data(),
+                                         OledBusEstimator::Bus::i2c(400000, 32)).windows.size();
+    }});
+    cases.push_back({"bus/OledBusEstimator/plan/full", [hardware, busBlank, busGeometry](long long) {
+        g_sink += OledBusEstimator::plan(busGeometry, busBlank->data(), hardware->data(),
+                                         OledBusEstimator::Bus::spi(8000000)).windows.size();
+    }});
+    // 差異更新：空白 → 線條圖 → 加上圖示 → 回到線條圖 (循環)，編碼並序列化整串
+    auto patchFrames = std::make_shared<std::vector<std::vector<uint8_t>>>(
+        std::vector<std::vector<uint8_t>>{*busBlank, *hardware, *busAfter});
+    cases.push_back({"patch/OledPatchEncoder/encodeSequence", [patchFrames, busGeometry](long long) {
+        const std::vector<OledPatchEncoder::Transition> transitions =
+            OledPatchEncoder::encodeSequence(busGeometry, *patchFrames, OledBusEstimator::Bus::i2c(400000, 32), true);
+        std::vector<uint8_t> stream;
+        for (const OledPatchEncoder::Transition& transition : transitions) {
+            OledPatchEncoder::serialize(transition, &stream);
+        }
+        g_sink += stream.size();
+    }});
+
+    // --- 動畫時間軸：200 個影格的開機動畫 (進度條 + 轉圈)，加入影格 (雜湊去除重複) 與拖曳時組出畫面 ---
+    auto bootFrames = std::make_shared<std::vector<std::vector<uint8_t>>>();
+    {
+        std::vector<uint8_t> frame(*busBlank);
+        const int stride = busGeometry.ramPageWidth;
+        for (int n = 0; n < 200; ++n) {
+            for (int x = 0; x < n * busGeometry.width / 200; ++x) frame[6 * stride + busGeometry.columnOffset + x] = 0x7E;
+            for (int x = 60; x < 68; ++x) frame[3 * stride + busGeometry.columnOffset + x] = uint8_t(1u << (n % 8));
+            bootFrames->push_back(frame);
+        }
+    }
+    cases.push_back({"timeline/OledTimeline/append200", [bootFrames, busGeometry](long long) {
+        OledTimeline timeline(busGeometry);
+        for (const std::vector<uint8_t>& frame : *bootFrames) {
+            timeline.appendFrame(frame.data());
+        }
+        g_sink += timeline.stats().uniquePages;
+    }});
+    auto bootTimeline = std::make_shared<OledTimeline>(busGeometry);
+    for (const std::vector<uint8_t>& frame : *bootFrames) {
+        bootTimeline->appendFrame(frame.data());
+    }
+    auto scrubBuffer = std::make_shared<std::vector<uint8_t>>(busGeometry.bufferSize());
+    cases.push_back({"timeline/OledTimeline/copyFrame", [bootTimeline, scrubBuffer](long long i) {
+        bootTimeline->copyFrame(int(i % bootTimeline->frameCount()), scrubBuffer->data());
+        g_sink += (*scrubBuffer)[0];
+    }});
+
+    // --- 動畫匯出：同一段開機動畫以每種格式編碼 (影格之間的差異平行計算) ---
+    for (const OledAnimationEncoder::Mode mode : OledAnimationEncoder::modes()) {
+        const QString label = "anim/" + OledAnimationEncoder::modeName(mode) + "/encode200";
+        cases.push_back({label, [bootFrames, busGeometry, mode](long long) {
+            OledAnimationEncoder::Result result;
+            OledAnimationEncoder::encode(mode, busGeometry, *bootFrames, OledAnimationEncoder::Options(), &result);
+            g_sink += result.report.flashBytes();
+        }});
+    }
+
+    // --- 文字：內建字型畫一行 21 個字元，y 在頁邊界 (整個 byte 寫入) 與不在頁邊界 (拆成兩頁) ---
+    auto textModel = std::make_shared<OledDataModel>();
+    const QString textLine = "Temp 23.5C  RH 41%  #";
+    cases.push_back({"text/OledFont/drawText/aligned", [textModel, textLine](long long i) {
+        g_sink += OledFont::builtin().drawText(textModel.get(), 0, 8 * int(i % 8), textLine, (i & 8) == 0).width();
+    }});
+    cases.push_back({"text/OledFont/drawText/shifted", [textModel, textLine](long long i) {
+        g_sink += OledFont::builtin().drawText(textModel.get(), 0, 8 * int(i % 7) + 3, textLine, (i & 8) == 0).width();
+    }});
+    // 字高 16 (兩頁) 的字型：內建字型的每一列放大兩倍 (系統字型要 QGuiApplication，這裡不使用)
+    auto tallFont = std::make_shared<OledFont>("10x16", 16, 14);
+    for (uint c = 32; c < 127; ++c) {
+        const OledFont::Glyph* g = OledFont::builtin().glyph(c);
+        const uint8_t* bits = OledFont::builtin().glyphBits(*g);
+        uint8_t tall[10 * 2] = {};
+        for (int x = 0; x < 10; ++x) {
+            for (int y = 0; y < 16; ++y) {
+                if (bits[x / 2] & (1u << (y / 2))) tall[(y >> 3) * 10 + x] |= uint8_t(1u << (y & 7));
+            }
+        }
+        tallFont->addGlyph(c, tall, 10, 12);
+    }
+    cases.push_back({"text/OledFont/drawText/tall-shifted", [textModel, tallFont, textLine](long long i) {
+        g_sink += tallFont->drawText(textModel.get(), 0, 8 * int(i % 6) + 5, textLine, (i & 8) == 0).width();
+    }});
+
+    // --- 壓縮格式：線條圖畫面的壓縮與主機端解碼 (MCU 上的估計週期見 --codecs) ---
+    const int pageWidth = pattern->geometry().ramPageWidth;
+    for (const OledCodec::Method method : OledCodec::methods()) {
+        auto encoded = std::make_shared<std::vector<uint8_t>>(
+            OledCodec::encode(method, hardware->data(), hardware->size(), pageWidth));
+        auto decoded = std::make_shared<std::vector<uint8_t>>(hardware->size());
+        const QString prefix = "codec/" + OledCodec::methodName(method) + "/";
+        cases.push_back({prefix + "encode", [hardware, method, pageWidth](long long) {
+            g_sink += OledCodec::encode(method, hardware->data(), hardware->size(), pageWidth).size();
+        }});
+        cases.push_back({prefix + "decode", [encoded, decoded, method, pageWidth](long long) {
+            g_sink += OledCodec::decode(method, encoded->data(), encoded->size(), decoded->data(), decoded->size(),
+                                        pageWidth);
+        }});
+    }
+
+    return cases;
+}
+
+QString jsonEscape(const QString& text)
+{
+    QString out;
+    for (int i = 0; i < text.size(); ++i) {
+        const QChar c = text.at(i);
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+// --codecs：各格式在典型畫面上的大小、壓縮比、估計的解碼週期 (AVR 模型) 與往返檢查
+int printCodecReport()
+{
+    const int pageWidth = OledDataModel().geometry().ramPageWidth;
+    bool allOk = true;
+    std::printf("%-10s %-12s %8s %8s %12s %6s\n", "screen", "codec", "bytes", "ratio", "est. cycles", "ok");
+    for (const auto& screen : codecScreens()) {
+        const std::vector<uint8_t>& data = screen.second;
+        const OledCodec::Method best = OledCodec::pickBest(data.data(), data.size(), pageWidth);
+        for (const OledCodec::Method method : OledCodec::methods()) {
+            const std::vector<uint8_t> encoded = OledCodec::encode(method, data.data(), data.size(), pageWidth);
+            std::vector<uint8_t> decoded(data.size());
+            OledCodec::DecodeStats stats;
+            const bool ok = OledCodec::decode(method, encoded.data(), encoded.size(), decoded.data(), decoded.size(),
+                                              pageWidth, &stats)
+                            && decoded == data;
+            allOk = allOk && ok;
+            std::printf("%-10s %-12s %8zu %7.1f%% %12lld %6s%s\n", qPrintable(screen.first),
+                        qPrintable(OledCodec::methodName(method)), encoded.size(),
+                        100.0 * double(encoded.size()) / double(data.size()), static_cast<long long>(stats.cycles()),
+                        ok ? "yes" : "NO", method == best ? "  <- auto" : "");
+        }
+    }
+    std::fflush(stdout);
+    return allOk ? 0 : 1;
+}
+
+void printUsage()
+{
+    std::printf("usage: bench_suite [--json | --csv] [--filter <substring>] [--min-time <ms>]\n"
+                "       bench_suite --codecs\n");
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    enum class Output { Table, Json, Csv } output = Output::Table;
+    QString filter;
+    qint64 minNs = 200LL * 1000 * 1000;
+
+    for (int i = 1; i < argc; ++i) {
+        const QString arg = QString::fromLocal8Bit(argv[i]);
+        if (arg == "--json") {
+            output = Output::Json;
+        } else if (arg == "--csv") {
+            output = Output::Csv;
+        } else if (arg == "--codecs") {
+            return printCodecReport();
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = QString::fromLocal8Bit(argv[++i]);
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            minNs = std::max(1, std::atoi(argv[++i])) * 1000LL * 1000;
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+
+    std::vector<BenchResult> results;
+    for (const BenchCase& bench : buildCases()) {
+        if (!filter.isEmpty() && !bench.name.contains(filter)) {
+            continue;
+        }
+        results.push_back(measure(bench, minNs));
+        if (output == Output::Table) {
+            const BenchResult& r = results.back();
+            std::printf("%-46s %12.1f ns/op %14.0f op/s %8.2f allocs/op %10.1f B/op\n",
+                        qPrintable(r.name), r.nsPerOp, r.nsPerOp > 0.0 ? 1e9 / r.nsPerOp : 0.0,
+                        r.allocsPerOp, r.bytesPerOp);
+        }
+    }
+
+    if (output == Output::Json) {
+        std::printf("{\n  \"suite\": \"oledcore\",\n  \"min_time_ms\": %lld,\n  \"results\": [\n",
+                    static_cast<long long>(minNs / 1000000));
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            std::printf("    {\"name\": \"%s\", \"iterations\": %lld, \"ns_per_op\": %.3f, "
+                        "\"ops_per_sec\": %.1f, \"allocs_per_op\": %.3f, \"bytes_per_op\": %.1f}%s\n",
+                        qPrintable(jsonEscape(r.name)), r.iterations, r.nsPerOp,
+                        r.nsPerOp > 0.0 ? 1e9 / r.nsPerOp : 0.0, r.allocsPerOp, r.bytesPerOp,
+                        i + 1 < results.size() ? "," : "");
+        }
+        std::printf("  ]\n}\n");
+    } else if (output == Output::Csv) {
+        std::printf("name,iterations,ns_per_op,ops_per_sec,allocs_per_op,bytes_per_op\n");
+        for (const BenchResult& r : results) {
+            std::printf("%s,%lld,%.3f,%.1f,%.3f,%.1f\n", qPrintable(r.name), r.iterations, r.nsPerOp,
+                        r.nsPerOp > 0.0 ? 1e9 / r.nsPerOp : 0.0, r.allocsPerOp, r.bytesPerOp);
+        }
+    }
+
+    std::fflush(stdout);
+    return g_sink == 0xFFFFFFFFFFFFFFFFull ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+#include "busestimatordialog.h"
+
+#include <QComboBox>
+#include <QFormLayout>
+#include <QSignalBlocker>
+#include <QSpinBox>
+#include <QtAlgorithms>
+
+namespace {
+
+QString formatCost(const OledBusEstimator::Cost &cost)
+{
+    QString text = QString("%1 bytes (指令 %2、資料 %3").arg(cost.busBytes()).arg(cost.commandBytes).arg(cost.dataBytes);
+    if (cost.overheadBytes > 0) {
+        text += QString("、位址/控制 %1，%2 次傳輸").arg(cost.overheadBytes).arg(cost.transactions);
+    }
+    return text + QString(")，%1 ms").arg(cost.seconds * 1000.0, 0, 'f', 3);
+}
+
+}
+
+BusEstimatorDialog::BusEstimatorDialog(QWidget *parent) : QDialog(parent) {
+    setupUi();
+}
+
+void BusEstimatorDialog::setupUi() {
+    setWindowTitle("傳輸分析 (I2C / SPI)");
+    resize(520, 460);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    // 匯流排設定
+    QFormLayout *form = new QFormLayout();
+    m_busComboBox = new QComboBox(this);
+    m_busComboBox->addItem("I2C", OledBusEstimator::Bus::I2c);
+    m_busComboBox->addItem("SPI", OledBusEstimator::Bus::Spi);
+    form->addRow("匯流排", m_busComboBox);
+
+    m_clockSpinBox = new QSpinBox(this);
+    m_clockSpinBox->setRange(10, 50000);
+    m_clockSpinBox->setSuffix(" kHz");
+    m_clockSpinBox->setValue(400);
+    form->addRow("時脈", m_clockSpinBox);
+
+    m_payloadSpinBox = new QSpinBox(this);
+    m_payloadSpinBox->setRange(0, 4096);
+    m_payloadSpinBox->setSpecialValueText("不限制");
+    m_payloadSpinBox->setValue(0);
+    m_payloadSpinBox->setToolTip("每次 I2C 傳輸在位址之後最多幾個 byte (含控制 byte)，Arduino Wire 為 32");
+    form->addRow("每次傳輸上限", m_payloadSpinBox);
+
+    m_fpsSpinBox = new QSpinBox(this);
+    m_fpsSpinBox->setRange(1, 240);
+    m_fpsSpinBox->setSuffix(" fps");
+    m_fpsSpinBox->setValue(30);
+    form->addRow("目標更新率", m_fpsSpinBox);
+    layout->addLayout(form);
+
+    // 結果
+    m_resultLabel = new QLabel(this);
+    m_resultLabel->setWordWrap(true);
+    layout->addWidget(m_resultLabel);
+
+    m_windowText = new QTextEdit(this);
+    m_windowText->setReadOnly(true);
+    QFont font("Courier");
+    font.setStyleHint(QFont::TypeWriter);
+    m_windowText->setFont(font);
+    layout->addWidget(m_windowText, 1);
+
+    QPushButton *baselineButton = new QPushButton("以目前畫面為基準 (已送到裝置)", this);
+    layout->addWidget(baselineButton);
+
+    connect(m_busComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &BusEstimatorDialog::onBusKindChanged);
+    connect(m_clockSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &BusEstimatorDialog::recalculate);
+    connect(m_payloadSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &BusEstimatorDialog::recalculate);
+    connect(m_fpsSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &BusEstimatorDialog::recalculate);
+    connect(baselineButton, &QPushButton::clicked, this, &BusEstimatorDialog::onUseCurrentAsBaseline);
+}
+
+OledBusEstimator::Bus BusEstimatorDialog::bus() const {
+    const int clockHz = m_clockSpinBox->value() * 1000;
+    if (m_busComboBox->currentData().toInt() == OledBusEstimator::Bus::Spi) {
+        return OledBusEstimator::Bus::spi(clockHz);
+    }
+    return OledBusEstimator::Bus::i2c(clockHz, m_payloadSpinBox->value());
+}
+
+void BusEstimatorDialog::setCurrent(const OledPanelGeometry &geometry, const std::vector<uint8_t> &buffer) {
+    if (geometry != m_geometry) {
+        m_geometry = geometry;
+        m_baseline.clear();
+    }
+    m_current = buffer;
+    recalculate();
+}
+
+void BusEstimatorDialog::setBaseline(const std::vector<uint8_t> &buffer) {
+    m_baseline = buffer;
+    recalculate();
+}
+
+void BusEstimatorDialog::onBusKindChanged() {
+    // 換匯流排時改成該匯流排常見的時脈 (I2C 400 kHz、SPI 8 MHz)
+    const bool spi = m_busComboBox->currentData().toInt() == OledBusEstimator::Bus::Spi;
+    m_payloadSpinBox->setEnabled(!spi);
+    const QSignalBlocker blocker(m_clockSpinBox);
+    m_clockSpinBox->setValue(spi ? 8000 : 400);
+    recalculate();
+}
+
+void BusEstimatorDialog::onUseCurrentAsBaseline() {
+    setBaseline(m_current);
+}
+
+void BusEstimatorDialog::recalculate() {
+    if (!m_geometry.isValid() || m_current.size() != static_cast<size_t>(m_geometry.bufferSize())) {
+        m_resultLabel->clear();
+        m_windowText->clear();
+        return;
+    }
+
+    const bool known = m_baseline.size() == m_current.size();
+    const OledBusEstimator::Plan plan =
+        OledBusEstimator::plan(m_geometry, known ? m_baseline.data() : nullptr, m_current.data(), bus());
+
+    // 時間預算：目標更新率下每個畫面可用的傳輸時間
+    const double budget = 1.0 / m_fpsSpinBox->value();
+    const OledBusEstimator::Cost &best = plan.best();
+    QString result;
+    if (!known) {
+        result += "基準未知 (尚未設定或面板已切換)，視為整個畫面都要送。\n";
+    }
+    result += QString("改變 %1 bytes，%2 頁，%3 段\n").arg(plan.changedBytes)
+                  .arg(qPopulationCount(plan.dirtyPages)).arg(plan.windows.size());
+    result += "局部更新：" + formatCost(plan.partial) + "\n";
+    result += "全畫面更新：" + formatCost(plan.full) + "\n";
+    result += QString("建議：%1，%2 ms / 預算 %3 ms (%4 fps) — %5")
+                  .arg(plan.preferFull() ? "全畫面更新" : "局部更新")
+                  .arg(best.seconds * 1000.0, 0, 'f', 3)
+                  .arg(budget * 1000.0, 0, 'f', 1)
+                  .arg(m_fpsSpinBox->value())
+                  .arg(best.seconds <= budget ? "符合" : "超出預算");
+    m_resultLabel->setText(result);
+
+    // 要送的範圍 (RAM 欄位，含 columnOffset)
+    QString windows;
+    for (const OledBusEstimator::Window &window : plan.windows) {
+        windows += QString("page %1  col %2..%3  (%4 bytes)\n")
+                       .arg(window.page)
+                       .arg(window.firstColumn, 3)
+                       .arg(window.lastColumn, 3)
+                       .arg(window.width());
+    }
+    m_windowText->setPlainText(windows.isEmpty() ? QStringLiteral("畫面沒有改變") : windows);
+}
@@ -0,0 +1,56 @@
+#ifndef BUSESTIMATORDIALOG_H
+#define BUSESTIMATORDIALOG_H
+
+#include "config.h"
+#include "oled_busestimator.h"
+#include <vector>
+#include <cstdint> // for uint8_t
+
+
+// 前置宣告，加快編譯速度
+class QComboBox;
+class QSpinBox;
+class QTextEdit;
+class QLabel;
+
+/**
+ * @brief 傳輸分析面板：比較「裝置上目前的畫面」(基準) 與畫布，估計局部 / 全畫面更新的 byte 數與時間。
+ *
+ * 非強制回應的視窗，MainWindow 在畫布改變時呼叫 setCurrent()；計算都在 OledBusEstimator。
+ */
+class BusEstimatorDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit BusEstimatorDialog(QWidget *parent = nullptr);
+
+    // 畫布的內容 (硬體格式，bufferSize() bytes)；面板幾何改變時基準會變成未知 (整個畫面都要送)
+    void setCurrent(const OledPanelGeometry &geometry, const std::vector<uint8_t> &buffer);
+
+    // 裝置上目前的畫面；空的表示未知
+    void setBaseline(const std::vector<uint8_t> &buffer);
+
+    OledBusEstimator::Bus bus() const;
+
+private slots:
+    void onBusKindChanged();
+    void onUseCurrentAsBaseline();
+    void recalculate();
+
+private:
+    QComboBox *m_busComboBox;
+    QSpinBox *m_clockSpinBox;       // kHz
+    QSpinBox *m_payloadSpinBox;     // I2C 每次傳輸的 byte 上限
+    QSpinBox *m_fpsSpinBox;         // 目標畫面更新率，用來算時間預算
+    QLabel *m_resultLabel;
+    QTextEdit *m_windowText;
+
+    OledPanelGeometry m_geometry;
+    std::vector<uint8_t> m_baseline;
+    std::vector<uint8_t> m_current;
+
+    // 初始化 UI 的 helper
+    void setupUi();
+};
+
+#endif // BUSESTIMATORDIALOG_H
@@ -0,0 +1,829 @@
+/* ******************Copyright (C) 2025 Ethan Yang *****************************
+ * @file    oledcli.cpp
+ * @brief   oledcore 的命令列工具：不開 GUI，批次轉換圖檔 / C 陣列並執行繪圖腳本。
+ *
+ * @details 只依賴 QtCore / QtGui (oledcore)，適合放在韌體的 CI 裡重新產生大量素材。
+ *
+ *          oledcli convert [選項] <輸入檔>...
+ *              輸入可以是圖片 (png/bmp/jpg...) 或 C 陣列 (.h/.c/.txt)。
+ *          oledcli render  [選項] <腳本檔>...
+ *              執行繪圖腳本 (格式見 oled_drawscript.h)，輸出整個畫面 (預設 SH1106 128x64)。
+ *          oledcli list    <C 陣列檔>...
+ *              列出檔案中的每個陣列 (名稱、尺寸、定址方式、byte 數、位置)。
+ *          oledcli replay  [選項] <匯流排紀錄>...
+ *              以 SH1106 指令串流模擬器執行 I2C / SPI 紀錄 (格式見 oled_emulator.h)，
+ *              逐畫面列出匯流排 byte 數與沒有改變內容的資料 byte；有 -o 時輸出最後 (或 --frame 指定) 的畫面。
+ *          oledcli patch   [選項] <畫面>...
+ *              依序比較每個畫面 (圖片或 C 陣列，面板大小)，只輸出改變的 (頁, 欄位, bytes) 與 C 的套用函式
+ *              (格式見 oled_patch.h)；第一個畫面完整輸出。逐畫面列出 patch 數與匯流排 byte 數，有 -o 時寫出 .h。
+ *          oledcli anim    [選項] <畫面>...
+ *              以每種動畫格式 (格式見 oled_animation.h) 編碼這串畫面，列出 flash 大小與每個畫面送到面板的
+ *              byte 數 (第一個、最差的一個與合計)；有 -o 時以 --mode 的格式寫出 .h (含 C 解碼函式)。
+ *          oledcli font    [選項] <腳本或文字檔>...
+ *              收集繪圖腳本的 text 指令與文字檔 (.txt，例如各語言的標籤) 用到的字元，只匯出這些字元的
+ *              字型 (格式見 oled_fontexport.h)，列出大小與完整 ASCII 表的差別；有 -o 時寫出 .h (含查找函式)。
+ *
+ *          共用選項：
+ *              -o, --output <路徑>   只有一個輸入時為輸出檔，多個輸入時為輸出資料夾
+ *              -f, --format <h|bin|png>  輸出格式，預設依副檔名判斷，否則為 h
+ *              -n, --name <名稱>     C 陣列名稱，預設使用輸入檔名
+ *              --invert              反白
+ *              --panel <id>          面板設定檔 (sh1106、ssd1306、ssd1309、sh1107、mono256x64)
+ *              --progmem             h 輸出的陣列加上 PROGMEM (AVR / ESP 放在 flash)
+ *              --size-macros         h 輸出加上 名稱_WIDTH / 名稱_HEIGHT 巨集
+ *              --codec <格式>        h / bin 輸出的壓縮格式 (raw、rle、packbits、page-delta、lz、auto)，預設 raw；
+ *                                    h 輸出會一併附上 C 解碼函式，auto 依每個素材選最小的格式
+ *          render 專用：
+ *              --layer <名稱>        只輸出單一圖層 (不經過合成)，可以把靜態與動態內容分開匯出
+ *          convert 專用：
+ *              --horizontal          C 陣列輸入為水平定址 (預設依註解判斷，沒有說明時為 SH1106 垂直頁面)
+ *              --size <WxH>          C 陣列輸入的尺寸 (沒有註解或巨集可以判斷時使用)
+ *              --array <名稱>        C 陣列輸入有多個陣列時要轉換的陣列 (預設為第一個有資料的陣列)
+ *              --dither <方法>       圖片輸入的混色方式 (threshold、floyd-steinberg、atkinson、sierra-lite、
+ *                                    bayer2、bayer4、bayer8、blue-noise)，預設 threshold
+ *              --gamma <值>          混色前的 gamma (預設 1.0)
+ *              --contrast <值>       混色前的對比 (預設 1.0)
+ *          replay 專用：
+ *              --frame <n>           要輸出的畫面 (從 0 開始，預設為最後一個)
+ *              --rotate180           模組上下顛倒安裝 (A1 + C8 為正向)
+ *          patch 專用：
+ *              --loop                加上最後一個畫面回到第一個畫面的切換 (循環動畫)
+ *              --bus <i2c|spi>       合併改變範圍時依這個匯流排的成本 (預設 i2c)
+ *              --payload <n>         I2C 每次傳輸的 byte 上限 (含控制 byte，Arduino Wire 為 32；預設不限制)
+ *          anim 專用 (--bus、--payload 同 patch)：
+ *              --mode <格式>         independent、keyframe-xor、page-skip、patches 或 auto (預設)；
+ *                                    auto 在 flash 放得下的格式中選之後的畫面送到面板最快的一個
+ *              --keyframe <n>        keyframe-xor 每幾個畫面一個關鍵畫面 (預設 16，0 表示只有第一個)
+ *              --flash-budget <n>    auto 可以使用的 flash byte 數 (預設不限制)
+ *          font 專用：
+ *              --font <字型檔>       BDF 或 C 陣列字型 (預設為內建 5x7；腳本的 text 指令也是用內建字型)
+ *
+ * @note    本專案使用 GPLv3 授權，詳情請見 LICENSE 檔案。
+ * *****************Copyright (C) 2025*****************************************
+ */
+
+#include "../oled_animation.h"
+#include "../oled_assetcatalog.h"
+#include "../oled_assetio.h"
+#include "../oled_carray.h"
+#include "../oled_codec.h"
+#include "../oled_datamodel.h"
+#include "../oled_drawscript.h"
+#include "../oled_emulator.h"
+#include "../oled_font.h"
+#include "../oled_fontexport.h"
+#include "../oled_patch.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+struct Options {
+    QString output;
+    QString format;
+    QString name;
+    bool invert = false;
+    bool horizontal = false;
+    QSize size;
+    const OledPanelProfile* panel = nullptr; // nullptr 表示沒有指定 --panel
+    QString layer;                           // render：空字串表示輸出合成後的畫面
+    QString array;                           // convert：C 陣列輸入要轉換的陣列，空字串表示第一個
+    OledDither::Options dither;              // convert：圖片輸入的混色設定
+    OledCArrayWriter::Options writer;        // h 輸出的格式
+    OledCodec::Method codec = OledCodec::Raw;
+    bool codecAuto = false;                  // --codec auto：每個素材選壓縮後最小的格式
+    int frame = -1;                          // replay：要輸出的畫面，-1 表示最後一個
+    bool rotated = false;                    // replay：模組上下顛倒安裝
+    bool loop = false;                       // patch：加上最後一個畫面回到第一個畫面的切換
+    OledBusEstimator::Bus bus;               // patch：合併改變範圍時的匯流排成本
+    OledAnimationEncoder::Options animation; // anim：關鍵影格間隔與匯流排 (同 bus)
+    OledAnimationEncoder::Mode animationMode = OledAnimationEncoder::Independent;
+    bool animationAuto = true;               // anim：依 flashBudget 選格式
+    qint64 flashBudget = 0;                  // anim：0 表示不限制
+    QString font;                            // font：字型檔，空字串表示內建 5x7
+};
+
+void printError(const QString& message)
+{
+    std::fprintf(stderr, "oledcli: %s\n", qPrintable(message));
+}
+
+bool readTextFile(const QString& path, QString* content)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        printError(QString("無法開啟檔案: %1").arg(path));
+        return false;
+    }
+    QTextStream in(&file);
+    *content = in.readAll();
+    return true;
+}
+
+bool isSourceFile(const QString& path)
+{
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    return suffix == "h" || suffix == "c" || suffix == "cpp" || suffix == "txt";
+}
+
+// 把檔名轉成合法的 C 識別字
+QString arrayNameFor(const QString& path)
+{
+    QString name = QFileInfo(path).completeBaseName();
+    for (int i = 0; i < name.size(); ++i) {
+        const QChar c = name.at(i);
+        if (!(c.isLetterOrNumber() && c.unicode() < 128) && c != '_') {
+            name[i] = '_';
+        }
+    }
+    if (name.isEmpty() || name.at(0).isDigit()) {
+        name.prepend('_');
+    }
+    return name;
+}
+
+QString outputPathFor(const QString& input, const Options& options, int inputCount, QString* format)
+{
+    QString path = options.output;
+    *format = options.format.toLower();
+
+    if (inputCount > 1 || path.isEmpty() || QFileInfo(path).isDir()) {
+        // 多個輸入：輸出到資料夾 (預設為目前目錄)，檔名沿用輸入檔名
+        if (format->isEmpty()) *format = "h";
+        const QDir dir(path.isEmpty() ? QStringLiteral(".") : path);
+        return dir.filePath(QFileInfo(input).completeBaseName() + "." + *format);
+    }
+
+    if (format->isEmpty()) {
+        const QString suffix = QFileInfo(path).suffix().toLower();
+        *format = (suffix == "bin" || suffix == "png" || suffix == "bmp") ? suffix : QStringLiteral("h");
+    }
+    return path;
+}
+
+/**
+ * 把「索引 1 = 點亮」的單色圖依格式寫出。
+ * h / bin 輸出 SH1106 垂直頁面格式 (不含 COLUMN_OFFSET)，與 GUI 的 .h 輸出相同；有指定 --codec 時輸出壓縮後的資料。
+ */
+bool writeBitmap(const QImage& mask, const QString& path, const QString& format, const QString& name,
+                 const Options& options)
+{
+    if (format == "png" || format == "bmp") {
+        if (!mask.save(path, format.toUpper().toLatin1().constData())) {
+            printError(QString("無法寫入檔案: %1").arg(path));
+            return false;
+        }
+        return true;
+    }
+
+    const QVector<uint8_t> pages = OledDataModel::convertLogicalToHardwareFormat(mask);
+    const std::vector<uint8_t> data(pages.cbegin(), pages.cend());
+    const int pageWidth = mask.width();
+    const OledCodec::Method codec = options.codecAuto
+                                        ? OledCodec::pickBest(data.data(), data.size(), pageWidth)
+                                        : options.codec;
+
+    QFile file(path);
+    if (format == "bin") {
+        if (!file.open(QIODevice::WriteOnly)) {
+            printError(QString("無法寫入檔案: %1").arg(path));
+            return false;
+        }
+        const std::vector<uint8_t> encoded = OledCodec::encode(codec, data.data(), data.size(), pageWidth);
+        file.write(reinterpret_cast<const char*>(encoded.data()), static_cast<qint64>(encoded.size()));
+        return true;
+    }
+
+    if (format != "h") {
+        printError(QString("不支援的輸出格式: %1").arg(format));
+        return false;
+    }
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        printError(QString("無法寫入檔案: %1").arg(path));
+        return false;
+    }
+    // 直接串流寫入檔案，不先組成整個字串
+    OledCArrayWriter writer(&file, options.writer);
+    writer.writeComment(QString("Image Data (%1x%2, SH1106 vertical page)")
+                            .arg(mask.width()).arg(mask.height()).toUtf8());
+    OledCodec::writeArray(&writer, codec, name.toUtf8(), data, pageWidth, mask.size());
+    if (!writer.flush()) {
+        printError(QString("無法寫入檔案: %1").arg(path));
+        return false;
+    }
+    return true;
+}
+
+QImage loadInput(const QString& path, const Options& options)
+{
+    if (!isSourceFile(path)) {
+        const QImage image(path);
+        if (image.isNull()) {
+            printError(QString("無法讀取圖片: %1").arg(path));
+            return QImage();
+        }
+        return OledAssetIO::toLitMask(image, options.invert, options.dither);
+    }
+
+    // 先建立素材索引，只讀出需要的那一個陣列
+    const std::shared_ptr<const OledAssetCatalog> catalog = OledAssetCatalog::open(path);
+    if (!catalog) {
+        printError(QString("無法開啟檔案: %1").arg(path));
+        return QImage();
+    }
+    if (catalog->count() == 0) {
+        printError(QString("未找到 Hex 數據: %1").arg(path));
+        return QImage();
+    }
+    const int index = options.array.isEmpty() ? 0 : catalog->find(options.array);
+    if (index < 0) {
+        printError(QString("%1: 沒有名為 \"%2\" 的陣列").arg(path, options.array));
+        return QImage();
+    }
+    const OledAssetCatalog::Entry& entry = catalog->entries()[static_cast<size_t>(index)];
+    const std::vector<uint8_t> data = catalog->load(index);
+    if (data.empty()) {
+        printError(QString("讀取時檔案已被修改: %1").arg(path));
+        return QImage();
+    }
+
+    QSize size = options.size.isValid() ? options.size : entry.size;
+    bool horizontal = options.horizontal || entry.addressing == OledAssetCatalog::Entry::Horizontal;
+    if (!size.isValid()) {
+        // 沒有尺寸資訊時只接受整個畫面大小的資料 (含或不含填充欄位)，有 --panel 時只比對該面板
+        bool includesPadding = false;
+        const int bytes = static_cast<int>(data.size());
+        const OledPanelProfile* panel = options.panel;
+        if (panel && panel->geometry.bufferSize() == bytes) {
+            includesPadding = true;
+        } else if (panel && panel->geometry.visibleBufferSize() == bytes) {
+            includesPadding = false;
+        } else if (!panel) {
+            panel = OledPanel::matchBufferSize(bytes, &includesPadding);
+        } else {
+            panel = nullptr;
+        }
+        if (!panel) {
+            printError(QString("無法判斷尺寸，請使用 --size: %1").arg(path));
+            return QImage();
+        }
+        size = QSize(includesPadding ? panel->geometry.ramPageWidth : panel->geometry.width,
+                     panel->geometry.height);
+    }
+
+    QImage mask = OledAssetIO::decodeBitmap(data, size, horizontal);
+    if (options.invert) {
+        mask.invertPixels(QImage::InvertRgb);
+    }
+    return mask;
+}
+
+int runConvert(const QStringList& inputs, const Options& options)
+{
+    int failures = 0;
+    for (const QString& input : inputs) {
+        const QImage mask = loadInput(input, options);
+        QString format;
+        const QString output = outputPathFor(input, options, inputs.size(), &format);
+        const QString name = options.name.isEmpty() || inputs.size() > 1 ? arrayNameFor(input) : options.name;
+        if (mask.isNull() || !writeBitmap(mask, output, format, name, options)) {
+            ++failures;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+int runList(const QStringList& inputs)
+{
+    int failures = 0;
+    for (const QString& input : inputs) {
+        const std::shared_ptr<const OledAssetCatalog> catalog = OledAssetCatalog::open(input);
+        if (!catalog) {
+            printError(QString("無法開啟檔案: %1").arg(input));
+            ++failures;
+            continue;
+        }
+        std::printf("%s: %d 個陣列\n", qPrintable(input), catalog->count());
+        for (const OledAssetCatalog::Entry& entry : catalog->entries()) {
+            const QString size = entry.size.isValid()
+                                     ? QString("%1x%2").arg(entry.size.width()).arg(entry.size.height())
+                                     : QStringLiteral("?");
+            const char* addressing = entry.addressing == OledAssetCatalog::Entry::Horizontal      ? "horizontal"
+                                     : entry.addressing == OledAssetCatalog::Entry::VerticalPages ? "vertical"
+                                                                                                  : "-";
+            std::printf("  %-32s %9s %-10s %7d bytes  @%llu\n", qPrintable(entry.name), qPrintable(size),
+                        addressing, entry.byteCount, static_cast<unsigned long long>(entry.offset));
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+int runRender(const QStringList& scripts, const Options& options)
+{
+    int failures = 0;
+    for (const QString& scriptPath : scripts) {
+        QString script;
+        if (!readTextFile(scriptPath, &script)) {
+            ++failures;
+            continue;
+        }
+
+        OledDataModel model(options.panel ? options.panel->geometry : OledPanel::defaultProfile().geometry);
+        QString error;
+        if (!OledDrawScript::run(&model, script, &error)) {
+            printError(QString("%1: %2").arg(scriptPath, error));
+            ++failures;
+            continue;
+        }
+
+        const QRect frame(0, 0, model.width(), model.height());
+        QImage mask;
+        if (options.layer.isEmpty()) {
+            mask = model.copyRegionToLogicalFormat(frame);
+        } else {
+            const int index = model.findLayer(options.layer);
+            if (index < 0) {
+                printError(QString("%1: 沒有名為 \"%2\" 的圖層").arg(scriptPath, options.layer));
+                ++failures;
+                continue;
+            }
+            // 只取出這一層的內容 (不經過合成)
+            OledDataModel single(model.geometry());
+            single.setFromHardwareBuffer(model.layerBuffer(index));
+            mask = single.copyRegionToLogicalFormat(frame);
+        }
+        mask.setColor(0, qRgb(0, 0, 0));
+        mask.setColor(1, qRgb(255, 255, 255));
+        if (options.invert) {
+            mask.invertPixels(QImage::InvertRgb);
+        }
+
+        QString format;
+        const QString output = outputPathFor(scriptPath, options, scripts.size(), &format);
+        const QString name = options.name.isEmpty() || scripts.size() > 1 ? arrayNameFor(scriptPath) : options.name;
+        if (!writeBitmap(mask, output, format, name, options)) {
+            ++failures;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+
+int runReplay(const QStringList& traces, const Options& options)
+{
+    const OledPanelGeometry geometry = options.panel ? options.panel->geometry : OledPanel::defaultProfile().geometry;
+    int failures = 0;
+    for (const QString& tracePath : traces) {
+        QString text;
+        if (!readTextFile(tracePath, &text)) {
+            ++failures;
+            continue;
+        }
+        std::vector<OledEmulator::Transfer> transfers;
+        QString error;
+        if (!OledEmulator::parseTrace(text, &transfers, &error)) {
+            printError(QString("%1: %2").arg(tracePath, error));
+            ++failures;
+            continue;
+        }
+
+        OledEmulator emulator(geometry);
+        emulator.run(transfers);
+        const std::vector<OledEmulator::Frame>& frames = emulator.frames();
+
+        // 每個畫面的匯流排 byte 數；redundant = 寫入的值和 RAM 原本相同 (可以省掉的重繪)
+        std::printf("%s: %zu 個畫面\n", qPrintable(tracePath), frames.size());
+        std::printf("  %5s %8s %8s %8s %8s %9s %7s  %s\n", "frame", "bus", "command", "data", "changed", "redundant",
+                    "hidden", "pages");
+        OledEmulator::FrameStats total;
+        for (size_t i = 0; i < frames.size(); ++i) {
+            const OledEmulator::FrameStats& stats = frames[i].stats;
+            QString pages;
+            for (int page = 0; page < geometry.pageCount(); ++page) {
+                pages += (stats.pagesWritten >> page) & 1 ? QString::number(page, 16) : QStringLiteral(".");
+            }
+            std::printf("  %5zu %8lld %8lld %8lld %8lld %9lld %7lld  %s\n", i, static_cast<long long>(stats.busBytes),
+                        static_cast<long long>(stats.commandBytes), static_cast<long long>(stats.dataBytes),
+                        static_cast<long long>(stats.changedBytes), static_cast<long long>(stats.redundantBytes),
+                        static_cast<long long>(stats.hiddenBytes), qPrintable(pages));
+            total.busBytes += stats.busBytes;
+            total.dataBytes += stats.dataBytes;
+            total.redundantBytes += stats.redundantBytes;
+            total.unsupportedCommands += stats.unsupportedCommands;
+        }
+        std::printf("  total: %lld bus bytes, %lld of %lld data bytes redundant (%.1f%%)\n",
+                    static_cast<long long>(total.busBytes), static_cast<long long>(total.redundantBytes),
+                    static_cast<long long>(total.dataBytes),
+                    total.dataBytes > 0 ? 100.0 * double(total.redundantBytes) / double(total.dataBytes) : 0.0);
+        if (total.unsupportedCommands > 0) {
+            std::printf("  %d 個 SH1106 不支援的指令已略過\n", total.unsupportedCommands);
+        }
+
+        if (options.output.isEmpty()) {
+            continue;
+        }
+        const int index = options.frame < 0 ? static_cast<int>(frames.size()) - 1 : options.frame;
+        if (index < 0 || index >= static_cast<int>(frames.size())) {
+            printError(QString("%1: 沒有第 %2 個畫面").arg(tracePath).arg(index));
+            ++failures;
+            continue;
+        }
+        const OledEmulator::Frame& frame = frames[static_cast<size_t>(index)];
+        const std::vector<uint8_t> display = OledEmulator::render(geometry, frame.ram, frame.state, options.rotated);
+
+        OledDataModel model(geometry);
+        model.setFromHardwareBuffer(display.data());
+        QImage mask = model.copyRegionToLogicalFormat(QRect(0, 0, model.width(), model.height()));
+        mask.setColor(0, qRgb(0, 0, 0));
+        mask.setColor(1, qRgb(255, 255, 255));
+        if (options.invert) {
+            mask.invertPixels(QImage::InvertRgb);
+        }
+
+        QString format;
+        const QString output = outputPathFor(tracePath, options, traces.size(), &format);
+        const QString name = options.name.isEmpty() || traces.size() > 1 ? arrayNameFor(tracePath) : options.name;
+        if (!writeBitmap(mask, output, format, name, options)) {
+            ++failures;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+// 每個畫面放進面板的 RAM 格式 (含 columnOffset)，patch 的欄位可以直接送到控制器
+bool loadFrames(const QStringList& inputs, const OledPanelGeometry& geometry, const Options& options,
+                std::vector<std::vector<uint8_t>>* frames)
+{
+    for (const QString& input : inputs) {
+        const QImage mask = loadInput(input, options);
+        if (mask.isNull()) {
+            return false;
+        }
+        if (mask.width() != geometry.width || mask.height() != geometry.height) {
+            printError(QString("%1: 畫面大小 %2x%3 與面板 %4x%5 不同").arg(input).arg(mask.width()).arg(mask.height())
+                           .arg(geometry.width).arg(geometry.height));
+            return false;
+        }
+        const QVector<uint8_t> pages = OledDataModel::convertLogicalToHardwareFormat(mask);
+        std::vector<uint8_t> frame(static_cast<size_t>(geometry.bufferSize()), 0);
+        for (int page = 0; page < geometry.pageCount(); ++page) {
+            std::copy(pages.cbegin() + page * geometry.width, pages.cbegin() + (page + 1) * geometry.width,
+                      frame.begin() + page * geometry.ramPageWidth + geometry.columnOffset);
+        }
+        frames->push_back(std::move(frame));
+    }
+    return true;
+}
+
+int runPatch(const QStringList& inputs, const Options& options)
+{
+    const OledPanelGeometry geometry = options.panel ? options.panel->geometry : OledPanel::defaultProfile().geometry;
+    if (!OledPatchEncoder::supports(geometry)) {
+        printError("這個面板的欄位超過 256，無法輸出差異更新");
+        return 1;
+    }
+
+    std::vector<std::vector<uint8_t>> frames;
+    if (!loadFrames(inputs, geometry, options, &frames)) {
+        return 1;
+    }
+
+    const std::vector<OledPatchEncoder::Transition> transitions =
+        OledPatchEncoder::encodeSequence(geometry, frames, options.bus, options.loop);
+
+    std::printf("%zu 個畫面，%zu 次切換\n", frames.size(), transitions.size());
+    std::printf("  %5s %7s %8s %8s %8s\n", "step", "patches", "data", "bus", "full");
+    qint64 busTotal = 0;
+    qint64 fullTotal = 0;
+    for (size_t i = 0; i < transitions.size(); ++i) {
+        const OledPatchEncoder::Transition& transition = transitions[i];
+        std::printf("  %5zu %7zu %8lld %8lld %8lld\n", i, transition.patches.size(),
+                    static_cast<long long>(transition.cost.dataBytes), static_cast<long long>(transition.cost.busBytes()),
+                    static_cast<long long>(transition.fullCost.busBytes()));
+        busTotal += transition.cost.busBytes();
+        fullTotal += transition.fullCost.busBytes();
+    }
+    std::printf("  total: %lld bus bytes (full redraw: %lld)\n", static_cast<long long>(busTotal),
+                static_cast<long long>(fullTotal));
+
+    if (options.output.isEmpty()) {
+        return 0;
+    }
+    QFile file(options.output);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        printError(QString("無法寫入檔案: %1").arg(options.output));
+        return 1;
+    }
+    const QString name = options.name.isEmpty() ? arrayNameFor(options.output) : options.name;
+    OledCArrayWriter writer(&file, options.writer);
+    OledPatchEncoder::writeArrays(&writer, name.toUtf8(), transitions, geometry);
+    if (!writer.flush()) {
+        printError(QString("無法寫入檔案: %1").arg(options.output));
+        return 1;
+    }
+    return 0;
+}
+int runAnim(const QStringList& inputs, const Options& options)
+{
+    const OledPanelGeometry geometry = options.panel ? options.panel->geometry : OledPanel::defaultProfile().geometry;
+    std::vector<std::vector<uint8_t>> frames;
+    if (!loadFrames(inputs, geometry, options, &frames)) {
+        return 1;
+    }
+
+    // 每種格式都列出來，方便和 MCU 的 flash 比較
+    const std::vector<OledAnimationEncoder::Report> reports =
+        OledAnimationEncoder::compare(geometry, frames, options.animation);
+    const OledAnimationEncoder::Mode mode =
+        options.animationAuto ? OledAnimationEncoder::recommend(reports, options.flashBudget) : options.animationMode;
+    std::printf("%zu 個畫面\n", frames.size());
+    std::printf("  %-13s %8s %8s %8s %9s %9s %10s\n", "mode", "flash", "data", "table", "first bus", "worst bus",
+                "total bus");
+    for (const OledAnimationEncoder::Report& report : reports) {
+        const bool fits = options.flashBudget <= 0 || report.flashBytes() <= options.flashBudget;
+        std::printf("%c %-13s %8lld %8lld %8lld %9lld %9lld %10lld%s\n", report.mode == mode ? '*' : ' ',
+                    qPrintable(OledAnimationEncoder::modeName(report.mode)),
+                    static_cast<long long>(report.flashBytes()), static_cast<long long>(report.dataBytes),
+                    static_cast<long long>(report.tableBytes), static_cast<long long>(report.first.busBytes()),
+                    static_cast<long long>(report.worst.busBytes()), static_cast<long long>(report.totalBusBytes),
+                    fits ? "" : "  (超過 flash 上限)");
+    }
+
+    if (options.output.isEmpty()) {
+        return 0;
+    }
+    OledAnimationEncoder::Result result;
+    if (!OledAnimationEncoder::encode(mode, geometry, frames, options.animation, &result)) {
+        printError(QString("這個面板無法使用 %1 格式").arg(OledAnimationEncoder::modeName(mode)));
+        return 1;
+    }
+    QFile file(options.output);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        printError(QString("無法寫入檔案: %1").arg(options.output));
+        return 1;
+    }
+    const QString name = options.name.isEmpty() ? arrayNameFor(options.output) : options.name;
+    OledCArrayWriter writer(&file, options.writer);
+    OledAnimationEncoder::writeArrays(&writer, name.toUtf8(), result, geometry, options.animation);
+    if (!writer.flush()) {
+        printError(QString("無法寫入檔案: %1").arg(options.output));
+        return 1;
+    }
+    return 0;
+}
+
+int runFont(const QStringList& inputs, const Options& options)
+{
+    OledFont loaded;
+    if (!options.font.isEmpty()) {
+        QString error;
+        if (!OledFont::load(options.font, &loaded, &error)) {
+            printError(QString("%1: %2").arg(options.font, error));
+            return 1;
+        }
+    }
+    const OledFont& font = options.font.isEmpty() ? OledFont::builtin() : loaded;
+
+    // .txt 的每一行都是一段文字 (標籤)，其他檔案視為繪圖腳本，只取 text 指令
+    QStringList texts;
+    for (const QString& input : inputs) {
+        QString content;
+        if (!readTextFile(input, &content)) {
+            return 1;
+        }
+        if (QFileInfo(input).suffix().toLower() == "txt") {
+            texts << content;
+        } else {
+            texts << OledDrawScript::texts(content);
+        }
+    }
+    const QString characters = OledFontExporter::usedCharacters(texts);
+    OledFontExporter::Result result;
+    if (characters.isEmpty() || !OledFontExporter::pack(font, characters, &result)) {
+        printError("輸入中沒有字型裡的任何字元");
+        return 1;
+    }
+
+    const OledFontExporter::Report& report = result.report;
+    std::printf("%s：%d 個字元，字高 %d (%d 頁)\n", qPrintable(font.name()), report.glyphs, result.height,
+                result.pages);
+    std::printf("  flash %lld bytes (點陣 %lld + 表 %lld)\n", static_cast<long long>(report.flashBytes()),
+                static_cast<long long>(report.bitmapBytes), static_cast<long long>(report.tableBytes));
+    std::printf("  完整 ASCII %lld bytes (省下 %lld)，整個字型 %lld bytes (省下 %lld)\n",
+                static_cast<long long>(report.asciiBytes),
+                static_cast<long long>(report.asciiBytes - report.flashBytes()),
+                static_cast<long long>(report.fullBytes),
+                static_cast<long long>(report.fullBytes - report.flashBytes()));
+    if (!report.missing.isEmpty()) {
+        std::printf("  字型中沒有 (以 '?' 代替)：%s\n", qPrintable(report.missing));
+    }
+
+    if (options.output.isEmpty()) {
+        return 0;
+    }
+    QFile file(options.output);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        printError(QString("無法寫入檔案: %1").arg(options.output));
+        return 1;
+    }
+    const QString name = options.name.isEmpty() ? arrayNameFor(options.output) : options.name;
+    OledCArrayWriter writer(&file, options.writer);
+    OledFontExporter::writeArrays(&writer, name.toUtf8(), result);
+    if (!writer.flush()) {
+        printError(QString("無法寫入檔案: %1").arg(options.output));
+        return 1;
+    }
+    return 0;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("oledcli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("SH1106 素材批次轉換工具 (不需要 GUI)");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "convert、render、list、replay、patch 或 anim");
+    parser.addPositionalArgument("inputs", "輸入檔案", "<輸入檔>...");
+
+    const QCommandLineOption outputOption({"o", "output"}, "輸出檔 (單一輸入) 或輸出資料夾 (多個輸入)", "path");
+    const QCommandLineOption formatOption({"f", "format"}, "輸出格式: h, bin, png", "format");
+    const QCommandLineOption nameOption({"n", "name"}, "C 陣列名稱", "name");
+    const QCommandLineOption invertOption("invert", "反白");
+    const QCommandLineOption horizontalOption("horizontal", "C 陣列輸入為水平定址 (MSB first)");
+    const QCommandLineOption sizeOption("size", "C 陣列輸入的尺寸，例如 16x16", "WxH");
+    const QCommandLineOption panelOption("panel", "面板設定檔，例如 sh1106、ssd1306、sh1107", "id");
+    const QCommandLineOption layerOption("layer", "render 只輸出指定的圖層", "name");
+    const QCommandLineOption arrayOption("array", "C 陣列輸入要轉換的陣列名稱", "name");
+    const QCommandLineOption ditherOption("dither", "圖片輸入的混色方式，例如 floyd-steinberg、bayer4、blue-noise", "method");
+    const QCommandLineOption gammaOption("gamma", "混色前的 gamma", "value");
+    const QCommandLineOption contrastOption("contrast", "混色前的對比", "value");
+    const QCommandLineOption progmemOption("progmem", "h 輸出的陣列加上 PROGMEM");
+    const QCommandLineOption sizeMacrosOption("size-macros", "h 輸出加上 _WIDTH / _HEIGHT 巨集");
+    const QCommandLineOption codecOption("codec", "壓縮格式: raw, rle, packbits, page-delta, lz, auto", "codec");
+    const QCommandLineOption frameOption("frame", "replay 要輸出的畫面 (預設為最後一個)", "n");
+    const QCommandLineOption rotateOption("rotate180", "replay：模組上下顛倒安裝 (A1 + C8 為正向)");
+    const QCommandLineOption loopOption("loop", "patch：加上最後一個畫面回到第一個畫面的切換");
+    const QCommandLineOption busOption("bus", "patch / anim：匯流排: i2c, spi", "bus");
+    const QCommandLineOption payloadOption("payload", "patch / anim：I2C 每次傳輸的 byte 上限 (含控制 byte)", "n");
+    const QCommandLineOption modeOption("mode", "anim：independent, keyframe-xor, page-skip, patches, auto", "mode");
+    const QCommandLineOption keyframeOption("keyframe", "anim：keyframe-xor 的關鍵畫面間隔", "n");
+    const QCommandLineOption flashBudgetOption("flash-budget", "anim：auto 可以使用的 flash byte 數", "n");
+    const QCommandLineOption fontOption("font", "font：BDF 或 C 陣列字型 (預設為內建 5x7)", "path");
+    parser.addOptions({outputOption, formatOption, nameOption, invertOption, horizontalOption, sizeOption,
+                       panelOption, layerOption, arrayOption, ditherOption, gammaOption, contrastOption,
+                       progmemOption, sizeMacrosOption, codecOption, frameOption, rotateOption, loopOption,
+                       busOption, payloadOption, modeOption, keyframeOption, flashBudgetOption, fontOption});
+    parser.process(app);
+
+    QStringList args = parser.positionalArguments();
+    if (args.size() < 2) {
+        parser.showHelp(2);
+    }
+    const QString command = args.takeFirst();
+
+    Options options;
+    options.output = parser.value(outputOption);
+    options.format = parser.value(formatOption);
+    options.name = parser.value(nameOption);
+    options.invert = parser.isSet(invertOption);
+    options.horizontal = parser.isSet(horizontalOption);
+    options.layer = parser.value(layerOption);
+    options.array = parser.value(arrayOption);
+    options.rotated = parser.isSet(rotateOption);
+    options.loop = parser.isSet(loopOption);
+    options.font = parser.value(fontOption);
+    if (parser.isSet(progmemOption)) {
+        options.writer.attribute = "PROGMEM";
+    }
+    options.writer.sizeMacros = parser.isSet(sizeMacrosOption);
+    if (parser.isSet(codecOption)) {
+        const QString codec = parser.value(codecOption);
+        options.codecAuto = codec == "auto";
+        if (!options.codecAuto && !OledCodec::methodFromName(codec, &options.codec)) {
+            printError(QString("未知的壓縮格式: %1 (可用: raw, rle, packbits, page-delta, lz, auto)").arg(codec));
+            return 2;
+        }
+    }
+    if (parser.isSet(sizeOption)) {
+        options.size = OledAssetIO::parseSizeHint(parser.value(sizeOption));
+        if (!options.size.isValid()) {
+            printError("--size 的格式應為 WxH，例如 16x16");
+            return 2;
+        }
+    }
+
+    if (parser.isSet(panelOption)) {
+        options.panel = OledPanel::find(parser.value(panelOption));
+        if (!options.panel) {
+            QStringList ids;
+            for (const OledPanelProfile& profile : OledPanel::profiles()) {
+                ids << QString::fromLatin1(profile.id);
+            }
+            printError(QString("未知的面板: %1 (可用: %2)").arg(parser.value(panelOption), ids.join(", ")));
+            return 2;
+        }
+    }
+
+    if (parser.isSet(ditherOption)
+        && !OledDither::methodFromName(parser.value(ditherOption), &options.dither.method)) {
+        printError(QString("未知的混色方式: %1 (可用: threshold, floyd-steinberg, atkinson, sierra-lite, "
+                           "bayer2, bayer4, bayer8, blue-noise)").arg(parser.value(ditherOption)));
+        return 2;
+    }
+    bool ok = true;
+    if (parser.isSet(frameOption)) {
+        options.frame = parser.value(frameOption).toInt(&ok);
+        if (!ok || options.frame < 0) {
+            printError("--frame 必須是不小於 0 的整數");
+            return 2;
+        }
+    }
+    if (parser.isSet(busOption)) {
+        const QString bus = parser.value(busOption).toLower();
+        if (bus == "spi") {
+            options.bus = OledBusEstimator::Bus::spi(8000000);
+        } else if (bus != "i2c") {
+            printError(QString("未知的匯流排: %1 (可用: i2c, spi)").arg(bus));
+            return 2;
+        }
+    }
+    if (parser.isSet(payloadOption)) {
+        options.bus.maxPayload = parser.value(payloadOption).toInt(&ok);
+        if (!ok || options.bus.maxPayload < 0) {
+            printError("--payload 必須是不小於 0 的整數");
+            return 2;
+        }
+    }
+    options.animation.bus = options.bus;
+    if (parser.isSet(modeOption)) {
+        const QString mode = parser.value(modeOption);
+        options.animationAuto = mode == "auto";
+        if (!options.animationAuto && !OledAnimationEncoder::modeFromName(mode, &options.animationMode)) {
+            printError(QString("未知的動畫格式: %1 (可用: independent, keyframe-xor, page-skip, patches, auto)")
+                           .arg(mode));
+            return 2;
+        }
+    }
+    if (parser.isSet(keyframeOption)) {
+        options.animation.keyframeInterval = parser.value(keyframeOption).toInt(&ok);
+        if (!ok || options.animation.keyframeInterval < 0) {
+            printError("--keyframe 必須是不小於 0 的整數");
+            return 2;
+        }
+    }
+    if (parser.isSet(flashBudgetOption)) {
+        options.flashBudget = parser.value(flashBudgetOption).toLongLong(&ok);
+        if (!ok || options.flashBudget < 0) {
+            printError("--flash-budget 必須是不小於 0 的整數");
+            return 2;
+        }
+    }
+    if (parser.isSet(gammaOption)) {
+        options.dither.gamma = parser.value(gammaOption).toDouble(&ok);
+        if (!ok || options.dither.gamma <= 0.0) {
+            printError("--gamma 必須是大於 0 的數字");
+            return 2;
+        }
+    }
+    if (parser.isSet(contrastOption)) {
+        options.dither.contrast = parser.value(contrastOption).toDouble(&ok);
+        if (!ok || options.dither.contrast < 0.0) {
+            printError("--contrast 必須是不小於 0 的數字");
+            return 2;
+        }
+    }
+
+    if (command == "convert") {
+        return runConvert(args, options);
+    }
+    if (command == "render") {
+        return runRender(args, options);
+    }
+    if (command == "list") {
+        return runList(args);
+    }
+    if (command == "replay") {
+        return runReplay(args, options);
+    }
+    if (command == "patch") {
+        return runPatch(args, options);
+    }
+    if (command == "anim") {
+        return runAnim(args, options);
+    }
+    if (command == "font") {
+        return runFont(args, options);
+    }
+    printError(QString("未知的指令: %1").arg(command));
+    return 2;
+}
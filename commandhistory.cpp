@@ -0,0 +1,84 @@
+#include "commandhistory.h"
+
+#include <algorithm>
+
+QString OledEditCommand::typeName(Type type)
+{
+    switch (type) {
+    case Stroke:          return "畫筆";
+    case Line:            return "直線";
+    case Rectangle:       return "方形";
+    case FilledRectangle: return "方塊";
+    case Ellipse:         return "圓形";
+    case Paste:           return "貼上";
+    case Cut:             return "剪下";
+    case Import:          return "匯入";
+    case Clear:           return "清除畫面";
+    case Text:            return "文字";
+    }
+    return QString();
+}
+
+void CommandHistory::push(OledEditCommand command)
+{
+    // 清除 redo 分支
+    while (static_cast<int>(m_commands.size()) > m_next) {
+        m_memoryUsage -= m_commands.back().byteSize();
+        m_commands.pop_back();
+    }
+
+    m_memoryUsage += command.byteSize();
+    m_commands.push_back(std::move(command));
+    m_next = static_cast<int>(m_commands.size());
+
+    enforceBudget();
+}
+
+const OledEditCommand* CommandHistory::undo()
+{
+    if (!canUndo()) {
+        return nullptr;
+    }
+    return &m_commands[--m_next];
+}
+
+const OledEditCommand* CommandHistory::redo()
+{
+    if (!canRedo()) {
+        return nullptr;
+    }
+    return &m_commands[m_next++];
+}
+
+bool CommandHistory::canUndo() const
+{
+    return m_next > 0;
+}
+
+bool CommandHistory::canRedo() const
+{
+    return m_next < static_cast<int>(m_commands.size());
+}
+
+void CommandHistory::clear()
+{
+    m_commands.clear();
+    m_next = 0;
+    m_memoryUsage = 0;
+}
+
+void CommandHistory::setMemoryBudget(qsizetype bytes)
+{
+    m_memoryBudget = std::max<qsizetype>(bytes, 0);
+    enforceBudget();
+}
+
+void CommandHistory::enforceBudget()
+{
+    // 只丟棄已經 undo 得到的舊操作，redo 分支保留
+    while (m_memoryUsage > m_memoryBudget && m_next > 0) {
+        m_memoryUsage -= m_commands.front().byteSize();
+        m_commands.pop_front();
+        --m_next;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <QByteArray>
+#include <QRect>
+#include <QString>
+#include <deque>
+
+// 一筆可逆的繪圖操作：只保存被改動的頁面/欄位窗口在操作前後的差異 (XOR 後以 PackBits 壓縮)
+struct OledEditCommand {
+    enum Type {
+        Stroke,      // 畫筆/橡皮擦軌跡
+        Line,
+        Rectangle,
+        FilledRectangle,
+        Ellipse,
+        Paste,
+        Cut,
+        Import,
+        Clear,
+        Text
+    };
+
+    Type type = Stroke;
+    int layer = 0;         // 被改動的圖層 (OledDataModel 的圖層索引)
+    QRect region;          // 被改動的範圍 (邏輯座標)
+    int firstPage = 0;     // 頁面窗口 (含)
+    int lastPage = -1;
+    int firstColumn = 0;   // RAM 欄位窗口 (含 COLUMN_OFFSET，含)
+    int lastColumn = -1;
+    QByteArray delta;      // 窗口內 before ^ after (逐頁排列) 的 PackBits；undo 與 redo 都是再 XOR 一次
+
+    int columnCount() const { return lastColumn - firstColumn + 1; }
+    int pageCount() const { return lastPage - firstPage + 1; }
+    qsizetype byteSize() const { return delta.size(); }   // 記憶體預算以壓縮後的大小計算
+    static QString typeName(Type type);
+};
+
+class CommandHistory {
+public:
+    CommandHistory() = default;
+
+    void push(OledEditCommand command);
+    const OledEditCommand* undo();   // 回傳要反向套用的操作，沒有則為 nullptr
+    const OledEditCommand* redo();   // 回傳要重新套用的操作，沒有則為 nullptr
+    bool canUndo() const;
+    bool canRedo() const;
+    void clear();
+
+    // 目前狀態之前的操作 (0 為最舊、仍保留的一筆)，例如重建每一步的畫面
+    int undoCount() const { return m_next; }
+    const OledEditCommand& command(int index) const { return m_commands[index]; }
+
+    void setMemoryBudget(qsizetype bytes);  // 超過預算 (以壓縮後的差異計算) 時從最舊的操作開始丟棄
+    qsizetype memoryUsage() const { return m_memoryUsage; }
+
+private:
+    std::deque<OledEditCommand> m_commands;   // 壓縮後一筆只有幾百 bytes，預算內可以有上千筆；丟棄最舊的是 O(1)
+    int m_next = 0;                 // 下一個 redo 的位置 (= 可 undo 的筆數)
+    qsizetype m_memoryBudget = 1024 * 1024;
+    qsizetype m_memoryUsage = 0;
+
+    void enforceBudget();
+};
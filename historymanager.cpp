@@ -1,77 +1,250 @@
 #include "historymanager.h"
 
+#include <algorithm>
+
+/*
+ * 差異格式 (delta)：
+ *   重複 { 相同 byte 的數量 (varint), 不同 byte 的數量 (varint), 不同 byte 的 XOR 值... }
+ * 尾端相同的部分直接省略。
+ * 因為是 XOR，同一筆差異既能從前一個狀態走到這個狀態 (redo)，也能反向走回去 (undo)。
+ */
+
+namespace {
+
+void writeVarint(QByteArray& out, qsizetype value)
+{
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+qsizetype readVarint(const QByteArray& in, qsizetype& pos)
+{
+    qsizetype value = 0;
+    int shift = 0;
+    while (pos < in.size()) {
+        const uint8_t byte = static_cast<uint8_t>(in[pos++]);
+        value |= static_cast<qsizetype>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+        shift += 7;
+    }
+    return value;
+}
+
+}
+
+QByteArray HistoryManager::encodeDelta(const QByteArray& from, const QByteArray& to)
+{
+    QByteArray out;
+    const qsizetype n = to.size();
+    const char* a = from.constData();
+    const char* b = to.constData();
+
+    qsizetype i = 0;
+    while (i < n) {
+        const qsizetype sameStart = i;
+        while (i < n && a[i] == b[i]) ++i;
+        if (i == n) break; // 尾端都相同，不需要記錄
+
+        const qsizetype diffStart = i;
+        // 單一個相同的 byte 夾在差異中間時一併當成差異，避免產生太多小段
+        while (i < n && (a[i] != b[i] || (i + 1 < n && a[i + 1] != b[i + 1]))) ++i;
+
+        writeVarint(out, diffStart - sameStart);
+        writeVarint(out, i - diffStart);
+        for (qsizetype k = diffStart; k < i; ++k) {
+            out.append(static_cast<char>(a[k] ^ b[k]));
+        }
+    }
+    return out;
+}
+
+void HistoryManager::applyDelta(QByteArray& state, const QByteArray& delta)
+{
+    char* data = state.data();
+    const qsizetype n = state.size();
+    qsizetype pos = 0;
+    qsizetype offset = 0;
+
+    while (pos < delta.size()) {
+        offset += readVarint(delta, pos);
+        const qsizetype count = readVarint(delta, pos);
+        for (qsizetype k = 0; k < count && pos < delta.size(); ++k, ++offset) {
+            if (offset < n) data[offset] ^= delta[pos];
+            ++pos;
+        }
+    }
+}
+
+qsizetype HistoryManager::nodeSize(const HistoryNode& node)
+{
+    return node.delta.size() + node.keyframe.size();
+}
+
 void HistoryManager::pushState(const QByteArray& state) {
-    if (current && current->canvasState == state) {
+    if (m_current >= 0 && m_currentState == state) {
         return; // 狀態相同，不要重複存
     }
-    auto* node = new HistoryNode{state};
-    if (current) {
-        // 清除 redo 分支
-        HistoryNode* temp = current->next;
-        while (temp) {
-            HistoryNode* next = temp->next;
-            delete temp;
-            temp = next;
-        }
-        current->next = node;
-        node->prev = current;
+
+    // 清除 redo 分支
+    truncateRedoBranch();
+
+    HistoryNode node;
+    const bool sameSize = m_current >= 0 && m_currentState.size() == state.size();
+    if (sameSize) {
+        node.delta = encodeDelta(m_currentState, state);
+        node.hasDelta = true;
+    }
+
+    // 第一筆、尺寸改變、或距離上個 keyframe 已滿 N 筆時，存一份完整快照
+    if (!sameSize || ++m_sinceKeyframe >= m_keyframeInterval) {
+        node.keyframe = state;
+        m_sinceKeyframe = 0;
     }
-    current = node;
+
+    m_memoryUsage += nodeSize(node);
+    m_nodes.push_back(std::move(node));
+    m_current = static_cast<int>(m_nodes.size()) - 1;
+    m_currentState = state;
+
+    enforceBudget();
 }
 
 QByteArray HistoryManager::undo() {
-    if (current && current->prev) {
-        current = current->prev;
-        return current->canvasState;
+    if (!canUndo()) {
+        return QByteArray();
+    }
+
+    const HistoryNode& node = m_nodes[m_current];
+    --m_current;
+
+    if (node.hasDelta) {
+        applyDelta(m_currentState, node.delta); // O(差異大小)
+    } else {
+        m_currentState = reconstruct(m_current);
     }
-    return QByteArray();
+    return m_currentState;
 }
 
 QByteArray HistoryManager::redo() {
-    if (current && current->next) {
-        current = current->next;
-        return current->canvasState;
+    if (!canRedo()) {
+        return QByteArray();
     }
-    return QByteArray();
+
+    ++m_current;
+    const HistoryNode& node = m_nodes[m_current];
+
+    if (!node.keyframe.isEmpty()) {
+        m_currentState = node.keyframe;
+    } else {
+        applyDelta(m_currentState, node.delta);
+    }
+    return m_currentState;
 }
 
 bool HistoryManager::canUndo() const {
-    return current && current->prev;
+    return m_current > 0;
 }
 
 bool HistoryManager::canRedo() const {
-    return current && current->next;
+    return m_current >= 0 && m_current + 1 < static_cast<int>(m_nodes.size());
 }
 
-void HistoryManager::clearNote() {
-    if (!current) return;
+void HistoryManager::setMemoryBudget(qsizetype bytes)
+{
+    m_memoryBudget = std::max<qsizetype>(bytes, 0);
+    enforceBudget();
+}
 
-    // 移動到最前面
-    while (current->prev)
-        current = current->prev;
+void HistoryManager::setKeyframeInterval(int interval)
+{
+    m_keyframeInterval = std::max(interval, 1);
+}
 
-    // 刪除所有節點
-    while (current) {
-        HistoryNode* next = current->next;
-        delete current;
-        current = next;
+/**
+ * @brief 從最近的 keyframe 往後套用差異，重建指定索引的完整狀態。
+ *
+ * 平常 undo/redo 只需要 m_currentState 加上一筆差異；只有跨越尺寸改變時才會走到這裡，
+ * 最多套用 keyframe 間隔 (N) 筆差異。
+ */
+QByteArray HistoryManager::reconstruct(int index) const
+{
+    int base = index;
+    while (base > 0 && m_nodes[base].keyframe.isEmpty()) {
+        --base;
     }
 
-    current = nullptr;
+    QByteArray state = m_nodes[base].keyframe;
+    for (int i = base + 1; i <= index; ++i) {
+        applyDelta(state, m_nodes[i].delta);
+    }
+    return state;
 }
 
+void HistoryManager::truncateRedoBranch()
+{
+    while (static_cast<int>(m_nodes.size()) > m_current + 1) {
+        m_memoryUsage -= nodeSize(m_nodes.back());
+        m_nodes.pop_back();
+    }
 
+    recountSinceKeyframe();
+}
 
-HistoryManager::~HistoryManager() {
-    //historymanager.cpp:43:17: Definition of implicitly declared destructor
-    // 往最前面走
-    while (current && current->prev) {
-        current = current->prev;
+/**
+ * @brief 從最後一筆往前數到最近的 keyframe，重新計算 m_sinceKeyframe。
+ *
+ * 丟棄 redo 分支或預算把最舊的差異升級成 keyframe 之後，原本的計數就不對了。
+ */
+void HistoryManager::recountSinceKeyframe()
+{
+    m_sinceKeyframe = 0;
+    for (int i = static_cast<int>(m_nodes.size()) - 1; i > 0 && m_nodes[i].keyframe.isEmpty(); --i) {
+        ++m_sinceKeyframe;
     }
-    // 從頭開始刪掉所有節點
-    while (current) {
-        HistoryNode* next = current->next;
-        delete current;
-        current = next;
+}
+
+/**
+ * @brief 超過記憶體預算時，從最舊的狀態開始丟棄。
+ *
+ * 丟掉最前面一筆之前，新的第一筆必須升級成 keyframe (完整快照)，
+ * 否則之後就無法再 undo 回到它。目前狀態永遠不會被丟棄。
+ */
+void HistoryManager::enforceBudget()
+{
+    bool trimmed = false;
+    while (m_memoryUsage > m_memoryBudget && m_current > 0) {
+        HistoryNode& next = m_nodes[1];
+        if (next.keyframe.isEmpty()) {
+            next.keyframe = reconstruct(1);
+            m_memoryUsage += next.keyframe.size();
+        }
+        m_memoryUsage -= next.delta.size();
+        next.delta.clear();
+        next.hasDelta = false;
+
+        m_memoryUsage -= nodeSize(m_nodes.front());
+        m_nodes.pop_front();
+        --m_current;
+        trimmed = true;
+    }
+    if (trimmed) {
+        recountSinceKeyframe();
     }
 }
+
+void HistoryManager::clearNote() {
+    m_nodes.clear();
+    m_current = -1;
+    m_currentState.clear();
+    m_sinceKeyframe = 0;
+    m_memoryUsage = 0;
+}
+
+
+
+HistoryManager::~HistoryManager() {
+    clearNote();
+}
@@ -1,10 +1,12 @@
 #pragma once
 #include <QByteArray>
+#include <deque>
 
+// 一筆歷史紀錄：相對於前一個狀態的 XOR 差異 (RLE 壓縮)，每隔 N 筆額外保存完整快照
 struct HistoryNode {
-    QByteArray canvasState;
-    HistoryNode* prev = nullptr;
-    HistoryNode* next = nullptr;
+    QByteArray delta;     // XOR(前一個狀態, 這個狀態) 的 RLE 編碼；第一筆或尺寸改變時為空
+    QByteArray keyframe;  // 完整快照 (keyframe)，非 keyframe 時為空
+    bool hasDelta = false;
 };
 
 class HistoryManager {
@@ -17,7 +19,29 @@ public:
     bool canUndo() const;
     bool canRedo() const;
 
+    // --- 記憶體控制 ---
+    void setMemoryBudget(qsizetype bytes);   // 超過預算時從最舊的狀態開始丟棄
+    void setKeyframeInterval(int interval);  // 每隔幾筆存一個完整快照
+    qsizetype memoryUsage() const { return m_memoryUsage; }
+    int stateCount() const { return static_cast<int>(m_nodes.size()); }
+
 private:
-    HistoryNode* current = nullptr;
+    std::deque<HistoryNode> m_nodes;
+    int m_current = -1;                 // 目前狀態在 m_nodes 中的索引
+    QByteArray m_currentState;          // 目前狀態的完整內容 (重建快取，undo/redo 只需套用一筆差異)
+
+    qsizetype m_memoryBudget = 256 * 1024;
+    int m_keyframeInterval = 32;
+    int m_sinceKeyframe = 0;            // 距離上一個 keyframe 的筆數
+    qsizetype m_memoryUsage = 0;
+
     void clearNote();
+    void truncateRedoBranch();
+    void recountSinceKeyframe();
+    void enforceBudget();
+    QByteArray reconstruct(int index) const;
+    static qsizetype nodeSize(const HistoryNode& node);
+
+    static QByteArray encodeDelta(const QByteArray& from, const QByteArray& to);
+    static void applyDelta(QByteArray& state, const QByteArray& delta);
 };
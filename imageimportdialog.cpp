@@ -3,11 +3,23 @@
 
 #include "imageimportdialog.h"
 #include "ui_imageimportdialog.h"
+#include "oled_assetio.h"
+#include "oled_panel.h"
+
+#include <QListWidget>
+#include <QSignalBlocker>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace {
+// 預覽的最大邊長：結果超過這個大小時，預覽改以代理圖計算
+constexpr int kPreviewMaxSide = 512;
+}
 
 ImageImportDialog::ImageImportDialog(const QImage &sourceImage, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::ImageImportDialog),
-    m_originalImage(sourceImage) // 保存原始圖片
+    m_originalImage(sourceImage), // 保存原始圖片
+    m_generation(std::make_shared<std::atomic<int>>(0))
 {
     ui->setupUi(this);
     this->setWindowTitle("匯入精靈");
@@ -37,7 +49,23 @@ ImageImportDialog::ImageImportDialog(const QImage &sourceImage, QWidget *parent)
     ui->rotationComboBox->addItem("180°", 180);
     ui->rotationComboBox->addItem("270° (逆時針)", 270); // 或 -90
 
-    // 4. 讓預覽圖的 QLabel 可以自動縮放內容
+    // 4. 混色方式與 gamma / 對比 (預設為單純門檻值，與以前的結果相同)
+    ui->ditherComboBox->addItem("門檻值", OledDither::Threshold);
+    ui->ditherComboBox->addItem("Floyd-Steinberg", OledDither::FloydSteinberg);
+    ui->ditherComboBox->addItem("Atkinson", OledDither::Atkinson);
+    ui->ditherComboBox->addItem("Sierra Lite", OledDither::SierraLite);
+    ui->ditherComboBox->addItem("Bayer 2x2", OledDither::Bayer2);
+    ui->ditherComboBox->addItem("Bayer 4x4", OledDither::Bayer4);
+    ui->ditherComboBox->addItem("Bayer 8x8", OledDither::Bayer8);
+    ui->ditherComboBox->addItem("藍噪聲", OledDither::BlueNoise);
+    ui->gammaSpinBox->setRange(0.2, 5.0);
+    ui->gammaSpinBox->setSingleStep(0.1);
+    ui->gammaSpinBox->setValue(1.0);
+    ui->contrastSpinBox->setRange(0.0, 4.0);
+    ui->contrastSpinBox->setSingleStep(0.1);
+    ui->contrastSpinBox->setValue(1.0);
+
+    // 5. 讓預覽圖的 QLabel 可以自動縮放內容
     ui->previewLabel->setScaledContents(false); // 我們手動設定大小，不讓 QLabel 自動縮放
     ui->previewLabel->setAlignment(Qt::AlignCenter);
 
@@ -50,21 +78,33 @@ ImageImportDialog::ImageImportDialog(const QImage &sourceImage, QWidget *parent)
 
 
     // --- 連接信號與槽 ---
+    connect(&m_previewWatcher, &QFutureWatcher<PreviewJob>::finished, this, &ImageImportDialog::onPreviewFinished);
     connect(ui->scaleSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &ImageImportDialog::updatePreview);
     connect(ui->rotationComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ImageImportDialog::updatePreview);
     connect(ui->B_W_swap, &QRadioButton::toggled, this, &ImageImportDialog::updatePreview);
+    connect(ui->ditherComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ImageImportDialog::updatePreview);
+    connect(ui->gammaSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &ImageImportDialog::updatePreview);
+    connect(ui->contrastSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &ImageImportDialog::updatePreview);
 
 
 
 
+    connect(ui->assetListWidget, &QListWidget::currentRowChanged, this, &ImageImportDialog::onAssetSelected);
     connect(ui->V_H_swap, &QRadioButton::toggled, this, &ImageImportDialog::updateFilePreview);
     connect(ui->B_W_swap_H, &QRadioButton::toggled, this, &ImageImportDialog::updateFilePreview);
     // --- 第一次載入時，立即更新一次預覽 ---
     updatePreview();
 }
 
+void ImageImportDialog::setCanvasSize(const QSize &size)
+{
+    m_canvasSize = size;
+}
+
 ImageImportDialog::~ImageImportDialog()
 {
+    // 執行中的預覽工作只持有複本，讓它在下一個步驟前放棄即可，不必等待
+    ++(*m_generation);
     delete ui;
 }
 
@@ -97,10 +137,12 @@ void ImageImportDialog::on_OpenPicture_pushButton_clicked()
 
     if (loaded.load(filePath)) {
         // 檢查尺寸 (選擇性)
-        if (loaded.width() > 128 || loaded.height() > 64) {
-            QMessageBox::warning(this, "注意", "圖片尺寸大於 128x64，匯入後可能需要縮小。");
+        if (loaded.width() > m_canvasSize.width() || loaded.height() > m_canvasSize.height()) {
+            QMessageBox::warning(this, "注意", QString("圖片尺寸大於 %1x%2，匯入後可能需要縮小。")
+                                                 .arg(m_canvasSize.width()).arg(m_canvasSize.height()));
         }
         m_originalImage = loaded;
+        m_proxyImage = QImage();   // 代理圖屬於舊圖片
         ui->label_ImgSize->setText(QString("原始尺寸: %1 x %2").arg(m_originalImage.width()).arg(m_originalImage.height()));
         updatePreview(); // 更新預覽
     }
@@ -108,111 +150,133 @@ void ImageImportDialog::on_OpenPicture_pushButton_clicked()
 
 void ImageImportDialog::updatePreview(){
 
+    // 參數改變：讓執行中的舊工作失效
+    ++(*m_generation);
+
     if (m_originalImage.isNull()) {
         ui->previewLabel->setText("請先開啟圖片");
         //qDebug() << "Warning: m_originalImage is null. import factor might be zero.";
         return;
     }
 
-    // 1. 取得設定值
-    int scaleFactor = ui->scaleSpinBox->value();
-    int rotation = ui->rotationComboBox->currentData().toInt();
-    bool shouldInvert = ui->B_W_swap->isChecked();
-
-
-    // 2. 建立一個局部的、用於處理的圖片副本
-    //    我們從原始圖片開始，確保每次更新都是全新的計算
-    QImage processedImage = m_originalImage;
-    //QImage temp = m_originalImage;
-
-
-    // 3. 【流水線步驟 A: 縮放】
-    //    注意：SpinBox 的 value() 通常是百分比，所以要除以 100.0
-    //    如果您的 SpinBox 直接是像素值，則不需要除法
-
-
-    int targetWidth = m_originalImage.width() * scaleFactor;
-    int targetHeight  = m_originalImage.height() * scaleFactor;
-    //processedImage = processedImage.scaled(targetWidth, targetHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-
-    processedImage = processedImage.scaled(
-        targetWidth,
-        targetHeight,
-        Qt::KeepAspectRatio,
-        Qt::SmoothTransformation
-        );
-
-    if (processedImage.isNull()) {
-        // 如果縮放失敗（例如 scale 為 0），就不要繼續執行
+    // 一次只跑一個工作：舊工作會在下一個步驟前放棄，結束後再以最新的參數重跑
+    if (m_previewWatcher.isRunning()) {
+        m_previewPending = true;
         return;
     }
+    startPreviewJob();
+}
 
-    // 4. 【流水線步驟 B: 旋轉】
-    if (rotation != 0) {
-        QTransform transform;
-        transform.rotate(rotation);
-        processedImage = processedImage.transformed(transform);
-    }
+QSize ImageImportDialog::processedSize() const
+{
+    const int scaleFactor = ui->scaleSpinBox->value();
+    return QSize(m_originalImage.width() * scaleFactor, m_originalImage.height() * scaleFactor);
+}
 
-    if (processedImage.isNull()) {
-        // 如果縮放失敗（例如 scale 為 0），就不要繼續執行
-        return;
-    }
+OledDither::Options ImageImportDialog::ditherOptions() const
+{
+    OledDither::Options options;
+    options.method = static_cast<OledDither::Method>(ui->ditherComboBox->currentData().toInt());
+    options.gamma = ui->gammaSpinBox->value();
+    options.contrast = ui->contrastSpinBox->value();
+    return options;
+}
+
+void ImageImportDialog::startPreviewJob()
+{
+    // 在 GUI 執行緒取得設定值，工作執行緒只拿到複本 (QImage 為隱式共享，複製不花成本)
+    const QImage original = m_originalImage;
+    const QImage proxy = m_proxyImage;
+    const QSize targetSize = processedSize();
+    const int rotation = ui->rotationComboBox->currentData().toInt();
+    const bool shouldInvert = ui->B_W_swap->isChecked();
+    const OledDither::Options dither = ditherOptions();
+    const std::shared_ptr<std::atomic<int>> counter = m_generation;
+    const int generation = counter->load();
+
+    m_previewWatcher.setFuture(QtConcurrent::run([=]() {
+        PreviewJob job;
+        job.generation = generation;
+        job.sourceKey = original.cacheKey();
+        const auto cancelled = [&counter, generation]() { return counter->load() != generation; };
+
+        if (targetSize.width() <= kPreviewMaxSide && targetSize.height() <= kPreviewMaxSide) {
+            // 結果本身就夠小：直接以原圖計算，預覽即是最終結果
+            job.exact = true;
+            job.image = OledAssetIO::transformForImport(original, targetSize, rotation, shouldInvert, dither,
+                                                           cancelled);
+            return job;
+        }
 
+        // 大圖：先縮成代理圖 (只做一次)，預覽以代理圖算出與最終結果同比例、但較小的圖
+        job.proxy = proxy.isNull() ? OledAssetIO::makePreviewProxy(original, kPreviewMaxSide) : proxy;
+        const QSize previewSize = targetSize.scaled(kPreviewMaxSide, kPreviewMaxSide, Qt::KeepAspectRatio);
+        job.image = OledAssetIO::transformForImport(job.proxy, previewSize, rotation, shouldInvert, dither,
+                                                       cancelled);
+        return job;
+    }));
+}
 
-    // 5. 【流水線步驟 C: 反轉】
-    if (shouldInvert) {
-        // 現在 processedImage 已經包含了縮放和旋轉的結果
-        // 我們在此基礎上進行反轉
-        processedImage.invertPixels(QImage::InvertRgb);
+void ImageImportDialog::onPreviewFinished()
+{
+    const PreviewJob job = m_previewWatcher.result();
+
+    // 代理圖與參數無關，只要來源圖片沒變就保留下來
+    if (m_proxyImage.isNull() && !job.proxy.isNull() && job.sourceKey == m_originalImage.cacheKey()) {
+        m_proxyImage = job.proxy;
     }
 
-    if (processedImage.isNull()) {
-        // 如果縮放失敗（例如 scale 為 0），就不要繼續執行
+    if (m_previewPending) {
+        m_previewPending = false;
+        startPreviewJob();
         return;
     }
 
-
-    // 6. 【流水線步驟 D: 轉換為單色圖】
-    //    這是流水線的最後一步，得到最終的單色邏輯資料
-    QImage monoImage = processedImage.convertToFormat(QImage::Format_Mono, Qt::ThresholdDither);
-
-    if (monoImage.isNull()) {
-        // 如果縮放失敗（例如 scale 為 0），就不要繼續執行
+    // 過時或被取消的結果直接丟掉
+    if (job.generation != m_generation->load() || job.image.isNull()) {
         return;
     }
 
-    /*  這段就有差別,
-
-    // 3. 顯示預覽
-    // 為了讓使用者看得清楚，預覽圖本身可以在 Label 上放大顯示
-    int displayScale = (scaleFactor < 2) ? 4 : 2;
-    QPixmap px = QPixmap::fromImage(mono);
-    // 這裡只是顯示放大，不改變 mono 本身數據
-    ui->previewLabel->setPixmap(px.scaled(px.size() * displayScale, Qt::KeepAspectRatio));
-    ui->previewLabel->resize(px.size() * displayScale);
-    */
-
-
-    // 7. 更新 UI 預覽
-    //    用最終的 monoImage 來更新預覽
-
-    // 讓 Label 跟著圖片大小改變
-    int previewWidth  = monoImage.width() * scaleFactor;
-    int previewHeight = monoImage.height() * scaleFactor;
-
+    // 更新 UI 預覽
+    // 全品質結果跟以前一樣依倍率放大顯示；代理圖的結果已經是預覽大小
+    const int displayScale = job.exact ? ui->scaleSpinBox->value() : 1;
     QPixmap pixmap = QPixmap::fromImage(
-        monoImage.scaled(previewWidth, previewHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation)
+        job.image.scaled(job.image.width() * displayScale, job.image.height() * displayScale,
+                         Qt::KeepAspectRatio, Qt::SmoothTransformation)
         );
 
     ui->previewLabel->setPixmap(pixmap);
     ui->previewLabel->resize(pixmap.size());  // 讓 Label 跟著圖片大小改變
 
+    // 將結果儲存到成員變數中，供 MainWindow 讀取 (代理圖的結果會在 accept() 時換成全品質)
+    m_processedImage = job.image;
+    m_shownGeneration = job.generation;
+    m_shownExact = job.exact;
+}
 
-    // 8. 將最終結果儲存到成員變數中，供 MainWindow 讀取
-    //    這一步非常重要，確保 getProcessedImage() 返回正確的結果
-    m_processedImage = monoImage;
-
+void ImageImportDialog::accept()
+{
+    if (ui->tabWidget->currentWidget() != ui->File_tab && !m_originalImage.isNull()) {
+        const int generation = m_generation->load();
+        const bool upToDate = m_shownExact && m_shownGeneration == generation;
+
+        // 取消還在跑的預覽，之後的結果一律視為過時
+        ++(*m_generation);
+        m_previewPending = false;
+
+        if (!upToDate) {
+            QApplication::setOverrideCursor(Qt::WaitCursor);
+            const QImage monoImage = OledAssetIO::transformForImport(
+                m_originalImage, processedSize(), ui->rotationComboBox->currentData().toInt(),
+                ui->B_W_swap->isChecked(), ditherOptions());
+            QApplication::restoreOverrideCursor();
+
+            if (!monoImage.isNull()) {
+                m_processedImage = monoImage;
+            }
+        }
+    }
+    QDialog::accept();
 }
 
 
@@ -227,8 +291,9 @@ void ImageImportDialog::on_Openfile_pushButton_clicked()
 
     if (filePath.isEmpty()) return;
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    // 只掃描一次建立索引 (名稱、尺寸、位置)，陣列的資料等選到時才讀
+    std::shared_ptr<const OledAssetCatalog> catalog = OledAssetCatalog::open(filePath);
+    if (!catalog) {
         QMessageBox::warning(this, "錯誤", "無法開啟檔案！");
         return;
     }
@@ -236,85 +301,83 @@ void ImageImportDialog::on_Openfile_pushButton_clicked()
     // 顯示路徑
     ui->lbl_FilePath->setText(filePath);
 
-    QTextStream in(&file);
-    m_currentFileContent = in.readAll();
-    //QString content = in.readAll();
-    file.close();
-
-    // 開始解析
-    updateFilePreview();
+    m_assetCatalog = catalog;
+    m_selectedAsset = -1;
+    m_selectedAssetData.clear();
+    m_fileRawImage = QImage();
+
+    {
+        const QSignalBlocker blocker(ui->assetListWidget);
+        ui->assetListWidget->clear();
+        for (const OledAssetCatalog::Entry &entry : catalog->entries()) {
+            const QString name = entry.name.isEmpty() ? QString("(未命名)") : entry.name;
+            const QString size = entry.size.isValid()
+                                     ? QString("%1x%2").arg(entry.size.width()).arg(entry.size.height())
+                                     : QString("?");
+            ui->assetListWidget->addItem(QString("%1  %2, %3 bytes").arg(name, size).arg(entry.byteCount));
+        }
+    }
 
-    //parseFileContentToImage(content);
+    if (catalog->count() == 0) {
+        ui->label_FilePreview->setText("未找到 Hex 數據");
+        return;
+    }
+    ui->assetListWidget->setCurrentRow(0);
 }
 
 
-void ImageImportDialog::updateFilePreview()
+void ImageImportDialog::onAssetSelected(int row)
 {
-    if (m_currentFileContent.isEmpty()) return;
+    if (!m_assetCatalog || row < 0 || row >= m_assetCatalog->count()) return;
 
-    // 直接呼叫你之前寫好的解析邏輯 (記得把 parseFileContentToImage 的邏輯整合進來)
-    // 這裡會讀取 ui->V_H_swap->isChecked() 和 ui->B_W_swap_H->isChecked()
-    parseFileContentToImage(m_currentFileContent);
-}
-
-void ImageImportDialog::parseFileContentToImage(const QString &content)
-{
-
-    // 1. 使用 Regex 提取 Hex
-    QString dataContent = content;
-    int startBrace = content.indexOf('{');
-    int endBrace = content.lastIndexOf('}');
-
-    // 如果找得到大括號，我們就只看大括號裡面的東西
-    if (startBrace != -1 && endBrace != -1 && endBrace > startBrace) {
-        dataContent = content.mid(startBrace, endBrace - startBrace + 1);
+    m_selectedAsset = row;
+    m_selectedAssetData = m_assetCatalog->load(row);
+    if (m_selectedAssetData.empty()) {
+        ui->label_FilePreview->setText("檔案已被修改，請重新選擇檔案");
+        m_fileRawImage = QImage();
+        return;
     }
 
-    // --- 2. 嘗試解析尺寸 (這是新增的關鍵功能) ---
-    // 目標：從註解中抓出 "(22x8 region" 這樣的資訊
-    // Regex 解說：尋找括號，接著數字(寬)，接著x，接著數字(高)
-    QRegularExpression sizeRegex("(\\d+)\\s*[xX]\\s*(\\d+)");
+    // 註解有寫定址方式時直接套用
+    const OledAssetCatalog::Entry &entry = m_assetCatalog->entries()[static_cast<size_t>(row)];
+    if (entry.addressing != OledAssetCatalog::Entry::UnknownAddressing) {
+        const QSignalBlocker blocker(ui->V_H_swap);
+        ui->V_H_swap->setChecked(entry.addressing == OledAssetCatalog::Entry::Horizontal);
+    }
 
-    auto sizeMatch = sizeRegex.match(content);
+    updateFilePreview();
+}
 
-    int targetW = 0;
-    int targetH = 0;
 
-    if (sizeMatch.hasMatch()) {
-        targetW = sizeMatch.captured(1).toInt();
-        targetH = sizeMatch.captured(2).toInt();
-    }
+void ImageImportDialog::updateFilePreview()
+{
+    if (!m_assetCatalog || m_selectedAsset < 0 || m_selectedAssetData.empty()) return;
 
-    QRegularExpression hexRegex("0x[0-9a-fA-F]+|[0-9a-fA-F]{2}");
-    //QRegularExpression hexRegex("0[xX][0-9a-fA-F]+");
-    auto matches = hexRegex.globalMatch(dataContent);
+    // 這裡會讀取 ui->V_H_swap->isChecked() 和 ui->B_W_swap_H->isChecked()
+    parseFileContentToImage(m_assetCatalog->entries()[static_cast<size_t>(m_selectedAsset)], m_selectedAssetData);
+}
 
-    std::vector<uint8_t> rawBuffer;
+void ImageImportDialog::parseFileContentToImage(const OledAssetCatalog::Entry &entry, const std::vector<uint8_t> &data)
+{
 
-    while (matches.hasNext()) {
-        auto match = matches.next();
-        bool ok;
-        int val = match.captured().toInt(&ok, 16);
-        if (ok) rawBuffer.push_back(static_cast<uint8_t>(val));
-    }
+    // 1. 尺寸來自索引 (陣列前的註解，例如 "(22x8 region"，或 _WIDTH / _HEIGHT 巨集)
+    int targetW = entry.size.isValid() ? entry.size.width() : 0;
+    int targetH = entry.size.isValid() ? entry.size.height() : 0;
 
-    if (rawBuffer.empty()) {
-        ui->label_FilePreview->setText("未找到 Hex 數據");
-        m_fileRawImage = QImage();
-        return;
-    }
+    std::vector<uint8_t> rawBuffer = data;
 
     //bool isHorizontal = content.contains("Horizontal", Qt::CaseInsensitive);
     bool isHorizontal = ui->V_H_swap->isChecked();
 
     if (targetW == 0 || targetH == 0) {
 
-        if (rawBuffer.size() == 1056) {
-            targetW = 132; targetH = 64; isHorizontal = false;
-        }
-        else if (rawBuffer.size() == 1024)
-            {
-                targetW = 128; targetH = 64; isHorizontal = false;
+        // 整個畫面大小的資料：依已知面板判斷 (含填充欄位時寬度為 RAM 頁寬，例如 SH1106 的 1056 -> 132x64)
+        bool includesPadding = false;
+        const OledPanelProfile *panel = OledPanel::matchBufferSize(static_cast<int>(rawBuffer.size()), &includesPadding);
+        if (panel) {
+            targetW = includesPadding ? panel->geometry.ramPageWidth : panel->geometry.width;
+            targetH = panel->geometry.height;
+            isHorizontal = false;
         }else {
             // 預設假設 (例如 16x16)
             targetW = 16;
@@ -322,53 +385,15 @@ void ImageImportDialog::parseFileContentToImage(const QString &content)
         }
     }
 
-    // 建立一張「剛好大小」的圖片，而不是全螢幕
-    QImage importImg(targetW, targetH, QImage::Format_Mono);
-    importImg.fill(0);
-    importImg.setColor(0, qRgb(0, 0, 0));
-    importImg.setColor(1, qRgb(255, 255, 255));
-
-
-    int p = 0;
-    if (isHorizontal) {
-        // --- 水平定址解析 (Horizontal) ---
-        // 每一行由 (targetW / 8) 個 byte 組成
-        int bytesPerRow = (targetW + 7) / 8;
-        for (int y = 0; y < targetH; ++y) {
-            for (int b = 0; b < bytesPerRow; ++b) {
-                if (p >= (int)rawBuffer.size()) break;
-                uint8_t byte = rawBuffer[p++];
-                for (int bit = 0; bit < 8; ++bit) {
-                    int x = b * 8 + bit;
-                    if (x < targetW) {
-                        // 水平模式通常是 MSB First (最高位元在左邊)
-                        if ((byte >> (7 - bit)) & 1) {
-                            importImg.setPixel(x, y, 1);
-                        }
-                    }
-                }
-            }
-        }
-    } else {
-        // --- 垂直定址解析 (Vertical/Page - SH1106 專用) ---
-        int pages = (targetH + 7) / 8;
-        for (int page = 0; page < pages; ++page) {
-            for (int col = 0; col < targetW; ++col) {
-                if (p >= (int)rawBuffer.size()) break;
-                uint8_t byte = rawBuffer[p++];
-                for (int bit = 0; bit < 8; ++bit) {
-                    int y = page * 8 + bit;
-                    if (y < targetH) {
-                        // 垂直模式通常是 LSB First
-                        if ((byte >> bit) & 1) {
-                            importImg.setPixel(col, y, 1);
-                        }
-                    }
-                }
-            }
-        }
+    if (targetW <= 0 || targetH <= 0) {
+        ui->label_FilePreview->setText("數據不足以組成圖片");
+        m_fileRawImage = QImage();
+        return;
     }
 
+    // 建立一張「剛好大小」的圖片，而不是全螢幕 (資料不足的部分視為熄滅)
+    QImage importImg = OledAssetIO::decodeBitmap(std::move(rawBuffer), QSize(targetW, targetH), isHorizontal);
+
     // 4. 儲存與預覽
 /*
  * m_fileRawImage = importImg;
@@ -391,7 +416,8 @@ void ImageImportDialog::parseFileContentToImage(const QString &content)
 
     ui->label_FilePreview->setPixmap(px.scaled(targetW * displayScale, targetH * displayScale, Qt::KeepAspectRatio));
     ui->label_FilePreview->resize(targetW * displayScale, targetH * displayScale);
-    ui->lbl_FilePath->setText(QString("解析成功: %1x%2 (%3)").arg(targetW).arg(targetH).arg(isHorizontal ? "水平" : "垂直"));
+    ui->lbl_FilePath->setText(QString("解析成功: %1 %2x%3 (%4)")
+                                  .arg(entry.name).arg(targetW).arg(targetH).arg(isHorizontal ? "水平" : "垂直"));
 
 }
 
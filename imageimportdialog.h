@@ -1,7 +1,13 @@
 #ifndef IMAGEIMPORTDIALOG_H
 #define IMAGEIMPORTDIALOG_H
 #include "config.h"
+#include "oled_assetcatalog.h"
 #include "oled_datamodel.h"
+#include "oled_dither.h"
+
+#include <QFutureWatcher>
+#include <atomic>
+#include <memory>
 
 
 
@@ -25,6 +31,13 @@ public:
 
     bool isCoverMode()const;
 
+    // 目前畫布 (面板) 的可視尺寸，開圖時以此判斷是否需要縮小；預設為 SH1106 的 128x64
+    void setCanvasSize(const QSize &size);
+
+public slots:
+    // 按下 OK：預覽若是代理圖的結果，先以原圖算出全品質的圖片再關閉
+    void accept() override;
+
 private slots:
     // 當 spinbox 或 combobox 的值改變時，呼叫此槽函數來更新預覽
     void updatePreview();
@@ -45,6 +58,8 @@ private:
 
     QImage m_fileImportImage;  // [新增] 檔案 Tab 解析出來的圖
 
+    QSize m_canvasSize = QSize(OledConfig::DISPLAY_WIDTH, OledConfig::DISPLAY_HEIGHT);
+
     // --- File Tab 變數 ---
     QImage m_fileRawImage;     // 從 .h 檔解析出來的原始圖片
 
@@ -52,14 +67,42 @@ private:
     // 輔助函式：解析文字內容並轉為圖片
     //void parseAndPreviewFile(const QString &fileContent);
 
-    void parseFileContentToImage(const QString &content);
-    QString m_currentFileContent; // 新增：儲存目前讀入的 .h 檔案文字內容
+    void parseFileContentToImage(const OledAssetCatalog::Entry &entry, const std::vector<uint8_t> &data);
+
+    // 開檔時只建立素材索引 (有快取，重開同一個檔案不必重新掃描)，選到哪個陣列才讀出哪個陣列
+    std::shared_ptr<const OledAssetCatalog> m_assetCatalog;
+    int m_selectedAsset = -1;
+    std::vector<uint8_t> m_selectedAssetData; // 選取中的陣列資料，切換定址/反白時不必重讀檔案
 
+    void onAssetSelected(int row);
     void updateFilePreview();
 
 
     QString m_lastLoadedFileContent; // 暫存檔案內容，方便切換模式時重繪
 
+    // --- Picture Tab 背景預覽 ---
+    // 縮放/旋轉/二值化在工作執行緒中執行，一次只跑一個工作；
+    // 每次參數改變都把世代計數 (generation) 加一，執行中的舊工作會在下一個步驟前自行放棄。
+    struct PreviewJob {
+        int generation = 0;
+        qint64 sourceKey = 0;   // 來源圖片的 cacheKey()，用來判斷代理圖是否還適用
+        QImage image;           // 單色結果 (被取消時為空)
+        QImage proxy;           // 本次使用的代理圖
+        bool exact = false;     // true：以原圖算出的全品質結果
+    };
+
+    void startPreviewJob();
+    void onPreviewFinished();
+    QSize processedSize() const;    // 全品質結果的縮放尺寸 (原圖 x 倍率)
+    OledDither::Options ditherOptions() const;
+
+    QFutureWatcher<PreviewJob> m_previewWatcher;
+    std::shared_ptr<std::atomic<int>> m_generation;
+    bool m_previewPending = false;  // 工作執行中參數又改變了，結束後要再跑一次
+    QImage m_proxyImage;            // 預覽用的代理圖 (第一次預覽時在工作執行緒中產生)
+    int m_shownGeneration = -1;     // m_processedImage 是哪一次參數的結果
+    bool m_shownExact = false;      // m_processedImage 是否為全品質結果
+
 };
 
 #endif // IMAGEIMPORTDIALOG_H
@@ -5,6 +5,18 @@
 #include "oledwidget_Paint.h"
 #include "ToolType.h"
 #include "config.h"
+#include "oled_carray.h"
+#include "oled_codec.h"
+#include "oled_patch.h"
+#include "busestimatordialog.h"
+#include "timelinedialog.h"
+#include "textdialog.h"
+#include "simulatordialog.h"
+
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QSignalBlocker>
+#include <algorithm>
 
 
 //#define test_1029
@@ -60,6 +72,18 @@ MainWindow::MainWindow(QWidget *parent)
     //匯入圖檔
     connect(ui->importButton, &QPushButton::clicked, this, &MainWindow::importImage);
 
+    //傳輸分析：估計畫布相對於裝置目前畫面的 I2C / SPI 更新時間
+    connect(ui->busAnalysisButton, &QPushButton::clicked, this, &MainWindow::showBusEstimator);
+
+    //動畫時間軸：多個影格的編輯與播放
+    connect(ui->timelineButton, &QPushButton::clicked, this, &MainWindow::showTimeline);
+
+    //文字：以點陣字型把文字畫到畫布
+    connect(ui->textButton, &QPushButton::clicked, this, &MainWindow::showTextTool);
+
+    //硬體模擬器：貼上畫面資料或裝置擷取的 I2C / SPI 紀錄，模擬結果匯入畫布
+    connect(ui->simulatorButton, &QPushButton::clicked, this, &MainWindow::showSimulator);
+
     //重製繪圖框尺寸
     connect(ui->resetOledSizeButton, &QPushButton::clicked, this, &MainWindow::resetOledPlaceholderSize);
 
@@ -98,6 +122,30 @@ MainWindow::MainWindow(QWidget *parent)
 
     //</筆刷功能>
 
+    //<面板選擇>
+    // 同一個程式支援多種面板，切換時會清除操作歷史；可視尺寸不同時也會清空畫布 (先詢問)
+    for (const OledPanelProfile &profile : OledPanel::profiles()) {
+        ui->panelComboBox->addItem(QString::fromUtf8(profile.name), QString::fromLatin1(profile.id));
+    }
+
+    connect(ui->panelComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, [this](int index) {
+                const OledPanelProfile *profile = OledPanel::find(ui->panelComboBox->itemData(index).toString());
+                if (!profile || profile->geometry == m_oled->panelGeometry()) {
+                    return;
+                }
+                if (!confirmPanelChange(*profile)) {
+                    // 取消：選擇還原成目前的面板，不觸發切換
+                    const OledPanelProfile *current = OledPanel::find(m_oled->panelGeometry());
+                    const QSignalBlocker blocker(ui->panelComboBox);
+                    ui->panelComboBox->setCurrentIndex(
+                        current ? ui->panelComboBox->findData(QString::fromLatin1(current->id)) : -1);
+                    return;
+                }
+                m_oled->setPanel(*profile);
+            });
+    //</面板選擇>
+
     // --- 3. 設定【繪圖工具】按鈕群組 ---`
     m_toolButtonGroup = new QButtonGroup(this);
     m_toolButtonGroup->setExclusive(true);
@@ -148,9 +196,14 @@ MainWindow::MainWindow(QWidget *parent)
                 m_oled->setCurrentTool(static_cast<ToolType>(id));
             });
 
-    connect(m_oled, &OLEDWidget::canvasStateChanged,
-            this, [this](const QByteArray &state) {
-                history.pushState(state);
+    // 操作歷史由 OLEDWidget 以可逆操作記錄，這裡只負責同步按鈕狀態
+    connect(m_oled, &OLEDWidget::historyChanged,
+            this, [this]() {
+                ui->undo_Bottom->setEnabled(m_oled->canUndo());
+                ui->redo_Bottom->setEnabled(m_oled->canRedo());
+                if (m_busDialog) {
+                    m_busDialog->setCurrent(m_oled->panelGeometry(), m_oled->getHardwareBuffer());
+                }
             });
 
 
@@ -195,7 +248,8 @@ MainWindow::MainWindow(QWidget *parent)
     ui->pushButton_Select->setShortcut(QKeySequence("S"));
 
     /************************HOT Key ******************/
-    history.pushState(captureCanvasState()); // 初始快照
+    ui->undo_Bottom->setEnabled(m_oled->canUndo());
+    ui->redo_Bottom->setEnabled(m_oled->canRedo());
 }
 
 void MainWindow::exportData()
@@ -208,7 +262,7 @@ void MainWindow::exportData()
 
     QRect region = m_oled->getSelectedRegion().isValid()
                        ? m_oled->getSelectedRegion()
-                       : QRect(0, 0, OledConfig::DISPLAY_WIDTH, OledConfig::DISPLAY_HEIGHT);
+                       : QRect(0, 0, m_oled->panelGeometry().width, m_oled->panelGeometry().height);
     QImage logicalData = m_oled->copyRegionToImage(region);
     QVector<uint8_t> hardwareData = OledDataModel::convertLogicalToHardwareFormat(logicalData);
 
@@ -220,54 +274,126 @@ void MainWindow::exportData()
         return;
     }
 
-    // 步骤 3: [修正] 动态地构建 C 阵列声明
-    // 我们不再硬编码数组大小 1024，而是使用 buffer.size() 来获取实际大小。
-    QString c_array = QString("const unsigned char screen_data[%1] = {\n    ")
-                          .arg(buffer.size());
-
-    int line_break_count = 0;
-
-
-    // 步骤 4: [修正] 使用 std::vector 的方式来遍历数据
-    for (size_t i = 0; i < buffer.size(); ++i) {
-        // buffer[i] 现在是对 std::vector 元素的访问，语义清晰。
-        c_array += QString("0x%1,").arg(buffer[i], 2, 16, QChar('0'));
-
-        line_break_count++;
-        if (line_break_count == 16 && i < buffer.size() - 1) { // 避免在最后一行后也换行
-            c_array += "\n    ";
-            line_break_count = 0;
+    // 步骤 3: 以共用的 OledCArrayWriter 格式化 (查表寫入預先配置的緩衝區，不再每個 byte 產生一個 QString)；
+    //         可以選壓縮格式，壓縮時一併輸出 C 解碼函式
+    const int pageWidth = m_oled->panelGeometry().ramPageWidth;
+    auto formatExport = [buffer, pageWidth](int codecChoice, QString *summary) {
+        std::vector<uint8_t> encoded;
+        const OledCodec::Method method = codecChoice < 0
+                                             ? OledCodec::pickBest(buffer.data(), buffer.size(), pageWidth, &encoded)
+                                             : static_cast<OledCodec::Method>(codecChoice);
+        if (codecChoice >= 0) {
+            encoded = OledCodec::encode(method, buffer.data(), buffer.size(), pageWidth);
         }
-    }
+        *summary = QString("%1: %2 -> %3 bytes")
+                       .arg(OledCodec::methodName(method)).arg(buffer.size()).arg(encoded.size());
 
-    // 步骤 5: [修正] 更健壮的字符串结尾处理
-    if (c_array.endsWith(", ")) {
-        c_array.chop(2); // 移除最后多余的 ", "
-    }
-    c_array += "\n};";
+        OledCArrayWriter::Options options;
+        options.type = "const unsigned char";
+        options.upperCase = false;
+        QByteArray c_array_bytes;
+        {
+            OledCArrayWriter writer(&c_array_bytes, options);
+            OledCodec::writeArray(&writer, method, "screen_data", buffer, pageWidth);
+        }
+        return QString::fromUtf8(c_array_bytes);
+    };
 
-    // 步骤 6: 显示对话框 (这部分逻辑保持不变)
+    // 步骤 4: 显示对话框
     QDialog *exportDialog = new QDialog(this);
     exportDialog->setWindowTitle("匯出的H檔 (可複製)");
     exportDialog->setAttribute(Qt::WA_DeleteOnClose); // 使用 WA_DeleteOnClose 更安全
     exportDialog->resize(600, 400);
 
+    QComboBox *codecComboBox = new QComboBox(exportDialog);
+    codecComboBox->addItem("不壓縮 (raw)", OledCodec::Raw);
+    codecComboBox->addItem("RLE", OledCodec::Rle);
+    codecComboBox->addItem("PackBits", OledCodec::PackBits);
+    codecComboBox->addItem("Page delta + PackBits", OledCodec::PageDelta);
+    codecComboBox->addItem("LZ", OledCodec::Lz);
+    codecComboBox->addItem("自動 (最小)", -1);
+    QLabel *codecLabel = new QLabel(exportDialog);
+
     QTextEdit *textEdit = new QTextEdit(exportDialog);
-    textEdit->setPlainText(c_array);
     textEdit->setReadOnly(true);
     textEdit->setFontFamily("Courier");
 
+    auto refresh = [=]() {
+        QString summary;
+        textEdit->setPlainText(formatExport(codecComboBox->currentData().toInt(), &summary));
+        codecLabel->setText(summary);
+    };
+    connect(codecComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), exportDialog, refresh);
+    refresh();
+
+    QPushButton *historyButton = new QPushButton("匯出操作歷史的差異更新...", exportDialog);
+    historyButton->setToolTip("每一步只輸出改變的 (頁, 欄位, bytes)，附 C 的套用函式");
+    connect(historyButton, &QPushButton::clicked, this, &MainWindow::exportHistoryPatches);
+
     QPushButton *closeButton = new QPushButton("關閉", exportDialog);
     connect(closeButton, &QPushButton::clicked, exportDialog, &QDialog::accept);
 
+    QHBoxLayout *codecLayout = new QHBoxLayout();
+    codecLayout->addWidget(codecComboBox);
+    codecLayout->addWidget(codecLabel, 1);
+
     QVBoxLayout *layout = new QVBoxLayout(exportDialog);
+    layout->addLayout(codecLayout);
     layout->addWidget(textEdit);
+    layout->addWidget(historyButton);
     layout->addWidget(closeButton);
 
     exportDialog->exec();
     // 使用 WA_DeleteOnClose 后，不再需要手动 delete
 }
 
+/**
+ * @brief 把操作歷史 (最舊仍保留的狀態到目前) 匯出成差異更新的 C 表格。
+ *
+ * 第一筆是完整的畫面，之後每一步只有改變的範圍；合併範圍的成本依傳輸分析面板的匯流排設定
+ * (沒開過面板時為 I2C 400 kHz)。
+ */
+void MainWindow::exportHistoryPatches()
+{
+    const OledPanelGeometry geometry = m_oled->panelGeometry();
+    if (!OledPatchEncoder::supports(geometry)) {
+        QMessageBox::information(this, "提示", "這個面板的欄位超過 256，無法輸出差異更新。");
+        return;
+    }
+    const std::vector<std::vector<uint8_t>> frames = m_oled->historyFrames();
+    if (frames.size() < 2) {
+        QMessageBox::information(this, "提示", "操作歷史是空的。");
+        return;
+    }
+
+    const QString filePath = QFileDialog::getSaveFileName(this, "匯出差異更新", "history_patches.h", "C header (*.h)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    const OledBusEstimator::Bus bus = m_busDialog ? m_busDialog->bus() : OledBusEstimator::Bus::i2c(400000);
+    const std::vector<OledPatchEncoder::Transition> transitions = OledPatchEncoder::encodeSequence(geometry, frames, bus);
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::critical(this, "错误", QString("无法写入档案:\n%1").arg(filePath));
+        return;
+    }
+
+    OledCArrayWriter::Options options;
+    options.type = "const unsigned char";
+    options.upperCase = false;
+    OledCArrayWriter writer(&file, options);
+    writer.writeComment("File generated by OLED GUI Designer");
+    OledPatchEncoder::writeArrays(&writer, "history_patches", transitions, geometry);
+
+    if (writer.flush()) {
+        QMessageBox::information(this, "成功", QString("%1 個畫面已匯出至:\n%2").arg(frames.size()).arg(filePath));
+    } else {
+        QMessageBox::critical(this, "错误", QString("无法写入档案:\n%1").arg(filePath));
+    }
+}
+
 void MainWindow::saveData()
 {
     // 步骤 1: 创建 log 文件夹 (这部分逻辑不变)
@@ -296,42 +422,23 @@ void MainWindow::saveData()
         return;
     }
 
-    // 3.3 使用 QTextStream 构建文件内容字符串
-    QString c_array_content;
-    QTextStream out(&c_array_content);
-
-    out << "// Saved at: " << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss") << "\n";
-    out << "// File generated by OLED GUI Designer\n\n";
-    // out << "#include <stdint.h>\n\n"; // 包含标准头文件是个好习惯
-
-    // 3.4 [修正] 动态地构建 C 阵列
-    out << QString("const unsigned char image_%1[%2] = {\n    ")
-               .arg(timestamp)
-               .arg(buffer.size());
-
-    // 3.5 [修正] 使用 std::vector 的方式遍历
-    for (size_t i = 0; i < buffer.size(); ++i) {
-        out << QString("0x%1, ").arg(buffer[i], 2, 16, QChar('0'));
-        if ((i + 1) % 16 == 0 && i < buffer.size() - 1) {
-            out << "\n    ";
-        }
+    // 步骤 4: 直接串流寫入档案 (OledCArrayWriter 每 64 KB 寫出一次，不先組成整個字串)
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::critical(this, "错误", QString("无法写入档案:\n%1").arg(filePath));
+        return;
     }
 
-    // 移除最后多余的 ", "
-    // (注意: QTextStream 不像 QString 那样有 chop 或 endsWith,
-    // 所以先构建 QString 再处理末尾是更稳妥的方式)
-    QString final_content = out.readAll(); // 从流中读出所有内容
-    if (final_content.endsWith(", ")) {
-        final_content.chop(2);
-    }
-    final_content += "\n};";
+    OledCArrayWriter::Options options;
+    options.type = "const unsigned char";
+    options.upperCase = false;
+    OledCArrayWriter writer(&file, options);
+    writer.writeComment("Saved at: " + QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss").toUtf8());
+    writer.writeComment("File generated by OLED GUI Designer");
+    writer.writeText("\n");
+    writer.writeArray("image_" + timestamp.toUtf8(), buffer.data(), buffer.size());
 
-    // 步骤 4: 写入档案 (这部分逻辑不变)
-    QFile file(filePath);
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream stream(&file);
-        stream << final_content; // 写入处理过的最终字符串
-        file.close();
+    if (writer.flush()) {
         QMessageBox::information(this, "成功", QString("档案已储存至:\n%1").arg(filePath));
     } else {
         QMessageBox::critical(this, "错误", QString("无法写入档案:\n%1").arg(filePath));
@@ -343,7 +450,8 @@ void MainWindow::saveData()
 void MainWindow::updateCoordinateLabel(const QPoint &pos)
 {
     // 檢查座標是否有效 (我們在 leaveEvent 中發送了 -1, -1)
-    if (pos.x() < 0 || pos.y() < 0 || pos.x() >= 128 || pos.y() >= 64) {
+    const OledPanelGeometry &geometry = m_oled->panelGeometry();
+    if (pos.x() < 0 || pos.y() < 0 || pos.x() >= geometry.width || pos.y() >= geometry.height) {
         // 如果無效，顯示預設文字
         ui->label_coordinate->setText("(x, y): --, --");
     } else {
@@ -371,9 +479,6 @@ void MainWindow::resetOledPlaceholderSize()
         // setScale() 导致的尺寸变化，会被 QScrollArea 自动侦测到，
         // Qt 的布局系统会负责处理剩下的更新。
     }
-
-    //for undo and redo
-    history.pushState(captureCanvasState());
 }
 
 
@@ -386,6 +491,7 @@ void MainWindow::importImage()
     // 直接建立 Dialog，並傳入空的 QImage，因為我們要在 Dialog 內部讓使用者選擇圖片或檔案。
 
     ImageImportDialog importDialog(QImage(), this);
+    importDialog.setCanvasSize(QSize(m_oled->panelGeometry().width, m_oled->panelGeometry().height));
     // 【修改點 2】: 執行 Dialog，等待使用者按下 OK (Accepted)
     if (importDialog.exec() == QDialog::Accepted) {
 
@@ -410,12 +516,96 @@ void MainWindow::importImage()
             // 疊加模式：進入貼上預覽模式 (會有虛線框跟隨滑鼠)
             m_oled->handleImportPreview(monoImage);
         }
-        history.pushState(captureCanvasState());
+    }
+}
+
+bool MainWindow::confirmPanelChange(const OledPanelProfile &profile)
+{
+    const OledPanelGeometry &current = m_oled->panelGeometry();
+    const bool sameSize = current.width == profile.geometry.width && current.height == profile.geometry.height;
+
+    QStringList losses;
+    if (!sameSize) {
+        const std::vector<uint8_t> buffer = m_oled->getHardwareBuffer();
+        if (std::any_of(buffer.cbegin(), buffer.cend(), [](uint8_t byte) { return byte != 0; })) {
+            losses << "畫布的內容";
+        }
+    }
+    if (!sameSize && m_timeline.frameCount() > 1) {
+        // 只有一個影格時它就是畫布
+        losses << QString("動畫的 %1 個影格").arg(m_timeline.frameCount());
+    }
+    if (m_oled->canUndo() || m_oled->canRedo()) {
+        losses << "復原 / 重做的記錄";
+    }
+    if (losses.isEmpty()) {
+        return true;
     }
 
-    //for undo and redo
-    //history.pushState(captureCanvasState());
+    const QString message = QString("切換到 %1 會清除%2，要繼續嗎？")
+                                .arg(QString::fromUtf8(profile.name), losses.join("與"));
+    return QMessageBox::question(this, "切換面板", message) == QMessageBox::Yes;
+}
+
+void MainWindow::showBusEstimator()
+{
+    if (!m_busDialog) {
+        // 第一次開啟時以目前的畫布作為「裝置上的畫面」，之後的編輯都和它比較
+        m_busDialog = new BusEstimatorDialog(this);
+        m_busDialog->setAttribute(Qt::WA_DeleteOnClose);
+        m_busDialog->setCurrent(m_oled->panelGeometry(), m_oled->getHardwareBuffer());
+        m_busDialog->setBaseline(m_oled->getHardwareBuffer());
+    }
+    m_busDialog->show();
+    m_busDialog->raise();
+    m_busDialog->activateWindow();
+}
 
+void MainWindow::showTimeline()
+{
+    if (!m_timelineDialog) {
+        // 只建立一次：關閉後畫布的編輯仍然寫回目前的影格
+        m_timelineDialog = new TimelineDialog(&m_timeline, m_oled, this);
+    }
+    m_timelineDialog->show();
+    m_timelineDialog->raise();
+    m_timelineDialog->activateWindow();
+}
+
+void MainWindow::showTextTool()
+{
+    if (!m_textDialog) {
+        // 只建立一次：匯出字型時要用到之前畫過的所有文字
+        m_textDialog = new TextDialog(m_oled, this);
+    }
+    m_textDialog->show();
+    m_textDialog->raise();
+    m_textDialog->activateWindow();
+}
+
+void MainWindow::showSimulator()
+{
+    // 以目前的面板模擬；強制回應，按下「模擬」或「套用到畫布」後才匯入
+    SimulatorDialog dialog(this);
+    if (const OledPanelProfile *profile = OledPanel::find(ui->panelComboBox->currentData().toString())) {
+        dialog.setPanel(*profile);
+    }
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    // 對話框回傳可視區域 (寬 x 頁數)，補回填充欄位後才是畫布的硬體格式
+    const OledPanelGeometry geometry = m_oled->panelGeometry();
+    const std::vector<uint8_t> visible = dialog.getBuffer();
+    if (visible.size() != static_cast<size_t>(geometry.visibleBufferSize())) {
+        return;
+    }
+    std::vector<uint8_t> buffer(static_cast<size_t>(geometry.bufferSize()), 0);
+    for (int page = 0; page < geometry.pageCount(); ++page) {
+        std::copy_n(visible.cbegin() + page * geometry.width, geometry.width,
+                    buffer.begin() + page * geometry.ramPageWidth + geometry.columnOffset);
+    }
+    m_oled->importBuffer(buffer.data());
 }
 
 void MainWindow::on_pushButton_Copy_clicked()
@@ -432,8 +622,6 @@ void MainWindow::on_pushButton_paste_clicked()
     if (m_oled) {
         m_oled->commitPaste();
     }
-    //for undo and redo
-    history.pushState(captureCanvasState());
 }
 
 void MainWindow::on_pushButton_Cut_clicked()
@@ -442,8 +630,6 @@ void MainWindow::on_pushButton_Cut_clicked()
     if (m_oled) {
         m_oled->handleCut();
     }
-    //for undo and redo
-    history.pushState(captureCanvasState());
 }
 
 
@@ -500,38 +686,11 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *event)
 
 
 void MainWindow::onUndoClicked() {
-    if (history.canUndo()) {
-        QByteArray state = history.undo();
-        applyCanvasState(state);
-    }
+    m_oled->undo();
 }
 
 void MainWindow::onRedoClicked() {
-    if (history.canRedo()) {
-        QByteArray state = history.redo();
-        applyCanvasState(state);
-    }
-}
-
-
-void MainWindow::applyCanvasState(const QByteArray& state) {
-    if (state.isEmpty()) return;
-    m_oled->setBuffer(reinterpret_cast<const uint8_t*>(state.constData()));
-
-    /* m_oled->setBuffer(reinterpret_cast<const uint8_t*>(state.constData()));
-     * 等同於：
-     * const char* rawData = state.constData();
-     * const uint8_t* buffer = reinterpret_cast<const uint8_t*>(rawData);
-     * m_oled->setBuffer(buffer);
-     */
-
-    //update(); // 觸發 Qt 重繪
-}
-
-
-QByteArray MainWindow::captureCanvasState() {
-    std::vector<uint8_t> buffer = m_oled->getHardwareBuffer();
-    return QByteArray(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    m_oled->redo();
 }
 
 MainWindow::~MainWindow()
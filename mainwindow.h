@@ -7,12 +7,17 @@
 #include "oledwidget_Paint.h"
 #include "imageimportdialog.h"
 #include "oled_datamodel.h"
+#include "oled_timeline.h"
 #include "config.h"
-#include "historymanager.h"
+
+#include <QPointer>
 
 
 
 class OLEDWidget; // 前向聲明
+class BusEstimatorDialog;
+class TimelineDialog;
+class TextDialog;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -38,6 +43,11 @@ private slots:
     void exportData(); // 聲明槽函數
     void saveData();
     void importImage(); // <-- 新增槽函式声明
+    void showBusEstimator(); // 傳輸分析面板 (非強制回應)
+    void exportHistoryPatches(); // 操作歷史每一步的差異更新 (.h)
+    void showTimeline(); // 動畫時間軸 (非強制回應，關閉後影格仍保留)
+    void showTextTool(); // 文字工具 (非強制回應，關閉後畫過的文字仍保留)
+    void showSimulator(); // 硬體模擬器 (畫面資料或 I2C / SPI 紀錄，結果匯入畫布)
     void updateCoordinateLabel(const QPoint &pos);
 
     void on_pushButton_Copy_clicked();
@@ -55,10 +65,13 @@ private:
     QScrollArea* scrollArea;   // <- 必須有這行
     ToolType m_currentTool;          // 储存当前选中的工具
     QSize m_originalOledSize;; // 用於儲存 oledPlaceholder 的原始尺寸
+    QPointer<BusEstimatorDialog> m_busDialog; // 開著的時候畫布每次改變都重新估計
+    OledTimeline m_timeline;                  // 動畫的影格 (畫布是目前的影格)
+    TimelineDialog *m_timelineDialog = nullptr;
+    TextDialog *m_textDialog = nullptr;       // 保留畫過的文字 (匯出字型時只放用到的字元)
 
-    HistoryManager history;
-    QByteArray captureCanvasState();          // 把畫布序列化成 QByteArray
-    void applyCanvasState(const QByteArray&); // 還原畫布
+    // 切換面板會遺失內容 (畫布、操作歷史) 時先詢問，使用者取消時回傳 false
+    bool confirmPanelChange(const OledPanelProfile &profile);
 
 protected: // 或者 private: 都可以，但 protected 更符合重寫基類函式的慣例
     bool eventFilter(QObject *obj, QEvent *event) override;
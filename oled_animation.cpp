@@ -0,0 +1,392 @@
+#include "oled_animation.h"
+#include "oled_carray.h"
+#include "oled_codec.h"
+#include "oled_patch.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr int kParallelMinFrames = 16;      // 影格少時建立執行緒不划算
+
+// 每個影格的編碼只讀取輸入，結果寫到各自的位置，可以直接分段平行處理
+template <typename Job>
+void forEachFrame(int count, const Job& job)
+{
+    const int threads = std::max(1, QThread::idealThreadCount());
+    if (threads == 1 || count < kParallelMinFrames) {
+        for (int i = 0; i < count; ++i) job(i);
+        return;
+    }
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    const int chunk = (count + threads - 1) / threads;
+    for (int begin = 0; begin < count; begin += chunk) {
+        const int end = std::min(count, begin + chunk);
+        pool.start([&job, begin, end]() {
+            for (int i = begin; i < end; ++i) job(i);
+        });
+    }
+    pool.waitForDone();
+}
+
+// 硬體格式 (含填充欄位) -> 可視範圍 (頁數 x width)
+void copyVisible(const OledPanelGeometry& geometry, const uint8_t* frame, uint8_t* out)
+{
+    for (int page = 0; page < geometry.pageCount(); ++page) {
+        std::memcpy(out + page * geometry.width, frame + page * geometry.ramPageWidth + geometry.columnOffset,
+                    static_cast<size_t>(geometry.width));
+    }
+}
+
+void copyFromVisible(const OledPanelGeometry& geometry, const uint8_t* visible, uint8_t* frame)
+{
+    std::fill(frame, frame + geometry.bufferSize(), 0);
+    for (int page = 0; page < geometry.pageCount(); ++page) {
+        std::memcpy(frame + page * geometry.ramPageWidth + geometry.columnOffset, visible + page * geometry.width,
+                    static_cast<size_t>(geometry.width));
+    }
+}
+
+bool isKeyframe(int index, const OledAnimationEncoder::Options& options)
+{
+    return index == 0 || (options.keyframeInterval > 0 && index % options.keyframeInterval == 0);
+}
+
+int maskBytes(const OledPanelGeometry& geometry)
+{
+    return (geometry.pageCount() + 7) / 8;
+}
+
+// --- 輸出到韌體的 C 函式 (開頭見 OledCArrayWriter::preludeSource()；XOR 影格用 OledCodec 的 PackBits 解碼) ---
+
+const char kPageSkipDecoder[] =
+    "#ifndef OLED_PAGESKIP_DECODE_DEFINED\n"
+    "#define OLED_PAGESKIP_DECODE_DEFINED\n"
+    "/* (pages + 7) / 8 mask bytes (bit n = page n changed, LSB first), then width bytes per changed page.\n"
+    "   Returns the mask: only those pages need to be sent to the display. */\n"
+    "static uint32_t oled_pageskip_decode(const uint8_t *src, uint8_t *dst, uint8_t pages, uint16_t width)\n"
+    "{\n"
+    "    uint32_t mask = 0;\n"
+    "    uint8_t i;\n"
+    "    for (i = 0; i < (uint8_t)((pages + 7) / 8); i++) mask |= (uint32_t)OLED_READ_BYTE(src++) << (8 * i);\n"
+    "    for (i = 0; i < pages; i++) {\n"
+    "        if (mask & ((uint32_t)1 << i)) {\n"
+    "            uint8_t *out = dst + (size_t)i * width;\n"
+    "            uint16_t n = width;\n"
+    "            while (n--) *out++ = OLED_READ_BYTE(src++);\n"
+    "        }\n"
+    "    }\n"
+    "    return mask;\n"
+    "}\n"
+    "#endif\n";
+
+}
+
+QString OledAnimationEncoder::modeName(Mode mode)
+{
+    switch (mode) {
+    case Independent: return "independent";
+    case KeyframeXor: return "keyframe-xor";
+    case PageSkip: return "page-skip";
+    case Patches: return "patches";
+    }
+    return QString();
+}
+
+bool OledAnimationEncoder::modeFromName(const QString& name, Mode* mode)
+{
+    for (Mode candidate : modes()) {
+        if (modeName(candidate) == name) {
+            *mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<OledAnimationEncoder::Mode> OledAnimationEncoder::modes()
+{
+    return {Independent, KeyframeXor, PageSkip, Patches};
+}
+
+bool OledAnimationEncoder::encode(Mode mode, const OledPanelGeometry& geometry,
+                                  const std::vector<std::vector<uint8_t>>& frames, const Options& options,
+                                  Result* result)
+{
+    if (!geometry.isValid() || frames.empty() || (mode == Patches && !OledPatchEncoder::supports(geometry))) {
+        return false;
+    }
+    for (const std::vector<uint8_t>& frame : frames) {
+        if (frame.size() != static_cast<size_t>(geometry.bufferSize())) {
+            return false;
+        }
+    }
+
+    const int count = static_cast<int>(frames.size());
+    const size_t visibleSize = static_cast<size_t>(geometry.visibleBufferSize());
+    const OledBusEstimator::Cost fullCost = OledBusEstimator::cost(OledBusEstimator::fullFrame(geometry), options.bus);
+    std::vector<std::vector<uint8_t>> chunks(frames.size());
+    std::vector<OledBusEstimator::Cost> costs(frames.size(), fullCost);
+
+    forEachFrame(count, [&](int i) {
+        const uint8_t* current = frames[size_t(i)].data();
+        const uint8_t* previous = i > 0 ? frames[size_t(i) - 1].data() : nullptr;
+        std::vector<uint8_t>& out = chunks[size_t(i)];
+
+        switch (mode) {
+        case Independent:
+            out.resize(visibleSize);
+            copyVisible(geometry, current, out.data());
+            break;
+        case KeyframeXor: {
+            std::vector<uint8_t> visible(visibleSize);
+            copyVisible(geometry, current, visible.data());
+            if (!isKeyframe(i, options)) {
+                std::vector<uint8_t> before(visibleSize);
+                copyVisible(geometry, previous, before.data());
+                for (size_t k = 0; k < visibleSize; ++k) {
+                    visible[k] ^= before[k];
+                }
+            }
+            out = OledCodec::encode(OledCodec::PackBits, visible.data(), visibleSize, geometry.width);
+            break;
+        }
+        case PageSkip: {
+            out.assign(static_cast<size_t>(maskBytes(geometry)), 0);
+            std::vector<OledBusEstimator::Window> windows;
+            for (int page = 0; page < geometry.pageCount(); ++page) {
+                const size_t offset = size_t(page) * size_t(geometry.ramPageWidth) + size_t(geometry.columnOffset);
+                if (previous && std::memcmp(previous + offset, current + offset, size_t(geometry.width)) == 0) {
+                    continue;
+                }
+                out[size_t(page / 8)] |= uint8_t(1u << (page % 8));
+                out.insert(out.end(), current + offset, current + offset + geometry.width);
+                windows.push_back(
+                    OledBusEstimator::Window{page, geometry.columnOffset, geometry.columnOffset + geometry.width - 1});
+            }
+            costs[size_t(i)] = OledBusEstimator::cost(windows, options.bus);
+            break;
+        }
+        case Patches: {
+            const OledPatchEncoder::Transition transition =
+                OledPatchEncoder::diff(geometry, previous, current, options.bus);
+            OledPatchEncoder::serialize(transition, &out);
+            costs[size_t(i)] = transition.cost;
+            break;
+        }
+        }
+    });
+
+    Result encoded;
+    Report& report = encoded.report;
+    report.mode = mode;
+    report.frames = count;
+    for (int i = 0; i < count; ++i) {
+        if (mode != Independent) {
+            encoded.offsets.push_back(encoded.data.size());
+        }
+        encoded.data.insert(encoded.data.end(), chunks[size_t(i)].begin(), chunks[size_t(i)].end());
+
+        const OledBusEstimator::Cost& cost = costs[size_t(i)];
+        report.totalBusBytes += cost.busBytes();
+        if (i == 0) {
+            report.first = cost;
+            report.worst = cost;
+        } else if (i == 1 || cost.clocks > report.worst.clocks) {
+            report.worst = cost;
+            report.worstFrame = i;
+        }
+    }
+    report.dataBytes = qint64(encoded.data.size());
+    if (!encoded.offsets.empty()) {
+        const size_t entry = encoded.offsets.back() > 0xFFFF ? 4 : 2;      // 和 writeOffsetArray() 相同
+        report.tableBytes = qint64(entry * encoded.offsets.size());
+    }
+    *result = std::move(encoded);
+    return true;
+}
+
+std::vector<OledAnimationEncoder::Report> OledAnimationEncoder::compare(
+    const OledPanelGeometry& geometry, const std::vector<std::vector<uint8_t>>& frames, const Options& options)
+{
+    std::vector<Report> reports;
+    for (Mode mode : modes()) {
+        Result result;
+        if (encode(mode, geometry, frames, options, &result)) {
+            reports.push_back(result.report);
+        }
+    }
+    return reports;
+}
+
+OledAnimationEncoder::Mode OledAnimationEncoder::recommend(const std::vector<Report>& reports, qint64 flashBudget)
+{
+    const Report* best = nullptr;
+    for (const Report& report : reports) {
+        if (flashBudget > 0 && report.flashBytes() > flashBudget) {
+            continue;
+        }
+        if (!best || report.worst.clocks < best->worst.clocks
+            || (report.worst.clocks == best->worst.clocks && report.flashBytes() < best->flashBytes())) {
+            best = &report;
+        }
+    }
+    if (!best) {
+        for (const Report& report : reports) {
+            if (!best || report.flashBytes() < best->flashBytes()) {
+                best = &report;
+            }
+        }
+    }
+    return best ? best->mode : Independent;
+}
+
+bool OledAnimationEncoder::decode(const Result& result, const OledPanelGeometry& geometry, const Options& options,
+                                  std::vector<std::vector<uint8_t>>* frames)
+{
+    const Mode mode = result.report.mode;
+    const int count = result.report.frames;
+    const size_t visibleSize = static_cast<size_t>(geometry.visibleBufferSize());
+    const std::vector<uint8_t>& data = result.data;
+    std::vector<uint8_t> visible(visibleSize, 0);
+    std::vector<uint8_t> ram(static_cast<size_t>(geometry.bufferSize()), 0);     // Patches 的畫面緩衝區
+    std::vector<uint8_t> scratch(visibleSize);
+
+    frames->clear();
+    for (int i = 0; i < count; ++i) {
+        const size_t begin = mode == Independent ? size_t(i) * visibleSize : result.offsets[size_t(i)];
+        const size_t end = mode == Independent ? begin + visibleSize
+                           : size_t(i) + 1 < result.offsets.size() ? result.offsets[size_t(i) + 1]
+                                                                   : data.size();
+        if (begin > end || end > data.size()) {
+            return false;
+        }
+        const uint8_t* src = data.data() + begin;
+        const size_t size = end - begin;
+
+        switch (mode) {
+        case Independent:
+            std::memcpy(visible.data(), src, visibleSize);
+            break;
+        case KeyframeXor:
+            if (!OledCodec::decode(OledCodec::PackBits, src, size, scratch.data(), visibleSize, geometry.width)) {
+                return false;
+            }
+            for (size_t k = 0; k < visibleSize; ++k) {
+                visible[k] = isKeyframe(i, options) ? scratch[k] : uint8_t(visible[k] ^ scratch[k]);
+            }
+            break;
+        case PageSkip: {
+            size_t pos = static_cast<size_t>(maskBytes(geometry));
+            if (size < pos) {
+                return false;
+            }
+            for (int page = 0; page < geometry.pageCount(); ++page) {
+                if (!(src[page / 8] & (1u << (page % 8)))) {
+                    continue;
+                }
+                if (size - pos < size_t(geometry.width)) {
+                    return false;
+                }
+                std::memcpy(visible.data() + page * geometry.width, src + pos, size_t(geometry.width));
+                pos += size_t(geometry.width);
+            }
+            break;
+        }
+        case Patches: {
+            size_t offset = 0;
+            if (!OledPatchEncoder::apply(src, size, &offset, ram.data(), geometry)) {
+                return false;
+            }
+            break;
+        }
+        }
+
+        std::vector<uint8_t> frame(static_cast<size_t>(geometry.bufferSize()), 0);
+        if (mode == Patches) {
+            copyVisible(geometry, ram.data(), scratch.data());
+            copyFromVisible(geometry, scratch.data(), frame.data());
+        } else {
+            copyFromVisible(geometry, visible.data(), frame.data());
+        }
+        frames->push_back(std::move(frame));
+    }
+    return true;
+}
+
+QByteArray OledAnimationEncoder::decoderSource(Mode mode)
+{
+    switch (mode) {
+    case Independent: return QByteArray();
+    case KeyframeXor: return OledCodec::decoderSource(OledCodec::PackBits);
+    case PageSkip: return OledCArrayWriter::preludeSource() + kPageSkipDecoder;
+    case Patches: return OledPatchEncoder::applySource();
+    }
+    return QByteArray();
+}
+
+void OledAnimationEncoder::writeArrays(OledCArrayWriter* writer, const QByteArray& name, const Result& result,
+                                       const OledPanelGeometry& geometry, const Options& options)
+{
+    const Report& report = result.report;
+    const QByteArray upper = name.toUpper();
+    const QByteArray framesName = name + "_frames";
+    const bool patches = report.mode == Patches;
+    const int pageWidth = patches ? geometry.ramPageWidth : geometry.width;
+
+    const QByteArray source = decoderSource(report.mode);
+    if (!source.isEmpty()) {
+        writer->writeText(source);
+        writer->writeText("\n");
+    }
+
+    writer->writeComment(name + ": " + modeName(report.mode).toUtf8() + ", " + QByteArray::number(report.frames)
+                         + " frames " + QByteArray::number(geometry.width) + "x" + QByteArray::number(geometry.height)
+                         + ", flash " + QByteArray::number(report.flashBytes()) + " bytes (data "
+                         + QByteArray::number(report.dataBytes) + " + table " + QByteArray::number(report.tableBytes)
+                         + ")");
+    writer->writeComment("bus bytes per frame: first " + QByteArray::number(report.first.busBytes()) + ", worst "
+                         + QByteArray::number(report.worst.busBytes()) + " (frame "
+                         + QByteArray::number(report.worstFrame) + ")");
+    switch (report.mode) {
+    case Independent:
+        writer->writeComment("frame n: " + name + " + n * " + upper + "_FRAME_SIZE");
+        break;
+    case KeyframeXor:
+        writer->writeComment("frame n (buffer holds frame n - 1 unless n is a keyframe):");
+        writer->writeComment("    oled_packbits_xor_decode(" + name + " + " + framesName + "[n], buffer, " + upper
+                             + "_FRAME_SIZE, "
+                             + (options.keyframeInterval > 0 ? "n % " + upper + "_KEYFRAME_INTERVAL != 0"
+                                                             : QByteArray("n != 0"))
+                             + " ? 0 : " + upper + "_FRAME_SIZE);");
+        break;
+    case PageSkip:
+        writer->writeComment("frame n (buffer holds frame n - 1); send only the pages set in mask:");
+        writer->writeComment("    mask = oled_pageskip_decode(" + name + " + " + framesName + "[n], buffer, " + upper
+                             + "_PAGE_COUNT, " + upper + "_PAGE_WIDTH);");
+        break;
+    case Patches:
+        writer->writeComment("frame n (buffer holds frame n - 1; columns include the column offset):");
+        writer->writeComment("    oled_patch_apply(" + name + " + " + framesName + "[n], buffer, " + upper
+                             + "_PAGE_WIDTH);");
+        break;
+    }
+
+    writer->writeText("#define " + upper + "_FRAME_COUNT " + QByteArray::number(report.frames) + "\n");
+    writer->writeText("#define " + upper + "_FRAME_SIZE "
+                      + QByteArray::number(patches ? geometry.bufferSize() : geometry.visibleBufferSize()) + "\n");
+    writer->writeText("#define " + upper + "_PAGE_COUNT " + QByteArray::number(geometry.pageCount()) + "\n");
+    writer->writeText("#define " + upper + "_PAGE_WIDTH " + QByteArray::number(pageWidth) + "\n");
+    if (report.mode == KeyframeXor) {
+        writer->writeText("#define " + upper + "_KEYFRAME_INTERVAL " + QByteArray::number(options.keyframeInterval)
+                          + "\n");
+    }
+    writer->writeArray(name, result.data.data(), result.data.size());
+    if (!result.offsets.empty()) {
+        writer->writeOffsetArray(framesName, result.offsets);
+    }
+}
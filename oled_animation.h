@@ -0,0 +1,103 @@
+#ifndef OLED_ANIMATION_H
+#define OLED_ANIMATION_H
+
+#pragma once
+
+#include "oled_busestimator.h"
+
+#include <QByteArray>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class OledCArrayWriter;
+
+/**
+ * @brief 動畫 (一串影格) 的匯出格式與大小報告 (oledcore，只用到 QtCore)。
+ *
+ * 影格輸入為編輯器的硬體格式 (bufferSize() bytes，含填充欄位)。格式：
+ * - Independent：每個影格完整的可視頁面資料 (頁數 x width bytes)，固定大小，不需要位置表。
+ * - KeyframeXor：關鍵影格 (第 0 個與每 keyframeInterval 個) 為 PackBits，其他影格是和前一個影格
+ *   XOR 後的 PackBits (沒變的地方變成大片的 0)。每個影格都要送出整個畫面。
+ * - PageSkip：每個影格先是 (頁數 + 7) / 8 byte 的遮罩 (bit n = 第 n 頁有改變，LSB 先)，
+ *   接著每個改變的頁完整的 width bytes；只送改變的頁。
+ * - Patches：OledPatchEncoder 的 (頁, 欄位, bytes) 資料流，只送改變的範圍 (RAM 欄位，含 columnOffset)。
+ *
+ * 第 0 個影格在每種格式都是完整的畫面，循環播放時回到開頭不需要特別處理。
+ * 除了 Patches (以 ramPageWidth 為頁寬) 之外，韌體的畫面緩衝區都是可視範圍 (頁數 x width bytes)。
+ * 每個影格的編碼彼此獨立 (只需要前一個影格的原始內容)，影格多時以 QThreadPool 平行計算。
+ */
+class OledAnimationEncoder
+{
+public:
+    enum Mode {
+        Independent,
+        KeyframeXor,
+        PageSkip,
+        Patches
+    };
+
+    struct Options {
+        int keyframeInterval = 16;          // KeyframeXor：每幾個影格一個關鍵影格，0 表示只有第 0 個
+        OledBusEstimator::Bus bus;          // 送到面板的成本 (Patches 合併範圍時也用到)
+    };
+
+    /// 匯出的大小與每個影格送到面板的成本
+    struct Report {
+        Mode mode = Independent;
+        int frames = 0;
+        qint64 dataBytes = 0;
+        qint64 tableBytes = 0;              // 每個影格的起始位置表 (Independent 為 0)
+        OledBusEstimator::Cost first;       // 第 0 個影格 (整個畫面)
+        OledBusEstimator::Cost worst;       // 之後的影格中成本最高的一個 (只有一個影格時同 first)
+        int worstFrame = 0;
+        qint64 totalBusBytes = 0;           // 依序播放一次
+
+        qint64 flashBytes() const { return dataBytes + tableBytes; }    // 不含解碼函式
+    };
+
+    struct Result {
+        Report report;
+        std::vector<uint8_t> data;
+        std::vector<size_t> offsets;        // 每個影格在 data 中的起始位置 (Independent 為空)
+    };
+
+    static QString modeName(Mode mode);     // "independent"、"keyframe-xor"、"page-skip"、"patches"
+    static bool modeFromName(const QString& name, Mode* mode);
+    static std::vector<Mode> modes();
+
+    /**
+     * @brief 以指定的格式編碼整串影格。
+     *
+     * @return 影格是空的、大小不對，或面板不支援該格式 (Patches 需要 ramPageWidth <= 256) 時回傳 false。
+     */
+    static bool encode(Mode mode, const OledPanelGeometry& geometry, const std::vector<std::vector<uint8_t>>& frames,
+                       const Options& options, Result* result);
+
+    /// 所有支援的格式的報告 (依 modes() 的順序)
+    static std::vector<Report> compare(const OledPanelGeometry& geometry,
+                                       const std::vector<std::vector<uint8_t>>& frames, const Options& options);
+
+    /**
+     * @brief 選出格式：flash 放得下 (flashBudget 為 0 表示不限制) 的格式中，之後的影格送到面板最快的一個；
+     *        都放不下時選 flash 最小的。reports 是空的時回傳 Independent。
+     */
+    static Mode recommend(const std::vector<Report>& reports, qint64 flashBudget);
+
+    /// 主機端的參考解碼 (與 decoderSource() 的 C 程式碼相同)，依序解出每個影格 (硬體格式，填充欄位為 0)
+    static bool decode(const Result& result, const OledPanelGeometry& geometry, const Options& options,
+                       std::vector<std::vector<uint8_t>>* frames);
+
+    /// 該格式的 C 解碼函式 (Independent 為空)，以 #ifndef 保護，讀取資料經過 OLED_READ_BYTE(p)
+    static QByteArray decoderSource(Mode mode);
+
+    /**
+     * @brief 輸出解碼函式、說明與報告註解、巨集 (名稱_FRAME_COUNT、_FRAME_SIZE、_PAGE_COUNT、_PAGE_WIDTH，
+     *        KeyframeXor 另有 _KEYFRAME_INTERVAL)、資料與位置表 名稱_frames[]。
+     */
+    static void writeArrays(OledCArrayWriter* writer, const QByteArray& name, const Result& result,
+                            const OledPanelGeometry& geometry, const Options& options);
+};
+
+#endif // OLED_ANIMATION_H
@@ -0,0 +1,231 @@
+#include "oled_assetcatalog.h"
+#include "oled_assetio.h"
+#include "oled_carray.h"
+
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <cstring>
+
+namespace {
+
+// 最多快取幾個檔案的索引 (每個索引只有名稱與位置，很小)
+constexpr int kMaxCachedCatalogs = 32;
+
+QMutex g_cacheMutex;
+QHash<QString, std::shared_ptr<const OledAssetCatalog>> g_cache;
+
+// 內容雜湊：一次處理 8 個 byte 的 FNV-1a 變形，只用來判斷「內容是否和上次相同」
+quint64 hashContent(const char* data, size_t size)
+{
+    const quint64 prime = 0x100000001b3ULL;
+    quint64 hash = 0xcbf29ce484222325ULL ^ size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        quint64 word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ static_cast<uchar>(data[i])) * prime;
+    }
+    return hash;
+}
+
+// 不分大小寫地尋找 ASCII 關鍵字 (keyword 必須是小寫)
+bool containsKeyword(QLatin1String text, const char* keyword)
+{
+    const int length = static_cast<int>(std::strlen(keyword));
+    const char* data = text.data();
+    for (int i = 0; i + length <= text.size(); ++i) {
+        int j = 0;
+        while (j < length && (data[i + j] | 0x20) == keyword[j]) ++j;
+        if (j == length) {
+            return true;
+        }
+    }
+    return false;
+}
+
+OledAssetCatalog::Entry::Addressing addressingFromComment(QLatin1String comment)
+{
+    if (containsKeyword(comment, "horizontal")) {
+        return OledAssetCatalog::Entry::Horizontal;
+    }
+    if (containsKeyword(comment, "vertical") || containsKeyword(comment, "page")) {
+        return OledAssetCatalog::Entry::VerticalPages;
+    }
+    return OledAssetCatalog::Entry::UnknownAddressing;
+}
+
+// 巨集的值：16、(16)、0x10、16u 都可以，其他 (運算式、字串) 不算
+bool parseMacroNumber(QLatin1String value, int* number)
+{
+    QString text = QString(value).trimmed();
+    while (text.startsWith('(') && text.endsWith(')')) {
+        text = text.mid(1, text.size() - 2).trimmed();
+    }
+    while (!text.isEmpty() && (text.endsWith('u') || text.endsWith('U') || text.endsWith('l') || text.endsWith('L'))) {
+        text.chop(1);
+    }
+    bool ok = false;
+    *number = text.toInt(&ok, 0);
+    return ok && *number > 0;
+}
+
+QSize sizeFromDefines(const QHash<QString, int>& defines, const QString& name)
+{
+    if (defines.isEmpty() || name.isEmpty()) {
+        return QSize();
+    }
+
+    QStringList bases{name.toUpper()};
+    static const char* const kSuffixes[] = {"_BITS", "_DATA", "_BMP", "_BITMAP", "_IMG", "_IMAGE"};
+    for (const char* suffix : kSuffixes) {
+        if (bases.first().endsWith(QLatin1String(suffix))) {
+            bases << bases.first().left(bases.first().size() - static_cast<int>(std::strlen(suffix)));
+        }
+    }
+
+    for (const QString& base : bases) {
+        const int width = defines.value(base + "_WIDTH", defines.value(base + "_W"));
+        const int height = defines.value(base + "_HEIGHT", defines.value(base + "_H"));
+        if (width > 0 && height > 0) {
+            return QSize(width, height);
+        }
+    }
+    return QSize();
+}
+
+}
+
+std::vector<OledAssetCatalog::Entry> OledAssetCatalog::index(const char* data, size_t size)
+{
+    std::vector<Entry> entries;
+    QHash<QString, int> defines;    // 數值巨集，名稱轉成大寫
+
+    OledCArrayReader reader(data, size);
+    reader.setDefineHandler([&defines](QLatin1String name, QLatin1String value) {
+        int number = 0;
+        if (parseMacroNumber(value, &number)) {
+            defines.insert(QString(name).toUpper(), number);
+        }
+    });
+
+    OledCArrayReader::Array array;
+    while (reader.nextArray(&array)) {
+        // 只數值的個數，不保留資料
+        int count = 0;
+        uint8_t value;
+        while (reader.nextValue(&value)) {
+            ++count;
+        }
+        if (count == 0) {
+            continue;
+        }
+
+        Entry entry;
+        entry.name = QString(array.name);
+        entry.byteCount = count;
+        entry.declaredSize = array.declaredSize;
+        entry.offset = array.offset;
+        entry.addressing = addressingFromComment(array.comment);
+        entry.size = OledAssetIO::parseSizeHint(array.comment.data(), static_cast<size_t>(array.comment.size()));
+        if (!entry.size.isValid() && entries.empty()) {
+            // 第一個陣列：尺寸也可能寫在檔頭的註解裡
+            entry.size = OledAssetIO::parseSizeHint(data, array.offset);
+        }
+        if (!entry.size.isValid()) {
+            entry.size = sizeFromDefines(defines, entry.name);
+        }
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+std::vector<uint8_t> OledAssetCatalog::load(const char* data, size_t size, const Entry& entry)
+{
+    std::vector<uint8_t> values;
+    OledCArrayReader reader(data, size);
+    if (!reader.seekArray(entry.offset)) {
+        return values;
+    }
+    values.reserve(static_cast<size_t>(entry.byteCount));
+    reader.readValues(&values);
+    if (static_cast<int>(values.size()) != entry.byteCount) {
+        values.clear();     // 同一個位置剛好也是 '{'，但內容已經不同
+    }
+    return values;
+}
+
+std::shared_ptr<const OledAssetCatalog> OledAssetCatalog::open(const QString& path)
+{
+    const QFileInfo info(path);
+    const QString key = info.absoluteFilePath();
+    const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+    const qint64 fileSize = info.size();
+
+    std::shared_ptr<const OledAssetCatalog> cached;
+    {
+        QMutexLocker locker(&g_cacheMutex);
+        cached = g_cache.value(key);
+    }
+    if (cached && cached->m_modified == modified && cached->m_fileSize == fileSize) {
+        return cached;
+    }
+
+    const OledMappedFile file(key);
+    if (!file.isOpen()) {
+        return nullptr;
+    }
+    const quint64 hash = hashContent(file.data(), file.size());
+
+    std::shared_ptr<OledAssetCatalog> catalog(new OledAssetCatalog);
+    if (cached && cached->m_fileSize == static_cast<qint64>(file.size()) && cached->m_hash == hash) {
+        // 只有修改時間變了：沿用上次的項目
+        catalog->m_entries = cached->m_entries;
+    } else {
+        catalog->m_entries = index(file.data(), file.size());
+    }
+    catalog->m_path = key;
+    catalog->m_modified = modified;
+    catalog->m_fileSize = static_cast<qint64>(file.size());
+    catalog->m_hash = hash;
+
+    QMutexLocker locker(&g_cacheMutex);
+    if (!g_cache.contains(key) && g_cache.size() >= kMaxCachedCatalogs) {
+        g_cache.clear();
+    }
+    g_cache.insert(key, catalog);
+    return catalog;
+}
+
+void OledAssetCatalog::clearCache()
+{
+    QMutexLocker locker(&g_cacheMutex);
+    g_cache.clear();
+}
+
+int OledAssetCatalog::find(const QString& name) const
+{
+    for (int i = 0; i < count(); ++i) {
+        if (m_entries[static_cast<size_t>(i)].name == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+std::vector<uint8_t> OledAssetCatalog::load(int index) const
+{
+    if (index < 0 || index >= count()) {
+        return std::vector<uint8_t>();
+    }
+    const OledMappedFile file(m_path);
+    if (!file.isOpen() || static_cast<qint64>(file.size()) != m_fileSize) {
+        return std::vector<uint8_t>();
+    }
+    return load(file.data(), file.size(), m_entries[static_cast<size_t>(index)]);
+}
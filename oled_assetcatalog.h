@@ -0,0 +1,85 @@
+#ifndef OLED_ASSETCATALOG_H
+#define OLED_ASSETCATALOG_H
+
+#pragma once
+
+#include <QSize>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 素材標頭檔的索引 (oledcore，不依賴 Qt Widgets)。
+ *
+ * 一個 .h 裡常常放了幾十、幾百個圖示或整套動畫影格。開檔時只以 OledCArrayReader 掃描一次，
+ * 記下每個陣列的名稱、尺寸、定址方式與 '{' 的位置，不保留任何資料；
+ * 使用者選到某個素材時才以 load() 從記錄的位置讀出那一個陣列。
+ *
+ * 索引依檔案快取在記憶體中 (整個程式共用，可跨執行緒)：再次開啟時若修改時間與大小都沒變，
+ * 直接回傳上一次的索引；修改時間變了但內容的雜湊相同 (例如 git checkout、touch) 也不必重新掃描。
+ *
+ * 尺寸的來源依序為：
+ * 1. 陣列前面的註解，例如 "// Image Data (22x8 region at (0, 0))" (第一個陣列也會看檔頭的註解)。
+ * 2. 陣列之前的數值巨集：名稱_WIDTH / 名稱_HEIGHT 或 名稱_W / 名稱_H (不分大小寫，
+ *    名稱可以去掉 _bits、_data、_bmp、_bitmap、_img、_image 後綴)。
+ * 都沒有時 size 為無效，由呼叫端決定 (例如依面板的畫面大小判斷)。
+ */
+class OledAssetCatalog
+{
+public:
+    struct Entry {
+        enum Addressing {
+            UnknownAddressing,  // 註解沒有說明
+            VerticalPages,      // 註解含 "vertical" 或 "page" (SH1106 垂直頁面)
+            Horizontal          // 註解含 "horizontal" (每列 MSB first)
+        };
+
+        QString name;                       // 陣列名稱；純 hex 字串時為空
+        QSize size;                         // 由註解或巨集得知的尺寸，不知道時為無效
+        Addressing addressing = UnknownAddressing;
+        int byteCount = 0;                  // 實際的值個數
+        int declaredSize = -1;              // 宣告的大小 ([1024])，沒寫時為 -1
+        size_t offset = 0;                  // '{' 在檔案中的位置
+    };
+
+    /**
+     * @brief 取得檔案的索引：快取還有效時直接回傳，否則掃描一次並放進快取。
+     * @return 無法開啟檔案時回傳 nullptr；檔案裡沒有任何陣列時回傳沒有項目的索引。
+     */
+    static std::shared_ptr<const OledAssetCatalog> open(const QString& path);
+
+    /// 掃描一段資料，回傳其中每個有資料的陣列 (open() 的核心，也可用於剪貼簿等非檔案來源)。
+    static std::vector<Entry> index(const char* data, size_t size);
+
+    /// 從 index() 的來源資料中讀出一個陣列；entry 與資料對不上時回傳空的 vector。
+    static std::vector<uint8_t> load(const char* data, size_t size, const Entry& entry);
+
+    /// 清空快取 (測試與量測使用)。
+    static void clearCache();
+
+    const QString& path() const { return m_path; }
+    const std::vector<Entry>& entries() const { return m_entries; }
+    int count() const { return static_cast<int>(m_entries.size()); }
+
+    /// 依名稱尋找 (區分大小寫)，找不到時回傳 -1。
+    int find(const QString& name) const;
+
+    /**
+     * @brief 延遲載入：重新對映檔案，從索引記錄的位置讀出第 index 個陣列。
+     * @return 檔案在建立索引後被修改 (大小不同或位置對不上) 時回傳空的 vector，請重新 open()。
+     */
+    std::vector<uint8_t> load(int index) const;
+
+private:
+    OledAssetCatalog() = default;
+
+    QString m_path;                 // 絕對路徑
+    qint64 m_modified = 0;          // 建立索引時的修改時間 (ms since epoch)
+    qint64 m_fileSize = 0;
+    quint64 m_hash = 0;             // 檔案內容的雜湊
+    std::vector<Entry> m_entries;
+};
+
+#endif // OLED_ASSETCATALOG_H
@@ -0,0 +1,205 @@
+#include "oled_assetio.h"
+#include "oled_bitpack.h"
+#include "oled_carray.h"
+
+#include <QTransform>
+#include <cstring>
+
+std::vector<uint8_t> OledAssetIO::parseHexArray(const QString& text)
+{
+    // 只有 ASCII 有意義，註解裡的中文轉成 UTF-8 之後會被略過
+    const QByteArray bytes = text.toUtf8();
+    return parseHexArray(bytes.constData(), static_cast<size_t>(bytes.size()));
+}
+
+std::vector<uint8_t> OledAssetIO::parseHexArray(const char* data, size_t size)
+{
+    std::vector<uint8_t> bytes;
+    OledCArrayReader reader(data, size);
+    OledCArrayReader::Array array;
+    while (reader.nextArray(&array)) {
+        if (array.declaredSize > 0) {
+            bytes.reserve(static_cast<size_t>(array.declaredSize));
+        }
+        if (reader.readValues(&bytes) > 0) {
+            break;
+        }
+    }
+    return bytes;
+}
+
+QSize OledAssetIO::parseSizeHint(const QString& text)
+{
+    const QByteArray bytes = text.toUtf8();
+    return parseSizeHint(bytes.constData(), static_cast<size_t>(bytes.size()));
+}
+
+QSize OledAssetIO::parseSizeHint(const char* data, size_t size)
+{
+    // 尋找數字(寬) x 數字(高)，例如 "(22x8 region"：從每個 x 往回找寬度、往後找高度
+    const char* end = data + size;
+    for (const char* p = data; p < end; ++p) {
+        if (*p != 'x' && *p != 'X') {
+            continue;
+        }
+        // "0x12" 是 hex 常值不是尺寸
+        if (p > data && p[-1] == '0' && (p - 1 == data || p[-2] < '0' || p[-2] > '9')) {
+            continue;
+        }
+        const char* left = p;
+        while (left > data && (left[-1] == ' ' || left[-1] == '\t')) --left;
+        const char* widthEnd = left;
+        while (left > data && left[-1] >= '0' && left[-1] <= '9') --left;
+
+        const char* right = p + 1;
+        while (right < end && (*right == ' ' || *right == '\t')) ++right;
+        const char* heightBegin = right;
+        while (right < end && *right >= '0' && *right <= '9') ++right;
+
+        if (left < widthEnd && heightBegin < right) {
+            auto toInt = [](const char* begin, const char* end) {
+                int value = 0;
+                for (; begin < end; ++begin) value = value * 10 + (*begin - '0');
+                return value;
+            };
+            return QSize(toInt(left, widthEnd), toInt(heightBegin, right));
+        }
+    }
+    return QSize();
+}
+
+QImage OledAssetIO::decodeBitmap(std::vector<uint8_t> data, const QSize& size, bool horizontal)
+{
+    const int w = size.width();
+    const int h = size.height();
+    if (w <= 0 || h <= 0) {
+        return QImage();
+    }
+
+    QImage image(w, h, QImage::Format_Mono);
+    image.setColor(0, qRgb(0, 0, 0));
+    image.setColor(1, qRgb(255, 255, 255));
+    image.fill(0);
+
+    const int bytesPerRow = (w + 7) / 8;
+    const int pages = (h + 7) / 8;
+    const size_t needed = horizontal ? size_t(bytesPerRow) * h : size_t(w) * pages;
+    if (data.size() < needed) {
+        data.resize(needed, 0);
+    }
+
+    if (horizontal) {
+        // 水平模式是 MSB First，與 Format_Mono 的 scanLine 排列相同，整列直接複製
+        for (int y = 0; y < h; ++y) {
+            std::memcpy(image.scanLine(y), data.data() + y * bytesPerRow, bytesPerRow);
+        }
+    } else {
+        // 垂直頁面模式以 8x8 區塊轉置成 scanLine
+        OledBitPacker::pagesToRows(data.data(), w, w, h, OledBitPacker::MsbFirst,
+                                   image.bits(), static_cast<int>(image.bytesPerLine()));
+    }
+    return image;
+}
+
+namespace {
+
+// 預設的門檻值設定：直接交給 Qt 的 ThresholdDither，輸出與加入混色之前完全相同
+bool isPlainThreshold(const OledDither::Options& dither)
+{
+    return dither.method == OledDither::Threshold && dither.threshold == 128
+           && dither.gamma == 1.0 && dither.contrast == 1.0;
+}
+
+}
+
+QImage OledAssetIO::toLitMask(const QImage& image, bool invert, const OledDither::Options& dither)
+{
+    if (image.isNull()) {
+        return QImage();
+    }
+
+    if (!isPlainThreshold(dither)) {
+        OledDither::Options options = dither;
+        options.invert = invert;
+        return OledDither::dither(image, options);
+    }
+
+    QImage mono = image.convertToFormat(QImage::Format_Mono, Qt::ThresholdDither);
+
+    // Qt 產生的單色圖調色盤順序不固定，依亮度判斷索引 1 是否為「亮」
+    const bool indexOneIsBright = mono.colorCount() > 1 && qGray(mono.color(1)) > qGray(mono.color(0));
+    if (indexOneIsBright == invert) {
+        mono.invertPixels(QImage::InvertRgb);
+    }
+    mono.setColor(0, qRgb(0, 0, 0));
+    mono.setColor(1, qRgb(255, 255, 255));
+    return mono;
+}
+
+QImage OledAssetIO::transformForImport(const QImage& image, const QSize& targetSize, int rotation, bool invert,
+                                       const OledDither::Options& dither, const std::function<bool()>& cancelled)
+{
+    auto isCancelled = [&cancelled]() { return cancelled && cancelled(); };
+
+    if (image.isNull() || targetSize.isEmpty() || isCancelled()) {
+        return QImage();
+    }
+
+    // 1. 縮放
+    QImage processed = image.scaled(targetSize.width(), targetSize.height(), Qt::KeepAspectRatio,
+                                    Qt::SmoothTransformation);
+    if (processed.isNull() || isCancelled()) {
+        return QImage();
+    }
+
+    // 2. 旋轉
+    if (rotation != 0) {
+        QTransform transform;
+        transform.rotate(rotation);
+        processed = processed.transformed(transform);
+        if (processed.isNull() || isCancelled()) {
+            return QImage();
+        }
+    }
+
+    // 3. 反白 (在縮放與旋轉的結果上進行)
+    if (invert) {
+        processed.invertPixels(QImage::InvertRgb);
+        if (isCancelled()) {
+            return QImage();
+        }
+    }
+
+    // 4. 二值化
+    if (isPlainThreshold(dither)) {
+        return processed.convertToFormat(QImage::Format_Mono, Qt::ThresholdDither);
+    }
+
+    // 混色：維持 Qt 單色圖的約定 (索引 0 = 白、索引 1 = 黑)，所以讓暗的像素成為索引 1
+    OledDither::Options options = dither;
+    options.invert = true;
+    QImage mono = OledDither::dither(processed, options);
+    mono.setColor(0, qRgb(255, 255, 255));
+    mono.setColor(1, qRgb(0, 0, 0));
+    return mono;
+}
+
+QImage OledAssetIO::makePreviewProxy(const QImage& image, int maxSide)
+{
+    if (image.isNull() || maxSide <= 0 || (image.width() <= maxSide && image.height() <= maxSide)) {
+        return image;
+    }
+    return image.scaled(maxSide, maxSide, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+
+QString OledAssetIO::formatCArray(const QString& name, const std::vector<uint8_t>& data,
+                                  const QString& comment)
+{
+    QByteArray output;
+    {
+        OledCArrayWriter writer(&output);
+        writer.writeComment(comment.toUtf8());
+        writer.writeArray(name.toUtf8(), data.data(), data.size());
+    }
+    return QString::fromUtf8(output);
+}
@@ -0,0 +1,108 @@
+#ifndef OLED_ASSETIO_H
+#define OLED_ASSETIO_H
+
+#pragma once
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "oled_dither.h"
+
+/**
+ * @brief 圖檔 / C 陣列 (.h) 的讀取與輸出工具 (oledcore，不依賴 Qt Widgets)。
+ *
+ * 匯入對話框、模擬器與命令列工具 (oledcli) 共用同一套解析與輸出邏輯，
+ * 所有的函式都是無狀態的 (stateless)。
+ *
+ * 點亮像素的約定：本類別產生的單色圖 (Format_Mono) 一律是索引 1 = 點亮 (白色)、
+ * 索引 0 = 熄滅 (黑色)，可以直接交給 OledDataModel::convertLogicalToHardwareFormat()。
+ */
+class OledAssetIO
+{
+public:
+    /**
+     * @brief 從 C 陣列或純 hex 文字中取出第一個有資料的陣列 (語法見 OledCArrayReader)。
+     *
+     * 註解、陣列宣告裡的大小與識別字 (例如 image_2024) 都不會被當成資料；
+     * 支援 0x / 0b / 十進位常值，沒有大括號時視為純 hex 字串 ("FF A1 ...")。
+     */
+    static std::vector<uint8_t> parseHexArray(const QString& text);
+    static std::vector<uint8_t> parseHexArray(const char* data, size_t size);   // 例如 OledMappedFile
+
+    /**
+     * @brief 從註解中找出尺寸資訊，例如 "// Image Data (22x8 region at (0, 0))"。
+     *
+     * 取整段文字中第一個「數字 x 數字」(x 可大寫，前後可有空白)。
+     * @return 找不到時回傳無效的 QSize。
+     */
+    static QSize parseSizeHint(const QString& text);
+    static QSize parseSizeHint(const char* data, size_t size);
+
+    /**
+     * @brief 把 byte 資料還原成單色圖。
+     *
+     * @param data       來源資料，不足一整張圖的部分視為 0 (熄滅)。
+     * @param size       圖片尺寸，必須有效。
+     * @param horizontal true：水平定址 (每列 (w + 7) / 8 byte，MSB first)；
+     *                   false：垂直頁面定址 (每頁 w byte，bit0 在最上面，SH1106 格式)。
+     * @return 索引 1 = 點亮的 Format_Mono 圖片；尺寸無效時回傳空的 QImage。
+     */
+    static QImage decodeBitmap(std::vector<uint8_t> data, const QSize& size, bool horizontal);
+
+    /**
+     * @brief 把任意圖片轉成「索引 1 = 點亮」的單色圖。
+     *
+     * 以亮度判斷：亮的像素視為點亮 (與 GUI 匯入圖片時相同)。
+     *
+     * @param image  來源圖片，任何格式皆可。
+     * @param invert 是否反白 (暗的像素視為點亮)。
+     * @param dither 混色設定；預設為單純門檻值 (與 Qt 的 ThresholdDither 相同)，
+     *               其中的 invert 欄位會被參數 invert 取代。
+     */
+    static QImage toLitMask(const QImage& image, bool invert = false,
+                            const OledDither::Options& dither = OledDither::Options());
+
+    /**
+     * @brief 匯入圖片的轉換流程：縮放 -> 旋轉 -> 反白 -> 二值化 (匯入對話框使用)。
+     *
+     * 只用到可重入的 QImage 操作，可以在工作執行緒中呼叫。每個步驟開始前會先詢問 cancelled，
+     * 回傳 true 時立即停止，讓過時的預覽工作不必跑完整條流程。
+     *
+     * @param image      來源圖片。
+     * @param targetSize 縮放後的尺寸 (保持長寬比放進這個範圍，平滑縮放)。
+     * @param rotation   順時針旋轉的角度 (0、90、180、270)。
+     * @param invert     是否反白。
+     * @param dither     二值化的混色設定；預設為單純門檻值 (與 Qt 的 ThresholdDither 相同)。
+     * @param cancelled  取消檢查，可以是空的。
+     * @return Format_Mono 圖片，與 QImage::convertToFormat(Format_Mono) 相同的約定 (索引 1 = 暗的像素)；
+     *         被取消或失敗時回傳空的 QImage。
+     */
+    static QImage transformForImport(const QImage& image, const QSize& targetSize, int rotation, bool invert,
+                                     const OledDither::Options& dither = OledDither::Options(),
+                                     const std::function<bool()>& cancelled = std::function<bool()>());
+
+    /**
+     * @brief 產生預覽用的代理圖 (proxy)：長寬都縮到 maxSide 以內，本身夠小時直接回傳原圖。
+     *
+     * 大圖只需要縮一次，之後每次調整參數都以代理圖計算預覽。
+     */
+    static QImage makePreviewProxy(const QImage& image, int maxSide);
+
+    /**
+     * @brief 把 byte 資料格式化成 C 陣列文字 (每行 16 個 byte)。
+     *
+     * OledCArrayWriter 預設格式的簡便版；要直接寫入檔案或改變格式 (PROGMEM、尺寸巨集...) 請用 OledCArrayWriter。
+     *
+     * @param name    陣列名稱。
+     * @param data    資料。
+     * @param comment 放在陣列前面的單行註解 (不含 "// ")，空字串表示不輸出註解。
+     */
+    static QString formatCArray(const QString& name, const std::vector<uint8_t>& data,
+                                const QString& comment = QString());
+};
+
+#endif // OLED_ASSETIO_H
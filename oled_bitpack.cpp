@@ -0,0 +1,163 @@
+#include "oled_bitpack.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OLED_BITPACK_SSE2 1
+#endif
+
+namespace {
+
+inline uint64_t byteSwap64(uint64_t v)
+{
+    v = ((v & 0x00FF00FF00FF00FFull) << 8)  | ((v >> 8)  & 0x00FF00FF00FF00FFull);
+    v = ((v & 0x0000FFFF0000FFFFull) << 16) | ((v >> 16) & 0x0000FFFF0000FFFFull);
+    return (v << 32) | (v >> 32);
+}
+
+/**
+ * 一次轉置兩個相鄰的 8x8 區塊。
+ * SSE2：兩個區塊放進同一個 128-bit 暫存器，每次 movemask 取出 16 個 byte 的最高位元，
+ * 剛好是兩個區塊各一個輸出 byte，8 次就完成。沒有 SSE2 時退回兩次 transpose8x8()。
+ */
+inline void transposePair(uint64_t a, uint64_t b, uint64_t &ta, uint64_t &tb)
+{
+#ifdef OLED_BITPACK_SSE2
+    __m128i v = _mm_set_epi64x(static_cast<long long>(b), static_cast<long long>(a));
+    uint64_t outA = 0;
+    uint64_t outB = 0;
+    for (int j = 7; j >= 0; --j) {
+        // 此時每個 byte 的 bit7 是原本的 bit j
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(v));
+        outA |= uint64_t(mask & 0xFF) << (j * 8);
+        outB |= uint64_t(mask >> 8) << (j * 8);
+        v = _mm_slli_epi64(v, 1);
+    }
+    ta = outA;
+    tb = outB;
+#else
+    ta = OledBitPacker::transpose8x8(a);
+    tb = OledBitPacker::transpose8x8(b);
+#endif
+}
+
+// 從水平資料取出某一頁、某 8 欄的 8 個 byte (第 k 個 byte = 第 k 列)，超出高度的列補 0
+inline uint64_t gatherRows(const uint8_t* rows, int rowStride, int height, int page, int blockX)
+{
+    uint64_t block = 0;
+    const int y0 = page * 8;
+    const int count = (height - y0 < 8) ? height - y0 : 8;
+    for (int k = 0; k < count; ++k) {
+        block |= uint64_t(rows[(y0 + k) * rowStride + blockX]) << (k * 8);
+    }
+    return block;
+}
+
+// 把轉置結果寫到頁面：MSB first 時 bit j 是第 (7 - j) 欄，所以 byte 順序要反過來
+inline void storeColumns(uint64_t columns, OledBitPacker::BitOrder order, uint8_t* dst, int count)
+{
+    if (order == OledBitPacker::MsbFirst) {
+        columns = byteSwap64(columns);
+    }
+    for (int j = 0; j < count; ++j) {
+        dst[j] = static_cast<uint8_t>(columns >> (j * 8));
+    }
+}
+
+// 從頁面取出 8 欄 (超出寬度的欄補 0)，MSB first 時反向排列，轉置後每個 byte 就是一列
+inline uint64_t gatherColumns(const uint8_t* src, int count, OledBitPacker::BitOrder order)
+{
+    uint64_t block = 0;
+    for (int j = 0; j < count; ++j) {
+        block |= uint64_t(src[j]) << (j * 8);
+    }
+    return order == OledBitPacker::MsbFirst ? byteSwap64(block) : block;
+}
+
+inline void storeRows(uint64_t block, uint8_t* rows, int rowStride, int height, int page, int blockX)
+{
+    const int y0 = page * 8;
+    const int count = (height - y0 < 8) ? height - y0 : 8;
+    for (int k = 0; k < count; ++k) {
+        rows[(y0 + k) * rowStride + blockX] = static_cast<uint8_t>(block >> (k * 8));
+    }
+}
+
+}
+
+uint64_t OledBitPacker::transpose8x8(uint64_t x)
+{
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAull;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCull;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ull;
+    x ^= t ^ (t << 28);
+    return x;
+}
+
+void OledBitPacker::rowsToPages(const uint8_t* rows, int rowStride, int width, int height,
+                                BitOrder order, uint8_t* pages, int pageStride)
+{
+    if (!rows || !pages || width <= 0 || height <= 0) {
+        return;
+    }
+
+    const int pageCount = (height + 7) / 8;
+    const int fullBlocks = width / 8;
+    const int tail = width % 8;
+
+    for (int page = 0; page < pageCount; ++page) {
+        uint8_t* dst = pages + page * pageStride;
+
+        int bx = 0;
+        for (; bx + 1 < fullBlocks; bx += 2) {
+            uint64_t a, b;
+            transposePair(gatherRows(rows, rowStride, height, page, bx),
+                          gatherRows(rows, rowStride, height, page, bx + 1), a, b);
+            storeColumns(a, order, dst + bx * 8, 8);
+            storeColumns(b, order, dst + bx * 8 + 8, 8);
+        }
+        for (; bx < fullBlocks; ++bx) {
+            storeColumns(transpose8x8(gatherRows(rows, rowStride, height, page, bx)),
+                         order, dst + bx * 8, 8);
+        }
+        if (tail) {
+            storeColumns(transpose8x8(gatherRows(rows, rowStride, height, page, fullBlocks)),
+                         order, dst + fullBlocks * 8, tail);
+        }
+    }
+}
+
+void OledBitPacker::pagesToRows(const uint8_t* pages, int pageStride, int width, int height,
+                                BitOrder order, uint8_t* rows, int rowStride)
+{
+    if (!pages || !rows || width <= 0 || height <= 0) {
+        return;
+    }
+
+    const int pageCount = (height + 7) / 8;
+    const int fullBlocks = width / 8;
+    const int tail = width % 8;
+
+    for (int page = 0; page < pageCount; ++page) {
+        const uint8_t* src = pages + page * pageStride;
+
+        int bx = 0;
+        for (; bx + 1 < fullBlocks; bx += 2) {
+            uint64_t a, b;
+            transposePair(gatherColumns(src + bx * 8, 8, order),
+                          gatherColumns(src + bx * 8 + 8, 8, order), a, b);
+            storeRows(a, rows, rowStride, height, page, bx);
+            storeRows(b, rows, rowStride, height, page, bx + 1);
+        }
+        for (; bx < fullBlocks; ++bx) {
+            storeRows(transpose8x8(gatherColumns(src + bx * 8, 8, order)),
+                      rows, rowStride, height, page, bx);
+        }
+        if (tail) {
+            storeRows(transpose8x8(gatherColumns(src + fullBlocks * 8, tail, order)),
+                      rows, rowStride, height, page, fullBlocks);
+        }
+    }
+}
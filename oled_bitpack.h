@@ -0,0 +1,60 @@
+#ifndef OLED_BITPACK_H
+#define OLED_BITPACK_H
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief 水平 (逐列) 與垂直 (SH1106 頁面) 兩種位元排列之間的轉換工具。
+ *
+ * - 水平定址 (Horizontal)：一個 byte 代表同一列上相鄰的 8 個像素，
+ *   每列佔 (width + 7) / 8 個 byte，例如 QImage::Format_Mono 的 scanLine()。
+ * - 垂直定址 (Vertical / Page)：一個 byte 代表同一欄上相鄰的 8 個像素，
+ *   bit0 在最上方，每頁佔 width 個 byte (SH1106 的 GDDRAM 格式)。
+ *
+ * 兩者互轉就是 8x8 位元矩陣轉置，這裡一次處理一整個 8x8 區塊，
+ * 取代逐像素呼叫 pixelIndex()/setPixel() 的寫法。
+ * 所有的函式都是無狀態的 (stateless)。
+ */
+class OledBitPacker
+{
+public:
+    /// 水平定址時，byte 內像素的排列順序
+    enum BitOrder {
+        MsbFirst, ///< 最高位元在最左邊 (QImage::Format_Mono、大部分取模軟體的水平模式)
+        LsbFirst  ///< 最低位元在最左邊 (QImage::Format_MonoLSB)
+    };
+
+    /**
+     * @brief 轉置一個 8x8 位元矩陣。
+     *
+     * 輸入的第 k 個 byte (little-endian) 的 bit j，會成為輸出第 j 個 byte 的 bit k。
+     * 使用三輪遮罩交換 (2x2 -> 4x4 -> 8x8 區塊)，不需要任何迴圈或分支。
+     */
+    static uint64_t transpose8x8(uint64_t block);
+
+    /**
+     * @brief 水平定址 -> 垂直定址 (頁面)。
+     *
+     * @param rows       來源資料，第 y 列從 rows + y * rowStride 開始。
+     * @param rowStride  來源每列的 byte 數 (QImage 請傳 bytesPerLine())。
+     * @param width      圖片寬度 (像素)。
+     * @param height     圖片高度 (像素)，最後一頁不足 8 列時以 0 補齊。
+     * @param order      來源 byte 內的像素順序。
+     * @param pages      目標緩衝區，第 p 頁從 pages + p * pageStride 開始，需至少 (height + 7) / 8 頁。
+     * @param pageStride 目標每頁的 byte 數，至少要有 width。
+     */
+    static void rowsToPages(const uint8_t* rows, int rowStride, int width, int height,
+                            BitOrder order, uint8_t* pages, int pageStride);
+
+    /**
+     * @brief 垂直定址 (頁面) -> 水平定址。
+     *
+     * 參數意義與 rowsToPages() 相同、方向相反。每列最後一個 byte 超出 width 的位元會被清為 0。
+     */
+    static void pagesToRows(const uint8_t* pages, int pageStride, int width, int height,
+                            BitOrder order, uint8_t* rows, int rowStride);
+};
+
+#endif // OLED_BITPACK_H
@@ -0,0 +1,153 @@
+#include "oled_busestimator.h"
+#include "oled_datamodel.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr int kAddressCommandBytes = 3;     // B0+頁、欄位低 4 位元、欄位高 4 位元
+constexpr int kI2cHeaderBytes = 2;          // 從機位址 + 控制 byte
+constexpr int kStartStopClocks = 2;
+
+void addWindow(OledBusEstimator::Cost* cost, int width, const OledBusEstimator::Bus& bus)
+{
+    cost->commandBytes += kAddressCommandBytes;
+    cost->dataBytes += width;
+    if (bus.kind == OledBusEstimator::Bus::Spi) {
+        cost->clocks += 8LL * (kAddressCommandBytes + width);
+        return;
+    }
+
+    // 指令一次傳輸；資料依 maxPayload (扣掉控制 byte) 分段，每段都要再送位址與控制 byte
+    // maxPayload 為 2 時每段只有 1 個資料 byte；0 (或只放得下控制 byte 的 1) 視為不限制
+    const int perChunk = bus.maxPayload > 1 ? bus.maxPayload - 1 : std::max(width, 1);
+    const int chunks = (width + perChunk - 1) / perChunk;
+    const int transactions = 1 + chunks;
+    const qint64 overhead = qint64(kI2cHeaderBytes) * transactions;
+    cost->overheadBytes += overhead;
+    cost->transactions += transactions;
+    cost->clocks += 9LL * (kAddressCommandBytes + width + overhead) + qint64(kStartStopClocks) * transactions;
+}
+
+qint64 windowClocks(int width, const OledBusEstimator::Bus& bus)
+{
+    OledBusEstimator::Cost cost;
+    addWindow(&cost, width, bus);
+    return cost.clocks;
+}
+
+void finish(OledBusEstimator::Cost* cost, const OledBusEstimator::Bus& bus)
+{
+    cost->seconds = bus.clockHz > 0 ? double(cost->clocks) / double(bus.clockHz) : 0.0;
+}
+
+}
+
+OledBusEstimator::Cost OledBusEstimator::cost(const Window& window, const Bus& bus)
+{
+    Cost result;
+    addWindow(&result, window.width(), bus);
+    finish(&result, bus);
+    return result;
+}
+
+OledBusEstimator::Cost OledBusEstimator::cost(const std::vector<Window>& windows, const Bus& bus)
+{
+    Cost result;
+    for (const Window& window : windows) {
+        addWindow(&result, window.width(), bus);
+    }
+    finish(&result, bus);
+    return result;
+}
+
+std::vector<OledBusEstimator::Window> OledBusEstimator::fullFrame(const OledPanelGeometry& geometry)
+{
+    std::vector<Window> windows;
+    windows.reserve(static_cast<size_t>(geometry.pageCount()));
+    for (int page = 0; page < geometry.pageCount(); ++page) {
+        windows.push_back(Window{page, geometry.columnOffset, geometry.columnOffset + geometry.width - 1});
+    }
+    return windows;
+}
+
+std::vector<OledBusEstimator::Window> OledBusEstimator::diff(const OledPanelGeometry& geometry, const uint8_t* before,
+                                                             const uint8_t* after, const Bus& bus)
+{
+    if (!before) {
+        return fullFrame(geometry);
+    }
+
+    std::vector<Window> windows;
+    const int first = geometry.columnOffset;
+    const int end = geometry.columnOffset + geometry.width;
+    for (int page = 0; page < geometry.pageCount(); ++page) {
+        const uint8_t* a = before + page * geometry.ramPageWidth;
+        const uint8_t* b = after + page * geometry.ramPageWidth;
+        bool open = false;
+        Window current{page, 0, -1};
+
+        int column = first;
+        while (column < end) {
+            if (a[column] == b[column]) {
+                ++column;
+                continue;
+            }
+            // 一段連續改變的欄位
+            const int runStart = column;
+            while (column < end && a[column] != b[column]) ++column;
+            const int runEnd = column - 1;
+
+            if (open) {
+                // 重送中間沒變的 byte 比另開一段便宜時合併
+                const qint64 merged = windowClocks(runEnd - current.firstColumn + 1, bus);
+                const qint64 separate = windowClocks(current.width(), bus) + windowClocks(runEnd - runStart + 1, bus);
+                if (merged <= separate) {
+                    current.lastColumn = runEnd;
+                    continue;
+                }
+                windows.push_back(current);
+            }
+            current = Window{page, runStart, runEnd};
+            open = true;
+        }
+        if (open) {
+            windows.push_back(current);
+        }
+    }
+    return windows;
+}
+
+OledBusEstimator::Plan OledBusEstimator::plan(const OledPanelGeometry& geometry, const uint8_t* before,
+                                              const uint8_t* after, const Bus& bus)
+{
+    Plan result;
+    result.windows = diff(geometry, before, after, bus);
+    result.partial = cost(result.windows, bus);
+    result.full = cost(fullFrame(geometry), bus);
+
+    for (const Window& window : result.windows) {
+        result.dirtyPages |= 1u << window.page;
+    }
+    if (!before) {
+        result.changedBytes = geometry.visibleBufferSize();
+        return result;
+    }
+    for (int page = 0; page < geometry.pageCount(); ++page) {
+        const int offset = page * geometry.ramPageWidth + geometry.columnOffset;
+        for (int x = 0; x < geometry.width; ++x) {
+            result.changedBytes += before[offset + x] != after[offset + x];
+        }
+    }
+    return result;
+}
+
+OledBusEstimator::Plan OledBusEstimator::plan(const OledDataModel& before, const OledDataModel& after, const Bus& bus)
+{
+    const std::vector<uint8_t> afterBuffer = after.getHardwareBuffer();
+    if (before.geometry() != after.geometry()) {
+        return plan(after.geometry(), nullptr, afterBuffer.data(), bus);
+    }
+    const std::vector<uint8_t> beforeBuffer = before.getHardwareBuffer();
+    return plan(after.geometry(), beforeBuffer.data(), afterBuffer.data(), bus);
+}
@@ -0,0 +1,97 @@
+#ifndef OLED_BUSESTIMATOR_H
+#define OLED_BUSESTIMATOR_H
+
+#pragma once
+
+#include "oled_panel.h"
+
+#include <cstdint>
+#include <vector>
+
+class OledDataModel;
+
+/**
+ * @brief 畫面更新的匯流排頻寬與傳輸時間估計 (oledcore，不依賴 Qt Widgets)。
+ *
+ * 比較兩個畫面 (裝置上目前的內容與新的內容)，找出需要重送的頁與欄位範圍 (Window)，
+ * 再依匯流排 (I2C / SPI、時脈、每次傳輸的 byte 上限) 算出 byte 數與傳輸時間，
+ * 和整個畫面重送比較，決定要局部更新還是全畫面更新。
+ *
+ * 每個 Window 以 SH1106 的頁定址送出：指令 B0+頁、欄位低 4 位元、欄位高 4 位元 (3 byte)，接著是資料。
+ * - SPI：每個 byte 8 個時脈，D/C 與 CS 的切換不計時間。
+ * - I2C：每個 byte 9 個時脈 (含 ACK)；每次傳輸另有從機位址、控制 byte (0x00 指令 / 0x40 資料)
+ *   與 START / STOP (約 2 個時脈)。指令一次傳輸，資料依 maxPayload 分成多次傳輸。
+ *
+ * 同一頁中兩段改變的欄位之間，重送中間沒變的 byte 比另開一個 Window 便宜時會合併成一段。
+ * 只比較可視區域 (columnOffset 起的 width 欄)，填充欄位永遠不送。
+ */
+class OledBusEstimator
+{
+public:
+    struct Bus {
+        enum Kind {
+            I2c,
+            Spi
+        };
+        Kind kind = I2c;
+        int clockHz = 400000;
+        int maxPayload = 0;     // I2C 每次傳輸位址之後最多幾個 byte (含控制 byte)，0 表示不限制；Arduino Wire 為 32
+
+        static Bus i2c(int clockHz, int maxPayload = 0) { return Bus{I2c, clockHz, maxPayload}; }
+        static Bus spi(int clockHz) { return Bus{Spi, clockHz, 0}; }
+    };
+
+    /// 一段連續的更新：第 page 頁的 RAM 欄位 firstColumn..lastColumn (含 columnOffset)
+    struct Window {
+        int page = 0;
+        int firstColumn = 0;
+        int lastColumn = -1;
+
+        int width() const { return lastColumn - firstColumn + 1; }
+    };
+
+    struct Cost {
+        qint64 commandBytes = 0;    // 定址指令
+        qint64 dataBytes = 0;
+        qint64 overheadBytes = 0;   // I2C 的位址與控制 byte
+        int transactions = 0;       // I2C 的 START ... STOP 次數 (SPI 為 0)
+        qint64 clocks = 0;          // 匯流排時脈數
+        double seconds = 0.0;
+
+        qint64 busBytes() const { return commandBytes + dataBytes + overheadBytes; }
+    };
+
+    struct Plan {
+        std::vector<Window> windows;    // 局部更新要送的範圍 (依頁、欄位排序)
+        quint32 dirtyPages = 0;         // 有改變的頁 (bit n = 第 n 頁)
+        int changedBytes = 0;           // 內容不同的 byte 數
+        Cost partial;                   // 只送 windows
+        Cost full;                      // 整個畫面 (每頁的可視欄位)
+
+        bool preferFull() const { return full.clocks <= partial.clocks; }
+        const Cost& best() const { return preferFull() ? full : partial; }
+    };
+
+    /**
+     * @brief 比較兩個畫面，算出局部更新與全畫面更新的成本。
+     *
+     * @param before 裝置上目前的內容 (bufferSize() bytes)；nullptr 表示未知，所有可視的頁都要送。
+     * @param after  新的內容 (bufferSize() bytes)。
+     */
+    static Plan plan(const OledPanelGeometry& geometry, const uint8_t* before, const uint8_t* after, const Bus& bus);
+
+    /// 以兩個資料模型 (合成後的畫面) 比較；幾何不同時視為 before 未知
+    static Plan plan(const OledDataModel& before, const OledDataModel& after, const Bus& bus);
+
+    /// 只找出改變的範圍 (已依 bus 的成本合併)
+    static std::vector<Window> diff(const OledPanelGeometry& geometry, const uint8_t* before, const uint8_t* after,
+                                    const Bus& bus);
+
+    /// 整個畫面：每頁一段，從 columnOffset 起的 width 欄
+    static std::vector<Window> fullFrame(const OledPanelGeometry& geometry);
+
+    static Cost cost(const std::vector<Window>& windows, const Bus& bus);
+    static Cost cost(const Window& window, const Bus& bus);
+};
+
+#endif // OLED_BUSESTIMATOR_H
@@ -0,0 +1,752 @@
+#include "oled_carray.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline bool isIdentifierStart(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+inline bool isIdentifierChar(char c)
+{
+    return isIdentifierStart(c) || isDigit(c);
+}
+
+// 每個 byte 的兩個 hex 字元 (大寫與小寫)，編譯時就算好
+struct HexTable {
+    char upper[512];
+    char lower[512];
+    constexpr HexTable() : upper(), lower()
+    {
+        const char digitsUpper[] = "0123456789ABCDEF";
+        const char digitsLower[] = "0123456789abcdef";
+        for (int i = 0; i < 256; ++i) {
+            upper[i * 2] = digitsUpper[i >> 4];
+            upper[i * 2 + 1] = digitsUpper[i & 15];
+            lower[i * 2] = digitsLower[i >> 4];
+            lower[i * 2 + 1] = digitsLower[i & 15];
+        }
+    }
+};
+constexpr HexTable kHexTable;
+
+// 輸出到 QIODevice 時每次寫出的大小，以及一次格式化的值個數
+constexpr int kWriterChunkSize = 64 * 1024;
+constexpr size_t kWriterBlockValues = 4096;
+constexpr size_t kWriterCellSize = 8;
+
+// 十六進位字母的值，不是的話回傳 -1
+inline int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+}
+
+OledCArrayReader::OledCArrayReader(const char* data, size_t size)
+    : m_begin(data), m_p(data), m_end(data ? data + size : data)
+{
+    // 完全沒有大括號：整段視為純 hex 字串
+    m_bare = data && size > 0 && std::memchr(data, '{', size) == nullptr;
+}
+
+OledCArrayReader::OledCArrayReader(const QByteArray& data)
+    : OledCArrayReader(data.constData(), static_cast<size_t>(data.size()))
+{
+}
+
+bool OledCArrayReader::skipTrivia(bool rememberComments)
+{
+    while (m_p < m_end) {
+        const char c = *m_p;
+        if (isSpace(c)) {
+            ++m_p;
+            continue;
+        }
+        if (c != '/' || m_p + 1 >= m_end) {
+            return true;
+        }
+
+        const char* start = m_p;
+        if (m_p[1] == '/') {
+            skipLine();
+        } else if (m_p[1] == '*') {
+            const char* close = m_p + 2;
+            while (close + 1 < m_end && !(close[0] == '*' && close[1] == '/')) ++close;
+            m_p = (close + 1 < m_end) ? close + 2 : m_end;
+        } else {
+            return true;
+        }
+        if (rememberComments) {
+            m_comment = start;
+            m_commentLength = static_cast<size_t>(m_p - start);
+        }
+    }
+    return false;
+}
+
+void OledCArrayReader::skipLine()
+{
+    while (m_p < m_end && *m_p != '\n') {
+        // 行尾的 '\' 代表下一行接續 (巨集)
+        if (*m_p == '\\' && m_p + 1 < m_end && (m_p[1] == '\n' || m_p[1] == '\r')) {
+            m_p += (m_p[1] == '\r' && m_p + 2 < m_end && m_p[2] == '\n') ? 3 : 2;
+            continue;
+        }
+        ++m_p;
+    }
+}
+
+void OledCArrayReader::skipQuoted(char quote)
+{
+    ++m_p;
+    while (m_p < m_end && *m_p != quote && *m_p != '\n') {
+        m_p += (*m_p == '\\' && m_p + 1 < m_end) ? 2 : 1;
+    }
+    if (m_p < m_end && *m_p == quote) ++m_p;
+}
+
+bool OledCArrayReader::nextArray(Array* array)
+{
+    if (m_bare) {
+        // 純 hex 字串只有一個陣列
+        if (m_bareStarted) {
+            m_p = m_end;
+            return false;
+        }
+        m_bareStarted = true;
+        if (array) {
+            *array = Array();
+            array->comment = QLatin1String(m_comment, static_cast<int>(m_commentLength));
+        }
+        return true;
+    }
+
+    // 目前的陣列沒讀完：略過剩下的值
+    uint8_t ignored;
+    while (m_depth > 0 && nextValue(&ignored)) {
+    }
+
+    // 在敘述層級尋找 "= {"，途中記下最後一個識別字與 [] 裡的大小。
+    // 前面沒有 '=' 的大括號 (函式本體、namespace、struct、extern "C") 不是陣列，只當作敘述的分界
+    const char* identifier = nullptr;
+    int identifierLength = 0;
+    const char* name = nullptr;
+    int nameLength = 0;
+    int declaredSize = -1;
+    int dimensions = 0;
+    bool assigned = false;
+    auto resetStatement = [&]() {
+        identifier = nullptr;
+        identifierLength = 0;
+        name = nullptr;
+        nameLength = 0;
+        declaredSize = -1;
+        dimensions = 0;
+        assigned = false;
+    };
+
+    while (skipTrivia(true)) {
+        const char c = *m_p;
+        if (isIdentifierStart(c)) {
+            identifier = m_p;
+            while (m_p < m_end && isIdentifierChar(*m_p)) ++m_p;
+            identifierLength = static_cast<int>(m_p - identifier);
+        } else if (c == '[') {
+            // 第一個 [] 前的識別字就是陣列名稱 (PROGMEM 等修飾字可以在前或在後)
+            if (!name) {
+                name = identifier;
+                nameLength = identifierLength;
+            }
+            ++m_p;
+            skipTrivia(false);
+            int size = -1;
+            if (m_p < m_end && isDigit(*m_p)) {
+                size = 0;
+                while (m_p < m_end && isDigit(*m_p)) size = size * 10 + (*m_p++ - '0');
+                while (m_p < m_end && isIdentifierChar(*m_p)) ++m_p;   // 10u 之類的後綴
+                skipTrivia(false);
+                if (m_p >= m_end || *m_p != ']') size = -1;             // 不是單純的數字 (例如 128 * 8)
+            }
+            while (m_p < m_end && *m_p != ']') ++m_p;
+            if (m_p < m_end) ++m_p;
+            // 二維陣列 [8][16] 的大小相乘
+            if (dimensions++ == 0) {
+                declaredSize = size;
+            } else {
+                declaredSize = (declaredSize < 0 || size < 0) ? -1 : declaredSize * size;
+            }
+        } else if (c == '=') {
+            // 只算單獨的 '='，"==" "<=" "!=" 之類的比較不算
+            const bool compound = (m_p + 1 < m_end && m_p[1] == '=')
+                                  || (m_p > m_begin && std::strchr("=!<>+-*/%&|^", m_p[-1]) != nullptr);
+            assigned = assigned || !compound;
+            m_p += (m_p + 1 < m_end && m_p[1] == '=') ? 2 : 1;
+        } else if (c == '{' && !assigned) {
+            resetStatement();
+            ++m_p;
+        } else if (c == '{') {
+            if (array) {
+                array->name = name ? QLatin1String(name, nameLength) : QLatin1String(identifier, identifierLength);
+                array->declaredSize = declaredSize;
+                array->comment = QLatin1String(m_comment, static_cast<int>(m_commentLength));
+                array->offset = static_cast<size_t>(m_p - m_begin);
+            }
+            ++m_p;
+            m_depth = 1;
+            m_comment = nullptr;
+            m_commentLength = 0;
+            return true;
+        } else if (c == ';' || c == '}') {
+            resetStatement();
+            ++m_p;
+        } else if (c == '#') {
+            if (m_defineHandler) {
+                reportDefine();
+            }
+            skipLine();
+        } else if (c == '"' || c == '\'') {
+            skipQuoted(c);
+        } else {
+            ++m_p;
+        }
+    }
+    return false;
+}
+
+void OledCArrayReader::reportDefine() const
+{
+    const char* p = m_p + 1;
+    auto skipBlanks = [&]() {
+        while (p < m_end && (*p == ' ' || *p == '\t')) ++p;
+    };
+    skipBlanks();
+    static const char kDefine[] = "define";
+    const size_t keywordLength = sizeof(kDefine) - 1;
+    if (static_cast<size_t>(m_end - p) <= keywordLength || std::memcmp(p, kDefine, keywordLength) != 0
+        || (p[keywordLength] != ' ' && p[keywordLength] != '\t')) {
+        return;
+    }
+    p += keywordLength;
+    skipBlanks();
+
+    const char* name = p;
+    while (p < m_end && isIdentifierChar(*p)) ++p;
+    if (p == name || !isIdentifierStart(*name) || (p < m_end && *p == '(')) {
+        return;     // 帶參數的巨集
+    }
+    const int nameLength = static_cast<int>(p - name);
+    skipBlanks();
+
+    const char* value = p;
+    while (p < m_end && *p != '\n' && *p != '\r') {
+        if (*p == '/' && p + 1 < m_end && (p[1] == '/' || p[1] == '*')) break;   // 行尾註解
+        ++p;
+    }
+    while (p > value && (p[-1] == ' ' || p[-1] == '\t')) --p;
+    m_defineHandler(QLatin1String(name, nameLength), QLatin1String(value, static_cast<int>(p - value)));
+}
+
+bool OledCArrayReader::readNumber(uint32_t* value)
+{
+    uint32_t result = 0;
+    if (*m_p == '0' && m_p + 1 < m_end && (m_p[1] == 'x' || m_p[1] == 'X')) {
+        m_p += 2;
+        int digit;
+        while (m_p < m_end && ((digit = hexValue(*m_p)) >= 0 || *m_p == '\'')) {
+            if (*m_p != '\'') result = (result << 4) | static_cast<uint32_t>(digit);
+            ++m_p;
+        }
+    } else if (*m_p == '0' && m_p + 1 < m_end && (m_p[1] == 'b' || m_p[1] == 'B')) {
+        m_p += 2;
+        while (m_p < m_end && (*m_p == '0' || *m_p == '1' || *m_p == '\'')) {
+            if (*m_p != '\'') result = (result << 1) | static_cast<uint32_t>(*m_p - '0');
+            ++m_p;
+        }
+    } else if (*m_p == '0') {
+        // C 的八進位 (單獨一個 0 也走這裡)
+        ++m_p;
+        while (m_p < m_end && ((*m_p >= '0' && *m_p <= '7') || *m_p == '\'')) {
+            if (*m_p != '\'') result = (result << 3) | static_cast<uint32_t>(*m_p - '0');
+            ++m_p;
+        }
+    } else {
+        while (m_p < m_end && (isDigit(*m_p) || *m_p == '\'')) {
+            if (*m_p != '\'') result = result * 10 + static_cast<uint32_t>(*m_p - '0');
+            ++m_p;
+        }
+    }
+    // 後綴 (u、UL...) 或不合法的尾巴一併略過
+    while (m_p < m_end && isIdentifierChar(*m_p)) ++m_p;
+
+    *value = result;
+    return true;
+}
+
+template <typename T>
+bool OledCArrayReader::readValue(T* value)
+{
+    if (m_bare) {
+        uint8_t byte = 0;
+        if (!m_bareStarted || !nextBareValue(&byte)) {
+            return false;
+        }
+        *value = byte;
+        return true;
+    }
+
+    bool negative = false;
+    while (m_depth > 0 && skipTrivia(false)) {
+        const char c = *m_p;
+        if (isDigit(c)) {
+            uint32_t number = 0;
+            readNumber(&number);
+            *value = static_cast<T>(negative ? 0u - number : number);
+            return true;
+        }
+        if (isIdentifierStart(c)) {
+            const char* start = m_p;
+            while (m_p < m_end && isIdentifierChar(*m_p)) ++m_p;
+            // 剛好兩個十六進位字母 (FF、A1) 視為省略 0x 的 hex，其他識別字 (型別轉換、巨集) 略過
+            if (m_p - start == 2 && hexValue(start[0]) >= 0 && hexValue(start[1]) >= 0) {
+                const uint32_t number = static_cast<uint32_t>((hexValue(start[0]) << 4) | hexValue(start[1]));
+                *value = static_cast<T>(negative ? 0u - number : number);
+                return true;
+            }
+            continue;
+        }
+        switch (c) {
+        case '{':
+            ++m_depth;
+            break;
+        case '}':
+            --m_depth;
+            break;
+        case '-':
+            negative = !negative;
+            break;
+        case ',':
+            negative = false;
+            break;
+        case '"':
+        case '\'':
+            skipQuoted(c);
+            continue;
+        case '#':
+            skipLine();
+            continue;
+        default:
+            break;
+        }
+        ++m_p;
+    }
+    m_depth = 0;
+    return false;
+}
+
+bool OledCArrayReader::nextValue(uint8_t* value)
+{
+    return readValue(value);
+}
+
+bool OledCArrayReader::nextValue(uint32_t* value)
+{
+    return readValue(value);
+}
+
+bool OledCArrayReader::nextBareValue(uint8_t* value)
+{
+    while (true) {
+        // 還在一串連續的 hex 字母中：每兩個字母一個 byte，落單的最後一個字母丟掉
+        if (m_runEnd) {
+            if (m_runEnd - m_p >= 2) {
+                *value = static_cast<uint8_t>((hexValue(m_p[0]) << 4) | hexValue(m_p[1]));
+                m_p += 2;
+                return true;
+            }
+            m_p = m_runEnd;
+            m_runEnd = nullptr;
+        }
+
+        if (!skipTrivia(false)) {
+            return false;
+        }
+
+        const char c = *m_p;
+        if (c == '0' && m_p + 1 < m_end && (m_p[1] == 'x' || m_p[1] == 'X')) {
+            uint32_t wide = 0;
+            readNumber(&wide);
+            *value = static_cast<uint8_t>(wide);
+            return true;
+        }
+        if (isIdentifierChar(c)) {
+            // 整個 token 都是 hex 字母才算數 (例如 "FFA1")，其他文字 (image_2024) 整個略過
+            const char* start = m_p;
+            bool allHex = true;
+            while (m_p < m_end && isIdentifierChar(*m_p)) {
+                allHex = allHex && hexValue(*m_p) >= 0;
+                ++m_p;
+            }
+            if (allHex) {
+                m_runEnd = m_p;
+                m_p = start;
+            }
+            continue;
+        }
+        ++m_p;
+    }
+}
+
+size_t OledCArrayReader::readValues(std::vector<uint8_t>* out)
+{
+    const size_t before = out->size();
+    uint8_t value;
+    while (nextValue(&value)) {
+        out->push_back(value);
+    }
+    return out->size() - before;
+}
+
+size_t OledCArrayReader::readValues(std::vector<uint32_t>* out)
+{
+    const size_t before = out->size();
+    uint32_t value;
+    while (nextValue(&value)) {
+        out->push_back(value);
+    }
+    return out->size() - before;
+}
+
+bool OledCArrayReader::seekArray(size_t offset)
+{
+    m_runEnd = nullptr;
+    if (m_bare) {
+        // 純 hex 字串的陣列從頭開始
+        m_p = m_begin;
+        m_bareStarted = true;
+        return offset == 0;
+    }
+    if (offset >= static_cast<size_t>(m_end - m_begin) || m_begin[offset] != '{') {
+        m_p = m_end;
+        m_depth = 0;
+        return false;
+    }
+    m_p = m_begin + offset + 1;
+    m_depth = 1;
+    return true;
+}
+
+void OledCArrayReader::setDefineHandler(std::function<void(QLatin1String name, QLatin1String value)> handler)
+{
+    m_defineHandler = std::move(handler);
+}
+
+OledCArrayWriter::OledCArrayWriter(QIODevice* device)
+    : OledCArrayWriter(device, Options())
+{
+}
+
+OledCArrayWriter::OledCArrayWriter(QByteArray* buffer)
+    : OledCArrayWriter(buffer, Options())
+{
+}
+
+OledCArrayWriter::OledCArrayWriter(QIODevice* device, const Options& options)
+    : OledCArrayWriter(&m_chunk, options)
+{
+    m_device = device;
+    m_chunk.reserve(kWriterChunkSize + 1024);
+}
+
+OledCArrayWriter::OledCArrayWriter(QByteArray* buffer, const Options& options)
+    : m_options(options), m_target(buffer)
+{
+    if (m_options.valuesPerLine <= 0) m_options.valuesPerLine = 16;
+
+    // 常見的格式 ("0x1F, " 6 個字元) 一個值只要一次 8 byte 的複製
+    m_cellLength = static_cast<size_t>(m_options.valuePrefix.size() + 2 + m_options.valueSuffix.size());
+    const size_t cellWithSeparator = m_cellLength + static_cast<size_t>(m_options.separator.size());
+    if (cellWithSeparator <= kWriterCellSize) {
+        const char* hex = m_options.upperCase ? kHexTable.upper : kHexTable.lower;
+        const QByteArray& prefix = m_options.valuePrefix;
+        const QByteArray& suffix = m_options.valueSuffix;
+        const QByteArray& separator = m_options.separator;
+        m_cells.assign(256 * kWriterCellSize, ' ');
+        for (int value = 0; value < 256; ++value) {
+            char* cell = m_cells.data() + value * kWriterCellSize;
+            std::memcpy(cell, prefix.constData(), static_cast<size_t>(prefix.size()));
+            cell += prefix.size();
+            *cell++ = hex[value * 2];
+            *cell++ = hex[value * 2 + 1];
+            std::memcpy(cell, suffix.constData(), static_cast<size_t>(suffix.size()));
+            cell += suffix.size();
+            std::memcpy(cell, separator.constData(), static_cast<size_t>(separator.size()));
+        }
+    }
+}
+
+OledCArrayWriter::~OledCArrayWriter()
+{
+    flush();
+}
+
+bool OledCArrayWriter::flush()
+{
+    if (m_device && !m_chunk.isEmpty()) {
+        if (m_device->write(m_chunk) != m_chunk.size()) {
+            m_error = true;
+        }
+        m_chunk.resize(0);      // 保留已配置的容量
+    }
+    return !m_error;
+}
+
+char* OledCArrayWriter::append(size_t length)
+{
+    const int oldSize = m_target->size();
+    m_target->resize(oldSize + static_cast<int>(length));
+    return m_target->data() + oldSize;
+}
+
+void OledCArrayWriter::appendBytes(const char* text, size_t length)
+{
+    if (length > 0) {
+        std::memcpy(append(length), text, length);
+    }
+}
+
+void OledCArrayWriter::writeText(const QByteArray& text)
+{
+    appendBytes(text.constData(), static_cast<size_t>(text.size()));
+    if (m_device && m_chunk.size() >= kWriterChunkSize) {
+        flush();
+    }
+}
+
+void OledCArrayWriter::writeComment(const QByteArray& text)
+{
+    if (text.isEmpty()) {
+        return;
+    }
+    appendBytes("// ", 3);
+    writeText(text);
+    appendBytes("\n", 1);
+}
+
+size_t OledCArrayWriter::valuesLength(size_t begin, size_t end, size_t total) const
+{
+    // 每個值：前綴 + 2 個 hex 字元 + 後綴；值之間是 separator，或換行時的 ",\n" + 縮排
+    if (begin >= end) {
+        return 0;
+    }
+    const size_t perLine = static_cast<size_t>(m_options.valuesPerLine);
+    const size_t count = end - begin;
+    const size_t gapsEnd = (end < total) ? end : total - 1;     // 最後一個值後面沒有分隔
+    const size_t gaps = gapsEnd > begin ? gapsEnd - begin : 0;
+    const size_t breaks = gapsEnd / perLine - begin / perLine;  // (i + 1) % perLine == 0 的個數
+    size_t length = count * (static_cast<size_t>(m_options.valuePrefix.size() + m_options.valueSuffix.size()) + 2);
+    length += (gaps - breaks) * static_cast<size_t>(m_options.separator.size());
+    length += breaks * (2 + static_cast<size_t>(m_options.indent.size()));
+    if (end == total && m_options.trailingComma) {
+        ++length;
+    }
+    return length;
+}
+
+void OledCArrayWriter::appendValues(const uint8_t* data, size_t begin, size_t end, size_t total)
+{
+    const size_t length = valuesLength(begin, end, total);
+    if (length == 0) {
+        return;
+    }
+    // 多配置 kWriterCellSize 個字元給 formatValues() 的整格複製，寫完再截掉
+    const int oldSize = m_target->size();
+    char* out = append(length + kWriterCellSize);
+    formatValues(out, data, begin, end, total);
+    m_target->resize(oldSize + static_cast<int>(length));
+}
+
+char* OledCArrayWriter::formatValues(char* out, const uint8_t* data, size_t begin, size_t end, size_t total) const
+{
+    const char* hex = m_options.upperCase ? kHexTable.upper : kHexTable.lower;
+    const char* prefix = m_options.valuePrefix.constData();
+    const size_t prefixLength = static_cast<size_t>(m_options.valuePrefix.size());
+    const char* suffix = m_options.valueSuffix.constData();
+    const size_t suffixLength = static_cast<size_t>(m_options.valueSuffix.size());
+    const char* separator = m_options.separator.constData();
+    const size_t separatorLength = static_cast<size_t>(m_options.separator.size());
+    const char* indent = m_options.indent.constData();
+    const size_t indentLength = static_cast<size_t>(m_options.indent.size());
+    const size_t perLine = static_cast<size_t>(m_options.valuesPerLine);
+
+    size_t column = begin % perLine;
+    if (!m_cells.empty()) {
+        // 整格 (含分隔) 以 8 byte 複製，遇到換行或最後一個值時退回分隔的位置改寫；
+        // 呼叫端要在 out 後面多留 kWriterCellSize 個字元
+        const char* cells = m_cells.data();
+        const size_t step = m_cellLength + separatorLength;
+        for (size_t i = begin; i < end; ++i) {
+            std::memcpy(out, cells + data[i] * kWriterCellSize, kWriterCellSize);
+            out += step;
+            if (i + 1 == total) {
+                out -= separatorLength;
+                if (m_options.trailingComma) *out++ = ',';
+            } else if (++column == perLine) {
+                column = 0;
+                out -= separatorLength;
+                *out++ = ',';
+                *out++ = '\n';
+                std::memcpy(out, indent, indentLength);
+                out += indentLength;
+            }
+        }
+        return out;
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+        std::memcpy(out, prefix, prefixLength);
+        out += prefixLength;
+        std::memcpy(out, hex + data[i] * 2, 2);
+        out += 2;
+        std::memcpy(out, suffix, suffixLength);
+        out += suffixLength;
+
+        if (i + 1 == total) {
+            if (m_options.trailingComma) *out++ = ',';
+        } else if (++column == perLine) {
+            column = 0;
+            *out++ = ',';
+            *out++ = '\n';
+            std::memcpy(out, indent, indentLength);
+            out += indentLength;
+        } else {
+            std::memcpy(out, separator, separatorLength);
+            out += separatorLength;
+        }
+    }
+    return out;
+}
+
+void OledCArrayWriter::writeArray(const QByteArray& name, const uint8_t* data, size_t size, const QSize& imageSize)
+{
+    if (m_options.sizeMacros && imageSize.isValid()) {
+        const QByteArray macro = name.toUpper();
+        writeText("#define " + macro + "_WIDTH " + QByteArray::number(imageSize.width()) + "\n"
+                  + "#define " + macro + "_HEIGHT " + QByteArray::number(imageSize.height()) + "\n");
+    }
+
+    QByteArray declaration = m_options.type + ' ' + name
+                             + '[' + QByteArray::number(static_cast<qulonglong>(size)) + ']';
+    if (!m_options.attribute.isEmpty()) {
+        declaration += ' ' + m_options.attribute;
+    }
+    declaration += " = {\n" + m_options.indent;
+    writeText(declaration);
+
+    if (!m_device) {
+        // 輸出到記憶體：整個陣列一次配置
+        appendValues(data, 0, size, size);
+    } else {
+        for (size_t begin = 0; begin < size; begin += kWriterBlockValues) {
+            appendValues(data, begin, std::min(size, begin + kWriterBlockValues), size);
+            if (m_chunk.size() >= kWriterChunkSize) {
+                flush();
+            }
+        }
+    }
+    writeText("\n};\n");
+}
+
+QByteArray OledCArrayWriter::preludeSource()
+{
+    // 輸出到韌體的 C 程式註解一律用英文，避免 MCU 工具鏈的編碼問題
+    return "#include <stddef.h>\n"
+           "#include <stdint.h>\n"
+           "#ifndef OLED_READ_BYTE\n"
+           "#define OLED_READ_BYTE(p) (*(const uint8_t *)(p)) /* AVR PROGMEM: pgm_read_byte(p) */\n"
+           "#endif\n";
+}
+
+int OledCArrayWriter::offsetValueBytes(size_t largest, int minimumBytes)
+{
+    const int bytes = largest > 0xFFFF ? 4 : largest > 0xFF ? 2 : 1;
+    return std::max(bytes, minimumBytes);
+}
+
+void OledCArrayWriter::writeOffsetArray(const QByteArray& name, const std::vector<size_t>& values, int minimumBytes)
+{
+    const size_t largest = values.empty() ? 0 : *std::max_element(values.begin(), values.end());
+    const int bytes = offsetValueBytes(largest, minimumBytes);
+    const QByteArray replacement = bytes == 4 ? "uint32_t" : bytes == 2 ? "uint16_t" : "uint8_t";
+    QByteArray type = m_options.type;
+    if (type.contains("uint8_t")) {
+        type.replace("uint8_t", replacement);
+    } else if (type.contains("unsigned char")) {
+        type.replace("unsigned char", replacement);
+    } else {
+        type = "const " + replacement;
+    }
+
+    QByteArray text = type + ' ' + name + '[' + QByteArray::number(static_cast<qulonglong>(values.size())) + ']';
+    if (!m_options.attribute.isEmpty()) {
+        text += ' ' + m_options.attribute;
+    }
+    text += " = {";
+    const size_t perLine = static_cast<size_t>(m_options.valuesPerLine);
+    for (size_t i = 0; i < values.size(); ++i) {
+        text += i % perLine == 0 ? '\n' + m_options.indent : QByteArray(" ");
+        text += QByteArray::number(static_cast<qulonglong>(values[i]));
+        if (i + 1 < values.size() || m_options.trailingComma) {
+            text += ',';
+        }
+    }
+    text += "\n};\n";
+    writeText(text);
+}
+
+OledMappedFile::OledMappedFile(const QString& path)
+    : m_file(path)
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    m_open = true;
+
+    const qint64 size = m_file.size();
+    if (size <= 0) {
+        return;
+    }
+    m_mapped = m_file.map(0, size);
+    if (m_mapped) {
+        m_data = reinterpret_cast<const char*>(m_mapped);
+        m_size = static_cast<size_t>(size);
+    } else {
+        m_copy = m_file.readAll();
+        m_data = m_copy.constData();
+        m_size = static_cast<size_t>(m_copy.size());
+    }
+}
+
+OledMappedFile::~OledMappedFile()
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+    }
+}
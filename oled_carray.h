@@ -0,0 +1,232 @@
+#ifndef OLED_CARRAY_H
+#define OLED_CARRAY_H
+
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QSize>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief C 陣列 (.h / .c) 的串流式讀取器 (oledcore，不依賴 Qt Widgets)。
+ *
+ * 只掃描一次、不配置任何記憶體：直接讀取呼叫端提供的 byte 區段
+ * (QByteArray、QFile::map() 的記憶體對映區段都可以)，名稱與註解也只是指向原始資料的 view。
+ * 來源文字以 byte 處理，註解裡的 Big5 / UTF-8 中文不影響解析。
+ *
+ * 認得的語法：
+ * - 註解 (// 與 / * * /)、字串與字元常值、前置處理指令 (#define ...) 都會被跳過。
+ * - 每個 "名稱[大小] ... = { ... }" 都是一個陣列，PROGMEM、const、static 等修飾字不影響名稱；
+ *   巢狀大括號 (二維陣列) 會被攤平。
+ * - 數值：0x 十六進位、0b 二進位、0 開頭的八進位、十進位，可帶 u/U/l/L 後綴與負號；
+ *   nextValue(uint8_t*) 只保留低 8 位元 (位置表等較大的值用 uint32_t 的版本)。型別轉換 (uint8_t) 與其他識別字會被略過，
+ *   只有剛好兩個十六進位字母的 token (例如 FF) 視為沒寫 0x 的 hex (相容舊的貼上格式)。
+ * - 整段文字都沒有 '{' 時視為純 hex 字串 (例如 "FF A1 0x3C" 或 "FFA13C")，當作一個沒有名稱的陣列。
+ *
+ * 用法：
+ * @code
+ *   OledCArrayReader reader(data, size);
+ *   OledCArrayReader::Array array;
+ *   while (reader.nextArray(&array)) {
+ *       uint8_t value;
+ *       while (reader.nextValue(&value)) { ... }
+ *   }
+ * @endcode
+ */
+class OledCArrayReader
+{
+public:
+    struct Array {
+        QLatin1String name;        // 陣列名稱；純 hex 字串或找不到名稱時為空
+        int declaredSize = -1;     // 宣告的大小 ([1024])；沒寫或不是單純的數字時為 -1
+        QLatin1String comment;     // 上一個陣列結束後、本陣列開始前的最後一段註解 (含 // 或 / *)
+        size_t offset = 0;         // '{' 在來源資料中的位置
+    };
+
+    OledCArrayReader(const char* data, size_t size);
+    explicit OledCArrayReader(const QByteArray& data);   // 不會複製，data 必須在讀取期間保持有效
+
+    /**
+     * @brief 移到下一個陣列的開頭。
+     *
+     * 目前的陣列還沒讀完時，剩下的值會被略過。
+     * @return 沒有更多陣列時回傳 false。
+     */
+    bool nextArray(Array* array);
+
+    /**
+     * @brief 讀取目前陣列的下一個值。
+     * @return 陣列結束 (對應的 '}' 或資料結尾) 時回傳 false。
+     */
+    bool nextValue(uint8_t* value);
+    bool nextValue(uint32_t* value);     // 不截斷 (例如 uint16_t / uint32_t 的位置表)；純 hex 字串仍是一次一個 byte
+
+    /// 把目前陣列剩下的值全部加到 out 的尾端，回傳加入的個數。
+    size_t readValues(std::vector<uint8_t>* out);
+    size_t readValues(std::vector<uint32_t>* out);
+
+    /**
+     * @brief 直接跳到先前 nextArray() 回報的 Array::offset，接著以 nextValue() 讀值 (素材索引的延遲載入)。
+     * @return offset 的位置不是 '{' (例如檔案已被修改) 時回傳 false。
+     */
+    bool seekArray(size_t offset);
+
+    /**
+     * @brief 尋找陣列途中遇到 "#define 名稱 值" 時呼叫 handler。
+     *
+     * value 是同一行剩下的文字 (去掉前後空白與行尾註解)，帶參數的巨集不回報。
+     * name 與 value 都指向原始資料。
+     */
+    void setDefineHandler(std::function<void(QLatin1String name, QLatin1String value)> handler);
+
+private:
+    bool skipTrivia(bool rememberComments);   // 跳過空白與註解，回傳是否還有資料
+    void skipLine();                          // 跳到行尾 (處理 '\' 接續行)
+    void skipQuoted(char quote);
+    bool readNumber(uint32_t* value);         // p 指向數字開頭
+    template <typename T>
+    bool readValue(T* value);                 // nextValue() 的兩個版本各自展開，讀 byte 時不經過 uint32_t 的版本
+    bool nextBareValue(uint8_t* value);
+    void reportDefine() const;                // p 指向 '#'
+
+    const char* m_begin = nullptr;
+    const char* m_p = nullptr;
+    const char* m_end = nullptr;
+    const char* m_comment = nullptr;          // 最近一段註解
+    size_t m_commentLength = 0;
+    int m_depth = 0;                          // 目前陣列的大括號深度，0 表示不在陣列內
+    bool m_bare = false;                      // 純 hex 字串模式
+    bool m_bareStarted = false;
+    const char* m_runEnd = nullptr;           // 純 hex 模式：目前這串連續 hex 字母的結尾
+    std::function<void(QLatin1String, QLatin1String)> m_defineHandler;
+};
+
+/**
+ * @brief C 陣列的串流式輸出器，GUI 的匯出 / 儲存與命令列工具共用。
+ *
+ * 以預先算好的 hex 對照表直接把字元寫進預先配置好的緩衝區，不會每個 byte 產生一個 QString：
+ * - 輸出到 QByteArray：先算出整個陣列的長度，一次配置後直接填入。
+ * - 輸出到 QIODevice (QFile、QSaveFile...)：每滿 64 KB 寫出一次，大量動畫影格不必整個放在記憶體。
+ *
+ * 輸出的格式 (Options 的預設值)：
+ * @code
+ *   // 註解
+ *   #define ICON_WIDTH 16          (sizeMacros 且有給尺寸時)
+ *   #define ICON_HEIGHT 16
+ *   const uint8_t icon[32] PROGMEM = {
+ *       0x00, 0x1F, ...             (每行 valuesPerLine 個)
+ *   };
+ * @endcode
+ * 文字 (名稱、註解) 以 UTF-8 的 QByteArray 傳入，原樣輸出。
+ */
+class OledCArrayWriter
+{
+public:
+    struct Options {
+        QByteArray type = "const uint8_t";  // 型別與修飾字，例如 "const unsigned char"、"static const uint8_t"
+        QByteArray attribute;               // 名稱後面的屬性，例如 "PROGMEM"；空的表示沒有
+        int valuesPerLine = 16;
+        QByteArray indent = "    ";
+        QByteArray valuePrefix = "0x";      // 每個值的前綴
+        QByteArray valueSuffix;             // 每個值的後綴，例如 "u"
+        QByteArray separator = ", ";        // 同一行的值之間 (換行時只保留逗號)
+        bool upperCase = true;              // 0x1F 或 0x1f
+        bool sizeMacros = false;            // 陣列前輸出 名稱_WIDTH / 名稱_HEIGHT (名稱轉大寫)
+        bool trailingComma = false;         // 最後一個值後面也加逗號
+    };
+
+    explicit OledCArrayWriter(QIODevice* device);
+    OledCArrayWriter(QIODevice* device, const Options& options);
+    explicit OledCArrayWriter(QByteArray* buffer);                          // 附加到 buffer 的尾端
+    OledCArrayWriter(QByteArray* buffer, const Options& options);
+    ~OledCArrayWriter();                    // 會呼叫 flush()
+
+    OledCArrayWriter(const OledCArrayWriter&) = delete;
+    OledCArrayWriter& operator=(const OledCArrayWriter&) = delete;
+
+    void writeText(const QByteArray& text);         // 原樣輸出，例如檔頭或 #include
+    void writeComment(const QByteArray& text);      // "// text\n"，text 是空的時不輸出
+
+    /**
+     * @brief 輸出一個完整的陣列宣告。
+     *
+     * @param name      陣列名稱。
+     * @param data      資料。
+     * @param size      byte 數。
+     * @param imageSize 圖片尺寸；有效且 Options::sizeMacros 為 true 時輸出尺寸巨集。
+     */
+    void writeArray(const QByteArray& name, const uint8_t* data, size_t size, const QSize& imageSize = QSize());
+
+    /**
+     * @brief 輸出位置表 (例如每個影格在資料中的起始位置)，值以十進位輸出。
+     *
+     * 型別沿用 Options::type 的修飾字 (static、const...)，byte 型別換成 offsetValueBytes() 選出的
+     * uint8_t、uint16_t 或 uint32_t；屬性、每行個數與縮排和 writeArray() 相同。
+     * minimumBytes 預設為 2 (韌體以 16 位元讀取的位置表)，查找函式配合讀取巨集時可以用 1。
+     */
+    void writeOffsetArray(const QByteArray& name, const std::vector<size_t>& values, int minimumBytes = 2);
+
+    /// writeOffsetArray() 每個值的 byte 數：放得下 largest 且不小於 minimumBytes 的 1、2 或 4
+    static int offsetValueBytes(size_t largest, int minimumBytes = 2);
+
+    /**
+     * @brief 輸出給韌體的 C 函式 (解碼、差異更新、字型查找) 共用的開頭：stddef.h / stdint.h 與 OLED_READ_BYTE(p)。
+     *
+     * 函式讀取陣列都經過 OLED_READ_BYTE(p)，以 #ifndef 保護；資料放在 AVR 的 PROGMEM 時
+     * 在 include 前定義成 pgm_read_byte(p)。
+     */
+    static QByteArray preludeSource();
+
+    /// 把緩衝的內容寫到 QIODevice (輸出到 QByteArray 時不做任何事)，回傳目前為止是否都寫入成功。
+    bool flush();
+    bool hasError() const { return m_error; }
+
+private:
+    char* append(size_t length);            // 在輸出的尾端空出 length 個字元
+    void appendBytes(const char* text, size_t length);
+    size_t valuesLength(size_t begin, size_t end, size_t total) const;
+    void appendValues(const uint8_t* data, size_t begin, size_t end, size_t total);
+    char* formatValues(char* out, const uint8_t* data, size_t begin, size_t end, size_t total) const;
+
+    Options m_options;
+    QIODevice* m_device = nullptr;
+    QByteArray* m_target = nullptr;         // 目前寫入的緩衝區 (m_chunk 或呼叫端的 QByteArray)
+    QByteArray m_chunk;                     // 輸出到 QIODevice 時的暫存
+    std::vector<char> m_cells;              // 每個值的完整文字 (前綴 + hex + 後綴 + 分隔)，每格 8 個字元；太長時為空
+    size_t m_cellLength = 0;
+    bool m_error = false;
+};
+
+/**
+ * @brief 唯讀開啟整個檔案給 OledCArrayReader 使用：優先以 QFile::map() 對映，不支援時才整個讀進記憶體。
+ *
+ * 好幾 MB 的字型 / 動畫標頭檔不必先轉成 QString，解析直接在對映的區段上進行。
+ */
+class OledMappedFile
+{
+public:
+    explicit OledMappedFile(const QString& path);
+    ~OledMappedFile();
+
+    OledMappedFile(const OledMappedFile&) = delete;
+    OledMappedFile& operator=(const OledMappedFile&) = delete;
+
+    bool isOpen() const { return m_open; }
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    QFile m_file;
+    uchar* m_mapped = nullptr;
+    QByteArray m_copy;          // 無法對映時的備援
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;
+};
+
+#endif // OLED_CARRAY_H
@@ -0,0 +1,457 @@
+#include "oled_codec.h"
+#include "oled_carray.h"
+
+#include <algorithm>
+
+namespace {
+
+// LZSS 的視窗與長度 (回參照是 12 位元的距離 + 4 位元的長度)
+constexpr size_t kLzWindow = 4096;
+constexpr size_t kLzMinMatch = 3;
+constexpr size_t kLzMaxMatch = 18;
+constexpr int kLzHashBits = 12;
+constexpr int kLzMaxChain = 256;
+
+// 主機端解碼時讀取壓縮資料：讀超過結尾時記下錯誤並回傳 0
+struct SourceReader {
+    const uint8_t* src;
+    size_t size;
+    size_t pos = 0;
+    bool ok = true;
+    OledCodec::DecodeStats* stats;
+
+    uint8_t read()
+    {
+        if (stats) ++stats->sourceReads;
+        if (pos >= size) {
+            ok = false;
+            return 0;
+        }
+        return src[pos++];
+    }
+};
+
+void encodeRle(const uint8_t* data, size_t size, std::vector<uint8_t>* out)
+{
+    size_t i = 0;
+    while (i < size) {
+        size_t run = 1;
+        while (i + run < size && run < 255 && data[i + run] == data[i]) ++run;
+        out->push_back(static_cast<uint8_t>(run));
+        out->push_back(data[i]);
+        i += run;
+    }
+}
+
+void encodePackBits(const uint8_t* data, size_t size, std::vector<uint8_t>* out)
+{
+    size_t i = 0;
+    while (i < size) {
+        size_t run = 1;
+        while (i + run < size && run < 128 && data[i + run] == data[i]) ++run;
+        if (run >= 2) {
+            out->push_back(static_cast<uint8_t>(257 - run));
+            out->push_back(data[i]);
+            i += run;
+            continue;
+        }
+
+        // 原樣的一段：直到出現 3 個以上相同的 byte 或滿 128 個 (2 個相同的 byte 併入原樣比較省)
+        const size_t start = i;
+        while (i < size && i - start < 128) {
+            if (i + 2 < size && data[i] == data[i + 1] && data[i] == data[i + 2]) break;
+            ++i;
+        }
+        out->push_back(static_cast<uint8_t>(i - start - 1));
+        out->insert(out->end(), data + start, data + i);
+    }
+}
+
+void encodePageDelta(const uint8_t* data, size_t size, int pageWidth, std::vector<uint8_t>* out)
+{
+    const size_t width = static_cast<size_t>(std::max(1, pageWidth));
+    std::vector<uint8_t> delta(data, data + size);
+    for (size_t i = width; i < size; ++i) {
+        delta[i] = static_cast<uint8_t>(data[i] ^ data[i - width]);
+    }
+    encodePackBits(delta.data(), size, out);
+}
+
+inline uint32_t lzHash(const uint8_t* p)
+{
+    const uint32_t key = uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16);
+    return (key * 2654435761u) >> (32 - kLzHashBits);
+}
+
+void encodeLz(const uint8_t* data, size_t size, std::vector<uint8_t>* out)
+{
+    // 以 3 byte 的雜湊串起視窗內相同開頭的位置 (hash chain)，找最長的回參照
+    std::vector<int> head(size_t(1) << kLzHashBits, -1);
+    std::vector<int> previous(size, -1);
+    auto insert = [&](size_t pos) {
+        if (pos + kLzMinMatch <= size) {
+            const uint32_t hash = lzHash(data + pos);
+            previous[pos] = head[hash];
+            head[hash] = static_cast<int>(pos);
+        }
+    };
+
+    size_t flagPos = 0;
+    int bit = 8;
+    size_t i = 0;
+    while (i < size) {
+        if (bit == 8) {
+            flagPos = out->size();
+            out->push_back(0);
+            bit = 0;
+        }
+
+        size_t bestLength = 0;
+        size_t bestDistance = 0;
+        if (i + kLzMinMatch <= size) {
+            const size_t maxLength = std::min(kLzMaxMatch, size - i);
+            int chain = 0;
+            for (int j = head[lzHash(data + i)]; j >= 0 && i - size_t(j) <= kLzWindow && chain < kLzMaxChain;
+                 j = previous[size_t(j)], ++chain) {
+                size_t length = 0;
+                while (length < maxLength && data[size_t(j) + length] == data[i + length]) ++length;
+                if (length > bestLength) {
+                    bestLength = length;
+                    bestDistance = i - size_t(j);
+                    if (length == maxLength) break;
+                }
+            }
+        }
+
+        if (bestLength >= kLzMinMatch) {
+            const size_t code = bestDistance - 1;
+            out->push_back(static_cast<uint8_t>(code & 0xFF));
+            out->push_back(static_cast<uint8_t>(((code >> 8) << 4) | (bestLength - kLzMinMatch)));
+            for (size_t k = 0; k < bestLength; ++k) insert(i + k);
+            i += bestLength;
+        } else {
+            (*out)[flagPos] = static_cast<uint8_t>((*out)[flagPos] | (1u << bit));
+            out->push_back(data[i]);
+            insert(i);
+            ++i;
+        }
+        ++bit;
+    }
+}
+
+// --- 主機端解碼 (與下面的 C 原始碼逐步對應) ---
+
+bool decodeRle(SourceReader& in, uint8_t* dst, size_t size, OledCodec::DecodeStats* stats)
+{
+    size_t out = 0;
+    while (out < size && in.ok) {
+        if (stats) ++stats->tokens;
+        unsigned count = in.read();
+        const uint8_t value = in.read();
+        while (count-- && out < size) {
+            dst[out++] = value;
+            if (stats) ++stats->writes;
+        }
+    }
+    return in.ok;
+}
+
+// PackBits 與 PageDelta 共用 (同 oled_packbits_xor_decode)：i >= back 的 byte 和 dst[i - back] 做 XOR，
+// back 為 size 時就是單純的 PackBits
+bool decodePackBits(SourceReader& in, uint8_t* dst, size_t size, size_t back, OledCodec::DecodeStats* stats)
+{
+    size_t out = 0;
+    while (out < size && in.ok) {
+        if (stats) ++stats->tokens;
+        const uint8_t header = in.read();
+        if (header == 128) {
+            continue;
+        }
+        const bool literal = header < 128;
+        unsigned count = literal ? header + 1u : 257u - header;
+        const uint8_t value = literal ? 0 : in.read();
+        while (count-- && out < size) {
+            uint8_t v = literal ? in.read() : value;
+            if (out >= back) {
+                v = static_cast<uint8_t>(v ^ dst[out - back]);
+                if (stats) ++stats->backReads;
+            }
+            dst[out++] = v;
+            if (stats) ++stats->writes;
+        }
+    }
+    return in.ok;
+}
+
+bool decodeLz(SourceReader& in, uint8_t* dst, size_t size, OledCodec::DecodeStats* stats)
+{
+    size_t out = 0;
+    uint8_t flags = 0;
+    int bits = 0;
+    while (out < size && in.ok) {
+        if (bits == 0) {
+            flags = in.read();
+            bits = 8;
+        }
+        if (stats) ++stats->tokens;
+        if (flags & 1) {
+            dst[out++] = in.read();
+            if (stats) ++stats->writes;
+        } else {
+            const uint8_t lo = in.read();
+            const uint8_t hi = in.read();
+            const size_t distance = ((size_t(hi >> 4) << 8) | lo) + 1;
+            unsigned length = (hi & 0x0Fu) + kLzMinMatch;
+            if (distance > out) {
+                return false;   // 參照到輸出開頭之前
+            }
+            while (length-- && out < size) {
+                dst[out] = dst[out - distance];
+                ++out;
+                if (stats) {
+                    ++stats->backReads;
+                    ++stats->writes;
+                }
+            }
+        }
+        flags = static_cast<uint8_t>(flags >> 1);
+        --bits;
+    }
+    return in.ok;
+}
+
+// --- 輸出到韌體的 C 解碼函式 (開頭見 OledCArrayWriter::preludeSource()) ---
+
+const char kRleDecoder[] =
+    "#ifndef OLED_RLE_DECODE_DEFINED\n"
+    "#define OLED_RLE_DECODE_DEFINED\n"
+    "/* (count, value) pairs */\n"
+    "static void oled_rle_decode(const uint8_t *src, uint8_t *dst, size_t size)\n"
+    "{\n"
+    "    uint8_t *end = dst + size;\n"
+    "    while (dst < end) {\n"
+    "        uint8_t count = OLED_READ_BYTE(src++);\n"
+    "        uint8_t value = OLED_READ_BYTE(src++);\n"
+    "        while (count-- && dst < end) *dst++ = value;\n"
+    "    }\n"
+    "}\n"
+    "#endif\n";
+
+// PackBits、PageDelta 與動畫的 XOR 影格共用同一個 C 函式，只差在 back
+const char kPackBitsXorDecoder[] =
+    "#ifndef OLED_PACKBITS_XOR_DECODE_DEFINED\n"
+    "#define OLED_PACKBITS_XOR_DECODE_DEFINED\n"
+    "/* header 0..127: header + 1 literal bytes follow; 129..255: next byte repeated 257 - header times.\n"
+    "   Bytes at i >= back are XORed with dst[i - back]: back = size is plain PackBits, back = page width\n"
+    "   undoes the page delta, back = 0 XORs onto the previous frame already in dst. */\n"
+    "static void oled_packbits_xor_decode(const uint8_t *src, uint8_t *dst, size_t size, size_t back)\n"
+    "{\n"
+    "    size_t i = 0;\n"
+    "    while (i < size) {\n"
+    "        uint8_t header = OLED_READ_BYTE(src++);\n"
+    "        uint8_t literal = header < 128;\n"
+    "        uint8_t count, value = 0;\n"
+    "        if (header == 128) continue;\n"
+    "        count = literal ? (uint8_t)(header + 1) : (uint8_t)(257 - header);\n"
+    "        if (!literal) value = OLED_READ_BYTE(src++);\n"
+    "        while (count-- && i < size) {\n"
+    "            uint8_t v = literal ? OLED_READ_BYTE(src++) : value;\n"
+    "            dst[i] = (uint8_t)(i >= back ? v ^ dst[i - back] : v);\n"
+    "            i++;\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "#define oled_packbits_decode(src, dst, size) oled_packbits_xor_decode((src), (dst), (size), (size))\n"
+    "#define oled_pagedelta_decode(src, dst, size, page_width) \\\n"
+    "    oled_packbits_xor_decode((src), (dst), (size), (page_width))\n"
+    "#endif\n";
+
+const char kLzDecoder[] =
+    "#ifndef OLED_LZ_DECODE_DEFINED\n"
+    "#define OLED_LZ_DECODE_DEFINED\n"
+    "/* LZSS: flag bits LSB first, 1 = literal, 0 = (distance - 1) low 8 bits, high 4 bits << 4 | length - 3 */\n"
+    "static void oled_lz_decode(const uint8_t *src, uint8_t *dst, size_t size)\n"
+    "{\n"
+    "    uint8_t *out = dst;\n"
+    "    uint8_t *end = dst + size;\n"
+    "    uint8_t flags = 0, bits = 0;\n"
+    "    while (out < end) {\n"
+    "        if (bits == 0) {\n"
+    "            flags = OLED_READ_BYTE(src++);\n"
+    "            bits = 8;\n"
+    "        }\n"
+    "        if (flags & 1) {\n"
+    "            *out++ = OLED_READ_BYTE(src++);\n"
+    "        } else {\n"
+    "            uint8_t lo = OLED_READ_BYTE(src++);\n"
+    "            uint8_t hi = OLED_READ_BYTE(src++);\n"
+    "            const uint8_t *from = out - ((((size_t)(hi >> 4)) << 8 | lo) + 1);\n"
+    "            uint8_t length = (uint8_t)((hi & 0x0F) + 3);\n"
+    "            while (length-- && out < end) *out++ = *from++;\n"
+    "        }\n"
+    "        flags >>= 1;\n"
+    "        bits--;\n"
+    "    }\n"
+    "}\n"
+    "#endif\n";
+
+}
+
+QString OledCodec::methodName(Method method)
+{
+    switch (method) {
+    case Raw: return "raw";
+    case Rle: return "rle";
+    case PackBits: return "packbits";
+    case PageDelta: return "page-delta";
+    case Lz: return "lz";
+    }
+    return QString();
+}
+
+bool OledCodec::methodFromName(const QString& name, Method* method)
+{
+    for (Method candidate : methods()) {
+        if (methodName(candidate) == name) {
+            *method = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<OledCodec::Method> OledCodec::methods()
+{
+    return {Raw, Rle, PackBits, PageDelta, Lz};
+}
+
+std::vector<uint8_t> OledCodec::encode(Method method, const uint8_t* data, size_t size, int pageWidth)
+{
+    std::vector<uint8_t> out;
+    out.reserve(size / 2 + 16);
+    switch (method) {
+    case Raw:
+        out.assign(data, data + size);
+        break;
+    case Rle:
+        encodeRle(data, size, &out);
+        break;
+    case PackBits:
+        encodePackBits(data, size, &out);
+        break;
+    case PageDelta:
+        encodePageDelta(data, size, pageWidth, &out);
+        break;
+    case Lz:
+        encodeLz(data, size, &out);
+        break;
+    }
+    return out;
+}
+
+bool OledCodec::decode(Method method, const uint8_t* src, size_t srcSize, uint8_t* dst, size_t size, int pageWidth,
+                       DecodeStats* stats)
+{
+    SourceReader in{src, srcSize, 0, true, stats};
+    switch (method) {
+    case Raw:
+        for (size_t i = 0; i < size; ++i) {
+            dst[i] = in.read();
+            if (stats) ++stats->writes;
+        }
+        return in.ok;
+    case Rle:
+        return decodeRle(in, dst, size, stats);
+    case PackBits:
+        return decodePackBits(in, dst, size, size, stats);
+    case PageDelta:
+        return decodePackBits(in, dst, size, static_cast<size_t>(std::max(1, pageWidth)), stats);
+    case Lz:
+        return decodeLz(in, dst, size, stats);
+    }
+    return false;
+}
+
+OledCodec::Method OledCodec::pickBest(const uint8_t* data, size_t size, int pageWidth, std::vector<uint8_t>* encoded)
+{
+    Method best = Raw;
+    std::vector<uint8_t> bestData(data, data + size);
+    qint64 bestCycles = 0;
+    {
+        DecodeStats stats;
+        std::vector<uint8_t> scratch(size);
+        decode(Raw, bestData.data(), bestData.size(), scratch.data(), size, pageWidth, &stats);
+        bestCycles = stats.cycles();
+    }
+
+    std::vector<uint8_t> scratch(size);
+    for (Method method : methods()) {
+        if (method == Raw) {
+            continue;
+        }
+        std::vector<uint8_t> candidate = encode(method, data, size, pageWidth);
+        if (candidate.size() > bestData.size()) {
+            continue;
+        }
+        DecodeStats stats;
+        decode(method, candidate.data(), candidate.size(), scratch.data(), size, pageWidth, &stats);
+        if (candidate.size() < bestData.size() || stats.cycles() < bestCycles) {
+            best = method;
+            bestData = std::move(candidate);
+            bestCycles = stats.cycles();
+        }
+    }
+    if (encoded) {
+        *encoded = std::move(bestData);
+    }
+    return best;
+}
+
+QByteArray OledCodec::decoderName(Method method)
+{
+    switch (method) {
+    case Raw: return QByteArray();
+    case Rle: return "oled_rle_decode";
+    case PackBits: return "oled_packbits_decode";
+    case PageDelta: return "oled_pagedelta_decode";
+    case Lz: return "oled_lz_decode";
+    }
+    return QByteArray();
+}
+
+QByteArray OledCodec::decoderSource(Method method)
+{
+    switch (method) {
+    case Raw: return QByteArray();
+    case Rle: return OledCArrayWriter::preludeSource() + kRleDecoder;
+    case PackBits:
+    case PageDelta: return OledCArrayWriter::preludeSource() + kPackBitsXorDecoder;
+    case Lz: return OledCArrayWriter::preludeSource() + kLzDecoder;
+    }
+    return QByteArray();
+}
+
+void OledCodec::writeArray(OledCArrayWriter* writer, Method method, const QByteArray& name,
+                           const std::vector<uint8_t>& data, int pageWidth, const QSize& imageSize)
+{
+    if (method == Raw) {
+        writer->writeArray(name, data.data(), data.size(), imageSize);
+        return;
+    }
+
+    const std::vector<uint8_t> encoded = encode(method, data.data(), data.size(), pageWidth);
+    const QByteArray rawSizeMacro = name.toUpper() + "_RAW_SIZE";
+    QByteArray call = decoderName(method) + "(" + name + ", buffer, " + rawSizeMacro;
+    if (method == PageDelta) {
+        call += ", " + QByteArray::number(pageWidth);
+    }
+    call += ");";
+
+    writer->writeText(decoderSource(method));
+    writer->writeText("\n");
+    writer->writeComment(name + ": " + methodName(method).toUtf8() + ", " + QByteArray::number(qulonglong(data.size()))
+                         + " -> " + QByteArray::number(qulonglong(encoded.size())) + " bytes");
+    writer->writeComment("decode: " + call);
+    writer->writeText("#define " + rawSizeMacro + " " + QByteArray::number(qulonglong(data.size())) + "\n");
+    writer->writeArray(name, encoded.data(), encoded.size(), imageSize);
+}
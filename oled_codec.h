@@ -0,0 +1,113 @@
+#ifndef OLED_CODEC_H
+#define OLED_CODEC_H
+
+#pragma once
+
+#include <QByteArray>
+#include <QSize>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class OledCArrayWriter;
+
+/**
+ * @brief 匯出用的點陣圖壓縮格式 (oledcore，不依賴 Qt Widgets)。
+ *
+ * MCU 上 flash 比 CPU 時間珍貴：整個畫面 1024 / 1056 byte 的頁面資料大多是空白或重複的圖樣，
+ * 壓縮後連同一個很小的 C 解碼函式一起輸出，韌體解到 RAM 的畫面緩衝區再送到面板。
+ *
+ * 格式 (壓縮前的資料一律是頁面格式，pageWidth 為每頁的 byte 數)：
+ * - Raw：不壓縮。
+ * - Rle：(次數 1..255, 值) 成對排列，適合大片空白。
+ * - PackBits：標頭 0..127 = 接著 n + 1 個原樣的 byte；129..255 = 下一個 byte 重複 257 - n 次；128 不使用。
+ * - PageDelta：每個 byte 先和上一頁同一欄 (i - pageWidth) 做 XOR，再以 PackBits 壓縮；
+ *   垂直方向重複的圖樣 (混色、格線、重複的圖示列) 會變成大片的 0。
+ * - Lz：LZSS，旗標 byte 的每個位元 (LSB 先) 1 = 原樣 byte，0 = 兩個 byte 的回參照
+ *   (距離 - 1 的低 8 位元；距離 - 1 的高 4 位元 << 4 | 長度 - 3，距離 1..4096、長度 3..18)。
+ *   回參照直接讀已經解出來的輸出，不需要額外的 RAM。
+ *
+ * decode() 是和 decoderSource() 輸出的 C 程式碼逐步對應的主機端版本，
+ * 用來驗證往返 (round trip) 並以簡單的 AVR 模型估計解碼的週期數。
+ * 所有的函式都是無狀態的 (stateless)。
+ */
+class OledCodec
+{
+public:
+    enum Method {
+        Raw,
+        Rle,
+        PackBits,
+        PageDelta,
+        Lz
+    };
+
+    /**
+     * @brief 解碼時的操作次數與估計的 AVR 週期數。
+     *
+     * 週期的模型：從 flash 讀一個 byte (LPM) 3、寫入 RAM (ST) 2、讀回已解出的 byte (LD) 2、
+     * 每個 token (標頭 / 旗標位元的分支與迴圈) 4、每個輸出 byte 的內層迴圈 3。
+     * 只用來比較各格式的相對快慢，不是精確的時序。
+     */
+    struct DecodeStats {
+        qint64 sourceReads = 0;
+        qint64 writes = 0;
+        qint64 backReads = 0;
+        qint64 tokens = 0;
+
+        qint64 cycles() const { return sourceReads * 3 + writes * (2 + 3) + backReads * 2 + tokens * 4; }
+    };
+
+    static QString methodName(Method method);   // "raw"、"rle"、"packbits"、"page-delta"、"lz"
+    static bool methodFromName(const QString& name, Method* method);
+    static std::vector<Method> methods();        // 全部的格式 (含 Raw)
+
+    /**
+     * @brief 壓縮。
+     * @param pageWidth 每頁的 byte 數 (只有 PageDelta 使用)，例如 128 或含填充欄位的 132。
+     */
+    static std::vector<uint8_t> encode(Method method, const uint8_t* data, size_t size, int pageWidth);
+
+    /**
+     * @brief 主機端的參考解碼器 (與 decoderSource() 的 C 程式碼相同的步驟)。
+     *
+     * @param dst   輸出，必須有 size 個 byte。
+     * @param stats 操作次數，可以是 nullptr。
+     * @return 壓縮資料不完整或格式錯誤 (讀超過 srcSize) 時回傳 false。
+     */
+    static bool decode(Method method, const uint8_t* src, size_t srcSize, uint8_t* dst, size_t size, int pageWidth,
+                       DecodeStats* stats = nullptr);
+
+    /**
+     * @brief 找出壓縮後最小的格式 (一樣小時選解碼週期較少的；都沒有比較小時為 Raw)。
+     * @param encoded 選中格式的壓縮結果，可以是 nullptr。
+     */
+    static Method pickBest(const uint8_t* data, size_t size, int pageWidth, std::vector<uint8_t>* encoded = nullptr);
+
+    /**
+     * @brief 該格式的 C 解碼函式 (Raw 為空)。
+     *
+     * 以 #ifndef 保護，多個標頭檔一起 include 也只會定義一次。讀取壓縮資料都經過 OLED_READ_BYTE(p)，
+     * 資料放在 AVR 的 PROGMEM 時在 include 前定義成 pgm_read_byte(p)。
+     * PackBits 與 PageDelta 輸出同一個 oled_packbits_xor_decode(src, dst, size, back)
+     * (i >= back 的 byte 和 dst[i - back] 做 XOR)，decoderName() 的名稱是以它定義的巨集；
+     * 動畫的 XOR 影格也使用它 (back = 0 時 XOR 到 dst 裡的前一個影格)。
+     */
+    static QByteArray decoderSource(Method method);
+
+    /// C 解碼函式的名稱，例如 "oled_rle_decode" (Raw 為空)。
+    static QByteArray decoderName(Method method);
+
+    /**
+     * @brief 輸出壓縮後的陣列：說明註解、解碼函式、名稱_RAW_SIZE 巨集與壓縮資料。
+     *
+     * Raw 時與 OledCArrayWriter::writeArray() 相同。
+     *
+     * @param imageSize 圖片尺寸，交給 OledCArrayWriter 輸出尺寸巨集 (可以是無效的)。
+     */
+    static void writeArray(OledCArrayWriter* writer, Method method, const QByteArray& name,
+                           const std::vector<uint8_t>& data, int pageWidth, const QSize& imageSize = QSize());
+};
+
+#endif // OLED_CODEC_H
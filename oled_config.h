@@ -0,0 +1,31 @@
+#ifndef OLED_CONFIG_H
+#define OLED_CONFIG_H
+#pragma once
+
+// 只放硬體常數，不包含任何 Qt 標頭。
+// 資料模型、轉換器、解析器 (oledcore) 都只依賴這個檔案，不需要 config.h 裡的 Widgets。
+
+// --- 硬體模擬常數 (Hardware Simulation Constants) ---
+// 這裡是「預設面板」(SH1106) 的常數。執行時可以切換成其他面板，
+// 面板列表與幾何見 oled_panel.h (OledPanel::profiles())。
+namespace OledConfig {
+
+// 這是 OLED 螢幕的可視區域尺寸
+constexpr int  DISPLAY_WIDTH   = 128;
+constexpr int  DISPLAY_HEIGHT  = 64;
+
+// 這是驅動晶片 (如 SH1106) 的記憶體頁寬度。
+// SH1106 的 RAM 是 132x64，所以頁寬是 132。
+// 如果是 SSD1306，它的 RAM 是 128x64，那這個值就是 128。
+constexpr int RAM_PAGE_WIDTH = 132;
+//constexpr int RAM_PAGE_WIDTH = 128;
+
+// 這是顯示區域在 RAM 中的起始欄位偏移。
+// SH1106 的 128 像素寬的顯示區域通常是從 RAM 的第 2 欄開始的。
+// SSD1306 則沒有偏移，這個值會是 0。
+constexpr int  COLUMN_OFFSET =  2;
+
+}
+
+
+#endif // OLED_CONFIG_H
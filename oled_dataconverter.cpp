@@ -13,7 +13,7 @@
  *              2. 格式必須為 QImage::Format_Mono (單色位圖)
  *
  * @note 轉換邏輯說明：
- * - 邊界處理：若圖片尺寸超過 OLED 顯示範圍 (OledConfig::DISPLAY_WIDTH/HEIGHT)，將進行裁切。
+ * - 邊界處理：若圖片尺寸超過 OLED 顯示範圍 (model->width() / height())，將進行裁切。
  * - 像素判定：針對 Format_Mono，此處將 pixelIndex 為 0 的點判定為「開啟 (True)」，
  *   通常對應於單色圖中的黑色部分（取決於調色盤設定）。
  *
@@ -41,8 +41,8 @@ void OledDataConverter::updateModelFromImage(OledDataModel* model, const QImage&
 
     // --- 步驟 3: 遍歷 QImage 並更新模型 ---
     // 計算需要遍歷的範圍，避免超出 OLED 的邊界
-    int width_to_copy = std::min(image.width(), OledConfig::DISPLAY_WIDTH);
-    int height_to_copy = std::min(image.height(), OledConfig::DISPLAY_HEIGHT);
+    int width_to_copy = std::min(image.width(), model->width());
+    int height_to_copy = std::min(image.height(), model->height());
 
     for (int y = 0; y < height_to_copy; ++y) {
         for (int x = 0; x < width_to_copy; ++x) {
@@ -57,3 +57,41 @@ void OledDataConverter::updateModelFromImage(OledDataModel* model, const QImage&
         }
     }
 }
+
+
+/**
+ * @brief 建立顯示用的調色盤圖片 (Format_Indexed8)，並設定亮/暗兩個顏色。
+ */
+QImage OledDataConverter::createIndexedImage(const QColor& onColor, const QColor& offColor, const QSize& size)
+{
+    QImage image(size, QImage::Format_Indexed8);
+    image.setColorCount(2);
+    image.setColor(0, offColor.rgb());
+    image.setColor(1, onColor.rgb());
+    image.fill(0);
+    return image;
+}
+
+/**
+ * @brief 以查表 + 掃描線寫入的方式，把 model 的指定範圍轉成調色盤索引。
+ *
+ * @par 實作細節：
+ * 1. 將 region 裁切到畫布範圍。
+ * 2. 交給 model 目前面板的 renderIndexed kernel：每一欄讀取一個頁面 byte，
+ *    查表一次展開成 8 個索引，再依序寫入 region 內的那幾條掃描線。
+ *    常見面板的 kernel 是編譯期特化的版本 (見 OledPanel::kernelsFor())。
+ */
+void OledDataConverter::renderModelToIndexedImage(const OledDataModel& model, QImage* image, const QRect& region)
+{
+    if (!image || image->format() != QImage::Format_Indexed8) {
+        return;
+    }
+
+    const QRect area = region.intersected(QRect(0, 0, model.width(), model.height()))
+                           .intersected(image->rect());
+    if (!area.isValid()) {
+        return;
+    }
+
+    model.kernels().renderIndexed(model.geometry(), model.getBuffer(), image, area);
+}
@@ -5,7 +5,9 @@
 
 
 #include "oled_datamodel.h" // 在 .cpp 中包含完整的定義
-#include "config.h"      // 需要 OledConfig
+#include "oled_config.h"  // 需要 OledConfig
+#include <QColor>
+#include <QImage>
 
 
 // Forward declaration to avoid including the full header
@@ -33,6 +35,31 @@ public:
      *              圖片中像素索引為 0 (通常是黑色) 的點會被視為亮點。
      */
     static void updateModelFromImage(OledDataModel* model, const QImage& image);
+
+    /**
+     * @brief 建立一張與畫布同尺寸、使用調色盤的顯示用圖片。
+     *
+     * 圖片格式為 QImage::Format_Indexed8，索引 0 為熄滅色、索引 1 為點亮色。
+     * 之後要更換主題顏色時只需要修改調色盤 (setColor)，不必重畫任何像素。
+     *
+     * @param onColor  點亮像素的顏色。
+     * @param offColor 熄滅像素的顏色。
+     * @param size     畫布尺寸 (OledDataModel::width() x height())，預設為 SH1106 的 128x64。
+     */
+    static QImage createIndexedImage(const QColor& onColor, const QColor& offColor,
+                                     const QSize& size = QSize(OledConfig::DISPLAY_WIDTH, OledConfig::DISPLAY_HEIGHT));
+
+    /**
+     * @brief 以掃描線方式把 model 的指定範圍寫入調色盤圖片。
+     *
+     * 直接讀取 model 的頁面 buffer，每個 byte 透過查表展開成 8 列的調色盤索引 (0/1)，
+     * 再寫進對應的 scanLine()，完全不經過 QColor 轉換。使用 model 目前面板的 kernel。
+     *
+     * @param model  來源資料模型。
+     * @param image  目標圖片，必須是 createIndexedImage() 建立的 Format_Indexed8 圖片。
+     * @param region 要更新的範圍 (邏輯座標)，會自動裁切到畫布範圍內。
+     */
+    static void renderModelToIndexedImage(const OledDataModel& model, QImage* image, const QRect& region);
 };
 
 #endif // OLEDDATACONVERTER_H
@@ -4,38 +4,312 @@
  * @brief 負責 OLED 顯示數據儲存與管理的模型類別實作。
  */
     #include "oled_datamodel.h"
-    #include "oledwidget_Paint.h"
+    #include "oled_bitpack.h"
+    #include "oled_codec.h"
     #include <algorithm>
     #include <QPoint>
     #include <cmath>
     #include <cstring>   // for memset, memcpy
+    #include <limits>
     #include <QPoint>    // Include QPoint here because we need its implementation for drawCircle
 
+namespace {
+
+/**
+ * @brief 方形筆刷沿著一串中心點蓋章後的聯集，逐列輸出成水平區段。
+ *
+ * 每一列記錄筆刷中心點的 x 範圍 (最多兩段：直線用一段，橢圓分左半與右半)。
+ * 第 y 列會被中心點落在 [y + off - (b - 1), y + off] 的筆刷蓋到，
+ * 把這幾列的範圍合併後往外擴張筆刷寬度，就是該列要填的區段。
+ * 路徑上的中心點是 8-連通的，所以合併後一定是連續的一段，每個像素只會寫一次。
+ */
+class BrushStamp
+{
+public:
+    BrushStamp(int brushSize, int runCount, int height)
+        : m_size(brushSize),
+          m_offset((brushSize - 1) / 2),
+          m_runCount(runCount),
+          m_height(height),
+          m_firstRow(m_offset - (brushSize - 1)),
+          m_rows(static_cast<size_t>(height + brushSize - 1) * runCount)
+    {
+    }
+
+    void add(int x, int y, int run = 0)
+    {
+        const int row = y - m_firstRow;
+        if (row < 0 || row >= m_height + m_size - 1) {
+            return; // 這個中心點的筆刷碰不到可視範圍
+        }
+        Range &range = m_rows[row * m_runCount + run];
+        range.lo = std::min(range.lo, x);
+        range.hi = std::max(range.hi, x);
+    }
+
+    // sink(x0, x1, y)：輸出一段尚未裁切的水平區段
+    template <typename Sink>
+    void emitSpans(Sink sink) const
+    {
+        for (int y = 0; y < m_height; ++y) {
+            Range merged[2];
+            for (int run = 0; run < m_runCount; ++run) {
+                for (int row = y; row < y + m_size; ++row) {
+                    const Range &range = m_rows[row * m_runCount + run];
+                    merged[run].lo = std::min(merged[run].lo, range.lo);
+                    merged[run].hi = std::max(merged[run].hi, range.hi);
+                }
+            }
+
+            Range &left = merged[0];
+            Range &right = merged[1];
+            if (left.valid() && right.valid() && right.lo <= left.hi + 1 && left.lo <= right.hi + 1) {
+                left.lo = std::min(left.lo, right.lo); // 兩段重疊時合併，避免重複寫入
+                left.hi = std::max(left.hi, right.hi);
+                right = Range();
+            }
+            for (const Range &range : merged) {
+                if (range.valid()) {
+                    sink(range.lo - m_offset, range.hi - m_offset + m_size - 1, y);
+                }
+            }
+        }
+    }
+
+private:
+    struct Range {
+        int lo = std::numeric_limits<int>::max();
+        int hi = std::numeric_limits<int>::min();
+        bool valid() const { return lo <= hi; }
+    };
+
+    int m_size;
+    int m_offset;
+    int m_runCount;
+    int m_height;               // 畫布高度
+    int m_firstRow;             // m_rows[0] 對應的中心列
+    std::vector<Range> m_rows;
+};
+
+}
+
 
 /**
  * @brief OledDataModel 建構子。
  *
- * 初始化邏輯緩衝區 (Logical Buffer)。
- * 緩衝區的大小由 OledConfig::DISPLAY_WIDTH 與 DISPLAY_HEIGHT 決定（通常是 128*64）。
- * 所有像素的預設狀態皆設為 false (代表黑色或關閉狀態)。
+ * 初始化頁面格式緩衝區 (Page Buffer)。
+ * 緩衝區的大小由面板的 RAM 頁寬與頁數決定（SH1106 為 132*8 = 1056 bytes），
+ * 與驅動晶片的 GDDRAM 佈局完全一致，包含 COLUMN_OFFSET 的填充欄位。
+ * 所有位元的預設狀態皆為 0 (代表黑色或關閉狀態)。
+ *
+ * @param geometry 面板幾何；無效的幾何會改用預設面板 (SH1106)。
  */
-    OledDataModel::OledDataModel()
-        // 初始化邏輯 buffer 為 128*64 的大小，所有值預設為 false (黑)
-        : m_logical_buffer(OledConfig::DISPLAY_WIDTH * OledConfig::DISPLAY_HEIGHT, false)
+    OledDataModel::OledDataModel(const OledPanelGeometry &geometry)
+    {
+        if (!setGeometry(geometry)) {
+            setGeometry(OledPanel::defaultProfile().geometry);
+        }
+    }
+
+    /**
+     * @brief 切換面板幾何。
+     *
+     * 重新配置頁面緩衝區並挑選對應的 kernel。可視尺寸和目前相同時 (例如 SH1106 <-> SSD1306)
+     * 每個圖層的內容以 OledPanel::repad() 搬到新的欄位位置；不同時只留下一個全黑的背景圖層。
+     * 舊的操作記錄以舊的欄位位置儲存，呼叫端需要一併清除操作歷史。
+     *
+     * @param[in] geometry 新的面板幾何。
+     * @return bool 幾何無效時不做任何修改並回傳 false。
+     */
+    bool OledDataModel::setGeometry(const OledPanelGeometry &geometry)
     {
+        if (!geometry.isValid()) {
+            return false;
+        }
+
+        const OledPanelGeometry previous = m_geometry;
+        const bool keepPixels = !m_layers.empty() && previous.width == geometry.width
+                                && previous.height == geometry.height;
+
+        m_geometry = geometry;
+        m_kernels = &OledPanel::kernelsFor(geometry);
+        m_buffer.assign(geometry.bufferSize(), 0);
+        m_dirtyTiles.assign(static_cast<size_t>(geometry.pageCount()) * ((geometry.width + 7) / 8), 0);
+        m_frameDirty = false;
 
+        if (keepPixels) {
+            for (Layer &layer : m_layers) {
+                std::vector<uint8_t> pages(geometry.bufferSize());
+                OledPanel::repad(previous, layer.pages.data(), geometry, pages.data());
+                layer.pages.swap(pages);
+            }
+        } else {
+            // 只留下一個不透明的背景圖層
+            m_layers.clear();
+            Layer background;
+            background.name = QString("background");
+            background.blend = BlendReplace;
+            background.pages.assign(geometry.bufferSize(), 0);
+            m_layers.push_back(std::move(background));
+            m_activeLayer = 0;
+        }
+        bindActiveLayer();
+
+        m_commandBefore.clear();
+        m_recording = false;
+        m_dirtyRect = QRect();
+        layersChanged();
+        return true;
     }
 
 
     /**
-     * @brief 清空顯示模型。
+     * @brief 清空顯示模型 (目前圖層)。
      *
-     * 使用 std::fill 將邏輯緩衝區內的所有像素值重置為 false。
+     * 使用 std::fill 將目前圖層的頁面緩衝區內的所有 byte 重置為 0，其他圖層不受影響。
      * 當需要重畫整個畫面或切換介面時會呼叫此函式。
     */
     void OledDataModel::clear()
     {
-        std::fill(m_logical_buffer.begin(), m_logical_buffer.end(), false);
+        saveAllPagesForCommand();
+        std::fill(m_plane, m_plane + m_geometry.bufferSize(), 0);
+        markAllDirty();
+    }
+
+    /**
+     * @brief 將一個矩形範圍併入髒區域。
+     *
+     * 輸入的矩形會先被裁切到可視範圍內，完全在畫面外的矩形不會有任何影響。
+     *
+     * @param[in] rect 被修改的範圍 (邏輯座標)。
+     */
+    void OledDataModel::markDirty(const QRect &rect)
+    {
+        const QRect clipped = rect.intersected(QRect(0, 0, m_geometry.width, m_geometry.height));
+        if (clipped.isValid()) {
+            m_dirtyRect = m_dirtyRect.united(clipped);
+            if (m_recording) {
+                m_commandRect = m_commandRect.united(clipped);
+            }
+            if (!m_passThrough) {
+                // 多圖層：記下需要重新合成的 tile
+                const int tilesPerRow = (m_geometry.width + 7) / 8;
+                for (int page = clipped.top() >> 3; page <= (clipped.bottom() >> 3); ++page) {
+                    uint8_t *tile = m_dirtyTiles.data() + page * tilesPerRow;
+                    std::fill(tile + (clipped.left() >> 3), tile + (clipped.right() >> 3) + 1, uint8_t(1));
+                }
+                m_frameDirty = true;
+            }
+        }
+    }
+
+    /**
+     * @brief 將整個畫面標記為髒區域，用於清除、整塊載入等全畫面操作。
+     */
+    void OledDataModel::markAllDirty()
+    {
+        markDirty(QRect(0, 0, m_geometry.width, m_geometry.height));
+    }
+
+    /**
+     * @brief 取出目前累積的髒區域並將其歸零。
+     *
+     * View 在同步畫面時呼叫此函式，只重新整理回傳的範圍。
+     *
+     * @return QRect 自上次呼叫以來被修改過的範圍；若沒有任何變更則為無效矩形。
+     */
+    QRect OledDataModel::takeDirtyRegion()
+    {
+        const QRect dirty = m_dirtyRect;
+        m_dirtyRect = QRect();
+        return dirty;
+    }
+
+    /**
+     * @brief 計算 (x, y) 在頁面緩衝區中的 byte 位置。
+     *
+     * page = y / 8，欄位需加上 COLUMN_OFFSET。呼叫端需自行保證座標在可視範圍內。
+     */
+    int OledDataModel::byteIndex(int x, int y) const
+    {
+        return (y >> 3) * m_geometry.ramPageWidth + (x + m_geometry.columnOffset);
+    }
+
+    /**
+     * @brief 不做邊界檢查的單點寫入，只對一個 byte 做遮罩運算。
+     */
+    void OledDataModel::setRawPixel(int x, int y, bool on)
+    {
+        if (m_recording && !(m_savedPages & (1u << (y >> 3)))) {
+            savePageForCommand(y >> 3);
+        }
+        const uint8_t mask = static_cast<uint8_t>(1u << (y & 7));
+        uint8_t &byte = m_plane[byteIndex(x, y)];
+        if (on) byte |= mask;
+        else    byte &= static_cast<uint8_t>(~mask);
+    }
+
+    /**
+     * @brief 寫入一段水平區段 [x0, x1] (第 y 列)。
+     *
+     * 頁面格式中同一列的像素落在同一頁、相鄰的 byte 上，只需要對連續的 byte 做同一個遮罩運算。
+     * 超出畫布的部分會被裁切掉。
+     */
+    void OledDataModel::fillSpan(int x0, int x1, int y, bool on)
+    {
+        if (y < 0 || y >= m_geometry.height) return;
+        x0 = std::max(x0, 0);
+        x1 = std::min(x1, m_geometry.width - 1);
+        if (x0 > x1) return;
+
+        const int page = y >> 3;
+        if (m_recording && !(m_savedPages & (1u << page))) {
+            savePageForCommand(page);
+        }
+
+        const uint8_t mask = static_cast<uint8_t>(1u << (y & 7));
+        uint8_t *p = m_plane + byteIndex(x0, y);
+        uint8_t *end = p + (x1 - x0 + 1);
+        if (on) {
+            for (; p != end; ++p) *p |= mask;
+        } else {
+            const uint8_t keep = static_cast<uint8_t>(~mask);
+            for (; p != end; ++p) *p &= keep;
+        }
+    }
+
+    /**
+     * @brief 填滿矩形 [x0, x1] x [y0, y1]。
+     *
+     * 每一頁先算出落在矩形內的列所對應的位元遮罩，再對每一欄做一次 OR / AND，
+     * 一次就寫好 8 列，成本是 O(面積 / 8)。超出畫布的部分會被裁切掉。
+     */
+    void OledDataModel::fillRect(int x0, int y0, int x1, int y1, bool on)
+    {
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        x1 = std::min(x1, m_geometry.width - 1);
+        y1 = std::min(y1, m_geometry.height - 1);
+        if (x0 > x1 || y0 > y1) return;
+
+        for (int page = y0 >> 3; page <= (y1 >> 3); ++page) {
+            const int top = std::max(y0, page * 8) & 7;
+            const int bottom = std::min(y1, page * 8 + 7) & 7;
+            const uint8_t mask = static_cast<uint8_t>((0xFFu << top) & (0xFFu >> (7 - bottom)));
+
+            if (m_recording && !(m_savedPages & (1u << page))) {
+                savePageForCommand(page);
+            }
+
+            uint8_t *p = m_plane + page * m_geometry.ramPageWidth + x0 + m_geometry.columnOffset;
+            uint8_t *end = p + (x1 - x0 + 1);
+            if (on) {
+                for (; p != end; ++p) *p |= mask;
+            } else {
+                const uint8_t keep = static_cast<uint8_t>(~mask);
+                for (; p != end; ++p) *p &= keep;
+            }
+        }
     }
 
     /**
@@ -48,6 +322,7 @@
      * - 當筆刷大小大於 1 時，它會以 (x, y) 為中心，繪製一個 `brushSize` x `brushSize` 的方形區域。
      *
      * 所有操作都會進行邊界檢查，以確保不會寫入到緩衝區範圍之外。
+     * 受影響的範圍會併入髒區域 (markDirty)，drawLine / drawRectangle / drawCircle 皆經由此處累積。
      *
      * @param[in] x         目標像素的 X 座標，或筆刷的中心 X 座標。
      * @param[in] y         目標像素的 Y 座標，或筆刷的中心 Y 座標。
@@ -59,8 +334,9 @@
         if (brushSize <= 1) {
             // 单点绘制
             // 如果笔刷大小大于 1，就画一个方块
-            if (x >= 0 && x < OledConfig::DISPLAY_WIDTH && y >= 0 && y < OledConfig::DISPLAY_HEIGHT){
-                m_logical_buffer[y * OledConfig::DISPLAY_WIDTH + x] = on;
+            if (x >= 0 && x < m_geometry.width && y >= 0 && y < m_geometry.height){
+                setRawPixel(x, y, on);
+                markDirty(QRect(x, y, 1, 1));
             }
 
         }else {
@@ -68,19 +344,10 @@
             // 例如，3x3 的笔刷，offset 是 1。循环 dx 从 0 到 2。
             // x + dx - offset 的范围就是 x-1, x, x+1。
             int offset = (brushSize - 1) / 2;
+            markDirty(QRect(x - offset, y - offset, brushSize, brushSize));
 
-            // 遍历笔刷覆盖的每一个点
-            for (int dy = 0; dy < brushSize; ++dy) {
-                for (int dx = 0; dx < brushSize; ++dx) {
-                    int px = x + dx - offset;
-                    int py = y + dy - offset;
-
-                    // 对每一个点都进行边界检查
-                    if (px >= 0 && px < OledConfig::DISPLAY_WIDTH && py >= 0 && py < OledConfig::DISPLAY_HEIGHT) {
-                        m_logical_buffer[py * OledConfig::DISPLAY_WIDTH + px] = on;
-                    }
-                }
-            }
+            // 整個方塊用頁面遮罩一次寫入 (裁切在 fillRect 內處理)
+            fillRect(x - offset, y - offset, x - offset + brushSize - 1, y - offset + brushSize - 1, on);
         }
 
     }
@@ -89,6 +356,7 @@
      * @brief 取得邏輯緩衝區中指定像素的狀態。
      *
      * 這是一個唯讀（const）的存取函數，用於查詢特定座標 (x, y) 上的像素是點亮 (`true`) 還是熄滅 (`false`)。
+     * 內部只需讀取一個 byte 並測試對應的位元。
      * 函數內部包含邊界檢查，如果查詢的座標超出了顯示範圍，將會安全地回傳 `false`。
      *
      * @param[in] x 要查詢的像素的 X 座標。
@@ -99,8 +367,8 @@
 
     bool OledDataModel::getPixel(int x, int y) const
     {
-        if (x >= 0 && x < OledConfig::DISPLAY_WIDTH && y >= 0 && y < OledConfig::DISPLAY_HEIGHT) {
-            return m_logical_buffer[y * OledConfig::DISPLAY_WIDTH + x];
+        if (x >= 0 && x < m_geometry.width && y >= 0 && y < m_geometry.height) {
+            return (getBuffer()[byteIndex(x, y)] >> (y & 7)) & 0x01;
         }
         return false;
     }
@@ -145,17 +413,119 @@
 
     void OledDataModel::drawLine(int x0, int y0, int x1, int y1, bool on,int brushSize)
     {
+        // 整條線的範圍 (含筆刷) 一次標記為髒區域
+        const int size = std::max(brushSize, 1);
+        const int offset = (size - 1) / 2;
+        markDirty(QRect(QPoint(std::min(x0, x1) - offset, std::min(y0, y1) - offset),
+                        QPoint(std::max(x0, x1) - offset + size - 1, std::max(y0, y1) - offset + size - 1)));
+
         int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
         int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
         int err = dx + dy, e2;
 
+        if (size == 1) {
+            for (;;) {
+                if (x0 >= 0 && x0 < m_geometry.width && y0 >= 0 && y0 < m_geometry.height) {
+                    setRawPixel(x0, y0, on);
+                }
+                if (x0 == x1 && y0 == y1) break;
+                e2 = 2 * err;
+                if (e2 >= dy) { err += dy; x0 += sx; }
+                if (e2 <= dx) { err += dx; y0 += sy; }
+            }
+            return;
+        }
+
+        // 粗線：先記錄每一列的筆刷中心範圍，再逐列輸出一段水平區段 (不再每一步蓋一個方塊)
+        BrushStamp stamp(size, 1, m_geometry.height);
         for (;;) {
-            setPixel(x0, y0, on,brushSize); // 直接呼叫簡單的 setPixel
+            stamp.add(x0, y0);
             if (x0 == x1 && y0 == y1) break;
             e2 = 2 * err;
             if (e2 >= dy) { err += dy; x0 += sx; }
             if (e2 <= dx) { err += dx; y0 += sy; }
         }
+        stamp.emitSpans([this, on](int spanX0, int spanX1, int y) { fillSpan(spanX0, spanX1, y, on); });
+    }
+
+    /**
+     * @brief 繪製指定端點樣式的粗線。
+     *
+     * - SquareCap：與 drawLine() 相同，方形筆刷沿著線段移動。
+     * - RoundCap：膠囊形，包含所有與線段距離在半個線寬以內的像素。
+     *   膠囊是凸形，與每一列的交集都是一段連續區段，可以直接解出左右端點，
+     *   不需要逐點測試，也沒有重複寫入。
+     *
+     * @param width 線寬 (像素)，小於等於 1 時等同 drawLine()。
+     */
+    void OledDataModel::drawThickLine(int x0, int y0, int x1, int y1, bool on, int width, LineCap cap)
+    {
+        if (cap == SquareCap || width <= 1) {
+            drawLine(x0, y0, x1, y1, on, width);
+            return;
+        }
+
+        // 與方形筆刷相同的對齊方式：偶數寬度時中心落在兩個像素之間
+        const int offset = (width - 1) / 2;
+        const double shift = (width - 1) / 2.0 - offset;
+        const double ax = x0 + shift, ay = y0 + shift;
+        const double bx = x1 + shift, by = y1 + shift;
+        // 半徑略大於 (width - 1) / 2，讓水平/垂直線剛好是 width 個像素寬，斜線邊緣也比較圓滑
+        const double radius = (width - 1) / 2.0 + 0.3;
+
+        const double dx = bx - ax, dy = by - ay;
+        const double len2 = dx * dx + dy * dy;
+        const double len = std::sqrt(len2);
+
+        const int top = static_cast<int>(std::floor(std::min(ay, by) - radius));
+        const int bottom = static_cast<int>(std::ceil(std::max(ay, by) + radius));
+        markDirty(QRect(QPoint(static_cast<int>(std::floor(std::min(ax, bx) - radius)), top),
+                        QPoint(static_cast<int>(std::ceil(std::max(ax, bx) + radius)), bottom)));
+
+        // 線性條件 lo <= a * x + c <= hi 的 x 範圍，與 [xmin, xmax] 取交集
+        auto clampLinear = [](double a, double c, double lo, double hi, double &xmin, double &xmax) {
+            if (a == 0.0) {
+                if (c < lo || c > hi) { xmin = 1.0; xmax = 0.0; }
+                return;
+            }
+            double from = (lo - c) / a, to = (hi - c) / a;
+            if (from > to) std::swap(from, to);
+            xmin = std::max(xmin, from);
+            xmax = std::min(xmax, to);
+        };
+
+        const double eps = 1e-9;
+        for (int y = std::max(top, 0); y <= std::min(bottom, m_geometry.height - 1); ++y) {
+            double lo = std::numeric_limits<double>::max();
+            double hi = std::numeric_limits<double>::lowest();
+
+            // 兩端的圓
+            const double ends[2][2] = {{ax, ay}, {bx, by}};
+            for (const auto &end : ends) {
+                const double h = radius * radius - (y - end[1]) * (y - end[1]);
+                if (h >= 0.0) {
+                    const double half = std::sqrt(h);
+                    lo = std::min(lo, end[0] - half);
+                    hi = std::max(hi, end[0] + half);
+                }
+            }
+
+            // 中間的長方形：投影落在線段上、且垂直距離 <= radius
+            if (len2 > 0.0) {
+                double xmin = std::numeric_limits<double>::lowest();
+                double xmax = std::numeric_limits<double>::max();
+                clampLinear(dx, (y - ay) * dy - ax * dx, 0.0, len2, xmin, xmax);
+                clampLinear(dy, -ax * dy - (y - ay) * dx, -radius * len, radius * len, xmin, xmax);
+                if (xmin <= xmax) {
+                    lo = std::min(lo, xmin);
+                    hi = std::max(hi, xmax);
+                }
+            }
+
+            if (lo <= hi) {
+                fillSpan(static_cast<int>(std::ceil(lo - eps)), static_cast<int>(std::floor(hi + eps)), y, on);
+            }
+        }
     }
 
     /**
@@ -186,11 +556,12 @@
         int y1 = std::max(y, y + h);
 
         if (fill) {
-            for (int i = y0; i <= y1; ++i) {
-                for (int j = x0; j <= x1; ++j) { // 實心矩形甚至可以更簡單
-                    setPixel(j, i, on, brushSize);
-                }
-            }
+            // 實心矩形加上筆刷後仍然是一個矩形，直接以頁面遮罩填滿 (每個像素只寫一次)
+            const int size = std::max(brushSize, 1);
+            const int offset = (size - 1) / 2;
+            const QRect area(QPoint(x0 - offset, y0 - offset), QPoint(x1 - offset + size - 1, y1 - offset + size - 1));
+            markDirty(area);
+            fillRect(area.left(), area.top(), area.right(), area.bottom(), on);
         } else {
             drawLine(x0, y0, x1, y0, on,brushSize);
             drawLine(x0, y1, x1, y1, on,brushSize);
@@ -275,6 +646,29 @@
         */
         long p = b2 - a2 * b + (a2 / 4);
 
+        // --- 輸出方式 ---
+        // 筆刷為 1 時直接寫點；筆刷較大時只記錄中心點 (左半 / 右半各一段)，
+        // 最後逐列輸出水平區段，圓周上重疊的方塊不會被重複寫入。
+        const int size = std::max(brushSize, 1);
+        const int offset = (size - 1) / 2;
+        BrushStamp stamp(size, size > 1 ? 2 : 0, m_geometry.height); // 筆刷為 1 時用不到，不配置記憶體
+        int minX = std::numeric_limits<int>::max(), maxX = std::numeric_limits<int>::min();
+        int minY = std::numeric_limits<int>::max(), maxY = std::numeric_limits<int>::min();
+        auto plot = [&](long px, long py, int run) {
+            const int ix = static_cast<int>(px), iy = static_cast<int>(py);
+            minX = std::min(minX, ix); maxX = std::max(maxX, ix);
+            minY = std::min(minY, iy); maxY = std::max(maxY, iy);
+            if (size > 1) {
+                stamp.add(ix, iy, run);
+            } else if (ix >= 0 && ix < m_geometry.width && iy >= 0 && iy < m_geometry.height) {
+                setRawPixel(ix, iy, true);
+            }
+        };
+        auto plotQuadrants = [&](long qx, long qy) {
+            plot(xc + qx, yc + qy, 1); plot(xc - qx, yc + qy, 0);
+            plot(xc + qx, yc - qy, 1); plot(xc - qx, yc - qy, 0);
+        };
+
 
         // --- 區域 1：處理斜率絕對值 < 1 的部分 (x 變化比 y 快) ---
         /**
@@ -284,8 +678,7 @@
             * 停止條件：當斜率達到 -1 (即 2b²x >= 2a²y) 時，切換到區域 2。
         */
         while (two_b2 * x < two_a2 * y) {
-            setPixel(xc + x, yc + y, true,brushSize); setPixel(xc - x, yc + y, true,brushSize);
-            setPixel(xc + x, yc - y, true,brushSize); setPixel(xc - x, yc - y, true,brushSize);
+            plotQuadrants(x, y);
             x++;
             if (p < 0) { p += two_b2 * x + b2; }
             else { y--; p += two_b2 * x + b2 - two_a2 * y; }
@@ -306,84 +699,144 @@
             * 停止條件：當 y 降到 0 (到達水平中軸) 時，整個 1/4 圓弧繪製完成。
         */
         while (y >= 0) {
-            setPixel(xc + x, yc + y, true,brushSize); setPixel(xc - x, yc + y, true,brushSize);
-            setPixel(xc + x, yc - y, true,brushSize); setPixel(xc - x, yc - y, true,brushSize);
+            plotQuadrants(x, y);
             y--;
             if (p > 0) { p -= two_a2 * y + a2; }
             else { x++; p += two_b2 * x - two_a2 * y + a2; }
         }
-    }
 
+        if (size > 1) {
+            stamp.emitSpans([this](int spanX0, int spanX1, int row) { fillSpan(spanX0, spanX1, row, true); });
+        }
+        markDirty(QRect(QPoint(minX - offset, minY - offset), QPoint(maxX - offset + size - 1, maxY - offset + size - 1)));
+    }
 
 
-    // --- 翻譯層：只在這裡處理硬體格式 ---
 
-    // 翻譯官 1: 將內部邏輯 buffer 翻譯成硬體 buffer
     /**
-     * @brief 取得符合硬體格式的顯示緩衝區。
+     * @brief 把頁面格式的點陣 (例如字型的字元) 貼到目前圖層。
      *
-     * 此函數將內部儲存的邏輯像素緩衝區（二維概念）轉換為 OLED 硬體所需的特定一維頁面式（page-based）緩衝區格式。
-     * 轉換過程涉及複雜的位元運算，將每個像素點對應到硬體緩衝區中特定位元組的特定位元。
-     * OLED 的記憶體是分頁的，每頁 8 個像素高。此函數會將 (x, y) 座標轉換為 (page, column, bit) 的對應關係。
+     * 來源與畫布同樣是「一個 byte = 一欄的 8 個垂直像素」，所以：
+     * - y 是 8 的倍數時，來源的每個 byte 剛好對上畫布的一個 byte，逐 byte OR (或 AND ~) 即可；
+     * - 否則來源的一頁會跨到畫布的兩頁，下半部左移 (y & 7)、上半部右移 8 - (y & 7) 後分別寫入。
+     * 兩種情況的成本都是 O(寬 x 頁數)，不需要逐點運算。
      *
-     * @return std::vector<uint8_t> 一個包含可以直接寫入 OLED RAM 的原始資料的緩衝區。
-     * @see setFromHardwareBuffer()
+     * @param[in] x, y    左上角 (邏輯座標)，可以是負的 (部分在畫面外)。
+     * @param[in] src     width * ((height + 7) / 8) bytes，頁優先。
+     * @param[in] width   欄數。
+     * @param[in] height  列數；最後一頁超過 height 的 bit 不會被寫入。
+     * @param[in] on      true 點亮 src 中點亮的像素，false 把它們熄滅；src 沒點亮的像素不變。
      */
-    std::vector<uint8_t> OledDataModel::getHardwareBuffer() const
+    void OledDataModel::blitPages(int x, int y, const uint8_t *src, int width, int height, bool on)
     {
-        std::vector<uint8_t> hardware_buffer(OledConfig::RAM_PAGE_WIDTH * (OledConfig::DISPLAY_HEIGHT / 8), 0);
+        const int x0 = std::max(x, 0);
+        const int x1 = std::min(x + width, m_geometry.width);   // 不含
+        if (!src || x0 >= x1 || height <= 0 || y >= m_geometry.height || y + height <= 0) return;
 
-        for (int y = 0; y < OledConfig::DISPLAY_HEIGHT; ++y) {
-            for (int x = 0; x < OledConfig::DISPLAY_WIDTH; ++x) {
-                if (getPixel(x, y)) { // 讀取簡單的邏輯 buffer
-                    // 進行複雜的位元運算，寫入到硬體 buffer
-                    int page = y / 8;
-                    int bit_index = y % 8;
-                    int byte_index = page * OledConfig::RAM_PAGE_WIDTH + (x + OledConfig::COLUMN_OFFSET);
-                    //int byte_index = page * OledConfig::RAM_PAGE_WIDTH + x;
+        const int shift = y & 7;
+        const int firstPage = y >> 3;                               // y 為負時向下取整
+        const int lastVisiblePage = (m_geometry.height - 1) >> 3;
+        const int bottomRows = m_geometry.height & 7;               // 最後一頁只有前幾列可見
+        const uint8_t bottomMask = bottomRows ? static_cast<uint8_t>((1u << bottomRows) - 1) : uint8_t(0xFF);
+        const int srcPages = (height + 7) >> 3;
+        const int columns = x1 - x0;
 
-                    if (byte_index < hardware_buffer.size()) {
-                        hardware_buffer[byte_index] |= (1 << bit_index);
-                    }
+        // 把 src 的一頁 (已套用 keep 遮罩並移位) 寫進畫布的第 page 頁
+        auto writePage = [&](int page, const uint8_t *s, uint8_t keep, int left, int right) {
+            if (page < 0 || page > lastVisiblePage) return;
+            uint8_t mask = static_cast<uint8_t>(((keep << left) & 0xFF) >> right);
+            if (page == lastVisiblePage) mask &= bottomMask;
+            if (!mask) return;
+            if (m_recording && !(m_savedPages & (1u << page))) {
+                savePageForCommand(page);
+            }
+            uint8_t *d = m_plane + page * m_geometry.ramPageWidth + x0 + m_geometry.columnOffset;
+            if (left == 0 && right == 0) {
+                // 頁對齊：整個 byte 直接寫入
+                if (on) {
+                    for (int i = 0; i < columns; ++i) d[i] |= s[i] & mask;
+                } else {
+                    for (int i = 0; i < columns; ++i) d[i] &= static_cast<uint8_t>(~(s[i] & mask));
                 }
+            } else if (on) {
+                for (int i = 0; i < columns; ++i) d[i] |= static_cast<uint8_t>(((s[i] << left) & 0xFF) >> right) & mask;
+            } else {
+                for (int i = 0; i < columns; ++i) d[i] &= static_cast<uint8_t>(~((((s[i] << left) & 0xFF) >> right) & mask));
+            }
+        };
+
+        for (int page = 0; page < srcPages; ++page) {
+            const int rows = std::min(8, height - page * 8);
+            const uint8_t keep = static_cast<uint8_t>(0xFFu >> (8 - rows));
+            const uint8_t *s = src + page * width + (x0 - x);
+            writePage(firstPage + page, s, keep, shift, 0);
+            if (shift) {
+                writePage(firstPage + page + 1, s, keep, 0, 8 - shift);
             }
         }
-        return hardware_buffer;
+        markDirty(QRect(x, y, width, height));
     }
 
 
-    // 翻譯官 2: 將外部硬體 buffer 翻譯並載入到內部邏輯 buffer
+
+    // --- 翻譯層：內部 buffer 已是硬體格式，翻譯只剩下複製 ---
+
     /**
-     * @brief 從硬體格式的緩衝區載入像素資料到內部邏輯緩衝區。
-     *
-     * 此函數執行與 getHardwareBuffer() 相反的操作。它接收一個指向原始硬體資料的指標，
-     * 解析其分頁式（page-based）的結構，並將其轉換回內部使用的二維邏輯像素表示。
-     * 這常用於從硬體讀取當前顯示內容時。
+     * @brief 取得內部頁面緩衝區的唯讀指標。
      *
-     * @note 在載入新資料前，會先呼叫 clear() 清空當前的邏輯緩衝區。
-     * @param[in] data 指向符合 OLED 硬體格式的原始資料緩衝區的指標。如果為 nullptr，則函數不做任何事。
-     * @see getHardwareBuffer()
+     * 緩衝區大小為 bufferSize()，佈局與 getHardwareBuffer() 回傳的內容完全相同，
+     * 適合需要避免複製的呼叫端 (例如預覽或比對)。
      */
-    void OledDataModel::setFromHardwareBuffer(const uint8_t* data)
+    const uint8_t* OledDataModel::getBuffer() const
     {
-        clear(); // 先清空
-        if (!data) return;
+        if (m_passThrough) {
+            return m_plane; // 只有一個可見圖層，合成結果就是它本身
+        }
+        if (m_frameDirty) {
+            flatten();
+        }
+        return m_buffer.data();
+    }
 
-        for (int page = 0; page < (OledConfig::DISPLAY_HEIGHT / 8); ++page) {
-            for (int x = 0; x < OledConfig::DISPLAY_WIDTH; ++x) {
+    /**
+     * @brief 取得符合硬體格式的顯示緩衝區。
+     *
+     * 內部緩衝區本身就是 OLED 硬體所需的頁面式（page-based）格式：
+     * 每頁 8 個像素高，一個 byte 代表一欄中的 8 個像素，並已包含 COLUMN_OFFSET 的填充欄。
+     * 因此這裡不再需要逐點的位元運算，只需整塊複製即可。
+     *
+     * @return std::vector<uint8_t> 一個包含可以直接寫入 OLED RAM 的原始資料的緩衝區。
+     * @see setFromHardwareBuffer()
+     */
+    std::vector<uint8_t> OledDataModel::getHardwareBuffer() const
+    {
+        const uint8_t *frame = getBuffer();
+        return std::vector<uint8_t>(frame, frame + m_geometry.bufferSize());
+    }
 
-                int byte_index = page * OledConfig::RAM_PAGE_WIDTH + (x + OledConfig::COLUMN_OFFSET);
-                //int byte_index = page * OledConfig::RAM_PAGE_WIDTH + x;
 
-                uint8_t byte = data[byte_index];
-                for (int bit = 0; bit < 8; ++bit) {
-                    if ((byte >> bit) & 0x01) {
-                        int y = page * 8 + bit;
-                        setPixel(x, y, true); // 寫入簡單的邏輯 buffer
-                    }
-                }
-            }
+    /**
+     * @brief 從硬體格式的緩衝區載入像素資料到內部緩衝區。
+     *
+     * 此函數執行與 getHardwareBuffer() 相反的操作。由於兩者格式相同，
+     * 只需 memcpy 整塊資料，再把可視範圍外的填充欄 (COLUMN_OFFSET 左右兩側) 清為 0，
+     * 確保畫布上看不到的位元不會被帶進之後的匯出結果。
+     *
+     * @param[in] data 指向符合 OLED 硬體格式的原始資料緩衝區的指標 (至少 bufferSize() bytes)。
+     *                 如果為 nullptr，則只清空畫布。
+     * @see getHardwareBuffer()
+     */
+    void OledDataModel::setFromHardwareBuffer(const uint8_t* data)
+    {
+        if (!data) {
+            clear();
+            return;
         }
+
+        saveAllPagesForCommand();
+        // 複製整塊資料並清除不可見的填充欄位 (依面板幾何使用特化的 kernel)
+        m_kernels->loadFrame(m_geometry, m_plane, data);
+        markAllDirty();
     }
 
 
@@ -394,14 +847,14 @@
      * 使用邏輯格式（1-bit monochrome）的 QImage 物件。
      * 這對於實現複製/貼上功能或預覽局部區域非常有用。
      *
-     * @param[in] region 要複製的來源區域，使用邏輯座標 (0,0 到 DISPLAY_WIDTH-1, DISPLAY_HEIGHT-1)。
+     * @param[in] region 要複製的來源區域，使用邏輯座標 (0,0 到 width()-1, height()-1)。
      * @return QImage 一個包含指定區域像素資料的 QImage。如果指定區域無效或在邊界外，則回傳一個空的 QImage。
      * @see convertLogicalToHardwareFormat()
      */
     QImage OledDataModel::copyRegionToLogicalFormat(const QRect& region) const
     {
         // 确保 region 在有效范围内
-        QRect validRegion = region.intersected(QRect(0, 0, OledConfig::DISPLAY_WIDTH, OledConfig::DISPLAY_HEIGHT));
+        QRect validRegion = region.intersected(QRect(0, 0, m_geometry.width, m_geometry.height));
         if (!validRegion.isValid()) {
             return QImage(); // 返回一个空的 QImage
         }
@@ -409,17 +862,8 @@
         QImage logicalCopy(validRegion.size(), QImage::Format_Mono);
         logicalCopy.fill(0);
 
-        for (int y = 0; y < validRegion.height(); ++y) {
-            for (int x = 0; x < validRegion.width(); ++x) {
-                int sourceX = validRegion.left() + x;
-                int sourceY = validRegion.top() + y;
-
-                // 直接访问内部的 m_logical_buffer，效率更高
-                if (getPixel(sourceX, sourceY)) {
-                    logicalCopy.setPixel(x, y, 1);
-                }
-            }
-        }
+        // 依頁面整塊轉置成 scanLine (索引 1 = 點亮)
+        m_kernels->copyToMono(m_geometry, getBuffer(), validRegion, &logicalCopy);
         return logicalCopy;
     }
 
@@ -431,7 +875,7 @@
      * 而不是類別實例的內部緩衝區。它會處理欄位偏移（COLUMN_OFFSET）和頁尾填充，
      * 產生一個完整的、符合硬體規範的資料緩衝區。
      *
-     * @param[in] logicalImage 要轉換的來源圖片，必須是 QImage::Format_Mono 格式。
+     * @param[in] logicalImage 要轉換的來源圖片，必須是 QImage::Format_Mono 或 QImage::Format_MonoLSB 格式。
      * @return QVector<uint8_t> 一個包含轉換後的硬體格式資料的 QVector。如果輸入圖片格式不正確，則回傳一個空的 QVector。
      * @note 請注意，此實現將 QImage 中像素索引為 0 的點（通常是白色）設置為硬體緩衝區中的亮點（對應位元為 1）。
      *       如果您的 QImage 使用相反的約定（例如，黑色為亮點），請在使用前進行相應的影像處理（如 invertPixels()）。
@@ -440,31 +884,417 @@
      */
     QVector<uint8_t> OledDataModel::convertLogicalToHardwareFormat(const QImage& logicalImage)
     {
-        // 确保传入的是单色图
-        if (logicalImage.format() != QImage::Format_Mono) {
+        // 确保传入的是单色图 (Format_Mono 或 Format_MonoLSB)
+        if (logicalImage.format() != QImage::Format_Mono && logicalImage.format() != QImage::Format_MonoLSB) {
             // 如果不是，可以先转换或返回空
             return QVector<uint8_t>();
         }
 
         int w = logicalImage.width();
         int h = logicalImage.height();
-
-        QVector<uint8_t> hardwareData;
         int pages = (h + 7) / 8;
 
-        for (int page = 0; page < pages; ++page) {
-            for (int x = 0; x < w; ++x) {
-                uint8_t byte = 0;
-                for (int bit = 0; bit < 8; ++bit) {
-                    int currentY = page * 8 + bit;
-                    if (currentY < h) {
-                        if (logicalImage.pixelIndex(x, currentY) != 0) {
-                            byte |= (1 << bit);
-                        }
+        // 单色图的 scanLine 本身就是水平定址的位元资料，直接以 8x8 区块转置成页面格式
+        QVector<uint8_t> hardwareData(pages * w);
+        OledBitPacker::rowsToPages(logicalImage.constBits(), static_cast<int>(logicalImage.bytesPerLine()), w, h,
+                                   logicalImage.format() == QImage::Format_Mono ? OledBitPacker::MsbFirst
+                                                                                : OledBitPacker::LsbFirst,
+                                   hardwareData.data(), w);
+        return hardwareData;
+    }
+
+
+
+    // --- 操作記錄 (Command) ---
+
+    /**
+     * @brief 開始記錄一筆可逆操作。
+     *
+     * 之後所有的繪圖呼叫在第一次寫到某一頁時，會先把該頁的原始內容保存起來 (copy-on-write)，
+     * 同時累積被改動的範圍。沒有被寫到的頁面完全不會被複製。
+     *
+     * @see endCommand()
+     */
+    void OledDataModel::beginCommand()
+    {
+        if (m_commandBefore.size() != m_buffer.size()) {
+            m_commandBefore.resize(m_buffer.size());
+        }
+        // 記錄的是目前圖層；記錄中不能切換圖層 (見 setActiveLayer)
+        m_recording = true;
+        m_savedPages = 0;
+        m_commandRect = QRect();
+    }
+
+    /**
+     * @brief 結束記錄，取出被改動窗口在操作前後的差異。
+     *
+     * 窗口是「被改動範圍所跨越的頁面」x「被改動的欄位」，
+     * 操作前保存的頁面與目前的 buffer 逐 byte XOR 後以 PackBits 壓縮 (沒改到的 byte 都是 0，
+     * 清除畫面或匯入這種整個窗口的操作也只比原始的一份略大，不必存前後兩份)。
+     *
+     * @param[in]  type    操作種類 (畫筆、矩形、貼上…)。
+     * @param[out] command 輸出的操作記錄。
+     * @return bool 有實際改動時回傳 true；沒有任何變化 (例如在同一點上重畫) 則回傳 false。
+     */
+    bool OledDataModel::endCommand(OledEditCommand::Type type, OledEditCommand* command)
+    {
+        const bool wasRecording = m_recording;
+        m_recording = false;
+
+        if (!wasRecording || !command || !m_commandRect.isValid()) {
+            return false;
+        }
+
+        OledEditCommand result;
+        result.type = type;
+        result.layer = m_activeLayer;
+        result.region = m_commandRect;
+        result.firstPage = m_commandRect.top() / 8;
+        result.lastPage = m_commandRect.bottom() / 8;
+        result.firstColumn = m_commandRect.left() + m_geometry.columnOffset;
+        result.lastColumn = m_commandRect.right() + m_geometry.columnOffset;
+
+        const int columns = result.columnCount();
+        const size_t windowSize = size_t(columns) * size_t(result.pageCount());
+        m_commandDelta.resize(windowSize);
+
+        uint8_t changed = 0;
+        for (int page = result.firstPage; page <= result.lastPage; ++page) {
+            const int source = page * m_geometry.ramPageWidth + result.firstColumn;
+            uint8_t *target = m_commandDelta.data() + size_t(page - result.firstPage) * size_t(columns);
+            for (int column = 0; column < columns; ++column) {
+                target[column] = m_commandBefore[size_t(source + column)] ^ m_plane[source + column];
+                changed |= target[column];
+            }
+        }
+        if (changed == 0) {
+            return false;
+        }
+
+        const std::vector<uint8_t> encoded =
+            OledCodec::encode(OledCodec::PackBits, m_commandDelta.data(), windowSize, columns);
+        result.delta = QByteArray(reinterpret_cast<const char *>(encoded.data()), int(encoded.size()));
+
+        *command = std::move(result);
+        return true;
+    }
+
+    /**
+     * @brief 反向 (undo) 或正向 (redo) 套用一筆操作記錄。
+     *
+     * 把記錄中的差異解壓後 XOR 回窗口，並將該範圍標記為髒區域，讓 View 只重畫這一塊。
+     * XOR 兩個方向都一樣：undo 時窗口是操作後的內容，redo 時是操作前的內容。
+     *
+     * @param[in] command 要套用的操作記錄。
+     * @param[in] undo    true 回到操作前內容，false 回到操作後內容 (兩者的運算相同，只是語意)。
+     */
+    void OledDataModel::applyCommand(const OledEditCommand& command, bool undo)
+    {
+        Q_UNUSED(undo);
+        const int columns = command.columnCount();
+        if (columns <= 0 || command.pageCount() <= 0
+            || command.layer < 0 || command.layer >= layerCount()) {
+            return;
+        }
+
+        const size_t windowSize = size_t(columns) * size_t(command.pageCount());
+        m_commandDelta.resize(windowSize);
+        if (!OledCodec::decode(OledCodec::PackBits, reinterpret_cast<const uint8_t *>(command.delta.constData()),
+                               size_t(command.delta.size()), m_commandDelta.data(), windowSize, columns)) {
+            return;
+        }
+
+        uint8_t *target = m_layers[command.layer].pages.data();
+        for (int page = command.firstPage; page <= command.lastPage; ++page) {
+            uint8_t *row = target + page * m_geometry.ramPageWidth + command.firstColumn;
+            const uint8_t *delta = m_commandDelta.data() + size_t(page - command.firstPage) * size_t(columns);
+            for (int column = 0; column < columns; ++column) {
+                row[column] ^= delta[column];
+            }
+        }
+        markDirty(command.region);
+    }
+
+    /**
+     * @brief 記錄中第一次寫到某一頁時，保存該頁原始內容。
+     */
+    void OledDataModel::savePageForCommand(int page)
+    {
+        const int offset = page * m_geometry.ramPageWidth;
+        std::memcpy(m_commandBefore.data() + offset, m_plane + offset, m_geometry.ramPageWidth);
+        m_savedPages |= (1u << page);
+    }
+
+    /**
+     * @brief 整塊覆寫 (clear / setFromHardwareBuffer) 前保存所有尚未保存的頁面。
+     */
+    void OledDataModel::saveAllPagesForCommand()
+    {
+        if (!m_recording) {
+            return;
+        }
+        for (int page = 0; page < m_geometry.pageCount(); ++page) {
+            if (!(m_savedPages & (1u << page))) {
+                savePageForCommand(page);
+            }
+        }
+    }
+
+
+
+    // --- 圖層 (Layer) ---
+
+    namespace {
+
+    // 讀寫一個 tile (同一頁中相鄰的最多 8 欄)；畫布寬度不是 8 的倍數時最後一個 tile 不足 8 欄
+    inline uint64_t loadTile(const uint8_t *p, int columns)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, p, static_cast<size_t>(columns));
+        return word;
+    }
+
+    inline void storeTile(uint8_t *p, uint64_t word, int columns)
+    {
+        std::memcpy(p, &word, static_cast<size_t>(columns));
+    }
+
+    const char *const kBlendModeNames[] = {"or", "and", "xor", "replace", "mask"};
+
+    }
+
+    /**
+     * @brief 合成方式的名稱 (繪圖腳本與命令列工具使用)。
+     */
+    QString OledDataModel::blendModeName(BlendMode mode)
+    {
+        return QString::fromLatin1(kBlendModeNames[mode]);
+    }
+
+    /**
+     * @brief 由名稱 (不分大小寫) 取得合成方式。
+     * @return bool 名稱無效時回傳 false，*mode 不變。
+     */
+    bool OledDataModel::blendModeFromName(const QString &name, BlendMode *mode)
+    {
+        for (int i = 0; i <= BlendMask; ++i) {
+            if (name.compare(QString::fromLatin1(kBlendModeNames[i]), Qt::CaseInsensitive) == 0) {
+                if (mode) *mode = static_cast<BlendMode>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 在最上層加入一個空白圖層，並回傳它的索引。
+     *
+     * 目前圖層不變 (需要時呼叫 setActiveLayer())。新圖層全黑，加入後畫面不會改變，
+     * 但是會離開單一圖層的直通模式，之後的修改改為逐 tile 合成。
+     */
+    int OledDataModel::addLayer(const QString &name, BlendMode mode)
+    {
+        Layer layer;
+        layer.name = name;
+        layer.blend = mode;
+        layer.pages.assign(m_geometry.bufferSize(), 0);
+        m_layers.push_back(std::move(layer));
+        bindActiveLayer();
+        layersChanged();
+        return layerCount() - 1;
+    }
+
+    /**
+     * @brief 移除圖層。
+     *
+     * 至少會保留一個圖層，記錄操作中也不能移除。
+     * 操作記錄以圖層索引保存，移除或搬移圖層後呼叫端需要清除操作歷史。
+     */
+    bool OledDataModel::removeLayer(int index)
+    {
+        if (m_recording || index < 0 || index >= layerCount() || layerCount() == 1) {
+            return false;
+        }
+        m_layers.erase(m_layers.begin() + index);
+        if (m_activeLayer > index || m_activeLayer >= layerCount()) {
+            --m_activeLayer;
+        }
+        bindActiveLayer();
+        layersChanged();
+        return true;
+    }
+
+    /**
+     * @brief 把圖層從 from 搬到 to (索引越大越上層)，目前圖層會跟著移動。
+     */
+    bool OledDataModel::moveLayer(int from, int to)
+    {
+        if (m_recording || from < 0 || from >= layerCount() || to < 0 || to >= layerCount()) {
+            return false;
+        }
+        if (from == to) {
+            return true;
+        }
+
+        const int active = m_activeLayer;
+        Layer moving = std::move(m_layers[from]);
+        m_layers.erase(m_layers.begin() + from);
+        m_layers.insert(m_layers.begin() + to, std::move(moving));
+
+        if (active == from) {
+            m_activeLayer = to;
+        } else if (from < active && active <= to) {
+            --m_activeLayer;
+        } else if (to <= active && active < from) {
+            ++m_activeLayer;
+        }
+        bindActiveLayer();
+        layersChanged();
+        return true;
+    }
+
+    /**
+     * @brief 依名稱尋找圖層。
+     * @return int 第一個同名圖層的索引，找不到時回傳 -1。
+     */
+    int OledDataModel::findLayer(const QString &name) const
+    {
+        for (int i = 0; i < layerCount(); ++i) {
+            if (m_layers[i].name == name) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief 切換之後繪圖要寫入的圖層。
+     * @return bool 索引無效或正在記錄操作時回傳 false。
+     */
+    bool OledDataModel::setActiveLayer(int index)
+    {
+        if (m_recording || index < 0 || index >= layerCount()) {
+            return false;
+        }
+        m_activeLayer = index;
+        bindActiveLayer();
+        return true;
+    }
+
+    QString OledDataModel::layerName(int index) const
+    {
+        return (index >= 0 && index < layerCount()) ? m_layers[index].name : QString();
+    }
+
+    void OledDataModel::setLayerName(int index, const QString &name)
+    {
+        if (index >= 0 && index < layerCount()) {
+            m_layers[index].name = name;
+        }
+    }
+
+    bool OledDataModel::isLayerVisible(int index) const
+    {
+        return index >= 0 && index < layerCount() && m_layers[index].visible;
+    }
+
+    void OledDataModel::setLayerVisible(int index, bool visible)
+    {
+        if (index >= 0 && index < layerCount() && m_layers[index].visible != visible) {
+            m_layers[index].visible = visible;
+            layersChanged();
+        }
+    }
+
+    OledDataModel::BlendMode OledDataModel::layerBlendMode(int index) const
+    {
+        return (index >= 0 && index < layerCount()) ? m_layers[index].blend : BlendOr;
+    }
+
+    void OledDataModel::setLayerBlendMode(int index, BlendMode mode)
+    {
+        if (index >= 0 && index < layerCount() && m_layers[index].blend != mode) {
+            m_layers[index].blend = mode;
+            layersChanged();
+        }
+    }
+
+    /**
+     * @brief 取得單一圖層的頁面資料 (不經過合成)。
+     *
+     * 佈局與 getBuffer() 相同 (bufferSize() bytes，含填充欄位)，
+     * 適合把靜態背景與動態內容分開匯出，在 MCU 上分別更新。
+     *
+     * @return 索引無效時回傳 nullptr。
+     */
+    const uint8_t* OledDataModel::layerBuffer(int index) const
+    {
+        return (index >= 0 && index < layerCount()) ? m_layers[index].pages.data() : nullptr;
+    }
+
+    /**
+     * @brief 圖層陣列變動 (新增、移除、搬移) 後重新取得目前圖層的指標。
+     */
+    void OledDataModel::bindActiveLayer()
+    {
+        m_plane = m_layers[m_activeLayer].pages.data();
+    }
+
+    /**
+     * @brief 圖層的組成改變：決定是否可以直通，並把整個畫面標記為需要重新合成。
+     *
+     * 只有一個可見圖層、且合成方式對全黑的底色不會改變內容 (or / xor / replace) 時，
+     * 合成結果就是該圖層本身，getBuffer() 直接回傳它，不需要任何合成。
+     */
+    void OledDataModel::layersChanged()
+    {
+        const Layer &only = m_layers.front();
+        m_passThrough = m_layers.size() == 1 && only.visible && only.blend != BlendAnd && only.blend != BlendMask;
+
+        // 直通時 markDirty 不記錄 tile，所以離開直通時整個畫面都要重新合成
+        std::fill(m_dirtyTiles.begin(), m_dirtyTiles.end(), uint8_t(m_passThrough ? 0 : 1));
+        m_frameDirty = !m_passThrough;
+        markAllDirty();
+    }
+
+    /**
+     * @brief 把髒的 tile 由下往上重新合成到 m_buffer。
+     *
+     * 一個 tile 是同一頁中相鄰的 8 欄 (8x8 像素)，剛好是一個 64 位元字：
+     * 每個可見圖層做一次 load 與一次位元運算，畫面上沒有變動的 tile 完全不碰。
+     */
+    void OledDataModel::flatten() const
+    {
+        const int tilesPerRow = (m_geometry.width + 7) / 8;
+        for (int page = 0; page < m_geometry.pageCount(); ++page) {
+            uint8_t *dirty = m_dirtyTiles.data() + page * tilesPerRow;
+            const int rowOffset = page * m_geometry.ramPageWidth + m_geometry.columnOffset;
+
+            for (int tile = 0; tile < tilesPerRow; ++tile) {
+                if (!dirty[tile]) {
+                    continue;
+                }
+                dirty[tile] = 0;
+
+                const int offset = rowOffset + tile * 8;
+                const int columns = std::min(8, m_geometry.width - tile * 8);
+                uint64_t frame = 0; // 最底下是全黑
+                for (const Layer &layer : m_layers) {
+                    if (!layer.visible) {
+                        continue;
+                    }
+                    const uint64_t word = loadTile(layer.pages.data() + offset, columns);
+                    switch (layer.blend) {
+                    case BlendOr:      frame |= word;  break;
+                    case BlendAnd:     frame &= word;  break;
+                    case BlendXor:     frame ^= word;  break;
+                    case BlendReplace: frame = word;   break;
+                    case BlendMask:    frame &= ~word; break;
                     }
                 }
-                hardwareData.append(byte);
+                storeTile(m_buffer.data() + offset, frame, columns);
             }
         }
-        return hardwareData;
+        m_frameDirty = false;
     }
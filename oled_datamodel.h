@@ -3,40 +3,113 @@
 
 
 #include <cstdint> // for uint8_t
-#include <vector> // 使用 std::vector<bool> 更安全、更靈活
-#include "config.h"
+#include <vector> // 使用 std::vector<uint8_t> 儲存頁面格式的 buffer
+#include <QImage>
+#include <QRect>
+#include <QString>
+#include <QVector>
+#include "oled_config.h" // 只需要硬體常數，不依賴 Qt Widgets
+#include "oled_panel.h"  // 面板幾何 (尺寸、RAM 頁寬、欄位偏移)
+#include "commandhistory.h"
 
 
-
-// 包含 DISPLAY_WIDTH, RAM_PAGE_WIDTH 等常數
-
 // Forward declaration for QPoint, avoids including full Qt header here
 class QPoint;
 
 class OledDataModel
 {
 public:
-    OledDataModel();
+    // 預設為 SH1106 128x64 (OledConfig 的常數)；其他面板請傳入對應的幾何
+    explicit OledDataModel(const OledPanelGeometry &geometry = OledPanel::defaultProfile().geometry);
+
+    // --- 面板幾何 ---
+    // 切換面板會重新配置 buffer；可視尺寸不同時清空畫布，相同時 (只有填充欄位不同) 保留每個圖層的內容。
+    // 之前記錄的操作 (OledEditCommand) 以舊的欄位位置儲存，不再適用
+    bool setGeometry(const OledPanelGeometry &geometry);
+    const OledPanelGeometry& geometry() const { return m_geometry; }
+    const OledPanelKernels& kernels() const { return *m_kernels; }
+    int width() const { return m_geometry.width; }
+    int height() const { return m_geometry.height; }
+
+    // --- 圖層 (Layer) ---
+    // 每個圖層都是一張完整的頁面格式畫布，繪圖一律寫在目前圖層 (activeLayer)，
+    // getBuffer() / getPixel() / 匯出讀到的是由下往上合成後的結果。
+    // 新建的 model 只有一個 "background" 圖層，行為與單一畫布完全相同。
+    enum BlendMode {
+        BlendOr,       // 點亮的像素疊加到下方 (預設)
+        BlendAnd,      // 只保留下方與本層都點亮的像素
+        BlendXor,      // 本層點亮的像素反轉下方
+        BlendReplace,  // 不透明：整層蓋掉下方所有內容
+        BlendMask      // 本層點亮的像素把下方清掉
+    };
+    static QString blendModeName(BlendMode mode);                     // "or"、"and"、"xor"、"replace"、"mask"
+    static bool blendModeFromName(const QString &name, BlendMode *mode);
+
+    int layerCount() const { return static_cast<int>(m_layers.size()); }
+    int addLayer(const QString &name, BlendMode mode = BlendOr);      // 加在最上層，回傳索引
+    bool removeLayer(int index);                                      // 至少保留一個圖層
+    bool moveLayer(int from, int to);
+    int findLayer(const QString &name) const;                         // 找不到回傳 -1
+    int activeLayer() const { return m_activeLayer; }
+    bool setActiveLayer(int index);                                   // 記錄操作中不能切換
+    QString layerName(int index) const;
+    void setLayerName(int index, const QString &name);
+    bool isLayerVisible(int index) const;
+    void setLayerVisible(int index, bool visible);
+    BlendMode layerBlendMode(int index) const;
+    void setLayerBlendMode(int index, BlendMode mode);
+    // 單一圖層的頁面資料 (bufferSize() bytes，與 getBuffer() 同樣的佈局)，可以獨立匯出
+    const uint8_t* layerBuffer(int index) const;
 
     // --- 核心 Buffer 操作 ---
     void setPixel(int x, int y, bool on,int brushSize);
 
-    bool getPixel(int x, int y) const;
-    void clear();
+    bool getPixel(int x, int y) const;   // 合成後的結果
+    void clear();                        // 只清除目前圖層
 
     // --- 底層繪圖演算法 ---
+    // 筆刷大於 1 時一律以「每列一段水平區段」輸出，每個像素只寫一次 (沒有重複蓋章)
     void drawLine(int x0, int y0, int x1, int y1, bool on,int brushSize);
+
+    // 粗線的端點樣式
+    enum LineCap {
+        SquareCap, // 方形筆刷沿著線段移動 (與 drawLine 相同)
+        RoundCap   // 膠囊形：與線段距離在半個線寬以內的像素
+    };
+    void drawThickLine(int x0, int y0, int x1, int y1, bool on, int width, LineCap cap);
     void drawRectangle(int x, int y, int w, int h, bool on, bool fill,int brushSize);
     void drawCircle(const QPoint &p1, const QPoint &p2,int brushSize);
 
+    // 貼上頁面格式的點陣 (src 每頁 width bytes、頁優先，bit0 在最上方，例如字型的字元)：
+    // 只寫入 src 中點亮的 bit (on 為 false 時清除)。y 是 8 的倍數時每個 byte 直接寫入一頁，
+    // 否則拆成相鄰兩頁的移位寫入。超出畫布的部分會被裁切掉。
+    void blitPages(int x, int y, const uint8_t *src, int width, int height, bool on);
+
     // --- 資料存取 ---
-    //const uint8_t* getBuffer() const;
+    // 合成後的畫面，本身就是硬體頁面格式 (含 COLUMN_OFFSET 填充)，可直接讀取
+    const uint8_t* getBuffer() const;
+    int bufferSize() const { return m_geometry.bufferSize(); }
     //void setBuffer(const uint8_t* data);
 
 
     // --- 資料交換 (這裡是翻譯發生的地方) ---
-    std::vector<uint8_t> getHardwareBuffer() const; // 返回硬體格式的 buffer
-    void setFromHardwareBuffer(const uint8_t* data); // 從硬體格式設定
+    std::vector<uint8_t> getHardwareBuffer() const; // 返回硬體格式的 buffer (合成後)
+    void setFromHardwareBuffer(const uint8_t* data); // 從硬體格式設定 (寫入目前圖層)
+
+    // --- 髒區域追蹤 (Dirty Region) ---
+    // 所有繪圖操作都會把受影響的範圍累積到髒區域中 (邏輯座標)，
+    // View 只需要重新整理這個範圍，取出後即歸零。
+    QRect dirtyRegion() const { return m_dirtyRect; }
+    QRect takeDirtyRegion();
+    void markDirty(const QRect &rect);
+    void markAllDirty();
+
+    // --- 操作記錄 (Command) ---
+    // beginCommand() 之後的所有修改會被記錄，endCommand() 取出被改動窗口前後的 XOR 差異 (PackBits 壓縮)，
+    // undo/redo 時把差異再 XOR 回窗口，成本與修改範圍成正比。
+    void beginCommand();
+    bool endCommand(OledEditCommand::Type type, OledEditCommand* command);
+    void applyCommand(const OledEditCommand& command, bool undo);
 
     // [新增] 负责将模型的一部分数据复制为一个独立的逻辑图像 (QImage)
     QImage copyRegionToLogicalFormat(const QRect& region) const;
@@ -46,12 +119,52 @@ public:
 
 private:
     // --- 私有輔助函式 ---
-    // 這個 "raw" setPixel 是給內部繪圖演算法呼叫的，效率更高
-    //void setRawPixel(int x, int y, bool on);
-
-    //uint8_t m_buffer[OledConfig::RAM_PAGE_WIDTH * (OledConfig::DISPLAY_HEIGHT / 8)];
-
-    std::vector<bool> m_logical_buffer;
+    // 這個 "raw" setPixel 是給內部繪圖演算法呼叫的，效率更高 (呼叫端需先做邊界檢查)
+    void setRawPixel(int x, int y, bool on);
+    void fillSpan(int x0, int x1, int y, bool on);              // 單列水平區段，會自動裁切
+    void fillRect(int x0, int y0, int x1, int y1, bool on);     // 以頁面遮罩一次寫入 8 列，會自動裁切
+    int byteIndex(int x, int y) const;
+    void savePageForCommand(int page);
+    void saveAllPagesForCommand();
+    void bindActiveLayer();          // 圖層陣列變動後重新取得 m_plane
+    void layersChanged();            // 圖層的順序、顯示或合成方式改變：整個畫面重新合成
+    void flatten() const;            // 把髒的 tile 重新合成到 m_buffer
+
+    struct Layer {
+        QString name;
+        bool visible = true;
+        BlendMode blend = BlendOr;
+        std::vector<uint8_t> pages;  // 頁面格式，大小與 m_buffer 相同
+    };
+
+    // 目前面板的幾何，以及依幾何挑選的整頁 kernel (常見尺寸為編譯期特化版本)
+    // 每頁 8 列，一個 byte 代表同一欄的 8 個垂直像素 (bit0 在最上方)
+    OledPanelGeometry m_geometry;
+    const OledPanelKernels* m_kernels = nullptr;
+
+    // [核心] 每個圖層都直接以驅動晶片 RAM 的頁面格式儲存 (SH1106 為 132 x 8 pages = 1056 bytes)
+    // 匯出硬體 buffer 只需要 memcpy，getPixel/setPixel 只是對單一 byte 的遮罩運算
+    std::vector<Layer> m_layers;
+    int m_activeLayer = 0;
+    uint8_t* m_plane = nullptr;      // 目前圖層的頁面資料，所有繪圖都寫在這裡
+
+    // 合成後的畫面。只有一個可見圖層 (or / xor / replace) 時直接使用該圖層 (m_passThrough)，
+    // 否則以 8x8 tile 為單位延遲合成：每個 tile 剛好是一個 64 位元字，每層一次 load + 一次運算。
+    mutable std::vector<uint8_t> m_buffer;
+    mutable std::vector<uint8_t> m_dirtyTiles;   // 每個 tile 一個 byte，第 page * tilesPerRow + x / 8 個
+    mutable bool m_frameDirty = false;
+    bool m_passThrough = true;
+
+    // 自上次 takeDirtyRegion() 之後被修改過的範圍 (無效矩形代表沒有變更)
+    QRect m_dirtyRect;
+
+    // --- 操作記錄狀態 ---
+    // 只有第一次被寫到的頁面才會複製到 m_commandBefore (copy-on-write)
+    bool m_recording = false;
+    uint32_t m_savedPages = 0;           // bit n = 第 n 頁已保存
+    QRect m_commandRect;                 // 本次操作改動的範圍
+    std::vector<uint8_t> m_commandBefore;
+    std::vector<uint8_t> m_commandDelta; // endCommand() / applyCommand() 的窗口暫存 (避免每次配置)
 
 };
 
@@ -0,0 +1,434 @@
+#include "oled_dither.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// 有序混色的門檻矩陣一律展開成 64x64 的 tile (Bayer 矩陣重複貼滿)，
+// 所有有序方法共用同一個 kernel：門檻 = tile[(y & 63) * 64 + (x & 63)]
+constexpr int kTileSize = 64;
+using ThresholdTile = std::array<uint8_t, kTileSize * kTileSize>;
+
+// 第 rank 個 (共 count 個) 門檻：亮度 v > 門檻時點亮，0 全暗、255 全亮，平均點亮比例為 v / 255
+uint8_t rankToThreshold(int rank, int count)
+{
+    return static_cast<uint8_t>(((2 * rank + 1) * 255) / (2 * count));
+}
+
+ThresholdTile makeBayerTile(int order)
+{
+    // 遞迴展開：M(2n) = [4M, 4M + 2; 4M + 3, 4M + 1]
+    std::vector<int> matrix(1, 0);
+    for (int n = 1; n < order; n *= 2) {
+        std::vector<int> next(size_t(4 * n * n));
+        for (int y = 0; y < n; ++y) {
+            for (int x = 0; x < n; ++x) {
+                const int value = 4 * matrix[size_t(y * n + x)];
+                next[size_t(y * 2 * n + x)] = value;
+                next[size_t(y * 2 * n + x + n)] = value + 2;
+                next[size_t((y + n) * 2 * n + x)] = value + 3;
+                next[size_t((y + n) * 2 * n + x + n)] = value + 1;
+            }
+        }
+        matrix.swap(next);
+    }
+
+    ThresholdTile tile{};
+    for (int y = 0; y < kTileSize; ++y) {
+        for (int x = 0; x < kTileSize; ++x) {
+            tile[size_t(y * kTileSize + x)] =
+                rankToThreshold(matrix[size_t((y % order) * order + x % order)], order * order);
+        }
+    }
+    return tile;
+}
+
+// 以 void-and-cluster (Ulichney 1993) 產生 64x64 的藍噪聲門檻矩陣。
+// 只在第一次使用時計算一次 (約數十毫秒)，結果固定 (使用固定的亂數種子)。
+ThresholdTile makeBlueNoiseTile()
+{
+    constexpr int N = kTileSize * kTileSize;
+    constexpr double sigma = 1.5;
+
+    // 環狀 (toroidal) 高斯權重，以位移 (dy & 63, dx & 63) 索引
+    std::vector<float> gaussian(N);
+    for (int dy = 0; dy < kTileSize; ++dy) {
+        for (int dx = 0; dx < kTileSize; ++dx) {
+            const int wy = std::min(dy, kTileSize - dy);
+            const int wx = std::min(dx, kTileSize - dx);
+            gaussian[size_t(dy * kTileSize + dx)] =
+                static_cast<float>(std::exp(-(wx * wx + wy * wy) / (2.0 * sigma * sigma)));
+        }
+    }
+
+    std::vector<uint8_t> pattern(N, 0);
+    std::vector<float> energy(N, 0.0f);
+    auto toggle = [&](int p, bool on) {
+        pattern[size_t(p)] = on ? 1 : 0;
+        const float sign = on ? 1.0f : -1.0f;
+        const int px = p % kTileSize;
+        const int py = p / kTileSize;
+        for (int y = 0; y < kTileSize; ++y) {
+            const float* weights = gaussian.data() + ((y - py) & (kTileSize - 1)) * kTileSize;
+            float* row = energy.data() + y * kTileSize;
+            for (int x = 0; x < kTileSize; ++x) {
+                row[x] += sign * weights[(x - px) & (kTileSize - 1)];
+            }
+        }
+    };
+    // 最密集的點 (已點亮中能量最高) / 最大的空洞 (未點亮中能量最低)
+    auto tightestCluster = [&]() {
+        int best = -1;
+        for (int p = 0; p < N; ++p) {
+            if (pattern[size_t(p)] && (best < 0 || energy[size_t(p)] > energy[size_t(best)])) best = p;
+        }
+        return best;
+    };
+    auto largestVoid = [&]() {
+        int best = -1;
+        for (int p = 0; p < N; ++p) {
+            if (!pattern[size_t(p)] && (best < 0 || energy[size_t(p)] < energy[size_t(best)])) best = p;
+        }
+        return best;
+    };
+
+    // 1. 初始圖樣：隨機點亮約 10%，再反覆把最密集的點搬到最大的空洞，直到穩定
+    uint32_t seed = 0x2545F491u;
+    const int initialCount = N / 10;
+    for (int placed = 0; placed < initialCount;) {
+        seed = seed * 1664525u + 1013904223u;
+        const int p = static_cast<int>((seed >> 8) % N);
+        if (!pattern[size_t(p)]) {
+            toggle(p, true);
+            ++placed;
+        }
+    }
+    for (int iteration = 0; iteration < N; ++iteration) {
+        const int cluster = tightestCluster();
+        toggle(cluster, false);
+        const int hole = largestVoid();
+        toggle(hole, true);
+        if (hole == cluster) {
+            break;
+        }
+    }
+
+    const std::vector<uint8_t> prototype = pattern;
+    const std::vector<float> prototypeEnergy = energy;
+    std::vector<int> rank(N, 0);
+
+    // 2. 由初始圖樣依序移除最密集的點，排名由高到低
+    for (int r = initialCount - 1; r >= 0; --r) {
+        const int cluster = tightestCluster();
+        toggle(cluster, false);
+        rank[size_t(cluster)] = r;
+    }
+
+    // 3. 由初始圖樣依序填入最大的空洞，直到全滿 (0 的能量 = 常數 - 1 的能量，所以後半段也是找最大空洞)
+    pattern = prototype;
+    energy = prototypeEnergy;
+    for (int r = initialCount; r < N; ++r) {
+        const int hole = largestVoid();
+        toggle(hole, true);
+        rank[size_t(hole)] = r;
+    }
+
+    ThresholdTile tile{};
+    for (int p = 0; p < N; ++p) {
+        tile[size_t(p)] = rankToThreshold(rank[size_t(p)], N);
+    }
+    return tile;
+}
+
+const ThresholdTile& thresholdTile(OledDither::Method method)
+{
+    static const ThresholdTile bayer2 = makeBayerTile(2);
+    static const ThresholdTile bayer4 = makeBayerTile(4);
+    static const ThresholdTile bayer8 = makeBayerTile(8);
+    if (method == OledDither::Bayer2) return bayer2;
+    if (method == OledDither::Bayer4) return bayer4;
+    if (method == OledDither::Bayer8) return bayer8;
+
+    static const ThresholdTile blueNoise = makeBlueNoiseTile();
+    return blueNoise;
+}
+
+// gamma -> 對比，預設值時為恆等對應。兩者都是非遞減的，反白另外處理，
+// 所以有序混色可以把曲線併進門檻 (見 ToneCuts)
+std::array<uint8_t, 256> makeToneTable(const OledDither::Options& options)
+{
+    std::array<uint8_t, 256> table{};
+    const double gamma = options.gamma > 0.0 ? options.gamma : 1.0;
+    const double contrast = std::max(0.0, options.contrast);
+    for (int v = 0; v < 256; ++v) {
+        double x = v / 255.0;
+        if (gamma != 1.0) {
+            x = std::pow(x, 1.0 / gamma);
+        }
+        x = (x - 0.5) * contrast + 0.5;
+        table[size_t(v)] = static_cast<uint8_t>(std::lround(std::clamp(x, 0.0, 1.0) * 255.0));
+    }
+    return table;
+}
+
+// 「調整後亮度 > t」等價於「原始亮度 >= cut(t)」(曲線非遞減)，t = -1..255，
+// cut 為 256 代表永遠不亮。反白時：255 - tone > t  <=>  !(tone > 254 - t)。
+struct ToneCuts
+{
+    ToneCuts(const std::array<uint8_t, 256>& tone, bool invert) : invert(invert)
+    {
+        int v = 0;
+        for (int t = -1; t <= 255; ++t) {
+            while (v < 256 && tone[size_t(v)] <= t) ++v;
+            cuts[size_t(t + 1)] = static_cast<uint16_t>(v);
+        }
+    }
+
+    // 門檻 t (調整後亮度 > t 點亮) 對應的原始亮度下限；invert 時結果要再反相
+    uint16_t cutFor(int t) const { return cuts[size_t((invert ? 254 - t : t) + 1)]; }
+
+    std::array<uint16_t, 257> cuts{};
+    bool invert;
+};
+
+// 把一列 0/1 (每像素一個 byte) 打包成 MSB first，最後一個 byte 多出的位元為 0。
+// 8 個 byte 當成一個 64 位元字 (little-endian，第 k 個像素在第 k 個 byte)，
+// 乘上 0x8040201008040201 之後，最高的 byte 剛好是 b0 << 7 | b1 << 6 | ... | b7。
+void packRow(const uint8_t* lit, int width, uint8_t* bits)
+{
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint64_t block;
+        std::memcpy(&block, lit + x, sizeof(block));
+        bits[x >> 3] = static_cast<uint8_t>((block * 0x8040201008040201ull) >> 56);
+    }
+    if (x < width) {
+        uint8_t packed = 0;
+        for (int i = 0; x + i < width; ++i) {
+            packed |= static_cast<uint8_t>(lit[x + i] << (7 - i));
+        }
+        bits[x >> 3] = packed;
+    }
+}
+
+// --- 誤差擴散的擴散表 ---
+// 誤差以「權重單位」累積 (不先除)，讀取像素時才除以 Divisor，沒有逐點捨入誤差。
+// dir = +1 (由左往右) 或 -1 (蛇形掃描的反向列)，水平位移跟著鏡射。
+struct FloydSteinbergKernel
+{
+    static constexpr int Divisor = 16;
+    static void spread(int* row0, int* row1, int* /*row2*/, int x, int dir, int error)
+    {
+        row0[x + dir] += error * 7;
+        row1[x - dir] += error * 3;
+        row1[x] += error * 5;
+        row1[x + dir] += error;
+    }
+};
+
+struct AtkinsonKernel
+{
+    static constexpr int Divisor = 8;   // 只擴散 6/8，剩下的 2/8 直接丟掉
+    static void spread(int* row0, int* row1, int* row2, int x, int dir, int error)
+    {
+        row0[x + dir] += error;
+        row0[x + 2 * dir] += error;
+        row1[x - dir] += error;
+        row1[x] += error;
+        row1[x + dir] += error;
+        row2[x] += error;
+    }
+};
+
+struct SierraLiteKernel
+{
+    static constexpr int Divisor = 4;
+    static void spread(int* row0, int* row1, int* /*row2*/, int x, int dir, int error)
+    {
+        row0[x + dir] += error * 2;
+        row1[x - dir] += error;
+        row1[x] += error;
+    }
+};
+
+template <typename Kernel>
+void diffuse(const uint8_t* luma, int width, int height, int lumaStride, const std::array<uint8_t, 256>& tone,
+             bool serpentine, uint8_t* bits, int bitsStride)
+{
+    // 三列環狀的誤差緩衝 (本列、下一列、下下列)，左右各留 2 格，擴散到畫面外的誤差直接丟掉
+    constexpr int pad = 2;
+    const size_t stride = size_t(width) + 2 * pad;
+    std::vector<int> errors(stride * 3, 0);
+    int* rows[3] = {errors.data() + pad, errors.data() + stride + pad, errors.data() + 2 * stride + pad};
+    std::vector<uint8_t> lit(size_t(width), 0);
+
+    constexpr int half = Kernel::Divisor / 2;
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* source = luma + y * lumaStride;
+        const bool reverse = serpentine && (y & 1);
+        const int dir = reverse ? -1 : 1;
+        int x = reverse ? width - 1 : 0;
+        for (int i = 0; i < width; ++i, x += dir) {
+            const int carried = rows[0][x];
+            const int correction = carried >= 0 ? (carried + half) / Kernel::Divisor
+                                                : -((-carried + half) / Kernel::Divisor);
+            const int value = tone[source[x]] + correction;
+            const bool on = value >= 128;
+            lit[size_t(x)] = on ? 1 : 0;
+            Kernel::spread(rows[0], rows[1], rows[2], x, dir, value - (on ? 255 : 0));
+        }
+        packRow(lit.data(), width, bits + y * bitsStride);
+
+        // 往下捲一列：用完的本列清空後變成新的下下列
+        int* done = rows[0];
+        std::fill(done - pad, done - pad + stride, 0);
+        rows[0] = rows[1];
+        rows[1] = rows[2];
+        rows[2] = done;
+    }
+}
+
+// 有序混色：門檻 tile 先換算成原始亮度的下限，內層迴圈只剩「比較 + 反相」，沒有查表也沒有相依，
+// 編譯器可以向量化
+void ordered(const uint8_t* luma, int width, int height, int lumaStride, const ToneCuts& cuts,
+             const ThresholdTile& tile, uint8_t* bits, int bitsStride)
+{
+    std::array<uint16_t, kTileSize * kTileSize> limits{};
+    for (size_t p = 0; p < limits.size(); ++p) {
+        limits[p] = cuts.cutFor(tile[p]);
+    }
+
+    const uint8_t flip = cuts.invert ? 1 : 0;
+    std::vector<uint8_t> lit(size_t(width), 0);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* source = luma + y * lumaStride;
+        const uint16_t* row = limits.data() + (y & (kTileSize - 1)) * kTileSize;
+        for (int x0 = 0; x0 < width; x0 += kTileSize) {
+            const int count = std::min(kTileSize, width - x0);
+            const uint8_t* s = source + x0;
+            uint8_t* out = lit.data() + x0;
+            for (int i = 0; i < count; ++i) {
+                out[i] = static_cast<uint8_t>((s[i] >= row[i] ? 1 : 0) ^ flip);
+            }
+        }
+        packRow(lit.data(), width, bits + y * bitsStride);
+    }
+}
+
+void threshold(const uint8_t* luma, int width, int height, int lumaStride, const ToneCuts& cuts, int level,
+               uint8_t* bits, int bitsStride)
+{
+    // 調整後亮度 >= level 點亮，也就是 > level - 1
+    const uint16_t limit = cuts.cutFor(std::clamp(level, 0, 256) - 1);
+    const uint8_t flip = cuts.invert ? 1 : 0;
+    std::vector<uint8_t> lit(size_t(width), 0);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* source = luma + y * lumaStride;
+        for (int x = 0; x < width; ++x) {
+            lit[size_t(x)] = static_cast<uint8_t>((source[x] >= limit ? 1 : 0) ^ flip);
+        }
+        packRow(lit.data(), width, bits + y * bitsStride);
+    }
+}
+
+struct MethodName {
+    OledDither::Method method;
+    const char* name;
+};
+
+const MethodName kMethodNames[] = {
+    {OledDither::Threshold, "threshold"},
+    {OledDither::FloydSteinberg, "floyd-steinberg"},
+    {OledDither::Atkinson, "atkinson"},
+    {OledDither::SierraLite, "sierra-lite"},
+    {OledDither::Bayer2, "bayer2"},
+    {OledDither::Bayer4, "bayer4"},
+    {OledDither::Bayer8, "bayer8"},
+    {OledDither::BlueNoise, "blue-noise"},
+};
+
+}
+
+QString OledDither::methodName(Method method)
+{
+    for (const MethodName& entry : kMethodNames) {
+        if (entry.method == method) {
+            return QString::fromLatin1(entry.name);
+        }
+    }
+    return QString();
+}
+
+bool OledDither::methodFromName(const QString& name, Method* method)
+{
+    for (const MethodName& entry : kMethodNames) {
+        if (name.compare(QString::fromLatin1(entry.name), Qt::CaseInsensitive) == 0) {
+            if (method) *method = entry.method;
+            return true;
+        }
+    }
+    return false;
+}
+
+void OledDither::ditherPlane(const uint8_t* luma, int width, int height, int lumaStride, const Options& options,
+                             uint8_t* bits, int bitsStride)
+{
+    if (!luma || !bits || width <= 0 || height <= 0) {
+        return;
+    }
+
+    const std::array<uint8_t, 256> curve = makeToneTable(options);
+
+    if (options.method == FloydSteinberg || options.method == Atkinson || options.method == SierraLite) {
+        // 誤差擴散需要實際的亮度值：把反白併進查表
+        std::array<uint8_t, 256> tone = curve;
+        if (options.invert) {
+            for (uint8_t& value : tone) value = static_cast<uint8_t>(255 - value);
+        }
+        if (options.method == FloydSteinberg) {
+            diffuse<FloydSteinbergKernel>(luma, width, height, lumaStride, tone, options.serpentine, bits, bitsStride);
+        } else if (options.method == Atkinson) {
+            diffuse<AtkinsonKernel>(luma, width, height, lumaStride, tone, options.serpentine, bits, bitsStride);
+        } else {
+            diffuse<SierraLiteKernel>(luma, width, height, lumaStride, tone, options.serpentine, bits, bitsStride);
+        }
+        return;
+    }
+
+    const ToneCuts cuts(curve, options.invert);
+    if (options.method == Threshold) {
+        threshold(luma, width, height, lumaStride, cuts, options.threshold, bits, bitsStride);
+    } else {
+        ordered(luma, width, height, lumaStride, cuts, thresholdTile(options.method), bits, bitsStride);
+    }
+}
+
+QImage OledDither::dither(const QImage& image, const Options& options)
+{
+    if (image.isNull()) {
+        return QImage();
+    }
+
+    const QImage rgb = image.convertToFormat(QImage::Format_RGB32);
+    const int w = rgb.width();
+    const int h = rgb.height();
+
+    std::vector<uint8_t> luma(size_t(w) * h);
+    for (int y = 0; y < h; ++y) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(rgb.constScanLine(y));
+        uint8_t* out = luma.data() + size_t(y) * w;
+        for (int x = 0; x < w; ++x) {
+            out[x] = static_cast<uint8_t>(qGray(line[x]));
+        }
+    }
+
+    QImage mono(w, h, QImage::Format_Mono);
+    mono.setColor(0, qRgb(0, 0, 0));
+    mono.setColor(1, qRgb(255, 255, 255));
+    ditherPlane(luma.data(), w, h, w, options, mono.bits(), static_cast<int>(mono.bytesPerLine()));
+    return mono;
+}
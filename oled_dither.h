@@ -0,0 +1,73 @@
+#ifndef OLED_DITHER_H
+#define OLED_DITHER_H
+
+#pragma once
+
+#include <QImage>
+#include <QString>
+#include <cstdint>
+
+/**
+ * @brief 把灰階/彩色圖片轉成 1-bit 單色圖的混色 (dithering) 工具 (oledcore，不依賴 Qt Widgets)。
+ *
+ * 直接以門檻值二值化會讓照片與漸層只剩一塊塊的黑白，混色以點的疏密表現灰階：
+ * - 誤差擴散 (Floyd–Steinberg、Atkinson、Sierra Lite)：畫質最好，逐列依序處理，可選蛇形掃描。
+ * - 有序矩陣 (Bayer 2/4/8、藍噪聲)：每個像素只和門檻矩陣比較，彼此獨立，
+ *   內層迴圈沒有資料相依，適合大量影格 (動畫) 或需要穩定圖樣的場合。
+ *
+ * 所有方法先以查表套用 gamma / 對比 / 反白，再進行混色。
+ * 輸出的單色圖一律是索引 1 = 點亮 (白色)，與 OledAssetIO 的約定相同。
+ * 所有的函式都是無狀態的 (stateless)，可以在多個執行緒中同時呼叫。
+ */
+class OledDither
+{
+public:
+    enum Method {
+        Threshold,       // 單純門檻值 (不混色)
+        FloydSteinberg,  // 7/16、3/16、5/16、1/16
+        Atkinson,        // 只擴散 6/8 的誤差，對比較強，適合小螢幕
+        SierraLite,      // 2/4、1/4、1/4，比 Floyd–Steinberg 快
+        Bayer2,          // 2x2 有序矩陣
+        Bayer4,          // 4x4 有序矩陣
+        Bayer8,          // 8x8 有序矩陣
+        BlueNoise        // 64x64 藍噪聲遮罩 (void-and-cluster 產生)，沒有規則的網格紋路
+    };
+
+    struct Options {
+        Method method = Threshold;
+        double gamma = 1.0;       // > 1 提亮中間調，< 1 壓暗
+        double contrast = 1.0;    // 以 128 為中心放大 (> 1) 或縮小 (< 1)
+        int threshold = 128;      // Threshold 方法的門檻 (亮度 >= threshold 視為點亮)
+        bool serpentine = true;   // 誤差擴散時奇數列由右往左掃描，減少斜向紋路
+        bool invert = false;      // 暗的像素視為點亮 (在 gamma / 對比之後套用)
+    };
+
+    static QString methodName(Method method);   // "threshold"、"floyd-steinberg"、"atkinson"、"sierra-lite"、
+                                                // "bayer2"、"bayer4"、"bayer8"、"blue-noise"
+    static bool methodFromName(const QString& name, Method* method);
+
+    /**
+     * @brief 把任意格式的圖片混色成單色圖。
+     *
+     * 亮度的算法與 qGray() 相同 ((r * 11 + g * 16 + b * 5) / 32)。
+     *
+     * @return 索引 1 = 點亮的 Format_Mono 圖片；image 為空時回傳空的 QImage。
+     */
+    static QImage dither(const QImage& image, const Options& options);
+
+    /**
+     * @brief 混色的核心：8 位元亮度平面 -> MSB first 的 1-bit 平面 (位元 1 = 點亮)。
+     *
+     * @param luma       亮度資料，第 y 列從 luma + y * lumaStride 開始。
+     * @param width      寬度 (像素)。
+     * @param height     高度 (像素)。
+     * @param lumaStride 亮度資料每列的 byte 數。
+     * @param options    混色設定 (gamma / 對比 / 反白也在這裡套用)。
+     * @param bits       輸出，第 y 列從 bits + y * bitsStride 開始，每列最後一個 byte 多出的位元清為 0。
+     * @param bitsStride 輸出每列的 byte 數，至少要有 (width + 7) / 8 (QImage 請傳 bytesPerLine())。
+     */
+    static void ditherPlane(const uint8_t* luma, int width, int height, int lumaStride, const Options& options,
+                            uint8_t* bits, int bitsStride);
+};
+
+#endif // OLED_DITHER_H
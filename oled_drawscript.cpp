@@ -0,0 +1,136 @@
+#include "oled_drawscript.h"
+#include "oled_datamodel.h"
+#include "oled_font.h"
+
+#include <QPoint>
+#include <QStringList>
+
+namespace {
+
+// 把參數轉成整數；缺少的選用參數使用預設值
+bool readArgs(const QStringList& tokens, int required, int optional, const int* defaults, int* out)
+{
+    const int given = tokens.size() - 1;
+    if (given < required || given > required + optional) {
+        return false;
+    }
+    for (int i = 0; i < required + optional; ++i) {
+        if (i < given) {
+            bool ok = false;
+            out[i] = tokens.at(i + 1).toInt(&ok);
+            if (!ok) return false;
+        } else {
+            out[i] = defaults[i - required];
+        }
+    }
+    return true;
+}
+
+// 一行腳本的 token：去掉 '#' 之後的註解，空白合併
+QStringList tokenize(QString line)
+{
+    const int comment = line.indexOf('#');
+    if (comment != -1) {
+        line.truncate(comment);
+    }
+    return line.simplified().split(' ', Qt::SkipEmptyParts);
+}
+
+}
+
+bool OledDrawScript::run(OledDataModel* model, const QString& script, QString* errorMessage)
+{
+    if (!model) {
+        return false;
+    }
+
+    const QStringList lines = script.split('\n');
+    for (int lineNo = 0; lineNo < lines.size(); ++lineNo) {
+        const QStringList tokens = tokenize(lines.at(lineNo));
+        if (tokens.isEmpty()) {
+            continue;
+        }
+
+        const QString cmd = tokens.first().toLower();
+        int a[6] = {};
+        bool ok = true;
+
+        if (cmd == "clear") {
+            ok = tokens.size() == 1;
+            if (ok) model->clear();
+        } else if (cmd == "pixel") {
+            static const int defaults[] = {1};
+            ok = readArgs(tokens, 2, 1, defaults, a);
+            if (ok) model->setPixel(a[0], a[1], a[2] != 0, 1);
+        } else if (cmd == "erase") {
+            static const int defaults[] = {1};
+            ok = readArgs(tokens, 2, 1, defaults, a);
+            if (ok) model->setPixel(a[0], a[1], false, a[2]);
+        } else if (cmd == "line") {
+            static const int defaults[] = {1};
+            ok = readArgs(tokens, 4, 1, defaults, a);
+            if (ok) model->drawLine(a[0], a[1], a[2], a[3], true, a[4]);
+        } else if (cmd == "roundline") {
+            static const int defaults[] = {1};
+            ok = readArgs(tokens, 4, 1, defaults, a);
+            if (ok) model->drawThickLine(a[0], a[1], a[2], a[3], true, a[4], OledDataModel::RoundCap);
+        } else if (cmd == "rect" || cmd == "fillrect") {
+            static const int defaults[] = {1};
+            const bool fill = cmd == "fillrect";
+            ok = readArgs(tokens, 4, fill ? 0 : 1, defaults, a) && a[2] > 0 && a[3] > 0;
+            // drawRectangle 的寬高是「右下角 - 左上角」，腳本的 w/h 是像素數
+            if (ok) model->drawRectangle(a[0], a[1], a[2] - 1, a[3] - 1, true, fill, fill ? 1 : a[4]);
+        } else if (cmd == "ellipse") {
+            static const int defaults[] = {1};
+            ok = readArgs(tokens, 4, 1, defaults, a);
+            if (ok) model->drawCircle(QPoint(a[0], a[1]), QPoint(a[2], a[3]), a[4]);
+        } else if (cmd == "text") {
+            // text x y 文字：內建 5x7 字型，(x, y) 為字元格的左上角，文字中的空白合併成一個
+            ok = tokens.size() >= 4 && readArgs(tokens.mid(0, 3), 2, 0, nullptr, a);
+            if (ok) OledFont::builtin().drawText(model, a[0], a[1], tokens.mid(3).join(' '));
+        } else if (cmd == "layer") {
+            // layer <名稱> [合成方式]：切換到該圖層，不存在時加在最上層
+            OledDataModel::BlendMode mode = OledDataModel::BlendOr;
+            ok = (tokens.size() == 2 || tokens.size() == 3)
+                 && (tokens.size() == 2 || OledDataModel::blendModeFromName(tokens.at(2), &mode));
+            if (ok) {
+                int index = model->findLayer(tokens.at(1));
+                if (index < 0) {
+                    index = model->addLayer(tokens.at(1), mode);
+                } else if (tokens.size() == 3) {
+                    model->setLayerBlendMode(index, mode);
+                }
+                ok = model->setActiveLayer(index);
+            }
+        } else if (cmd == "hide" || cmd == "show") {
+            const int index = tokens.size() == 2 ? model->findLayer(tokens.at(1)) : -1;
+            ok = index >= 0;
+            if (ok) model->setLayerVisible(index, cmd == "show");
+        } else {
+            if (errorMessage) {
+                *errorMessage = QString("第 %1 行：未知的指令 \"%2\"").arg(lineNo + 1).arg(tokens.first());
+            }
+            return false;
+        }
+
+        if (!ok) {
+            if (errorMessage) {
+                *errorMessage = QString("第 %1 行：\"%2\" 的參數不正確").arg(lineNo + 1).arg(cmd);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+QStringList OledDrawScript::texts(const QString& script)
+{
+    QStringList result;
+    for (const QString& line : script.split('\n')) {
+        const QStringList tokens = tokenize(line);
+        if (tokens.size() >= 4 && tokens.first().toLower() == "text") {
+            result << tokens.mid(3).join(' ');
+        }
+    }
+    return result;
+}
@@ -0,0 +1,50 @@
+#ifndef OLED_DRAWSCRIPT_H
+#define OLED_DRAWSCRIPT_H
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+class OledDataModel;
+
+/**
+ * @brief 簡單的繪圖腳本，讓命令列工具不開 GUI 也能批次產生畫面。
+ *
+ * 一行一個指令，'#' 之後為註解，座標都是邏輯座標：
+ * @code
+ * clear
+ * pixel    x y [0|1]
+ * line     x0 y0 x1 y1 [brush]
+ * roundline x0 y0 x1 y1 [width]
+ * rect     x y w h [brush]
+ * fillrect x y w h
+ * ellipse  x0 y0 x1 y1 [brush]
+ * erase    x y [brush]
+ * text     x y 文字 (內建 5x7 字型，不能包含 '#')
+ * layer    name [or|and|xor|replace|mask]
+ * hide     name
+ * show     name
+ * @endcode
+ *
+ * 一開始只有 "background" 圖層。layer 切換之後的指令要畫在哪個圖層，
+ * 圖層不存在時以指定的合成方式 (預設 or) 加在最上層。
+ */
+class OledDrawScript
+{
+public:
+    /**
+     * @brief 在 model 上執行腳本。
+     *
+     * @param model        目標資料模型，不可為 nullptr。
+     * @param script       腳本內容。
+     * @param errorMessage 失敗時寫入錯誤訊息 (含行號)，可為 nullptr。
+     * @return 全部指令都成功執行時回傳 true；遇到第一個錯誤就停止並回傳 false。
+     */
+    static bool run(OledDataModel* model, const QString& script, QString* errorMessage = nullptr);
+
+    /// 腳本中每個 text 指令的文字 (依序，不執行腳本)，例如匯出字型時找出用到的字元
+    static QStringList texts(const QString& script);
+};
+
+#endif // OLED_DRAWSCRIPT_H
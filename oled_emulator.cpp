@@ -0,0 +1,351 @@
+#include "oled_emulator.h"
+
+#include <QStringList>
+#include <algorithm>
+
+namespace {
+
+// I2C 控制 byte：bit7 = Co (只跟一個 byte)，bit6 = D/C，其餘位元為 0
+bool isControlByte(uint8_t byte)
+{
+    return (byte & 0x3F) == 0;
+}
+
+bool parseHexByte(QString token, uint8_t* value)
+{
+    if (token.startsWith("0x", Qt::CaseInsensitive)) {
+        token = token.mid(2);
+    }
+    bool ok = false;
+    const uint number = token.toUInt(&ok, 16);
+    if (!ok || token.isEmpty() || number > 0xFF) {
+        return false;
+    }
+    *value = static_cast<uint8_t>(number);
+    return true;
+}
+
+}
+
+OledEmulator::OledEmulator(const OledPanelGeometry& geometry)
+    : m_geometry(geometry)
+{
+    reset();
+}
+
+void OledEmulator::reset()
+{
+    m_state = State();
+    m_state.multiplexRatio = m_geometry.pageCount() * 8;
+    m_ram.assign(static_cast<size_t>(m_geometry.bufferSize()), 0);
+    m_written.assign(m_ram.size(), 0);
+    m_frames.clear();
+    m_stats = FrameStats();
+    m_frameActive = false;
+    m_trailingCommandBytes = 0;
+    m_trailingBusBytes = 0;
+    m_pendingCommand = 0;
+    m_pendingArgs = 0;
+}
+
+void OledEmulator::command(uint8_t byte)
+{
+    m_frameActive = true;
+    ++m_stats.commandBytes;
+    ++m_stats.busBytes;
+    ++m_trailingCommandBytes;
+    ++m_trailingBusBytes;
+
+    const int rows = m_geometry.pageCount() * 8;
+
+    // 雙 byte 指令的參數
+    if (m_pendingArgs > 0) {
+        --m_pendingArgs;
+        switch (m_pendingCommand) {
+        case 0x81: m_state.contrast = byte; break;
+        case 0xA8: m_state.multiplexRatio = std::min((byte & 0x7F) + 1, rows); break;
+        case 0xD3: m_state.displayOffset = byte % rows; break;
+        default: break;     // 類比電路設定或不支援的指令的參數
+        }
+        return;
+    }
+
+    if (byte <= 0x0F) {
+        m_state.column = (m_state.column & 0xF0) | byte;
+    } else if (byte <= 0x1F) {
+        m_state.column = (m_state.column & 0x0F) | ((byte & 0x0F) << 4);
+    } else if (byte >= 0x30 && byte <= 0x33) {
+        // 充電泵電壓
+    } else if (byte >= 0x40 && byte <= 0x7F) {
+        m_state.startLine = byte & 0x3F;
+    } else if (byte >= 0xB0 && byte <= 0xBF) {
+        m_state.page = byte & 0x0F;
+    } else if (byte >= 0xC0 && byte <= 0xCF) {
+        m_state.comReverse = (byte & 0x08) != 0;
+    } else {
+        switch (byte) {
+        case 0x81: case 0xA8: case 0xAD: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            m_pendingCommand = byte;
+            m_pendingArgs = 1;
+            break;
+        case 0x20: case 0x8D:   // SSD1306：定址模式、充電泵
+            m_pendingCommand = byte;
+            m_pendingArgs = 1;
+            ++m_stats.unsupportedCommands;
+            break;
+        case 0x21: case 0x22:   // SSD1306：欄位 / 頁範圍
+            m_pendingCommand = byte;
+            m_pendingArgs = 2;
+            ++m_stats.unsupportedCommands;
+            break;
+        case 0xA0: case 0xA1: m_state.segmentRemap = byte == 0xA1; break;
+        case 0xA2: case 0xA3: break;    // 偏壓
+        case 0xA4: case 0xA5: m_state.entireOn = byte == 0xA5; break;
+        case 0xA6: case 0xA7: m_state.inverted = byte == 0xA7; break;
+        case 0xAE: case 0xAF: m_state.displayOn = byte == 0xAF; break;
+        case 0xE0:
+            m_state.readModifyWrite = true;
+            m_state.rmwColumn = m_state.column;
+            break;
+        case 0xEE:
+            if (m_state.readModifyWrite) {
+                m_state.column = m_state.rmwColumn;
+                m_state.readModifyWrite = false;
+            }
+            break;
+        case 0xE3: break;       // NOP
+        default:
+            ++m_stats.unsupportedCommands;
+            break;
+        }
+    }
+}
+
+void OledEmulator::data(const uint8_t* bytes, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        writeData(bytes[i]);
+    }
+}
+
+void OledEmulator::writeData(uint8_t value)
+{
+    m_frameActive = true;
+    const int page = m_state.page;
+    const int column = m_state.column;
+    if (column < m_geometry.ramPageWidth) {
+        ++m_state.column;   // 只有頁定址：欄位加一，超過頁寬之後的資料丟棄
+    }
+
+    if (page >= m_geometry.pageCount() || column >= m_geometry.ramPageWidth) {
+        ++m_stats.dataBytes;
+        ++m_stats.busBytes;
+        ++m_stats.hiddenBytes;
+        return;
+    }
+
+    const size_t index = static_cast<size_t>(page * m_geometry.ramPageWidth + column);
+    if (m_autoSplit && m_written[index]) {
+        // 同一個位置又被寫一次：新的畫面開始；剛才設定頁 / 欄位的指令屬於新畫面
+        const qint64 commandBytes = m_trailingCommandBytes;
+        const qint64 busBytes = m_trailingBusBytes;
+        m_stats.commandBytes -= commandBytes;
+        m_stats.busBytes -= busBytes;
+        endFrame();
+        m_stats.commandBytes = commandBytes;
+        m_stats.busBytes = busBytes;
+        m_frameActive = true;
+    }
+    m_trailingCommandBytes = 0;
+    m_trailingBusBytes = 0;
+
+    ++m_stats.dataBytes;
+    ++m_stats.busBytes;
+    if (m_ram[index] == value) {
+        ++m_stats.redundantBytes;
+    } else {
+        ++m_stats.changedBytes;
+        m_ram[index] = value;
+    }
+    if (column < m_geometry.columnOffset || column >= m_geometry.columnOffset + m_geometry.width) {
+        ++m_stats.hiddenBytes;
+    }
+    m_written[index] = 1;
+    m_stats.pagesWritten |= 1u << page;
+}
+
+void OledEmulator::execute(const Transfer& transfer)
+{
+    if (transfer.kind == Transfer::FrameEnd) {
+        endFrame();
+        return;
+    }
+
+    if (transfer.overheadBytes > 0) {
+        m_frameActive = true;
+        m_stats.busBytes += transfer.overheadBytes;
+        m_trailingBusBytes += transfer.overheadBytes;
+    }
+    if (transfer.kind == Transfer::Command) {
+        for (const uint8_t byte : transfer.bytes) {
+            command(byte);
+        }
+    } else {
+        data(transfer.bytes.data(), transfer.bytes.size());
+    }
+}
+
+void OledEmulator::endFrame()
+{
+    if (!m_frameActive) {
+        return;
+    }
+    Frame frame;
+    frame.stats = m_stats;
+    frame.state = m_state;
+    frame.ram = m_ram;
+    m_frames.push_back(std::move(frame));
+
+    m_stats = FrameStats();
+    m_frameActive = false;
+    m_trailingCommandBytes = 0;
+    m_trailingBusBytes = 0;
+    std::fill(m_written.begin(), m_written.end(), 0);
+}
+
+void OledEmulator::run(const std::vector<Transfer>& transfers)
+{
+    const bool autoSplit = m_autoSplit;
+    m_autoSplit = std::none_of(transfers.cbegin(), transfers.cend(),
+                               [](const Transfer& t) { return t.kind == Transfer::FrameEnd; });
+    for (const Transfer& transfer : transfers) {
+        execute(transfer);
+    }
+    endFrame();
+    m_autoSplit = autoSplit;
+}
+
+std::vector<uint8_t> OledEmulator::render(const OledPanelGeometry& geometry, const std::vector<uint8_t>& ram,
+                                          const State& state, bool rotated180)
+{
+    std::vector<uint8_t> out(static_cast<size_t>(geometry.bufferSize()), 0);
+    if (ram.size() < out.size() || !state.displayOn) {
+        return out;     // 顯示關閉：全黑
+    }
+
+    const int rows = geometry.pageCount() * 8;
+    const int pageWidth = geometry.ramPageWidth;
+    for (int y = 0; y < std::min(geometry.height, state.multiplexRatio); ++y) {
+        // 面板第 y 列由哪一條 COM 驅動，再對應到 RAM 的哪一列 (多工比以外的列不會亮)
+        const int com = state.comReverse ? state.multiplexRatio - 1 - y : y;
+        const int row = (com + state.startLine + state.displayOffset) % rows;
+        const uint8_t* source = ram.data() + (row >> 3) * pageWidth;
+        const int bit = row & 7;
+
+        const int outY = rotated180 ? geometry.height - 1 - y : y;
+        uint8_t* target = out.data() + (outY >> 3) * pageWidth + geometry.columnOffset;
+        const uint8_t mask = static_cast<uint8_t>(1u << (outY & 7));
+
+        for (int x = 0; x < geometry.width; ++x) {
+            const int segment = x + geometry.columnOffset;
+            const int column = state.segmentRemap ? pageWidth - 1 - segment : segment;
+            const bool lit = state.entireOn || (((source[column] >> bit) & 1) != 0) != state.inverted;
+            if (lit) {
+                target[rotated180 ? geometry.width - 1 - x : x] |= mask;
+            }
+        }
+    }
+    return out;
+}
+
+bool OledEmulator::splitI2c(const uint8_t* bytes, size_t size, std::vector<Transfer>* transfers)
+{
+    size_t i = 0;
+    int overhead = 0;
+    if (size > 0 && !isControlByte(bytes[0])) {
+        ++i;        // 從機位址 (0x78、0x7A 或 7 位元的 0x3C、0x3D)
+        ++overhead;
+    }
+    if (i >= size) {
+        return false;
+    }
+
+    while (i < size) {
+        const uint8_t control = bytes[i++];
+        ++overhead;
+        Transfer transfer;
+        transfer.kind = (control & 0x40) ? Transfer::Data : Transfer::Command;
+        transfer.overheadBytes = overhead;
+        overhead = 0;
+        if (control & 0x80) {
+            // Co = 1：只有下一個 byte，之後又是控制 byte
+            if (i >= size) {
+                return false;
+            }
+            transfer.bytes.push_back(bytes[i++]);
+        } else {
+            transfer.bytes.assign(bytes + i, bytes + size);
+            i = size;
+        }
+        transfers->push_back(std::move(transfer));
+    }
+    return true;
+}
+
+bool OledEmulator::parseTrace(const QString& text, std::vector<Transfer>* transfers, QString* errorMessage)
+{
+    const QStringList lines = text.split('\n');
+    for (int lineNo = 0; lineNo < lines.size(); ++lineNo) {
+        QString line = lines.at(lineNo);
+        for (const char marker : {'#', ';'}) {
+            const int comment = line.indexOf(QLatin1Char(marker));
+            if (comment != -1) {
+                line.truncate(comment);
+            }
+        }
+        line.replace(',', ' ');
+        const QStringList tokens = line.simplified().split(' ', Qt::SkipEmptyParts);
+        if (tokens.isEmpty()) {
+            continue;
+        }
+
+        const QString kind = tokens.first().toLower();
+        auto fail = [&](const QString& message) {
+            if (errorMessage) {
+                *errorMessage = QString("第 %1 行: %2").arg(lineNo + 1).arg(message);
+            }
+            return false;
+        };
+
+        if (kind == "frame" || kind == "---") {
+            Transfer transfer;
+            transfer.kind = Transfer::FrameEnd;
+            transfers->push_back(transfer);
+            continue;
+        }
+
+        std::vector<uint8_t> bytes;
+        bytes.reserve(static_cast<size_t>(tokens.size()));
+        for (int i = 1; i < tokens.size(); ++i) {
+            uint8_t value;
+            if (!parseHexByte(tokens.at(i), &value)) {
+                return fail(QString("無效的 hex 值: %1").arg(tokens.at(i)));
+            }
+            bytes.push_back(value);
+        }
+
+        if (kind == "c" || kind == "cmd" || kind == "d" || kind == "data") {
+            Transfer transfer;
+            transfer.kind = (kind == "c" || kind == "cmd") ? Transfer::Command : Transfer::Data;
+            transfer.bytes = std::move(bytes);
+            transfers->push_back(std::move(transfer));
+        } else if (kind == "i" || kind == "i2c") {
+            if (!splitI2c(bytes.data(), bytes.size(), transfers)) {
+                return fail("I2C 傳輸缺少控制 byte 或內容");
+            }
+        } else {
+            return fail(QString("未知的傳輸類型: %1 (可用: C, D, I, frame)").arg(tokens.first()));
+        }
+    }
+    return true;
+}
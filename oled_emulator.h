@@ -0,0 +1,162 @@
+#ifndef OLED_EMULATOR_H
+#define OLED_EMULATOR_H
+
+#pragma once
+
+#include "oled_panel.h"
+
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief SH1106 指令串流模擬器 (oledcore，不依賴 Qt Widgets)。
+ *
+ * 依序執行從 I2C / SPI 擷取到的指令與資料 (D/C 已標記)，更新 132x64 的 GDDRAM 模型，
+ * 再依目前的顯示設定 (起始列、顯示偏移、區段重映射、COM 掃描方向、反白、全亮、開關) 算出面板上看到的畫面。
+ * 每個畫面統計匯流排 byte 數與「寫了但內容沒變」的 byte 數，不用硬體就能從裝置的紀錄找出多餘的重繪。
+ *
+ * 支援的指令 (SH1106 資料手冊)：
+ * - 00-0F / 10-1F 欄位位址低 / 高 4 位元，B0-B7 頁位址 (只有頁定址，寫入資料後欄位加一、頁不變)
+ * - 40-7F 顯示起始列，81 xx 對比，A0/A1 區段重映射，A4/A5 全亮，A6/A7 反白，A8 xx 多工比，
+ *   AE/AF 顯示關 / 開，C0/C8 COM 掃描方向，D3 xx 顯示偏移
+ * - E0 / EE 讀-改-寫 (結束時欄位回到 E0 時的位置)，E3 NOP
+ * - 30-33、A2/A3、AD xx、D5 xx、D9 xx、DA xx、DB xx 只影響類比電路，接受但不模擬
+ * - SSD1306 的 20 xx、21 xx xx、22 xx xx、8D xx 會吃掉參數 (避免串流錯位)，記為不支援的指令
+ *
+ * 寫入超過 RAM 頁寬的資料會被丟棄 (記在 FrameStats::hiddenBytes)。
+ * 幾何沿用 OledPanelGeometry：RAM 為 ramPageWidth x (頁數 x 8)，可視區域從 columnOffset 開始。
+ */
+class OledEmulator
+{
+public:
+    /// 一段傳輸：一串指令或一串資料 (同一個 D/C 狀態)，或畫面分隔
+    struct Transfer {
+        enum Kind {
+            Command,
+            Data,
+            FrameEnd
+        };
+        Kind kind = Command;
+        std::vector<uint8_t> bytes;
+        int overheadBytes = 0;      // 線上的額外 byte (I2C 的位址與控制 byte)
+    };
+
+    /// 顯示相關的暫存器 (上電時的預設值)
+    struct State {
+        int page = 0;
+        int column = 0;
+        int startLine = 0;          // 40-7F
+        int displayOffset = 0;      // D3
+        int multiplexRatio = 64;    // A8 (已加一，列數)
+        int contrast = 0x80;        // 81
+        bool segmentRemap = false;  // A1
+        bool comReverse = false;    // C8
+        bool inverted = false;      // A7
+        bool entireOn = false;      // A5
+        bool displayOn = false;     // AF
+        bool readModifyWrite = false;
+        int rmwColumn = 0;          // E0 時的欄位
+    };
+
+    struct FrameStats {
+        qint64 busBytes = 0;        // 線上實際傳輸的 byte (指令 + 資料 + I2C 額外 byte)
+        qint64 commandBytes = 0;
+        qint64 dataBytes = 0;
+        qint64 changedBytes = 0;    // 寫入後 RAM 內容有改變的資料 byte
+        qint64 redundantBytes = 0;  // 寫入的值和 RAM 原本的值相同 (多餘的重繪)
+        qint64 hiddenBytes = 0;     // 寫到可視區域外 (填充欄位或超過頁寬) 的資料 byte
+        int unsupportedCommands = 0;
+        quint32 pagesWritten = 0;   // 有寫入資料的頁 (bit n = 第 n 頁)
+    };
+
+    struct Frame {
+        FrameStats stats;
+        State state;                // 畫面結束時的暫存器
+        std::vector<uint8_t> ram;   // 畫面結束時的 GDDRAM (bufferSize() bytes)
+    };
+
+    explicit OledEmulator(const OledPanelGeometry& geometry = OledPanel::defaultProfile().geometry);
+
+    const OledPanelGeometry& geometry() const { return m_geometry; }
+
+    /// 回到上電狀態：暫存器為預設值、RAM 清為 0、清除已記錄的畫面
+    void reset();
+
+    void command(uint8_t byte);
+    void data(const uint8_t* bytes, size_t size);
+    void execute(const Transfer& transfer);
+
+    /**
+     * @brief 結束目前的畫面：記下統計、暫存器與 RAM。目前的畫面沒有任何傳輸時不做事。
+     */
+    void endFrame();
+
+    /**
+     * @brief 執行整段紀錄，最後結束未完成的畫面。
+     *
+     * 紀錄中有 FrameEnd 時以它分隔畫面；沒有時，資料寫到這個畫面已經寫過的 RAM 位置就視為新畫面開始。
+     */
+    void run(const std::vector<Transfer>& transfers);
+
+    const State& state() const { return m_state; }
+    const std::vector<uint8_t>& ram() const { return m_ram; }
+    const std::vector<Frame>& frames() const { return m_frames; }
+    const FrameStats& currentStats() const { return m_stats; }
+
+    /**
+     * @brief 依 state 的顯示設定，算出面板上看到的畫面。
+     *
+     * 輸出與編輯器的硬體緩衝區相同的格式 (bufferSize() bytes，可視區域從 columnOffset 開始，填充欄位為 0)，
+     * 可以直接交給 OledDataModel::setFromHardwareBuffer()。
+     *
+     * @param rotated180 模組上下顛倒安裝 (許多 SH1106 模組以 A1 + C8 為正向)。
+     */
+    static std::vector<uint8_t> render(const OledPanelGeometry& geometry, const std::vector<uint8_t>& ram,
+                                       const State& state, bool rotated180 = false);
+    std::vector<uint8_t> render(bool rotated180 = false) const { return render(m_geometry, m_ram, m_state, rotated180); }
+
+    /**
+     * @brief 解析文字格式的匯流排紀錄。
+     *
+     * 一行一段傳輸，'#' 或 ';' 之後為註解，數值為 hex (可加 0x，可用逗號分隔)：
+     * @code
+     * C AE D5 80        # SPI 指令 (D/C = 0)，也可以寫 cmd
+     * D 00 FF 3C ...    # SPI 資料 (D/C = 1)，也可以寫 data
+     * I 78 00 AE A1     # I2C 寫入：[從機位址] 控制 byte 之後的內容，也可以寫 i2c
+     * frame             # 畫面分隔，也可以寫 ---
+     * @endcode
+     * I2C 的控制 byte：bit6 (D/C) 決定後面是指令或資料；bit7 (Co) 為 0 時本次傳輸剩下的 byte 都是同一種，
+     * 為 1 時只有下一個 byte，接著又是控制 byte。第一個 byte 不是 00/40/80/C0 時視為從機位址。
+     *
+     * @param errorMessage 失敗時寫入錯誤訊息 (含行號)，可為 nullptr。
+     */
+    static bool parseTrace(const QString& text, std::vector<Transfer>* transfers, QString* errorMessage = nullptr);
+
+    /**
+     * @brief 把一次 I2C 寫入 ([從機位址] 控制 byte ...) 拆成指令 / 資料段，加到 transfers 的尾端。
+     *
+     * 位址與控制 byte 記在各段的 overheadBytes。
+     * @return 控制 byte 之後缺少內容 (Co = 1 卻已經結束) 或沒有任何控制 byte 時回傳 false。
+     */
+    static bool splitI2c(const uint8_t* bytes, size_t size, std::vector<Transfer>* transfers);
+
+private:
+    void writeData(uint8_t value);
+
+    OledPanelGeometry m_geometry;
+    State m_state;
+    std::vector<uint8_t> m_ram;
+    std::vector<uint8_t> m_written;     // 目前畫面寫過的 RAM 位置 (自動分隔畫面用)
+    std::vector<Frame> m_frames;
+    FrameStats m_stats;
+    bool m_frameActive = false;         // 目前的畫面有傳輸
+    bool m_autoSplit = true;
+    qint64 m_trailingCommandBytes = 0;  // 上一個資料 byte 之後的指令 (自動分隔時算到新畫面)
+    qint64 m_trailingBusBytes = 0;
+    int m_pendingCommand = 0;           // 等待參數的雙 byte 指令
+    int m_pendingArgs = 0;              // 還要吃掉的參數個數
+};
+
+#endif // OLED_EMULATOR_H
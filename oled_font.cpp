@@ -0,0 +1,605 @@
+#include "oled_font.h"
+#include "oled_carray.h"
+#include "oled_datamodel.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QFont>
+#include <QFontMetrics>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QStringList>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+constexpr int kMaxFontHeight = 256;         // 與面板相同，最多 32 頁
+constexpr int kMaxCachedFonts = 32;
+
+// 經典的 5x7 ASCII 字型 (32..126)，每個字元 5 欄，bit0 在最上方
+const uint8_t kFont5x7[95][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00}, // ' ' ! "
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62}, // # $ %
+    {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00}, // & ' (
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x08, 0x2A, 0x1C, 0x2A, 0x08}, {0x08, 0x08, 0x3E, 0x08, 0x08}, // ) * +
+    {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00}, // , - .
+    {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00}, // / 0 1
+    {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31}, {0x18, 0x14, 0x12, 0x7F, 0x10}, // 2 3 4
+    {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03}, // 5 6 7
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x36, 0x36, 0x00, 0x00}, // 8 9 :
+    {0x00, 0x56, 0x36, 0x00, 0x00}, {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14}, // ; < =
+    {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, {0x32, 0x49, 0x79, 0x41, 0x3E}, // > ? @
+    {0x7E, 0x11, 0x11, 0x11, 0x7E}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22}, // A B C
+    {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01}, // D E F
+    {0x3E, 0x41, 0x49, 0x49, 0x7A}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00}, // G H I
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40}, // J K L
+    {0x7F, 0x02, 0x0C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E}, // M N O
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46}, // P Q R
+    {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F}, // S T U
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F}, {0x63, 0x14, 0x08, 0x14, 0x63}, // V W X
+    {0x07, 0x08, 0x70, 0x08, 0x07}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00}, // Y Z [
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04}, // \ ] ^
+    {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78}, // _ ` a
+    {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7F}, // b c d
+    {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x0C, 0x52, 0x52, 0x52, 0x3E}, // e f g
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3D, 0x00}, // h i j
+    {0x7F, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78}, // k l m
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0x7C, 0x14, 0x14, 0x14, 0x08}, // n o p
+    {0x08, 0x14, 0x14, 0x18, 0x7C}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20}, // q r s
+    {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C}, // t u v
+    {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C}, // w x y
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7F, 0x00, 0x00}, // z { |
+    {0x00, 0x41, 0x36, 0x08, 0x00}, {0x08, 0x04, 0x08, 0x10, 0x08},                                 // } ~
+};
+
+std::atomic<quint64> g_rasterizedGlyphs{0};
+
+QMutex g_fontMutex;
+struct CachedFile {
+    std::shared_ptr<const OledFont> font;
+    qint64 modified = 0;
+    qint64 size = 0;
+};
+QHash<QString, CachedFile> g_fileFonts;
+QHash<QString, std::shared_ptr<const OledFont>> g_systemFonts;
+
+void setError(QString* errorMessage, const QString& message)
+{
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+}
+
+// 巨集的值：0、16、(16)、0x20、16u 都可以
+bool parseMacroValue(QLatin1String value, int* number)
+{
+    QString text = QString(value).trimmed();
+    while (text.startsWith('(') && text.endsWith(')')) {
+        text = text.mid(1, text.size() - 2).trimmed();
+    }
+    while (!text.isEmpty() && (text.endsWith('u') || text.endsWith('U') || text.endsWith('l') || text.endsWith('L'))) {
+        text.chop(1);
+    }
+    bool ok = false;
+    *number = text.toInt(&ok, 0);
+    return ok && *number >= 0;
+}
+
+}
+
+OledFont::OledFont(const QString& name, int height, int ascent)
+    : m_name(name), m_height(std::clamp(height, 0, kMaxFontHeight)), m_ascent(std::clamp(ascent, 0, m_height))
+{
+}
+
+const OledFont& OledFont::builtin()
+{
+    static const OledFont font = []() {
+        OledFont builtin("5x7", 8, 7);
+        for (int i = 0; i < 95; ++i) {
+            builtin.addGlyph(uint(32 + i), kFont5x7[i], 5, 6);
+        }
+        return builtin;
+    }();
+    return font;
+}
+
+bool OledFont::isFixedPitch() const
+{
+    return std::all_of(m_glyphs.begin(), m_glyphs.end(),
+                       [this](const Glyph& glyph) { return glyph.advance == m_glyphs.front().advance; });
+}
+
+void OledFont::addGlyph(uint codepoint, const uint8_t* bits, int width, int advance)
+{
+    width = std::max(width, 0);
+    Glyph glyph;
+    glyph.width = width;
+    glyph.advance = std::max(advance, 0);
+    glyph.offset = m_atlas.size();
+
+    // 每個字元從 byte 邊界開始，最後一頁超過字高的 bit 清掉 (畫到畫布時才不會多出列)
+    const size_t size = static_cast<size_t>(width) * static_cast<size_t>(pageCount());
+    m_atlas.resize(m_atlas.size() + size, 0);
+    if (bits && size > 0) {
+        uint8_t* out = m_atlas.data() + glyph.offset;
+        std::memcpy(out, bits, size);
+        if (m_height & 7) {
+            const uint8_t keep = static_cast<uint8_t>((1u << (m_height & 7)) - 1);
+            uint8_t* last = out + size_t(pageCount() - 1) * size_t(width);
+            for (int x = 0; x < width; ++x) last[x] &= keep;
+        }
+    }
+
+    int index = static_cast<int>(m_glyphs.size());
+    if (const Glyph* existing = findGlyph(codepoint)) {
+        index = static_cast<int>(existing - m_glyphs.data());     // 取代 (舊的點陣留在 atlas 中)
+        m_glyphs[size_t(index)] = glyph;
+    } else {
+        m_glyphs.push_back(glyph);
+    }
+    if (codepoint < 128) {
+        if (m_ascii.empty()) m_ascii.assign(128, -1);
+        m_ascii[codepoint] = index;
+    } else {
+        m_index[codepoint] = index;
+    }
+}
+
+const OledFont::Glyph* OledFont::findGlyph(uint codepoint) const
+{
+    if (codepoint < 128) {
+        const int index = m_ascii.empty() ? -1 : m_ascii[codepoint];
+        return index < 0 ? nullptr : &m_glyphs[size_t(index)];
+    }
+    const auto it = m_index.find(codepoint);
+    return it == m_index.end() ? nullptr : &m_glyphs[size_t(it->second)];
+}
+
+std::vector<uint> OledFont::codepoints() const
+{
+    std::vector<uint> result;
+    result.reserve(m_glyphs.size());
+    for (size_t codepoint = 0; codepoint < m_ascii.size(); ++codepoint) {
+        if (m_ascii[codepoint] >= 0) result.push_back(uint(codepoint));
+    }
+    const size_t ascii = result.size();     // ASCII 已經依序排好，只排其他字元
+    for (const auto& entry : m_index) {
+        result.push_back(entry.first);
+    }
+    std::sort(result.begin() + std::ptrdiff_t(ascii), result.end());
+    return result;
+}
+
+const OledFont::Glyph* OledFont::glyph(uint codepoint) const
+{
+    const Glyph* found = findGlyph(codepoint);
+    return found ? found : findGlyph('?');
+}
+
+QSize OledFont::measure(const QString& text) const
+{
+    int width = 0;
+    int lines = 1;
+    int pen = 0;
+    for (const uint codepoint : text.toUcs4()) {
+        if (codepoint == '\n') {
+            pen = 0;
+            ++lines;
+            continue;
+        }
+        const Glyph* g = glyph(codepoint);
+        width = std::max(width, pen + (g ? g->width : 0));
+        pen += g ? g->advance : m_height / 2;
+    }
+    return QSize(width, lines * m_height);
+}
+
+QRect OledFont::drawText(OledDataModel* model, int x, int y, const QString& text, bool on) const
+{
+    if (!model || m_height <= 0) {
+        return QRect();
+    }
+    int pen = x;
+    int top = y;
+    for (const uint codepoint : text.toUcs4()) {
+        if (codepoint == '\n') {
+            pen = x;
+            top += m_height;
+            continue;
+        }
+        const Glyph* g = glyph(codepoint);
+        if (!g) {
+            pen += m_height / 2;
+            continue;
+        }
+        if (g->width > 0) {
+            model->blitPages(pen, top, glyphBits(*g), g->width, m_height, on);
+        }
+        pen += g->advance;
+    }
+    return QRect(QPoint(x, y), measure(text));
+}
+
+QImage OledFont::render(const QString& text) const
+{
+    const QSize size = measure(text);
+    QImage image(std::max(size.width(), 1), std::max(size.height(), 1), QImage::Format_Mono);
+    image.setColor(0, qRgb(0, 0, 0));
+    image.setColor(1, qRgb(255, 255, 255));
+    image.fill(0);
+
+    int pen = 0;
+    int top = 0;
+    for (const uint codepoint : text.toUcs4()) {
+        if (codepoint == '\n') {
+            pen = 0;
+            top += m_height;
+            continue;
+        }
+        const Glyph* g = glyph(codepoint);
+        if (!g) {
+            pen += m_height / 2;
+            continue;
+        }
+        const uint8_t* bits = glyphBits(*g);
+        for (int row = 0; row < m_height; ++row) {
+            const uint8_t* page = bits + (row >> 3) * g->width;
+            const uint8_t mask = static_cast<uint8_t>(1u << (row & 7));
+            for (int column = 0; column < g->width; ++column) {
+                if (page[column] & mask) {
+                    image.setPixel(pen + column, top + row, 1);
+                }
+            }
+        }
+        pen += g->advance;
+    }
+    return image;
+}
+
+bool OledFont::fromBdf(const QByteArray& data, OledFont* font, QString* errorMessage)
+{
+    const QList<QByteArray> lines = data.split('\n');
+    QString name;
+    int boxHeight = 0;
+    int boxY = 0;
+    int ascent = -1;
+    int descent = -1;
+
+    // 第一輪：字型的基線與字高 (FONT_ASCENT / FONT_DESCENT 可能出現在 FONTBOUNDINGBOX 之後)
+    for (const QByteArray& raw : lines) {
+        const QList<QByteArray> tokens = raw.simplified().split(' ');
+        const QByteArray& key = tokens.first();
+        if (key == "STARTCHAR") {
+            break;
+        }
+        if (key == "FONT" && tokens.size() > 1) {
+            name = QString::fromUtf8(raw.simplified().mid(5));
+        } else if (key == "FONTBOUNDINGBOX" && tokens.size() >= 5) {
+            boxHeight = tokens.at(2).toInt();
+            boxY = tokens.at(4).toInt();
+        } else if (key == "FONT_ASCENT" && tokens.size() > 1) {
+            ascent = tokens.at(1).toInt();
+        } else if (key == "FONT_DESCENT" && tokens.size() > 1) {
+            descent = tokens.at(1).toInt();
+        }
+    }
+    if (ascent < 0) ascent = boxHeight + boxY;
+    if (descent < 0) descent = -boxY;
+    const int height = ascent + descent;
+    if (height <= 0 || height > kMaxFontHeight || ascent < 0) {
+        setError(errorMessage, "BDF 字型沒有有效的字高 (FONTBOUNDINGBOX / FONT_ASCENT / FONT_DESCENT)");
+        return false;
+    }
+
+    OledFont result(name.isEmpty() ? QString("bdf") : name, height, ascent);
+    const int pages = result.pageCount();
+    std::vector<uint8_t> bits;
+    int encoding = -1;
+    int advance = 0;
+    int w = 0, h = 0, xo = 0, yo = 0;
+    int row = -1;           // BITMAP 之後的第幾列，-1 表示不在點陣中
+    int cellWidth = 0;
+
+    for (const QByteArray& raw : lines) {
+        const QByteArray line = raw.trimmed();
+        if (row >= 0) {
+            if (line == "ENDCHAR") {
+                if (encoding >= 0) {
+                    result.addGlyph(uint(encoding), bits.data(), cellWidth, advance);
+                }
+                row = -1;
+                continue;
+            }
+            // 每列 (w + 7) / 8 bytes 的 hex，MSB 在最左邊
+            const int cellRow = ascent - yo - h + row;
+            if (cellRow >= 0 && cellRow < height) {
+                const QByteArray bytes = QByteArray::fromHex(line);
+                for (int column = 0; column < w; ++column) {
+                    const int cellColumn = xo + column;
+                    if (cellColumn < 0 || cellColumn >= cellWidth || column / 8 >= bytes.size()) continue;
+                    if (uint8_t(bytes.at(column / 8)) & (0x80u >> (column & 7))) {
+                        bits[size_t((cellRow >> 3) * cellWidth + cellColumn)] |= uint8_t(1u << (cellRow & 7));
+                    }
+                }
+            }
+            ++row;
+            continue;
+        }
+
+        const QList<QByteArray> tokens = line.simplified().split(' ');
+        const QByteArray& key = tokens.first();
+        if (key == "STARTCHAR") {
+            encoding = -1;
+            advance = 0;
+            w = h = xo = yo = 0;
+        } else if (key == "ENCODING" && tokens.size() > 1) {
+            encoding = tokens.at(1).toInt();
+        } else if (key == "DWIDTH" && tokens.size() > 1) {
+            advance = tokens.at(1).toInt();
+        } else if (key == "BBX" && tokens.size() >= 5) {
+            w = tokens.at(1).toInt();
+            h = tokens.at(2).toInt();
+            xo = tokens.at(3).toInt();
+            yo = tokens.at(4).toInt();
+        } else if (key == "BITMAP") {
+            // 字元格從第 0 欄開始，畫在左邊界之外的部分會被裁掉
+            cellWidth = std::clamp(xo + w, 0, 255);
+            bits.assign(size_t(cellWidth) * size_t(pages), 0);
+            row = 0;
+        }
+    }
+
+    if (!result.isValid()) {
+        setError(errorMessage, "BDF 字型中沒有任何字元");
+        return false;
+    }
+    *font = std::move(result);
+    return true;
+}
+
+bool OledFont::fromCArray(const QByteArray& data, OledFont* font, QString* errorMessage)
+{
+    QHash<QString, int> defines;    // 數值巨集，名稱轉成大寫
+    OledCArrayReader reader(data);
+    reader.setDefineHandler([&defines](QLatin1String name, QLatin1String value) {
+        int number = 0;
+        if (parseMacroValue(value, &number)) {
+            defines.insert(QString(name).toUpper(), number);
+        }
+    });
+
+    static const char* const kTableSuffixes[] = {"_WIDTHS", "_OFFSETS", "_CODEPOINTS", "_ADVANCES"};
+    QString name;
+    std::vector<uint8_t> bitmap;
+    QHash<QString, std::vector<uint32_t>> tables;   // name_widths[]、name_offsets[]...，名稱轉成大寫
+    OledCArrayReader::Array array;
+    while (reader.nextArray(&array)) {
+        const QString arrayName = QString(array.name);
+        const QString upper = arrayName.toUpper();
+        const bool table = std::any_of(std::begin(kTableSuffixes), std::end(kTableSuffixes),
+                                       [&upper](const char* suffix) { return upper.endsWith(suffix); });
+        if (table) {
+            std::vector<uint32_t> values;
+            reader.readValues(&values);
+            tables.insert(upper, std::move(values));
+        } else if (name.isEmpty()) {
+            std::vector<uint8_t> values;
+            reader.readValues(&values);
+            if (!values.empty()) {
+                name = arrayName;
+                bitmap = std::move(values);
+            }
+        }
+    }
+    if (name.isEmpty()) {
+        setError(errorMessage, "找不到字型的點陣陣列");
+        return false;
+    }
+
+    const QString prefix = name.toUpper() + "_";
+    const int height = defines.value(prefix + "HEIGHT", 0);
+    if (height <= 0 || height > kMaxFontHeight) {
+        setError(errorMessage, QString("缺少 %1HEIGHT 巨集 (字高)").arg(prefix));
+        return false;
+    }
+    const int firstChar = defines.value(prefix + "FIRST_CHAR", 32);
+    const int spacing = defines.value(prefix + "SPACING", 1);
+    OledFont result(name, height, defines.value(prefix + "ASCENT", height));
+    const size_t pages = static_cast<size_t>(result.pageCount());
+
+    // 每個字元的位置與寬度：name_offsets[] (最後一個到陣列結尾)、name_widths[] 或固定的 NAME_WIDTH
+    std::vector<size_t> offsets;
+    std::vector<int> widths;
+    const std::vector<uint32_t> offsetTable = tables.value(prefix + "OFFSETS");
+    const std::vector<uint32_t> widthTable = tables.value(prefix + "WIDTHS");
+    const std::vector<uint32_t> codepoints = tables.value(prefix + "CODEPOINTS");
+    const std::vector<uint32_t> advances = tables.value(prefix + "ADVANCES");
+    if (!offsetTable.empty()) {
+        // 匯出的位置表多一個結尾；沒有結尾時最後一個字元到陣列的結尾
+        const size_t count = codepoints.empty() || codepoints.size() < offsetTable.size() ? offsetTable.size() - 1
+                                                                                         : offsetTable.size();
+        for (size_t i = 0; i < count; ++i) {
+            const size_t end = i + 1 < offsetTable.size() ? offsetTable[i + 1] : bitmap.size();
+            if (offsetTable[i] > end) {
+                setError(errorMessage, QString("%1_offsets[] 不是由小到大").arg(name));
+                return false;
+            }
+            offsets.push_back(offsetTable[i]);
+            widths.push_back(int((end - offsetTable[i]) / pages));
+        }
+    } else {
+        if (!widthTable.empty()) {
+            widths.assign(widthTable.begin(), widthTable.end());
+        } else {
+            const int width = defines.value(prefix + "WIDTH", 0);
+            if (width <= 0) {
+                setError(errorMessage, QString("缺少 %1WIDTH 巨集或 %2_widths[] (字寬)").arg(prefix, name));
+                return false;
+            }
+            const size_t count = codepoints.empty() ? bitmap.size() / (size_t(width) * pages) : codepoints.size();
+            widths.assign(count, width);
+        }
+        size_t offset = 0;
+        for (const int width : widths) {
+            offsets.push_back(offset);
+            offset += size_t(width) * pages;
+        }
+    }
+    if (!codepoints.empty() && codepoints.size() != widths.size()) {
+        setError(errorMessage, QString("%1_codepoints[] 有 %2 個字元，字寬是 %3 個").arg(name)
+                                   .arg(codepoints.size()).arg(widths.size()));
+        return false;
+    }
+
+    for (size_t i = 0; i < widths.size(); ++i) {
+        const int width = std::clamp(widths[i], 0, 255);
+        if (offsets[i] + size_t(width) * pages > bitmap.size()) {
+            setError(errorMessage, QString("%1[] 的資料比 %2 個字元少").arg(name).arg(widths.size()));
+            return false;
+        }
+        const uint codepoint = codepoints.empty() ? uint(firstChar) + uint(i) : uint(codepoints[i]);
+        const int advance = i < advances.size() ? int(advances[i]) : width + spacing;
+        result.addGlyph(codepoint, bitmap.data() + offsets[i], width, advance);
+    }
+    if (!result.isValid()) {
+        setError(errorMessage, QString("%1[] 中沒有任何字元").arg(name));
+        return false;
+    }
+    *font = std::move(result);
+    return true;
+}
+
+bool OledFont::load(const QString& path, OledFont* font, QString* errorMessage)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(errorMessage, QString("無法開啟檔案: %1").arg(path));
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    if (QFileInfo(path).suffix().toLower() == "bdf") {
+        return fromBdf(data, font, errorMessage);
+    }
+    return fromCArray(data, font, errorMessage);
+}
+
+int OledFont::rasterize(const QFont& font, int threshold, const QString& characters)
+{
+    const QFontMetrics metrics(font);
+    if (m_height <= 0) {
+        m_height = std::clamp(metrics.height(), 1, kMaxFontHeight);
+        m_ascent = std::clamp(metrics.ascent(), 0, m_height);
+        m_name = QString("%1 %2px").arg(font.family()).arg(font.pixelSize());
+    }
+
+    int added = 0;
+    std::vector<uint8_t> bits;
+    for (const uint codepoint : characters.toUcs4()) {
+        if (codepoint == '\n' || findGlyph(codepoint)) {
+            continue;
+        }
+        const QString text = QString::fromUcs4(&codepoint, 1);
+        const int advance = metrics.horizontalAdvance(text);
+        const int width = std::clamp(std::max(advance, metrics.boundingRect(text).right() + 1), 0, 255);
+
+        bits.assign(size_t(width) * size_t(pageCount()), 0);
+        if (width > 0) {
+            // 以灰階畫出 (保留反鋸齒的灰階)，再依 threshold 二值化
+            QImage image(width, m_height, QImage::Format_Grayscale8);
+            image.fill(0);
+            QPainter painter(&image);
+            painter.setFont(font);
+            painter.setPen(Qt::white);
+            painter.drawText(0, m_ascent, text);
+            painter.end();
+            for (int y = 0; y < m_height; ++y) {
+                const uchar* line = image.constScanLine(y);
+                for (int x = 0; x < width; ++x) {
+                    if (line[x] >= threshold) {
+                        bits[size_t((y >> 3) * width + x)] |= uint8_t(1u << (y & 7));
+                    }
+                }
+            }
+        }
+        addGlyph(codepoint, bits.data(), width, advance);
+        ++added;
+    }
+    g_rasterizedGlyphs += quint64(added);
+    return added;
+}
+
+std::shared_ptr<const OledFont> OledFontCache::file(const QString& path, QString* errorMessage)
+{
+    const QFileInfo info(path);
+    const QString key = info.absoluteFilePath();
+    const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+    const qint64 size = info.size();
+    {
+        QMutexLocker locker(&g_fontMutex);
+        const CachedFile cached = g_fileFonts.value(key);
+        if (cached.font && cached.modified == modified && cached.size == size) {
+            return cached.font;
+        }
+    }
+
+    auto font = std::make_shared<OledFont>();
+    if (!OledFont::load(path, font.get(), errorMessage)) {
+        return nullptr;
+    }
+    QMutexLocker locker(&g_fontMutex);
+    if (!g_fileFonts.contains(key) && g_fileFonts.size() >= kMaxCachedFonts) {
+        g_fileFonts.clear();
+    }
+    g_fileFonts.insert(key, CachedFile{font, modified, size});
+    return font;
+}
+
+std::shared_ptr<const OledFont> OledFontCache::system(const QFont& font, int pixelSize, int threshold,
+                                                      const QString& text)
+{
+    const QString key = QString("%1|%2|%3").arg(font.key()).arg(pixelSize).arg(threshold);
+    QMutexLocker locker(&g_fontMutex);
+    std::shared_ptr<const OledFont> cached = g_systemFonts.value(key);
+
+    bool missing = !cached;
+    if (cached) {
+        for (const uint codepoint : text.toUcs4()) {
+            if (codepoint != '\n' && !cached->contains(codepoint)) {
+                missing = true;
+                break;
+            }
+        }
+    }
+    if (!missing) {
+        return cached;
+    }
+
+    // copy-on-write：只畫出還沒有的字元
+    auto updated = cached ? std::make_shared<OledFont>(*cached) : std::make_shared<OledFont>();
+    QFont sized(font);
+    sized.setPixelSize(std::max(pixelSize, 1));
+    updated->rasterize(sized, threshold, text);
+    if (!cached && g_systemFonts.size() >= kMaxCachedFonts) {
+        g_systemFonts.clear();
+    }
+    g_systemFonts.insert(key, updated);
+    return updated;
+}
+
+quint64 OledFontCache::rasterizedGlyphCount()
+{
+    return g_rasterizedGlyphs.load();
+}
+
+void OledFontCache::clear()
+{
+    QMutexLocker locker(&g_fontMutex);
+    g_fileFonts.clear();
+    g_systemFonts.clear();
+}
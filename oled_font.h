@@ -0,0 +1,144 @@
+#ifndef OLED_FONT_H
+#define OLED_FONT_H
+
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QRect>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class OledDataModel;
+class QFont;
+
+/**
+ * @brief 點陣字型 (oledcore，只用到 QtCore / QtGui)。
+ *
+ * 每個字元都是整個字高 (height() 列) 的頁面格式點陣：第 0 列是字元格的頂端，
+ * 每欄 pageCount() 個 byte (bit0 在最上方)，頁優先 (先是第 0 頁的每一欄，再來第 1 頁...)。
+ * 所有字元依序緊密地放在同一塊 atlas 中，每個字元從 byte 邊界 (字元格頂端 = 頁的 bit0) 開始，
+ * 所以畫到 y 為 8 的倍數的位置時可以整個 byte 直接寫入畫布 (OledDataModel::blitPages())。
+ *
+ * 來源：
+ * - builtin()：內建的 5x7 ASCII 字型 (字高 8，每字前進 6 欄)。
+ * - fromBdf()：X11 BDF 點陣字型 (固定寬度或比例字型)。
+ * - fromCArray()：本專案的 C 陣列字型標頭，格式如下 (NAME 為陣列名稱的大寫)：
+ *   @code
+ *   #define NAME_HEIGHT 8          // 字高 (必要)
+ *   #define NAME_ASCENT 7          // 基線以上的列數 (預設同字高)
+ *   #define NAME_FIRST_CHAR 32     // 第一個字元的編碼 (預設 32)
+ *   #define NAME_WIDTH 5           // 固定寬度字型的字寬 (沒有 name_widths[] / name_offsets[] 時必要)
+ *   #define NAME_SPACING 1         // 字距 (預設 1)
+ *   const uint8_t name[] = { ... };         // 每個字元 寬 x 頁數 bytes，頁優先，依編碼順序
+ *   const uint8_t name_widths[] = { ... };  // 比例字型：每個字元的寬度 (選用)
+ *   const uint16_t name_offsets[] = { ... };    // 或：每個字元在 name[] 中的位置，最後多一個結尾 (選用)
+ *   const uint16_t name_codepoints[] = { ... }; // 不連續的字元 (子集)：每個字元的編碼，由小到大 (選用)
+ *   const uint8_t name_advances[] = { ... };    // 字距不固定時：每個字元前進的欄數 (選用)
+ *   @endcode
+ *   位置表與字元表可以是 uint8_t、uint16_t 或 uint32_t (依最大值)。
+ *   OledFontExporter 匯出的子集字型就是這個格式，可以直接再讀回來。
+ * - rasterize()：以 QFont 畫出字元後依 threshold 二值化 (系統字型)，通常經由 OledFontCache。
+ */
+class OledFont
+{
+public:
+    struct Glyph {
+        int width = 0;          // 點陣的欄數 (空白可以是 0)
+        int advance = 0;        // 畫完之後游標前進的欄數 (含字距)
+        size_t offset = 0;      // 點陣在 atlas 中的位置 (width * pageCount() bytes)
+    };
+
+    OledFont() = default;
+    OledFont(const QString& name, int height, int ascent);
+
+    /// 內建 5x7 字型 (ASCII 32..126)
+    static const OledFont& builtin();
+
+    static bool fromBdf(const QByteArray& data, OledFont* font, QString* errorMessage = nullptr);
+    static bool fromCArray(const QByteArray& data, OledFont* font, QString* errorMessage = nullptr);
+    /// 依副檔名 (.bdf 或 C 陣列) 讀取字型檔
+    static bool load(const QString& path, OledFont* font, QString* errorMessage = nullptr);
+
+    bool isValid() const { return m_height > 0 && !m_glyphs.empty(); }
+    const QString& name() const { return m_name; }
+    int height() const { return m_height; }
+    int ascent() const { return m_ascent; }
+    int pageCount() const { return (m_height + 7) / 8; }
+    int glyphCount() const { return static_cast<int>(m_glyphs.size()); }
+    std::vector<uint> codepoints() const;   // 字型中所有的字元，由小到大
+    bool isFixedPitch() const;
+    const std::vector<uint8_t>& atlas() const { return m_atlas; }
+
+    /**
+     * @brief 加入 (或取代) 一個字元。
+     * @param bits 頁面格式的點陣，width * pageCount() bytes；超過字高的 bit 會被清掉。
+     */
+    void addGlyph(uint codepoint, const uint8_t* bits, int width, int advance);
+    bool contains(uint codepoint) const { return findGlyph(codepoint) != nullptr; }
+
+    /// 字元；字型中沒有時改用 '?'，也沒有時回傳 nullptr (只前進字高的一半)
+    const Glyph* glyph(uint codepoint) const;
+    const uint8_t* glyphBits(const Glyph& glyph) const { return m_atlas.data() + glyph.offset; }
+
+    /**
+     * @brief 以 QFont 畫出 characters 中還沒有的字元，灰階 >= threshold 的像素點亮。
+     *
+     * 字元格的大小 (字高、基線) 在第一次呼叫時由 QFontMetrics 決定，之後的字元沿用。
+     * @return 新加入的字元數。
+     */
+    int rasterize(const QFont& font, int threshold, const QString& characters);
+
+    /// 文字的大小 ('\n' 換行，每行 height() 列)
+    QSize measure(const QString& text) const;
+
+    /**
+     * @brief 把文字畫到 model 的目前圖層，(x, y) 為第一行字元格的左上角。
+     *
+     * 每個字元以 OledDataModel::blitPages() 寫入 (y 為 8 的倍數時整個 byte 直接寫入)。
+     * @return 文字佔用的範圍 (未裁切)。
+     */
+    QRect drawText(OledDataModel* model, int x, int y, const QString& text, bool on = true) const;
+
+    /// 預覽用：把文字畫成 Format_Mono 的 QImage (1 = 點亮，與 copyRegionToLogicalFormat() 相同)
+    QImage render(const QString& text) const;
+
+private:
+    const Glyph* findGlyph(uint codepoint) const;
+
+    QString m_name;
+    int m_height = 0;
+    int m_ascent = 0;
+    std::vector<Glyph> m_glyphs;
+    std::vector<int> m_ascii;                       // ASCII 的字元索引 (-1 表示沒有)，最常用的字元不查表
+    std::unordered_map<uint, int> m_index;          // 其他字元
+    std::vector<uint8_t> m_atlas;
+};
+
+/**
+ * @brief 字型快取 (整個程式共用，可跨執行緒)。
+ *
+ * - file()：依路徑快取，修改時間與大小沒變時直接回傳上一次讀取的字型。
+ * - system()：依 (QFont::key()、像素大小、threshold) 快取二值化後的系統字型，
+ *   只有第一次用到的字元才會畫出並二值化；重新輸入同一段文字不會再處理任何字元。
+ *   加入新字元時以 copy-on-write 換掉快取中的字型，已經拿到的 shared_ptr 不受影響。
+ */
+class OledFontCache
+{
+public:
+    static std::shared_ptr<const OledFont> file(const QString& path, QString* errorMessage = nullptr);
+    static std::shared_ptr<const OledFont> system(const QFont& font, int pixelSize, int threshold,
+                                                  const QString& text);
+
+    /// 累計二值化過的字元數 (量測用)
+    static quint64 rasterizedGlyphCount();
+
+    /// 清空快取 (測試與量測使用)。
+    static void clear();
+};
+
+#endif // OLED_FONT_H
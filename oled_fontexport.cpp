@@ -0,0 +1,300 @@
+#include "oled_fontexport.h"
+#include "oled_carray.h"
+#include "oled_font.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace {
+
+// --- 輸出到韌體的 C 程式 (接在 OledCArrayWriter::preludeSource() 之後，只多了 16 / 32 位元的讀取巨集) ---
+
+const char kFontPrelude[] =
+    "#ifndef OLED_READ_WORD\n"
+    "#define OLED_READ_WORD(p) (*(const uint16_t *)(p)) /* AVR PROGMEM: pgm_read_word(p) */\n"
+    "#endif\n"
+    "#ifndef OLED_READ_DWORD\n"
+    "#define OLED_READ_DWORD(p) (*(const uint32_t *)(p)) /* AVR PROGMEM: pgm_read_dword(p) */\n"
+    "#endif\n"
+    "#ifndef OLED_GLYPH_DEFINED\n"
+    "#define OLED_GLYPH_DEFINED\n"
+    "/* bits: width * pages bytes, page-major (all columns of page 0 first), bit 0 = top row.\n"
+    "   Same byte layout as the display RAM: at a page-aligned y each byte is copied as is. */\n"
+    "typedef struct {\n"
+    "    const uint8_t *bits;\n"
+    "    uint8_t width;\n"
+    "    uint8_t advance;\n"
+    "} oled_glyph;\n"
+    "#endif\n";
+
+// 位置表與字元表用最窄的型別 (小的 ASCII 子集只要 uint8_t)，與 writeOffsetArray(..., 1) 相同
+int tableValueBytes(size_t largest)
+{
+    return OledCArrayWriter::offsetValueBytes(largest, 1);
+}
+
+QByteArray readMacro(size_t largest)
+{
+    switch (tableValueBytes(largest)) {
+    case 1:
+        return "OLED_READ_BYTE";
+    case 2:
+        return "OLED_READ_WORD";
+    default:
+        return "OLED_READ_DWORD";
+    }
+}
+
+// 依序打包 codepoints (都在字型中)，決定需要哪些表並算出大小
+void layout(const OledFont& font, const std::vector<uint>& codepoints, OledFontExporter::Result* result)
+{
+    const size_t pages = static_cast<size_t>(font.pageCount());
+    result->fontName = font.name();
+    result->height = font.height();
+    result->ascent = font.ascent();
+    result->pages = font.pageCount();
+    result->codepoints = codepoints;
+    result->bitmap.clear();
+    result->offsets.clear();
+    result->advances.clear();
+
+    std::vector<int> widths;
+    std::vector<int> advances;
+    for (const uint codepoint : codepoints) {
+        const OledFont::Glyph* glyph = font.glyph(codepoint);
+        const uint8_t* bits = font.glyphBits(*glyph);
+        result->offsets.push_back(result->bitmap.size());
+        result->bitmap.insert(result->bitmap.end(), bits, bits + size_t(glyph->width) * pages);
+        widths.push_back(glyph->width);
+        advances.push_back(glyph->advance);
+    }
+    result->offsets.push_back(result->bitmap.size());
+
+    const bool fixed = std::all_of(widths.begin(), widths.end(), [&widths](int width) { return width == widths.front(); });
+    const int spacing = advances.front() - widths.front();
+    bool uniform = spacing >= 0 && spacing <= 255;
+    for (size_t i = 0; uniform && i < widths.size(); ++i) {
+        uniform = advances[i] - widths[i] == spacing;
+    }
+
+    OledFontExporter::Report& report = result->report;
+    report.glyphs = static_cast<int>(codepoints.size());
+    report.bitmapBytes = static_cast<qint64>(result->bitmap.size());
+    report.tableBytes = 0;
+    if (fixed) {
+        result->fixedWidth = widths.front();
+        result->offsets.clear();
+    } else {
+        result->fixedWidth = 0;
+        report.tableBytes += qint64(result->offsets.size()) * tableValueBytes(result->offsets.back());
+    }
+    if (!result->isContiguous()) {
+        report.tableBytes += qint64(codepoints.size()) * tableValueBytes(codepoints.back());
+    }
+    if (uniform) {
+        result->spacing = spacing;
+    } else {
+        result->spacing = 0;
+        for (const int advance : advances) {
+            result->advances.push_back(static_cast<uint8_t>(std::clamp(advance, 0, 255)));
+        }
+        report.tableBytes += qint64(result->advances.size());
+    }
+}
+
+// 字型中 [first, last] 範圍內有的字元以相同格式存放的大小
+qint64 rangeBytes(const OledFont& font, const std::vector<uint>& all, uint first, uint last)
+{
+    std::vector<uint> codepoints;
+    std::copy_if(all.begin(), all.end(), std::back_inserter(codepoints),
+                 [first, last](uint codepoint) { return codepoint >= first && codepoint <= last; });
+    if (codepoints.empty()) {
+        return 0;
+    }
+    OledFontExporter::Result result;
+    layout(font, codepoints, &result);
+    return result.report.flashBytes();
+}
+
+// 註解中的字元：可見的 ASCII 原樣輸出，其他 (含 '\'，行尾的 '\' 會接續下一行) 寫成 U+XXXX
+QByteArray describeCharacters(const std::vector<uint>& codepoints)
+{
+    QByteArray text;
+    for (const uint codepoint : codepoints) {
+        if (codepoint > ' ' && codepoint < 127 && codepoint != '\\') {
+            text += char(codepoint);
+        } else {
+            text += " U+" + QByteArray::number(codepoint, 16).toUpper().rightJustified(4, '0') + ' ';
+        }
+    }
+    return text.simplified();
+}
+
+}
+
+bool OledFontExporter::Result::isContiguous() const
+{
+    return !codepoints.empty() && codepoints.back() - codepoints.front() + 1 == codepoints.size();
+}
+
+QString OledFontExporter::usedCharacters(const QStringList& texts)
+{
+    std::vector<uint> codepoints;
+    for (const QString& text : texts) {
+        for (const uint codepoint : text.toUcs4()) {
+            if (codepoint != '\n' && codepoint != '\r') {
+                codepoints.push_back(codepoint);
+            }
+        }
+    }
+    std::sort(codepoints.begin(), codepoints.end());
+    codepoints.erase(std::unique(codepoints.begin(), codepoints.end()), codepoints.end());
+    return QString::fromUcs4(codepoints.data(), static_cast<int>(codepoints.size()));
+}
+
+bool OledFontExporter::pack(const OledFont& font, const QString& characters, Result* result)
+{
+    if (!font.isValid()) {
+        return false;
+    }
+    const std::vector<uint> all = font.codepoints();
+
+    std::vector<uint> codepoints;
+    std::vector<uint> missing;
+    if (characters.isEmpty()) {
+        codepoints = all;
+    } else {
+        for (const uint codepoint : characters.toUcs4()) {
+            if (codepoint == '\n' || codepoint == '\r') {
+                continue;
+            }
+            if (font.contains(codepoint)) {
+                codepoints.push_back(codepoint);
+            } else {
+                missing.push_back(codepoint);
+                if (font.contains('?')) codepoints.push_back('?');
+            }
+        }
+        std::sort(codepoints.begin(), codepoints.end());
+        codepoints.erase(std::unique(codepoints.begin(), codepoints.end()), codepoints.end());
+        std::sort(missing.begin(), missing.end());
+        missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+    }
+    if (codepoints.empty()) {
+        return false;
+    }
+
+    Result packed;
+    layout(font, codepoints, &packed);
+    packed.report.missing = QString::fromUcs4(missing.data(), static_cast<int>(missing.size()));
+    packed.report.asciiBytes = rangeBytes(font, all, 32, 126);
+    packed.report.fullBytes = codepoints == all ? packed.report.flashBytes()
+                                                : rangeBytes(font, all, 0, 0xFFFFFFFFu);
+    *result = std::move(packed);
+    return true;
+}
+
+QByteArray OledFontExporter::preludeSource()
+{
+    return OledCArrayWriter::preludeSource() + kFontPrelude;
+}
+
+void OledFontExporter::writeArrays(OledCArrayWriter* writer, const QByteArray& name, const Result& result)
+{
+    const Report& report = result.report;
+    const QByteArray upper = name.toUpper();
+    const QByteArray count = QByteArray::number(qulonglong(result.codepoints.size()));
+    const bool contiguous = result.isContiguous();
+    const bool fixed = result.offsets.empty();
+    const bool uniform = result.advances.empty();
+
+    writer->writeText(preludeSource());
+    writer->writeText("\n");
+    writer->writeComment(name + ": font \"" + result.fontName.toUtf8() + "\", " + count + " glyphs, "
+                         + QByteArray::number(result.height) + " rows (" + QByteArray::number(result.pages)
+                         + " pages), flash " + QByteArray::number(report.flashBytes()) + " bytes (bitmap "
+                         + QByteArray::number(report.bitmapBytes) + " + tables "
+                         + QByteArray::number(report.tableBytes) + ")");
+    writer->writeComment("full ASCII table: " + QByteArray::number(report.asciiBytes) + " bytes, whole font: "
+                         + QByteArray::number(report.fullBytes) + " bytes");
+    writer->writeComment("characters: " + describeCharacters(result.codepoints));
+    if (!report.missing.isEmpty()) {
+        const auto missing = report.missing.toUcs4();
+        writer->writeComment("not in the font (drawn as '?'): "
+                             + describeCharacters(std::vector<uint>(missing.begin(), missing.end())));
+    }
+
+    writer->writeText("#define " + upper + "_HEIGHT " + QByteArray::number(result.height) + "\n");
+    writer->writeText("#define " + upper + "_ASCENT " + QByteArray::number(result.ascent) + "\n");
+    writer->writeText("#define " + upper + "_PAGES " + QByteArray::number(result.pages) + "\n");
+    writer->writeText("#define " + upper + "_GLYPH_COUNT " + count + "\n");
+    if (contiguous) {
+        writer->writeText("#define " + upper + "_FIRST_CHAR " + QByteArray::number(result.codepoints.front()) + "\n");
+    }
+    if (fixed) {
+        writer->writeText("#define " + upper + "_WIDTH " + QByteArray::number(result.fixedWidth) + "\n");
+    }
+    if (uniform) {
+        writer->writeText("#define " + upper + "_SPACING " + QByteArray::number(result.spacing) + "\n");
+    }
+
+    // 全部都是寬度 0 的字元 (例如只有空白) 時仍輸出一個 byte，空的陣列不是合法的 C
+    if (result.bitmap.empty()) {
+        const uint8_t zero = 0;
+        writer->writeArray(name, &zero, 1);
+    } else {
+        writer->writeArray(name, result.bitmap.data(), result.bitmap.size());
+    }
+    if (!fixed) {
+        writer->writeOffsetArray(name + "_offsets", result.offsets, 1);
+    }
+    if (!contiguous) {
+        writer->writeOffsetArray(name + "_codepoints",
+                                 std::vector<size_t>(result.codepoints.begin(), result.codepoints.end()), 1);
+    }
+    if (!uniform) {
+        writer->writeArray(name + "_advances", result.advances.data(), result.advances.size());
+    }
+
+    // 查找函式：連續的字元直接相減，否則在 name_codepoints[] 中二分搜尋
+    const QByteArray index = result.codepoints.size() > 0xFFFF ? "uint32_t" : "uint16_t";
+    QByteArray source;
+    source += "\n/* " + name + "_glyph: look up character c (Unicode); returns 0 when it is not in the font */\n";
+    source += "static inline uint8_t " + name + "_glyph(uint32_t c, oled_glyph *glyph)\n{\n";
+    if (contiguous) {
+        source += "    " + index + " i;\n";
+        source += "    if ((uint32_t)(c - " + upper + "_FIRST_CHAR) >= " + upper + "_GLYPH_COUNT) return 0;\n";
+        source += "    i = (" + index + ")(c - " + upper + "_FIRST_CHAR);\n";
+    } else {
+        const QByteArray read = readMacro(result.codepoints.back());
+        source += "    " + index + " i, lo = 0, hi = " + upper + "_GLYPH_COUNT;\n";
+        source += "    while (lo < hi) {\n";
+        source += "        " + index + " mid = (" + index + ")((lo + hi) / 2);\n";
+        source += "        if ((uint32_t)" + read + "(&" + name + "_codepoints[mid]) < c) lo = (" + index
+                  + ")(mid + 1); else hi = mid;\n";
+        source += "    }\n";
+        source += "    if (lo == " + upper + "_GLYPH_COUNT || (uint32_t)" + read + "(&" + name
+                  + "_codepoints[lo]) != c) return 0;\n";
+        source += "    i = lo;\n";
+    }
+    if (fixed) {
+        source += "    glyph->bits = " + name + " + (size_t)i * (" + upper + "_WIDTH * " + upper + "_PAGES);\n";
+        source += "    glyph->width = " + upper + "_WIDTH;\n";
+    } else {
+        const QByteArray read = readMacro(result.offsets.back());
+        source += "    {\n";
+        source += "        uint32_t start = " + read + "(&" + name + "_offsets[i]);\n";
+        source += "        glyph->bits = " + name + " + start;\n";
+        source += "        glyph->width = (uint8_t)((" + read + "(&" + name + "_offsets[i + 1]) - start) / " + upper
+                  + "_PAGES);\n";
+        source += "    }\n";
+    }
+    if (uniform) {
+        source += "    glyph->advance = (uint8_t)(glyph->width + " + upper + "_SPACING);\n";
+    } else {
+        source += "    glyph->advance = OLED_READ_BYTE(&" + name + "_advances[i]);\n";
+    }
+    source += "    return 1;\n}\n";
+    writer->writeText(source);
+}
@@ -0,0 +1,78 @@
+#ifndef OLED_FONTEXPORT_H
+#define OLED_FONTEXPORT_H
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class OledCArrayWriter;
+class OledFont;
+
+/**
+ * @brief 把點陣字型匯出成韌體用的 C 字型 (oledcore，只用到 QtCore)。
+ *
+ * 只保留文字中用到的字元 (子集)，中日韓的標籤不必把整個字型放進 flash。
+ * 每個字元的點陣就是 OledFont 的 atlas：寬 x 頁數 bytes、頁優先、bit0 在最上方，
+ * 與 convertLogicalToHardwareFormat() 產生的畫面緩衝區是同一種 byte 排列，
+ * y 在頁邊界時韌體可以整個 byte 複製到畫面緩衝區。
+ *
+ * 輸出的格式與 OledFont::fromCArray() 相同 (可以再讀回編輯器)，只輸出需要的表：
+ * - 字寬都一樣時只有 NAME_WIDTH，否則 name_offsets[] (字元數 + 1 個位置，寬度由相鄰位置相減)。
+ * - 字元連續時只有 NAME_FIRST_CHAR，否則 name_codepoints[] (由小到大，韌體以二分搜尋查找)。
+ * - 前進的欄數都是字寬 + 固定字距時只有 NAME_SPACING，否則 name_advances[]。
+ * 最後附上 C 的查找函式 name_glyph()。
+ */
+class OledFontExporter
+{
+public:
+    struct Report {
+        int glyphs = 0;
+        qint64 bitmapBytes = 0;
+        qint64 tableBytes = 0;          // 位置表、字元表與前進欄數表
+        qint64 asciiBytes = 0;          // 同一個字型的完整 ASCII (32..126，字型中有的) 以相同格式存放
+        qint64 fullBytes = 0;           // 整個字型以相同格式存放
+        QString missing;                // 文字中用到但字型沒有的字元 (以 '?' 代替)
+
+        qint64 flashBytes() const { return bitmapBytes + tableBytes; }  // 不含查找函式
+    };
+
+    struct Result {
+        Report report;
+        QString fontName;
+        int height = 0;
+        int ascent = 0;
+        int pages = 0;
+        std::vector<uint> codepoints;   // 由小到大
+        std::vector<uint8_t> bitmap;
+        std::vector<size_t> offsets;    // 字元數 + 1；固定寬度時為空
+        std::vector<uint8_t> advances;  // 字距固定時為空
+        int fixedWidth = 0;             // 固定寬度 (offsets 為空時)
+        int spacing = 0;                // 固定字距 (advances 為空時)
+
+        bool isContiguous() const;      // 字元連續 (不需要 name_codepoints[])
+    };
+
+    /// 文字中用到的字元，由小到大、不重複 (不含換行)
+    static QString usedCharacters(const QStringList& texts);
+
+    /**
+     * @brief 把 font 中 characters 用到的字元打包。
+     *
+     * 字型沒有的字元以 '?' 代替 (記在 Report::missing)；characters 是空的時打包整個字型。
+     * @return 沒有任何字元可以打包時回傳 false。
+     */
+    static bool pack(const OledFont& font, const QString& characters, Result* result);
+
+    /// 查找函式 name_glyph() 共用的部分：讀取巨集 (AVR PROGMEM 可以改成 pgm_read_*) 與 oled_glyph
+    static QByteArray preludeSource();
+
+    /// 輸出巨集、陣列與查找函式 name_glyph()
+    static void writeArrays(OledCArrayWriter* writer, const QByteArray& name, const Result& result);
+};
+
+#endif // OLED_FONTEXPORT_H
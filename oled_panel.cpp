@@ -0,0 +1,267 @@
+#include "oled_panel.h"
+#include "oled_bitpack.h"
+#include "oled_config.h"
+
+#include <QImage>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+// 把一個頁面 byte 展開成 8 個調色盤索引 (每列一個 byte，第 k 個 byte 對應 bit k)
+// 例如 0b00000101 -> 0x0000000000010001
+constexpr std::array<uint64_t, 256> makePageExpandTable()
+{
+    std::array<uint64_t, 256> table{};
+    for (int value = 0; value < 256; ++value) {
+        uint64_t expanded = 0;
+        for (int bit = 0; bit < 8; ++bit) {
+            if (value & (1 << bit)) {
+                expanded |= uint64_t(1) << (bit * 8);
+            }
+        }
+        table[value] = expanded;
+    }
+    return table;
+}
+
+constexpr std::array<uint64_t, 256> kPageExpandTable = makePageExpandTable();
+
+// 編譯期固定的幾何：所有尺寸都是常數，kernel 的迴圈次數在編譯期就確定
+template <int Width, int Height, int RamPageWidth, int ColumnOffset>
+struct FixedGeometry
+{
+    explicit FixedGeometry(const OledPanelGeometry&) {}
+    static constexpr int width() { return Width; }
+    static constexpr int height() { return Height; }
+    static constexpr int ramPageWidth() { return RamPageWidth; }
+    static constexpr int columnOffset() { return ColumnOffset; }
+    static constexpr int pageCount() { return (Height + 7) / 8; }
+};
+
+// 執行期的幾何：任何有效尺寸都能用
+struct DynamicGeometry
+{
+    explicit DynamicGeometry(const OledPanelGeometry& geometry) : m_geometry(geometry) {}
+    int width() const { return m_geometry.width; }
+    int height() const { return m_geometry.height; }
+    int ramPageWidth() const { return m_geometry.ramPageWidth; }
+    int columnOffset() const { return m_geometry.columnOffset; }
+    int pageCount() const { return m_geometry.pageCount(); }
+
+    const OledPanelGeometry& m_geometry;
+};
+
+template <typename G>
+void loadFrame(const OledPanelGeometry& panel, uint8_t* buffer, const uint8_t* data)
+{
+    const G g(panel);
+    std::memcpy(buffer, data, size_t(g.ramPageWidth()) * g.pageCount());
+
+    // 清除每一頁中不可見的填充欄位
+    const int rightPad = g.ramPageWidth() - g.columnOffset() - g.width();
+    for (int page = 0; page < g.pageCount(); ++page) {
+        uint8_t* row = buffer + page * g.ramPageWidth();
+        if (g.columnOffset() > 0) {
+            std::memset(row, 0, g.columnOffset());
+        }
+        if (rightPad > 0) {
+            std::memset(row + g.columnOffset() + g.width(), 0, rightPad);
+        }
+    }
+
+    // 高度不是 8 的倍數時，最後一頁超出畫布的位元也要清掉
+    const int tailRows = g.height() & 7;
+    if (tailRows != 0) {
+        const uint8_t keep = static_cast<uint8_t>((1u << tailRows) - 1);
+        uint8_t* row = buffer + (g.pageCount() - 1) * g.ramPageWidth() + g.columnOffset();
+        for (int x = 0; x < g.width(); ++x) {
+            row[x] &= keep;
+        }
+    }
+}
+
+template <typename G>
+void renderIndexed(const OledPanelGeometry& panel, const uint8_t* buffer, QImage* image, const QRect& area)
+{
+    const G g(panel);
+    const bool fullWidth = area.left() == 0 && area.right() == g.width() - 1;
+
+    for (int page = area.top() / 8; page <= area.bottom() / 8; ++page) {
+        // 這一頁中落在 area 內的列範圍
+        const int rowBegin = std::max(area.top(), page * 8);
+        const int rowEnd = std::min(area.bottom(), page * 8 + 7);
+
+        uchar* lines[8];
+        for (int y = rowBegin; y <= rowEnd; ++y) {
+            lines[y - rowBegin] = image->scanLine(y);
+        }
+
+        const uint8_t* pageBytes = buffer + page * g.ramPageWidth() + g.columnOffset();
+
+        if (fullWidth && rowEnd - rowBegin == 7) {
+            // 整頁整列 (全畫面重繪)：迴圈次數是 width()，8 條掃描線全部展開
+            for (int x = 0; x < g.width(); ++x) {
+                const uint64_t expanded = kPageExpandTable[pageBytes[x]];
+                lines[0][x] = static_cast<uchar>(expanded);
+                lines[1][x] = static_cast<uchar>(expanded >> 8);
+                lines[2][x] = static_cast<uchar>(expanded >> 16);
+                lines[3][x] = static_cast<uchar>(expanded >> 24);
+                lines[4][x] = static_cast<uchar>(expanded >> 32);
+                lines[5][x] = static_cast<uchar>(expanded >> 40);
+                lines[6][x] = static_cast<uchar>(expanded >> 48);
+                lines[7][x] = static_cast<uchar>(expanded >> 56);
+            }
+            continue;
+        }
+
+        const int shiftBase = (rowBegin & 7) * 8;
+        for (int x = area.left(); x <= area.right(); ++x) {
+            const uint64_t expanded = kPageExpandTable[pageBytes[x]] >> shiftBase;
+            for (int row = 0; row <= rowEnd - rowBegin; ++row) {
+                lines[row][x] = static_cast<uchar>(expanded >> (row * 8));
+            }
+        }
+    }
+}
+
+template <typename G>
+void copyToMono(const OledPanelGeometry& panel, const uint8_t* buffer, const QRect& area, QImage* mono)
+{
+    const G g(panel);
+    const uint8_t* origin = buffer + (area.top() / 8) * g.ramPageWidth() + g.columnOffset() + area.left();
+
+    if ((area.top() & 7) == 0) {
+        // 對齊頁面：直接以 8x8 區塊轉置
+        OledBitPacker::pagesToRows(origin, g.ramPageWidth(), area.width(), area.height(),
+                                   OledBitPacker::MsbFirst, mono->bits(), static_cast<int>(mono->bytesPerLine()));
+        return;
+    }
+
+    // 沒有對齊頁面：逐列取出同一個位元，每 8 個像素組成一個 byte (MSB first)
+    for (int y = 0; y < area.height(); ++y) {
+        const int sourceY = area.top() + y;
+        const uint8_t* source = buffer + (sourceY >> 3) * g.ramPageWidth() + g.columnOffset() + area.left();
+        const int bit = sourceY & 7;
+        uchar* line = mono->scanLine(y);
+        for (int x = 0; x < area.width(); x += 8) {
+            const int count = std::min(8, area.width() - x);
+            uint8_t packed = 0;
+            for (int i = 0; i < count; ++i) {
+                packed |= static_cast<uint8_t>(((source[x + i] >> bit) & 1) << (7 - i));
+            }
+            line[x >> 3] = packed;
+        }
+    }
+}
+
+template <typename G>
+constexpr OledPanelKernels makeKernels(const char* name)
+{
+    return OledPanelKernels{name, &loadFrame<G>, &renderIndexed<G>, &copyToMono<G>};
+}
+
+// 特化的幾何；新增面板時若尺寸與這些都不同，會自動使用通用版本
+using Sh1106Geometry = FixedGeometry<128, 64, 132, 2>;
+using Ssd1306Geometry = FixedGeometry<128, 64, 128, 0>;
+using Sh1107Geometry = FixedGeometry<128, 128, 128, 0>;
+using Wide256Geometry = FixedGeometry<256, 64, 256, 0>;
+
+const OledPanelKernels kSh1106Kernels = makeKernels<Sh1106Geometry>("128x64+2/132");
+const OledPanelKernels kSsd1306Kernels = makeKernels<Ssd1306Geometry>("128x64/128");
+const OledPanelKernels kSh1107Kernels = makeKernels<Sh1107Geometry>("128x128/128");
+const OledPanelKernels kWide256Kernels = makeKernels<Wide256Geometry>("256x64/256");
+const OledPanelKernels kGenericKernels = makeKernels<DynamicGeometry>("generic");
+
+template <typename G>
+constexpr OledPanelGeometry geometryOf()
+{
+    return OledPanelGeometry{G::width(), G::height(), G::ramPageWidth(), G::columnOffset()};
+}
+
+}
+
+const std::vector<OledPanelProfile>& OledPanel::profiles()
+{
+    // 第一個必須是預設面板，與 OledConfig 的常數一致
+    static const std::vector<OledPanelProfile> list = {
+        {"sh1106", "SH1106 128x64",
+         {OledConfig::DISPLAY_WIDTH, OledConfig::DISPLAY_HEIGHT, OledConfig::RAM_PAGE_WIDTH, OledConfig::COLUMN_OFFSET}},
+        {"ssd1306", "SSD1306 128x64", {128, 64, 128, 0}},
+        {"ssd1309", "SSD1309 128x64", {128, 64, 128, 0}},
+        {"sh1107", "SH1107 128x128", {128, 128, 128, 0}},
+        {"mono256x64", "256x64 (頁面格式)", {256, 64, 256, 0}},
+    };
+    return list;
+}
+
+const OledPanelProfile& OledPanel::defaultProfile()
+{
+    return profiles().front();
+}
+
+const OledPanelProfile* OledPanel::find(const QString& id)
+{
+    for (const OledPanelProfile& profile : profiles()) {
+        if (id.compare(QString::fromLatin1(profile.id), Qt::CaseInsensitive) == 0) {
+            return &profile;
+        }
+    }
+    return nullptr;
+}
+
+const OledPanelProfile* OledPanel::find(const OledPanelGeometry& geometry)
+{
+    for (const OledPanelProfile& profile : profiles()) {
+        if (profile.geometry == geometry) {
+            return &profile;
+        }
+    }
+    return nullptr;
+}
+
+const OledPanelProfile* OledPanel::matchBufferSize(int bytes, bool* includesPadding)
+{
+    for (const OledPanelProfile& profile : profiles()) {
+        if (profile.geometry.bufferSize() == bytes) {
+            if (includesPadding) *includesPadding = true;
+            return &profile;
+        }
+    }
+    for (const OledPanelProfile& profile : profiles()) {
+        if (profile.geometry.visibleBufferSize() == bytes) {
+            if (includesPadding) *includesPadding = false;
+            return &profile;
+        }
+    }
+    return nullptr;
+}
+
+bool OledPanel::repad(const OledPanelGeometry& from, const uint8_t* src, const OledPanelGeometry& to, uint8_t* dst)
+{
+    if (from.width != to.width || from.height != to.height) {
+        return false;
+    }
+    for (int page = 0; page < to.pageCount(); ++page) {
+        uint8_t* row = dst + page * to.ramPageWidth;
+        std::memset(row, 0, static_cast<size_t>(to.ramPageWidth));
+        std::memcpy(row + to.columnOffset, src + page * from.ramPageWidth + from.columnOffset,
+                    static_cast<size_t>(to.width));
+    }
+    return true;
+}
+
+const OledPanelKernels& OledPanel::kernelsFor(const OledPanelGeometry& geometry)
+{
+    if (geometry == geometryOf<Sh1106Geometry>()) return kSh1106Kernels;
+    if (geometry == geometryOf<Ssd1306Geometry>()) return kSsd1306Kernels;
+    if (geometry == geometryOf<Sh1107Geometry>()) return kSh1107Kernels;
+    if (geometry == geometryOf<Wide256Geometry>()) return kWide256Kernels;
+    return kGenericKernels;
+}
+
+const OledPanelKernels& OledPanel::genericKernels()
+{
+    return kGenericKernels;
+}
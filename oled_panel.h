@@ -0,0 +1,125 @@
+#ifndef OLED_PANEL_H
+#define OLED_PANEL_H
+
+#pragma once
+
+#include <QRect>
+#include <QString>
+#include <cstdint>
+#include <vector>
+
+class QImage;
+
+/**
+ * @brief 面板的頁面格式幾何資訊 (oledcore，不依賴 Qt Widgets)。
+ *
+ * 所有支援的驅動晶片都使用相同的頁面格式：每頁 8 列，一個 byte 代表同一欄的 8 個垂直像素
+ * (bit0 在最上方)。不同晶片只差在可視尺寸、RAM 頁寬與可視區域的起始欄位。
+ */
+struct OledPanelGeometry
+{
+    int width = 0;          // 可視寬度 (像素)
+    int height = 0;         // 可視高度 (像素)
+    int ramPageWidth = 0;   // RAM 每頁的 byte 數 (SH1106 為 132)
+    int columnOffset = 0;   // 可視區域在 RAM 中的起始欄位 (SH1106 為 2)
+
+    constexpr int pageCount() const { return (height + 7) / 8; }
+    constexpr int bufferSize() const { return ramPageWidth * pageCount(); }
+    constexpr int visibleBufferSize() const { return width * pageCount(); }   // 不含填充欄位
+
+    // 操作記錄以 32 位元記錄已保存的頁面，所以最多 32 頁 (256 列)
+    constexpr bool isValid() const
+    {
+        return width > 0 && height > 0 && height <= 256 && columnOffset >= 0
+               && ramPageWidth >= columnOffset + width;
+    }
+
+    constexpr bool operator==(const OledPanelGeometry& other) const
+    {
+        return width == other.width && height == other.height
+               && ramPageWidth == other.ramPageWidth && columnOffset == other.columnOffset;
+    }
+    constexpr bool operator!=(const OledPanelGeometry& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief 一款面板的設定檔：識別字 (給命令列與設定檔使用)、顯示名稱與幾何資訊。
+ */
+struct OledPanelProfile
+{
+    const char* id;
+    const char* name;
+    OledPanelGeometry geometry;
+};
+
+/**
+ * @brief 依面板幾何挑選的整頁運算 (kernel)。
+ *
+ * 常見的幾何 (見 OledPanel::profiles()) 各有一份以模板在編譯期展開的版本，
+ * 寬度、頁寬與偏移都是常數，迴圈次數固定，編譯器可以展開或向量化；
+ * 其他尺寸使用讀取執行期參數的通用版本。兩者的輸出完全相同。
+ */
+struct OledPanelKernels
+{
+    const char* name;       // 例如 "128x64+2/132"，通用版本為 "generic"
+
+    // 把外部的整張頁面資料 (bufferSize() bytes) 載入 buffer，並把不可見的填充欄位清為 0
+    void (*loadFrame)(const OledPanelGeometry& geometry, uint8_t* buffer, const uint8_t* data);
+
+    // 把 area (已裁切到畫布內) 展開成 Format_Indexed8 的調色盤索引 (0 = 熄滅，1 = 點亮)
+    void (*renderIndexed)(const OledPanelGeometry& geometry, const uint8_t* buffer, QImage* image,
+                          const QRect& area);
+
+    // 把 area (已裁切到畫布內) 複製成與 area 同尺寸的 Format_Mono 圖 (索引 1 = 點亮)
+    void (*copyToMono)(const OledPanelGeometry& geometry, const uint8_t* buffer, const QRect& area,
+                       QImage* mono);
+};
+
+/**
+ * @brief 面板設定檔列表與 kernel 選擇。所有的函式都是無狀態的 (stateless)。
+ */
+class OledPanel
+{
+public:
+    /**
+     * @brief 內建的面板設定檔 (SH1106、SSD1306、SSD1309、SH1107 128x128、256x64)。
+     *
+     * 第一個是預設面板 (SH1106)，與 OledConfig 的常數相同。
+     */
+    static const std::vector<OledPanelProfile>& profiles();
+
+    /// 預設面板 (SH1106 128x64)。
+    static const OledPanelProfile& defaultProfile();
+
+    /// 依識別字 (不分大小寫) 尋找設定檔，找不到時回傳 nullptr。
+    static const OledPanelProfile* find(const QString& id);
+
+    /// 依幾何尋找設定檔，找不到時回傳 nullptr。
+    static const OledPanelProfile* find(const OledPanelGeometry& geometry);
+
+    /**
+     * @brief 依資料長度猜測面板：先比對含填充欄位的 bufferSize()，再比對 visibleBufferSize()。
+     *
+     * 多款面板尺寸相同時回傳列表中較前面的那一款。
+     *
+     * @param[out] includesPadding 若不為 nullptr，寫入長度是否包含填充欄位。
+     * @return 找不到時回傳 nullptr。
+     */
+    static const OledPanelProfile* matchBufferSize(int bytes, bool* includesPadding = nullptr);
+
+    /**
+     * @brief 把 from 的畫面 (bufferSize() bytes) 搬到可視尺寸相同、填充欄位不同的 to (例如 SH1106 -> SSD1306)。
+     *
+     * 只複製可視欄位，to 的填充欄位為 0。
+     * @return 可視尺寸不同時不做任何事並回傳 false；dst 必須有 to.bufferSize() bytes。
+     */
+    static bool repad(const OledPanelGeometry& from, const uint8_t* src, const OledPanelGeometry& to, uint8_t* dst);
+
+    /// 取得 geometry 對應的 kernel：內建幾何回傳特化版本，其他尺寸回傳通用版本。
+    static const OledPanelKernels& kernelsFor(const OledPanelGeometry& geometry);
+
+    /// 通用版本的 kernel (適用任何有效幾何，主要給效能比較使用)。
+    static const OledPanelKernels& genericKernels();
+};
+
+#endif // OLED_PANEL_H
@@ -0,0 +1,191 @@
+#include "oled_patch.h"
+#include "oled_carray.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr uint8_t kEndOfTransition = 0xFF;
+constexpr int kMaxPatchLength = 256;        // 長度以 length - 1 存在 1 個 byte
+
+// --- 輸出到韌體的 C 函式 (開頭見 OledCArrayWriter::preludeSource()) ---
+
+const char kPatchFunctions[] =
+    "#ifndef OLED_PATCH_APPLY_DEFINED\n"
+    "#define OLED_PATCH_APPLY_DEFINED\n"
+    "/* records: page, column, length - 1, data[length]; 0xFF ends one transition.\n"
+    "   column is the controller RAM column (column offset included). Both return the next transition. */\n"
+    "static const uint8_t *oled_patch_apply(const uint8_t *p, uint8_t *buffer, size_t page_width)\n"
+    "{\n"
+    "    uint8_t page;\n"
+    "    while ((page = OLED_READ_BYTE(p++)) != 0xFF) {\n"
+    "        uint8_t *dst = buffer + (size_t)page * page_width + OLED_READ_BYTE(p++);\n"
+    "        uint16_t count = (uint16_t)(OLED_READ_BYTE(p++) + 1);\n"
+    "        while (count--) *dst++ = OLED_READ_BYTE(p++);\n"
+    "    }\n"
+    "    return p;\n"
+    "}\n"
+    "\n"
+    "/* send() sets the page (0xB0 + page) and column address, then writes length bytes of data\n"
+    "   (data points into the table: read it with OLED_READ_BYTE) */\n"
+    "typedef void (*oled_patch_send_fn)(uint8_t page, uint8_t column, const uint8_t *data, uint16_t length);\n"
+    "static const uint8_t *oled_patch_send(const uint8_t *p, oled_patch_send_fn send)\n"
+    "{\n"
+    "    uint8_t page;\n"
+    "    while ((page = OLED_READ_BYTE(p++)) != 0xFF) {\n"
+    "        uint8_t column = OLED_READ_BYTE(p++);\n"
+    "        uint16_t length = (uint16_t)(OLED_READ_BYTE(p++) + 1);\n"
+    "        send(page, column, p, length);\n"
+    "        p += length;\n"
+    "    }\n"
+    "    return p;\n"
+    "}\n"
+    "#endif\n";
+
+void accumulate(OledBusEstimator::Cost* total, const OledBusEstimator::Cost& cost)
+{
+    total->commandBytes += cost.commandBytes;
+    total->dataBytes += cost.dataBytes;
+    total->overheadBytes += cost.overheadBytes;
+    total->transactions += cost.transactions;
+    total->clocks += cost.clocks;
+    total->seconds += cost.seconds;
+}
+
+}
+
+bool OledPatchEncoder::supports(const OledPanelGeometry& geometry)
+{
+    return geometry.isValid() && geometry.ramPageWidth <= 256;
+}
+
+OledPatchEncoder::Transition OledPatchEncoder::diff(const OledPanelGeometry& geometry, const uint8_t* before,
+                                                    const uint8_t* after, const OledBusEstimator::Bus& bus)
+{
+    Transition transition;
+    const std::vector<OledBusEstimator::Window> windows = OledBusEstimator::diff(geometry, before, after, bus);
+    std::vector<OledBusEstimator::Window> emitted;   // 切成長度上限以內、實際送出的窗口
+    emitted.reserve(windows.size());
+
+    for (const OledBusEstimator::Window& window : windows) {
+        const uint8_t* row = after + window.page * geometry.ramPageWidth;
+        for (int column = window.firstColumn; column <= window.lastColumn; column += kMaxPatchLength) {
+            const int end = std::min(window.lastColumn + 1, column + kMaxPatchLength);
+            Patch patch;
+            patch.page = window.page;
+            patch.column = column;
+            patch.bytes.assign(row + column, row + end);
+            transition.patches.push_back(std::move(patch));
+
+            OledBusEstimator::Window piece;
+            piece.page = window.page;
+            piece.firstColumn = column;
+            piece.lastColumn = end - 1;
+            emitted.push_back(piece);
+        }
+    }
+
+    // 成本以切開後的 patch 計算：每一段都各自重新定位欄位
+    transition.cost = OledBusEstimator::cost(emitted, bus);
+    transition.fullCost = OledBusEstimator::cost(OledBusEstimator::fullFrame(geometry), bus);
+    return transition;
+}
+
+std::vector<OledPatchEncoder::Transition> OledPatchEncoder::encodeSequence(
+    const OledPanelGeometry& geometry, const std::vector<std::vector<uint8_t>>& frames,
+    const OledBusEstimator::Bus& bus, bool loop)
+{
+    std::vector<Transition> transitions;
+    if (!supports(geometry) || frames.empty()) {
+        return transitions;
+    }
+
+    transitions.reserve(frames.size() + (loop ? 1 : 0));
+    const uint8_t* previous = nullptr;
+    for (const std::vector<uint8_t>& frame : frames) {
+        transitions.push_back(diff(geometry, previous, frame.data(), bus));
+        previous = frame.data();
+    }
+    if (loop && frames.size() > 1) {
+        transitions.push_back(diff(geometry, previous, frames.front().data(), bus));
+    }
+    return transitions;
+}
+
+void OledPatchEncoder::serialize(const Transition& transition, std::vector<uint8_t>* out)
+{
+    for (const Patch& patch : transition.patches) {
+        out->push_back(static_cast<uint8_t>(patch.page));
+        out->push_back(static_cast<uint8_t>(patch.column));
+        out->push_back(static_cast<uint8_t>(patch.bytes.size() - 1));
+        out->insert(out->end(), patch.bytes.begin(), patch.bytes.end());
+    }
+    out->push_back(kEndOfTransition);
+}
+
+bool OledPatchEncoder::apply(const uint8_t* stream, size_t size, size_t* offset, uint8_t* buffer,
+                             const OledPanelGeometry& geometry)
+{
+    size_t pos = *offset;
+    while (pos < size) {
+        const uint8_t page = stream[pos++];
+        if (page == kEndOfTransition) {
+            *offset = pos;
+            return true;
+        }
+        if (size - pos < 2) {
+            return false;
+        }
+        const int column = stream[pos];
+        const size_t length = size_t(stream[pos + 1]) + 1;
+        pos += 2;
+        if (page >= geometry.pageCount() || column + length > size_t(geometry.ramPageWidth) || size - pos < length) {
+            return false;
+        }
+        std::copy(stream + pos, stream + pos + length, buffer + page * geometry.ramPageWidth + column);
+        pos += length;
+    }
+    return false;
+}
+
+QByteArray OledPatchEncoder::applySource()
+{
+    return OledCArrayWriter::preludeSource() + kPatchFunctions;
+}
+
+void OledPatchEncoder::writeArrays(OledCArrayWriter* writer, const QByteArray& name,
+                                   const std::vector<Transition>& transitions, const OledPanelGeometry& geometry)
+{
+    std::vector<uint8_t> stream;
+    std::vector<size_t> offsets;
+    offsets.reserve(transitions.size());
+    qint64 patchCount = 0;
+    OledBusEstimator::Cost total;
+    OledBusEstimator::Cost fullTotal;
+    for (const Transition& transition : transitions) {
+        offsets.push_back(stream.size());
+        serialize(transition, &stream);
+        patchCount += qint64(transition.patches.size());
+        accumulate(&total, transition.cost);
+        accumulate(&fullTotal, transition.fullCost);
+    }
+
+    const QByteArray upper = name.toUpper();
+    const QByteArray framesName = name + "_frames";
+    writer->writeText(applySource());
+    writer->writeText("\n");
+    writer->writeComment(name + ": " + QByteArray::number(qulonglong(transitions.size())) + " transitions, "
+                         + QByteArray::number(patchCount) + " patches, " + QByteArray::number(qulonglong(stream.size()))
+                         + " bytes (" + QByteArray::number(geometry.width) + "x" + QByteArray::number(geometry.height)
+                         + ", page width " + QByteArray::number(geometry.ramPageWidth) + ")");
+    writer->writeComment("bus bytes: " + QByteArray::number(total.busBytes()) + " partial / "
+                         + QByteArray::number(fullTotal.busBytes()) + " full redraw");
+    writer->writeComment("step n (buffer holds frame n - 1; step 0 draws the whole first frame):");
+    writer->writeComment("    oled_patch_apply(" + name + " + " + framesName + "[n], buffer, " + upper + "_PAGE_WIDTH);");
+    writer->writeText("#define " + upper + "_FRAME_COUNT " + QByteArray::number(qulonglong(transitions.size())) + "\n");
+    writer->writeText("#define " + upper + "_PAGE_WIDTH " + QByteArray::number(geometry.ramPageWidth) + "\n");
+    writer->writeArray(name, stream.data(), stream.size());
+
+    // 每次切換的起始位置 (隨機跳到某個影格時用；依序播放只要沿用 oled_patch_apply() 回傳的指標)
+    writer->writeOffsetArray(framesName, offsets);
+}
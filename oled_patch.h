@@ -0,0 +1,84 @@
+#ifndef OLED_PATCH_H
+#define OLED_PATCH_H
+
+#pragma once
+
+#include "oled_busestimator.h"
+
+#include <QByteArray>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class OledCArrayWriter;
+
+/**
+ * @brief 連續畫面之間的最小差異更新 (patch) 編碼 (oledcore，不依賴 Qt Widgets)。
+ *
+ * 輸入一串畫面 (操作歷史的每個狀態、動畫影格...)，每次切換只輸出改變的 (頁, 起始欄位, bytes)；
+ * 同一頁中相鄰的改變由 OledBusEstimator::diff() 依匯流排成本合併 (重送中間沒變的 byte 比另開一段便宜時)。
+ * 電池供電的裝置不必每個畫面都重送沒變的頁。
+ *
+ * 匯出的資料流 (每次切換一段，依序排列)：
+ * @code
+ *   page, column, length - 1, data[length]   (重複，column 為 RAM 欄位，已含 columnOffset)
+ *   0xFF                                     (這次切換結束)
+ * @endcode
+ * 搭配 applySource() 的 C 函式：oled_patch_apply() 套用到 RAM 的畫面緩衝區，
+ * oled_patch_send() 對每一段呼叫傳送函式 (送出 B0+page、欄位位址，再送 data)。
+ */
+class OledPatchEncoder
+{
+public:
+    struct Patch {
+        int page = 0;
+        int column = 0;                 // RAM 欄位 (含 columnOffset)
+        std::vector<uint8_t> bytes;     // 1..256 個 byte
+    };
+
+    struct Transition {
+        std::vector<Patch> patches;
+        OledBusEstimator::Cost cost;    // 送出這些 patch 的成本
+        OledBusEstimator::Cost fullCost;// 整個畫面重送的成本 (比較用)
+    };
+
+    /// 欄位要能放進 1 個 byte (ramPageWidth <= 256)
+    static bool supports(const OledPanelGeometry& geometry);
+
+    /// 兩個畫面 (bufferSize() bytes) 之間的 patch；before 為 nullptr 時為整個畫面
+    static Transition diff(const OledPanelGeometry& geometry, const uint8_t* before, const uint8_t* after,
+                           const OledBusEstimator::Bus& bus);
+
+    /**
+     * @brief 整串畫面的 patch：第一個畫面完整送出 (裝置上的內容未知)，之後每個畫面只送和前一個的差異。
+     *
+     * @param loop 加上最後一個畫面回到第一個畫面的切換 (循環播放的動畫)。
+     */
+    static std::vector<Transition> encodeSequence(const OledPanelGeometry& geometry,
+                                                  const std::vector<std::vector<uint8_t>>& frames,
+                                                  const OledBusEstimator::Bus& bus, bool loop = false);
+
+    /// 一次切換的資料流 (含結尾的 0xFF)，附加到 out 的尾端
+    static void serialize(const Transition& transition, std::vector<uint8_t>* out);
+
+    /**
+     * @brief 主機端的參考實作 (與 oled_patch_apply() 相同)：從 stream[*offset] 套用一次切換到 buffer。
+     *
+     * @return 資料流不完整或超出 buffer 時回傳 false。成功時 *offset 移到下一次切換的開頭。
+     */
+    static bool apply(const uint8_t* stream, size_t size, size_t* offset, uint8_t* buffer,
+                      const OledPanelGeometry& geometry);
+
+    /// C 的 oled_patch_apply() / oled_patch_send()，以 #ifndef 保護，讀取資料經過 OLED_READ_BYTE(p)
+    static QByteArray applySource();
+
+    /**
+     * @brief 輸出整串 patch：套用函式、說明註解、名稱_FRAME_COUNT / 名稱_PAGE_WIDTH 巨集、資料流與每次切換的起始位置表。
+     *
+     * 起始位置表為 名稱_frames[] (OledCArrayWriter::writeOffsetArray())。
+     */
+    static void writeArrays(OledCArrayWriter* writer, const QByteArray& name, const std::vector<Transition>& transitions,
+                            const OledPanelGeometry& geometry);
+};
+
+#endif // OLED_PATCH_H
@@ -0,0 +1,231 @@
+#include "oled_timeline.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// 頁面內容雜湊：一次處理 8 個 byte 的 FNV-1a 變形，相同雜湊時還會再比較內容
+quint64 hashPage(const uint8_t* data, size_t size)
+{
+    const quint64 prime = 0x100000001b3ULL;
+    quint64 hash = 0xcbf29ce484222325ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        quint64 word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ data[i]) * prime;
+    }
+    return hash;
+}
+
+}
+
+OledTimeline::OledTimeline(const OledPanelGeometry& geometry)
+{
+    reset(geometry);
+}
+
+void OledTimeline::reset(const OledPanelGeometry& geometry)
+{
+    m_geometry = geometry;
+    m_pageCount = geometry.isValid() ? geometry.pageCount() : 0;
+    clear();
+}
+
+bool OledTimeline::repad(const OledPanelGeometry& geometry)
+{
+    if (!geometry.isValid() || geometry.width != m_geometry.width || geometry.height != m_geometry.height) {
+        return false;
+    }
+
+    // 頁面池以內容雜湊去除重複，填充欄位改變後雜湊也不同，整個重新放入比逐頁修改簡單
+    const OledPanelGeometry previous = m_geometry;
+    const int frames = m_frameCount;
+    const size_t frameSize = static_cast<size_t>(geometry.bufferSize());
+    std::vector<uint8_t> source(static_cast<size_t>(previous.bufferSize()));
+    std::vector<uint8_t> padded(size_t(frames) * frameSize);
+    for (int i = 0; i < frames; ++i) {
+        copyFrame(i, source.data());
+        OledPanel::repad(previous, source.data(), geometry, padded.data() + size_t(i) * frameSize);
+    }
+
+    reset(geometry);
+    for (int i = 0; i < frames; ++i) {
+        appendFrame(padded.data() + size_t(i) * frameSize);
+    }
+    return true;
+}
+
+void OledTimeline::clear()
+{
+    m_frameCount = 0;
+    m_framePages.clear();
+    m_storage.clear();
+    m_refCounts.clear();
+    m_hashes.clear();
+    m_freePages.clear();
+    m_index.clear();
+    ++m_revision;
+}
+
+int OledTimeline::acquirePage(const uint8_t* bytes)
+{
+    const size_t width = static_cast<size_t>(m_geometry.ramPageWidth);
+    const quint64 hash = hashPage(bytes, width);
+    const auto range = m_index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (std::memcmp(pageData(it->second), bytes, width) == 0) {
+            ++m_refCounts[size_t(it->second)];
+            return it->second;
+        }
+    }
+
+    int id;
+    if (!m_freePages.empty()) {
+        id = m_freePages.back();
+        m_freePages.pop_back();
+    } else {
+        id = static_cast<int>(m_refCounts.size());
+        m_refCounts.push_back(0);
+        m_hashes.push_back(0);
+        m_storage.resize(m_storage.size() + width);
+    }
+    std::memcpy(m_storage.data() + size_t(id) * width, bytes, width);
+    m_refCounts[size_t(id)] = 1;
+    m_hashes[size_t(id)] = hash;
+    m_index.emplace(hash, id);
+    return id;
+}
+
+void OledTimeline::releasePage(int id)
+{
+    if (--m_refCounts[size_t(id)] > 0) {
+        return;
+    }
+    const auto range = m_index.equal_range(m_hashes[size_t(id)]);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == id) {
+            m_index.erase(it);
+            break;
+        }
+    }
+    m_freePages.push_back(id);
+}
+
+void OledTimeline::replaceRow(int index, const uint8_t* buffer)
+{
+    // 先取得新頁面再釋放舊的，內容沒變的頁面保留原來的編號
+    int* row = m_framePages.data() + size_t(index) * size_t(m_pageCount);
+    std::vector<uint8_t> blank;
+    if (!buffer) {
+        blank.assign(static_cast<size_t>(m_geometry.ramPageWidth), 0);
+    }
+    for (int page = 0; page < m_pageCount; ++page) {
+        const uint8_t* bytes = buffer ? buffer + page * m_geometry.ramPageWidth : blank.data();
+        const int id = acquirePage(bytes);
+        if (row[page] >= 0) {
+            releasePage(row[page]);
+        }
+        row[page] = id;
+    }
+}
+
+int OledTimeline::insertFrame(int index, const uint8_t* buffer)
+{
+    if (index < 0 || index > m_frameCount || m_pageCount == 0) {
+        return -1;
+    }
+    m_framePages.insert(m_framePages.begin() + ptrdiff_t(index) * m_pageCount, size_t(m_pageCount), -1);
+    ++m_frameCount;
+    replaceRow(index, buffer);
+    ++m_revision;
+    return index;
+}
+
+int OledTimeline::duplicateFrame(int index)
+{
+    if (index < 0 || index >= m_frameCount) {
+        return -1;
+    }
+    const auto source = m_framePages.begin() + ptrdiff_t(index) * m_pageCount;
+    const std::vector<int> row(source, source + m_pageCount);
+    for (const int id : row) {
+        ++m_refCounts[size_t(id)];
+    }
+    m_framePages.insert(m_framePages.begin() + ptrdiff_t(index + 1) * m_pageCount, row.begin(), row.end());
+    ++m_frameCount;
+    ++m_revision;
+    return index + 1;
+}
+
+void OledTimeline::setFrame(int index, const uint8_t* buffer)
+{
+    if (index < 0 || index >= m_frameCount) {
+        return;
+    }
+    replaceRow(index, buffer);
+    ++m_revision;
+}
+
+void OledTimeline::removeFrame(int index)
+{
+    if (index < 0 || index >= m_frameCount) {
+        return;
+    }
+    const auto row = m_framePages.begin() + ptrdiff_t(index) * m_pageCount;
+    for (auto it = row; it != row + m_pageCount; ++it) {
+        releasePage(*it);
+    }
+    m_framePages.erase(row, row + m_pageCount);
+    --m_frameCount;
+    ++m_revision;
+}
+
+void OledTimeline::moveFrame(int from, int to)
+{
+    if (from < 0 || from >= m_frameCount || to < 0 || to >= m_frameCount || from == to) {
+        return;
+    }
+    // 只搬動頁面編號
+    const auto begin = m_framePages.begin();
+    const ptrdiff_t pages = m_pageCount;
+    if (from < to) {
+        std::rotate(begin + from * pages, begin + (from + 1) * pages, begin + (to + 1) * pages);
+    } else {
+        std::rotate(begin + to * pages, begin + from * pages, begin + (from + 1) * pages);
+    }
+    ++m_revision;
+}
+
+void OledTimeline::copyFrame(int index, uint8_t* out) const
+{
+    const size_t width = static_cast<size_t>(m_geometry.ramPageWidth);
+    for (int page = 0; page < m_pageCount; ++page) {
+        std::memcpy(out + size_t(page) * width, this->page(index, page), width);
+    }
+}
+
+std::vector<uint8_t> OledTimeline::frame(int index) const
+{
+    std::vector<uint8_t> buffer(static_cast<size_t>(m_geometry.bufferSize()));
+    if (index >= 0 && index < m_frameCount) {
+        copyFrame(index, buffer.data());
+    }
+    return buffer;
+}
+
+OledTimeline::Stats OledTimeline::stats() const
+{
+    Stats result;
+    result.frames = m_frameCount;
+    result.uniquePages = static_cast<int>(m_refCounts.size() - m_freePages.size());
+    result.storedBytes = qint64(result.uniquePages) * m_geometry.ramPageWidth
+                         + qint64(m_framePages.size()) * qint64(sizeof(int));
+    result.rawBytes = qint64(m_frameCount) * m_geometry.bufferSize();
+    return result;
+}
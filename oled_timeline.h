@@ -0,0 +1,96 @@
+#ifndef OLED_TIMELINE_H
+#define OLED_TIMELINE_H
+
+#pragma once
+
+#include "oled_panel.h"
+
+#include <QtGlobal>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 動畫時間軸：多個影格 (硬體格式的整個畫面) 的儲存 (oledcore，不依賴 Qt Widgets)。
+ *
+ * 每個影格只記錄每一頁的頁面編號；頁面的內容放在共用的頁面池，以內容雜湊去除重複，
+ * 所以沒有改變的頁 (背景、靜止的部分) 在所有影格中只存一份。頁面放進池子後不再修改，
+ * 改變影格時只替換有變的頁面編號 (copy-on-write)，沒有影格使用的頁面會被回收重複利用。
+ *
+ * 頁面池是一整塊連續記憶體 (每頁 ramPageWidth bytes)，加入影格時不會每頁配置一次記憶體。
+ * 相同內容一定是同一個頁面編號，比較兩個影格的某一頁只要比較編號 (pageId())。
+ */
+class OledTimeline
+{
+public:
+    struct Stats {
+        int frames = 0;
+        int uniquePages = 0;        // 頁面池中使用中的頁面
+        qint64 storedBytes = 0;     // 頁面池的內容 + 每個影格的頁面編號
+        qint64 rawBytes = 0;        // 不去除重複時需要的 byte 數 (影格數 x bufferSize())
+    };
+
+    explicit OledTimeline(const OledPanelGeometry& geometry = OledPanel::defaultProfile().geometry);
+
+    const OledPanelGeometry& geometry() const { return m_geometry; }
+    int frameCount() const { return m_frameCount; }
+    bool isEmpty() const { return m_frameCount == 0; }
+
+    // 每次內容或影格順序改變都會加 1 (播放器用來判斷已經顯示的頁面是否還有效)
+    quint64 revision() const { return m_revision; }
+
+    /// 清除所有影格並改用新的面板幾何
+    void reset(const OledPanelGeometry& geometry);
+
+    /// 可視尺寸相同的面板 (只有填充欄位不同，例如 SH1106 -> SSD1306)：保留所有影格，搬到新的欄位位置。
+    /// 尺寸不同時不做任何事並回傳 false (呼叫端改用 reset())。
+    bool repad(const OledPanelGeometry& geometry);
+    void clear();
+
+    /**
+     * @brief 在 index 之前插入一個影格 (index 為 frameCount() 時加在最後)。
+     *
+     * @param buffer bufferSize() bytes 的畫面；nullptr 表示空白的影格。
+     * @return 新影格的位置，index 超出範圍時回傳 -1。
+     */
+    int insertFrame(int index, const uint8_t* buffer);
+    int appendFrame(const uint8_t* buffer) { return insertFrame(m_frameCount, buffer); }
+
+    /// 在 index 之後插入一個和它相同的影格 (共用所有頁面)，回傳新影格的位置
+    int duplicateFrame(int index);
+
+    /// 以新的畫面取代影格內容，只有改變的頁面會換成新的頁面編號
+    void setFrame(int index, const uint8_t* buffer);
+    void removeFrame(int index);
+    void moveFrame(int from, int to);
+
+    /// 組出整個畫面到 out (bufferSize() bytes)，不配置記憶體
+    void copyFrame(int index, uint8_t* out) const;
+    std::vector<uint8_t> frame(int index) const;
+
+    /// 影格 index 第 page 頁的頁面編號與內容 (ramPageWidth bytes，下一次修改時間軸前有效)
+    int pageId(int index, int page) const { return m_framePages[size_t(index) * size_t(m_pageCount) + size_t(page)]; }
+    const uint8_t* page(int index, int page) const { return pageData(pageId(index, page)); }
+    const uint8_t* pageData(int id) const { return m_storage.data() + size_t(id) * size_t(m_geometry.ramPageWidth); }
+
+    Stats stats() const;
+
+private:
+    int acquirePage(const uint8_t* bytes);      // 找到相同內容的頁面或放進新的頁面，參照數加 1
+    void releasePage(int id);
+    void replaceRow(int index, const uint8_t* buffer);
+
+    OledPanelGeometry m_geometry;
+    int m_pageCount = 0;
+    int m_frameCount = 0;
+    quint64 m_revision = 0;
+
+    std::vector<int> m_framePages;              // 每個影格 pageCount() 個頁面編號，依影格順序排列
+    std::vector<uint8_t> m_storage;             // 頁面池的內容
+    std::vector<int> m_refCounts;               // 每個頁面被幾個 (影格, 頁) 使用，0 表示空著
+    std::vector<quint64> m_hashes;
+    std::vector<int> m_freePages;
+    std::unordered_multimap<quint64, int> m_index;  // 內容雜湊 -> 頁面編號
+};
+
+#endif // OLED_TIMELINE_H
@@ -0,0 +1,117 @@
+#include "oled_timelineplayer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+OledTimelinePlayer::OledTimelinePlayer(QObject* parent) : QObject(parent)
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &OledTimelinePlayer::onTick);
+    setFps(m_fps);
+}
+
+void OledTimelinePlayer::setTimeline(const OledTimeline* timeline)
+{
+    stop();
+    m_timeline = timeline;
+    m_current = -1;
+    m_shownRevision = 0;
+    m_shownPages.clear();
+}
+
+void OledTimelinePlayer::setFps(double fps)
+{
+    m_fps = std::clamp(fps, 1.0, 240.0);
+    m_timer.setInterval(std::max(1, int(std::lround(1000.0 / m_fps))));
+    if (isPlaying()) {
+        // 從目前的影格重新計時
+        m_startFrame = m_current;
+        m_clock.start();
+    }
+}
+
+void OledTimelinePlayer::play()
+{
+    if (!m_timeline || m_timeline->frameCount() < 2 || isPlaying()) {
+        return;
+    }
+    // 停在最後一個影格又不循環時從頭播放
+    m_startFrame = (m_current < 0 || (!m_looping && m_current >= m_timeline->frameCount() - 1)) ? 0 : m_current;
+    show(m_startFrame);
+    m_clock.start();
+    m_timer.start();
+    emit playingChanged(true);
+}
+
+void OledTimelinePlayer::stop()
+{
+    if (!isPlaying()) {
+        return;
+    }
+    m_timer.stop();
+    emit playingChanged(false);
+}
+
+void OledTimelinePlayer::seek(int index)
+{
+    if (!m_timeline || index < 0 || index >= m_timeline->frameCount()) {
+        return;
+    }
+    if (isPlaying()) {
+        m_startFrame = index;
+        m_clock.start();
+    }
+    show(index);
+}
+
+void OledTimelinePlayer::onTick()
+{
+    const int count = m_timeline ? m_timeline->frameCount() : 0;
+    if (count == 0) {
+        stop();
+        return;
+    }
+
+    const qint64 elapsedFrames = qint64(double(m_clock.elapsed()) * m_fps / 1000.0);
+    qint64 index = m_startFrame + elapsedFrames;
+    if (m_looping) {
+        index %= count;
+    } else if (index >= count - 1) {
+        show(count - 1);
+        stop();
+        return;
+    }
+    if (index != m_current) {
+        show(int(index));
+    }
+}
+
+void OledTimelinePlayer::show(int index)
+{
+    const OledTimeline& timeline = *m_timeline;
+    const OledPanelGeometry& geometry = timeline.geometry();
+    const int pageCount = geometry.pageCount();
+    const size_t width = static_cast<size_t>(geometry.ramPageWidth);
+
+    // 面板改變或時間軸被修改過 (頁面編號可能被重複利用) 時整個畫面重新組出
+    // 只比較 byte 數不夠：mono256x64 與 sh1107 都是 2048 bytes，但頁數不同
+    if (m_shownGeometry != geometry || m_shownPages.size() != static_cast<size_t>(pageCount)) {
+        m_shownGeometry = geometry;
+        m_buffer.assign(static_cast<size_t>(geometry.bufferSize()), 0);
+        m_shownPages.assign(static_cast<size_t>(pageCount), -1);
+    } else if (m_shownRevision != timeline.revision()) {
+        std::fill(m_shownPages.begin(), m_shownPages.end(), -1);
+    }
+    m_shownRevision = timeline.revision();
+
+    for (int page = 0; page < pageCount; ++page) {
+        const int id = timeline.pageId(index, page);
+        if (m_shownPages[size_t(page)] != id) {
+            std::memcpy(m_buffer.data() + size_t(page) * width, timeline.pageData(id), width);
+            m_shownPages[size_t(page)] = id;
+        }
+    }
+    m_current = index;
+    emit frameChanged(index, m_buffer.data());
+}
@@ -0,0 +1,68 @@
+#ifndef OLED_TIMELINEPLAYER_H
+#define OLED_TIMELINEPLAYER_H
+
+#pragma once
+
+#include "oled_timeline.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <vector>
+
+/**
+ * @brief 時間軸的播放器 (oledcore，只用到 QtCore)：以 QTimer 依目標更新率送出影格。
+ *
+ * 影格的位置依播放開始後經過的時間計算，計時器晚到時會跳過影格，不會越播越慢。
+ * 畫面組在預先配置的緩衝區裡，而且只複製和上一次送出的畫面不同的頁面 (比較頁面編號)，
+ * 播放與拖曳時間軸都不會配置記憶體。frameChanged() 傳出的指標在下一個影格前有效。
+ */
+class OledTimelinePlayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OledTimelinePlayer(QObject* parent = nullptr);
+
+    /// 要播放的時間軸 (不擁有)；時間軸在播放器之前被刪除時要先設成 nullptr
+    void setTimeline(const OledTimeline* timeline);
+    const OledTimeline* timeline() const { return m_timeline; }
+
+    void setFps(double fps);
+    double fps() const { return m_fps; }
+    void setLooping(bool looping) { m_looping = looping; }
+    bool isLooping() const { return m_looping; }
+
+    bool isPlaying() const { return m_timer.isActive(); }
+    int currentFrame() const { return m_current; }
+
+public slots:
+    void play();
+    void stop();
+    void seek(int index);       // 立刻送出該影格 (拖曳時間軸)
+
+signals:
+    void frameChanged(int index, const uint8_t* buffer);
+    void playingChanged(bool playing);
+
+private slots:
+    void onTick();
+
+private:
+    void show(int index);
+
+    const OledTimeline* m_timeline = nullptr;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    double m_fps = 12.0;
+    bool m_looping = true;
+    int m_current = -1;
+    int m_startFrame = 0;               // 播放開始時的影格
+
+    std::vector<uint8_t> m_buffer;      // 目前送出的畫面
+    std::vector<int> m_shownPages;      // m_buffer 每一頁的頁面編號，-1 表示需要重新複製
+    OledPanelGeometry m_shownGeometry;  // m_buffer 的面板
+    quint64 m_shownRevision = 0;
+};
+
+#endif // OLED_TIMELINEPLAYER_H
@@ -8,8 +8,10 @@ void OLEDWidget::clearScreen() {
     //memset(m_buffer, 0, sizeof(m_buffer));
     //updateImageFromBuffer(); // 更新顯示
 
-    // 1. 调用数据模型来清除数据
+    // 1. 调用数据模型来清除数据 (记录为一笔可逆操作，可以 undo)
+    m_model.beginCommand();
     m_model.clear();
+    commitCommand(OledEditCommand::Clear);
 
     // 2. 调用辅助函数，从更新后的模型同步到显示图像
     updateImageFromModel();
@@ -17,6 +19,44 @@ void OLEDWidget::clearScreen() {
 
 
 
+/**
+ * @brief 切換面板 (尺寸、RAM 頁寬、欄位偏移)。
+ *
+ * 畫布重新配置：可視尺寸相同 (只有填充欄位不同，例如 SH1106 <-> SSD1306) 時保留畫面，否則清空。
+ * 操作歷史、選取框與貼上預覽一律清除 (舊的操作記錄是以舊面板的欄位位置儲存的，不能套用到新面板)。
+ * 會遺失內容時由呼叫端先詢問使用者 (見 MainWindow)。
+ *
+ * @param profile 要切換的面板設定檔，見 OledPanel::profiles()。
+ * @return 面板幾何無效時不做任何修改並回傳 false。
+ */
+bool OLEDWidget::setPanel(const OledPanelProfile &profile)
+{
+    if (!m_model.setGeometry(profile.geometry)) {
+        return false;
+    }
+
+    m_commandHistory.clear();
+    m_selectedRegion = QRect();
+    m_isSelecting = false;
+    m_pastePreviewActive = false;
+    m_pastePreviewImage = QImage();
+    m_isDrawing = false;
+
+    m_image = OledDataConverter::createIndexedImage(m_pixelOnColor, m_pixelOffColor,
+                                                    QSize(m_model.width(), m_model.height()));
+    m_gridOverlay = QPixmap(); // 尺寸改變，網格圖層需要重建
+    updateImageFromModel();     // 新的 m_image 是全黑的；保留畫面時整個重畫
+
+    setScale(scale);            // 依新尺寸重設 widget 大小
+    emit historyChanged();
+    return true;
+}
+
+const OledPanelGeometry &OLEDWidget::panelGeometry() const
+{
+    return m_model.geometry();
+}
+
 void OLEDWidget::setScale(int s) {
     const int minScale = 1;
     const int maxScale = 20; // 依需求調整最大放大倍數
@@ -46,6 +86,22 @@ void OLEDWidget::setBrushSize(int size)
 }
 
 
+/**
+ * @brief 設定亮/暗像素的顯示顏色。
+ *
+ * m_image 是調色盤圖片，換顏色只需要改兩個調色盤項目，像素資料完全不用動。
+ */
+void OLEDWidget::setPixelColors(const QColor &onColor, const QColor &offColor)
+{
+    m_pixelOnColor = onColor;
+    m_pixelOffColor = offColor;
+
+    m_image.setColor(0, m_pixelOffColor.rgb());
+    m_image.setColor(1, m_pixelOnColor.rgb());
+    update();
+}
+
+
 void OLEDWidget::setBuffer(const uint8_t *buffer){
     // 同步内部状态
 
@@ -56,6 +112,36 @@ void OLEDWidget::setBuffer(const uint8_t *buffer){
     updateImageFromModel();
 }
 
+/**
+ * @brief 以硬體格式的畫面覆蓋目前的圖層，記錄成一筆「匯入」操作。
+ *
+ * 與 setBuffer() 不同，這是使用者的編輯，可以 undo。
+ * @param buffer 長度為 panelGeometry().bufferSize() 的頁面資料 (含填充欄位)。
+ */
+void OLEDWidget::importBuffer(const uint8_t *buffer)
+{
+    m_model.beginCommand();
+    m_model.setFromHardwareBuffer(buffer);
+    commitCommand(OledEditCommand::Import);
+    updateImageFromModel();
+}
+
+/**
+ * @brief 顯示動畫時間軸的某個影格。
+ *
+ * 操作記錄只對一個影格有意義，換影格時清除；播放時操作歷史已經是空的，
+ * 不會每個影格都發出 historyChanged()。
+ */
+void OLEDWidget::showFrame(const uint8_t *buffer)
+{
+    m_model.setFromHardwareBuffer(buffer);
+    updateImageFromModel();
+    if (m_commandHistory.canUndo() || m_commandHistory.canRedo()) {
+        m_commandHistory.clear();
+        emit historyChanged();
+    }
+}
+
 
 
     /**
@@ -76,3 +162,94 @@ void OLEDWidget::setBuffer(const uint8_t *buffer){
 }
 
 
+
+
+/**
+ * @brief 結束目前記錄中的操作，若畫布確實有改變就放進操作歷史。
+ *
+ * @param[in] type 操作種類，用於顯示與除錯。
+ * @see OledDataModel::beginCommand()
+ */
+void OLEDWidget::commitCommand(OledEditCommand::Type type)
+{
+    OledEditCommand command;
+    if (m_model.endCommand(type, &command)) {
+        m_commandHistory.push(std::move(command));
+        emit historyChanged();
+    }
+}
+
+/**
+ * @brief 以點陣字型把文字畫到目前的圖層，記錄成一筆「文字」操作。
+ *
+ * 字元直接以頁面 byte 寫入模型 (OledFont::drawText())，不經過 QImage。
+ * @return 文字佔用的範圍 (邏輯座標，未裁切)。
+ */
+QRect OLEDWidget::drawText(const OledFont &font, const QPoint &pos, const QString &text, bool on)
+{
+    m_model.beginCommand();
+    const QRect rect = font.drawText(&m_model, pos.x(), pos.y(), text, on);
+    commitCommand(OledEditCommand::Text);
+    updateImageFromModel();
+    return rect;
+}
+
+/**
+ * @brief [SLOT] 復原上一筆操作。
+ *
+ * 只把該操作記錄的頁面窗口寫回操作前的內容，並只重畫被影響的範圍，
+ * 不需要重新載入整個畫布。
+ */
+void OLEDWidget::undo()
+{
+    if (const OledEditCommand *command = m_commandHistory.undo()) {
+        m_model.applyCommand(*command, true);
+        updateImageFromModel();
+        emit historyChanged();
+    }
+}
+
+/**
+ * @brief [SLOT] 重做下一筆操作。
+ */
+void OLEDWidget::redo()
+{
+    if (const OledEditCommand *command = m_commandHistory.redo()) {
+        m_model.applyCommand(*command, false);
+        updateImageFromModel();
+        emit historyChanged();
+    }
+}
+
+/**
+ * @brief 重建操作歷史中每一步的畫面。
+ *
+ * 在模型上依序反向套用所有可 undo 的操作，再逐筆重新套用並取出畫面，
+ * 最後模型回到目前的狀態 (可 redo 的操作不包含在內)；畫布不需要重畫。
+ */
+std::vector<std::vector<uint8_t>> OLEDWidget::historyFrames()
+{
+    const int count = m_commandHistory.undoCount();
+    for (int i = count - 1; i >= 0; --i) {
+        m_model.applyCommand(m_commandHistory.command(i), true);
+    }
+
+    std::vector<std::vector<uint8_t>> frames;
+    frames.reserve(static_cast<size_t>(count) + 1);
+    frames.push_back(m_model.getHardwareBuffer());
+    for (int i = 0; i < count; ++i) {
+        m_model.applyCommand(m_commandHistory.command(i), false);
+        frames.push_back(m_model.getHardwareBuffer());
+    }
+    return frames;
+}
+
+bool OLEDWidget::canUndo() const
+{
+    return m_commandHistory.canUndo();
+}
+
+bool OLEDWidget::canRedo() const
+{
+    return m_commandHistory.canRedo();
+}
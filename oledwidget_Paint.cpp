@@ -18,18 +18,19 @@
 
 OLEDWidget::OLEDWidget(QWidget *parent)
     : QWidget(parent),
-    m_image(OledConfig::DISPLAY_WIDTH, OledConfig::DISPLAY_HEIGHT, QImage::Format_RGB888), // 直接在初始化列表創建 QImage
+    m_image(OledDataConverter::createIndexedImage(m_pixelOnColor, m_pixelOffColor)), // 直接在初始化列表創建調色盤 QImage
     m_currentTool(Tool_Pen), // 預設為畫筆
     m_isDrawing(false),
     m_brushSize(1)
 {
-    // 初始為空白 128x64
-
-    m_image.fill(Qt::black); // 填充背景色
+    // 初始為空白 128x64 (createIndexedImage 已經把所有像素設為索引 0，也就是暗色)
 
     setScale(7); // 呼叫 setScale 來設定尺寸和縮放
 
     setFocusPolicy(Qt::StrongFocus); // 允許接收鍵盤事件
+
+    // paintEvent 會自己填滿所有重繪範圍，Qt 不需要先幫我們清背景
+    setAttribute(Qt::WA_OpaquePaintEvent);
 }
 
 //留下paintEvent
@@ -41,48 +42,40 @@ void OLEDWidget::paintEvent(QPaintEvent *event) {
     //int ScaleMultiple=1;
 
 
-    // 步骤 1: 绘制 widget 的灰色背景，方便区分显示区域
-    painter.fillRect(rect(), Qt::darkGray);
+    // 本次需要重绘的范围 (update(QRect) 只会让局部失效)
+    const QRect exposed = event->rect();
+
+    // 步骤 1: 绘制 widget 的灰色背景，方便区分显示区域 (只填满需要重绘的部分)
+    painter.fillRect(exposed, Qt::darkGray);
 
     // 步骤 2: 计算 OLED 图像的显示位置和大小
 
-    int scaled_width = OledConfig::DISPLAY_WIDTH * scale;
-    int scaled_height = OledConfig::DISPLAY_HEIGHT * scale;
+    int scaled_width = m_model.width() * scale;
+    int scaled_height = m_model.height() * scale;
 
     // 计算偏移量，使其在 widget 中居中显示
     int x_offset = (width() - scaled_width) / 2;
     int y_offset = (height() - scaled_height) / 2;
 
     QRect targetRect(x_offset, y_offset, scaled_width, scaled_height);
-
-    /*1107修改 開始*/
-    painter.drawImage(targetRect, m_image);
-    /*1107修改 結束*/
-
-
-    // 步骤 3: 绘制核心的 OLED 屏幕图像 (m_image)
-    // 这是最高效的绘制方式，一次性将缓存的 QImage "贴"上去
-    painter.drawImage(targetRect, m_image);
-
-    // 步骤 4: 绘制边框和网格线，增强视觉效果
-    // 4.1 绘制白色外边框
-    painter.setPen(QPen(Qt::white, 1));
-    // adjusted(-1, -1) 是为了让边框完全落在绘制区域内，避免被裁切
-    painter.drawRect(targetRect.adjusted(0, 0, -1, -1));// adjusted 确保边框在内侧
-
-    // 4.2 如果缩放比例足够大，绘制像素网格
-    if (scale >= 4) {
-        QPen grid_pen(QColor(128, 128, 128, 100), 1); // 半透明灰色
-        painter.setPen(grid_pen);
-
-        // 绘制垂直线
-        for (int i = 1; i < OledConfig::DISPLAY_WIDTH; ++i) {
-            painter.drawLine(x_offset + i * scale, y_offset, x_offset + i * scale, y_offset + scaled_height);
-        }
-        // 绘制水平线
-        for (int j = 1; j < OledConfig::DISPLAY_HEIGHT; ++j) {
-            painter.drawLine(x_offset, y_offset + j * scale, x_offset + scaled_width, y_offset + j * scale);
-        }
+    const QRect exposedTarget = exposed.intersected(targetRect);
+
+    if (exposedTarget.isValid()) {
+        // 步骤 3: 绘制核心的 OLED 屏幕图像 (m_image)
+        // 只取出与重绘范围重叠的那几个逻辑像素，避免每次都把整张图放大 scale 倍
+        const QRect sourceRect(QPoint((exposedTarget.left() - x_offset) / scale,
+                                      (exposedTarget.top() - y_offset) / scale),
+                               QPoint((exposedTarget.right() - x_offset) / scale,
+                                      (exposedTarget.bottom() - y_offset) / scale));
+        painter.drawImage(convertToScreen(sourceRect), m_image, sourceRect);
+
+        // 步骤 4: 贴上缓存好的边框与网格线图层 (只在 scale 或尺寸改变时重建)
+        // 来源矩形以 pixmap 的实体像素为单位，HiDPI 时要乘上 devicePixelRatio
+        ensureGridOverlay();
+        const qreal dpr = m_gridOverlay.devicePixelRatio();
+        const QRectF overlaySource(QRectF(exposedTarget.translated(-x_offset, -y_offset)).topLeft() * dpr,
+                                   QSizeF(exposedTarget.size()) * dpr);
+        painter.drawPixmap(QRectF(exposedTarget), m_gridOverlay, overlaySource);
     }
 
     if (m_pastePreviewActive && !m_pastePreviewImage.isNull()) {
@@ -171,6 +164,78 @@ void OLEDWidget::paintEvent(QPaintEvent *event) {
 
 }
 
+/**
+ * @brief 確保邊框與網格線的快取圖層 (m_gridOverlay) 與目前的縮放倍率一致。
+ *
+ * 網格在 scale >= 4 時需要 (寬 - 1) 條垂直線與 (高 - 1) 條水平線 (128x64 為 127 + 63 條)，
+ * 每次 paintEvent 都重畫的成本很高。這裡把白色外框與半透明網格畫進一張透明的 QPixmap，
+ * 只有在 scale 改變或切換面板 (setPanel 會清掉快取) 時才重建，paintEvent 只需要把重繪範圍貼上去。
+ */
+void OLEDWidget::ensureGridOverlay()
+{
+    const int scaled_width = m_model.width() * scale;
+    const int scaled_height = m_model.height() * scale;
+    const qreal dpr = devicePixelRatioF();
+
+    if (!m_gridOverlay.isNull() && m_gridOverlayScale == scale && m_gridOverlay.devicePixelRatio() == dpr) {
+        return; // 快取仍然有效
+    }
+
+    m_gridOverlay = QPixmap(QSize(scaled_width, scaled_height) * dpr);
+    m_gridOverlay.setDevicePixelRatio(dpr);
+    m_gridOverlay.fill(Qt::transparent);
+    m_gridOverlayScale = scale;
+
+    QPainter painter(&m_gridOverlay);
+    const QRect overlayRect(0, 0, scaled_width, scaled_height);
+
+    // 1. 绘制白色外边框
+    painter.setPen(QPen(Qt::white, 1));
+    painter.drawRect(overlayRect.adjusted(0, 0, -1, -1));// adjusted 确保边框在内侧
+
+    // 2. 如果缩放比例足够大，绘制像素网格
+    if (scale >= 4) {
+        QPen grid_pen(QColor(128, 128, 128, 100), 1); // 半透明灰色
+        painter.setPen(grid_pen);
+
+        // 绘制垂直线
+        for (int i = 1; i < m_model.width(); ++i) {
+            painter.drawLine(i * scale, 0, i * scale, scaled_height);
+        }
+        // 绘制水平线
+        for (int j = 1; j < m_model.height(); ++j) {
+            painter.drawLine(0, j * scale, scaled_width, j * scale);
+        }
+    }
+}
+
+/**
+ * @brief 計算目前所有互動預覽 (貼上預覽、形狀預覽、選取框) 在 widget 上的外框。
+ *
+ * 滑鼠拖曳時只需要重繪「移動前」與「移動後」兩個外框的聯集，
+ * 不必讓整個放大後的畫布失效。外框會多留 2px，涵蓋虛線筆寬。
+ *
+ * @return QRect widget 座標系中的範圍；沒有任何預覽時為無效矩形。
+ */
+QRect OLEDWidget::interactionOverlayRect() const
+{
+    QRect overlay;
+
+    if (m_pastePreviewActive && !m_pastePreviewImage.isNull()) {
+        overlay = overlay.united(convertToScreen(QRect(m_pastePosition, m_pastePreviewImage.size())));
+    }
+
+    if ((m_isDrawing && m_currentTool != Tool_Pen && m_currentTool != Tool_Select) || m_isSelecting) {
+        overlay = overlay.united(convertToScreen(QRect(m_startPoint, m_endPoint).normalized()));
+    }
+
+    if (m_selectedRegion.isValid()) {
+        overlay = overlay.united(convertToScreen(m_selectedRegion));
+    }
+
+    return overlay.isValid() ? overlay.adjusted(-2, -2, 2, 2) : overlay;
+}
+
 void OLEDWidget::mousePressEvent(QMouseEvent *event) {
 
     // 步骤 1: 将 Qt 的 widget 坐标转换为我们的 OLED 逻辑坐标
@@ -207,6 +272,9 @@ void OLEDWidget::mousePressEvent(QMouseEvent *event) {
         m_startPoint = oled_pos; // 记录起点
         m_endPoint = oled_pos;   // 终点与起点相同
 
+        // 整条笔迹 (press -> move -> release) 记录为一笔可逆操作
+        m_model.beginCommand();
+
         if (event->button() == Qt::LeftButton) {
             // 左键：调用 model 画点 (应用笔刷大小)
             // [注意] 我们需要为 OledDataModel 添加一个带笔刷的 setPixel
@@ -252,8 +320,9 @@ void OLEDWidget::mouseMoveEvent(QMouseEvent *event) {
 
     // 步骤 2: [高优先级] 检查是否处于“贴上预览”模式
     if (m_pastePreviewActive) {
+        const QRect before = interactionOverlayRect();
         m_pastePosition = oled_pos; // 更新预览图的左上角位置
-        update();                   // 触发重绘，让 paintEvent 画出移动后的预览
+        update(before.united(interactionOverlayRect())); // 只重绘预览图移动前后的范围
         return;                     // 贴上模式下，不进行其他任何操作
     }
 
@@ -270,6 +339,7 @@ void OLEDWidget::mouseMoveEvent(QMouseEvent *event) {
     }
 
     // 步骤 4: 更新当前鼠标位置作为“终点”
+    const QRect overlayBefore = interactionOverlayRect();
     m_endPoint = oled_pos;
 
     // 步骤 5: 根据当前工具，分发事件
@@ -308,7 +378,8 @@ void OLEDWidget::mouseMoveEvent(QMouseEvent *event) {
         // --- 其他形状工具的逻辑：只更新预览 ---
         // 我们只需要更新 m_endPoint (前面已完成)，然后触发一次重绘。
         // 真正的绘制逻辑在 paintEvent 中，它会根据 m_startPoint 和 m_endPoint 绘制预览线框。
-        update();
+        // 只让预览框移动前后的范围失效即可。
+        update(overlayBefore.united(interactionOverlayRect()));
         break;
 
     default:
@@ -348,17 +419,20 @@ void OLEDWidget::mouseReleaseEvent(QMouseEvent *event) {
 
     case Tool_Pen:
         // 对于画笔工具，所有的绘制工作都在 press 和 move 事件中完成了。
-        // release 事件只需要做一件事：结束“正在绘制”的状态。
+        // release 事件只需要结束“正在绘制”的状态，并把整条笔迹提交为一笔操作。
         // 无需调用任何绘图函数。
+        commitCommand(OledEditCommand::Stroke);
         break;
 
     case Tool_Line:
         // --- 直线工具：最终绘制 ---
         if (event->button() == Qt::LeftButton) {
             // 指挥“绘图引擎”在起点和终点之间，画一条 1 像素宽的线
+            m_model.beginCommand();
             m_model.drawLine(m_startPoint.x(), m_startPoint.y(),
                              m_endPoint.x()-1, m_endPoint.y(),
                              true,m_brushSize); // on=true, brushSize=1
+            commitCommand(OledEditCommand::Line);
             updateImageFromModel(); // 数据已变，同步视图
         }
         break;
@@ -368,8 +442,10 @@ void OLEDWidget::mouseReleaseEvent(QMouseEvent *event) {
         if (event->button() == Qt::LeftButton) {
             const QRect rect = QRect(m_startPoint, m_endPoint).normalized();
             // 指挥引擎画一个不填充的、1 像素宽的矩形
+            m_model.beginCommand();
             m_model.drawRectangle(rect.x()-1, rect.y()-1, rect.width(), rect.height(),
                                   true, false, m_brushSize); // on=true, fill=false, brushSize=1
+            commitCommand(OledEditCommand::Rectangle);
             updateImageFromModel();
         }
         break;
@@ -379,8 +455,10 @@ void OLEDWidget::mouseReleaseEvent(QMouseEvent *event) {
         if (event->button() == Qt::LeftButton) {
             const QRect rect = QRect(m_startPoint, m_endPoint).normalized();
             // 指挥引擎画一个填充的、1 像素宽边框的矩形
+            m_model.beginCommand();
             m_model.drawRectangle(rect.x()-1, rect.y()-1, rect.width(), rect.height(),
                                   true, true, m_brushSize); // on=true, fill=true, brushSize=1
+            commitCommand(OledEditCommand::FilledRectangle);
             updateImageFromModel();
         }
         break;
@@ -389,7 +467,9 @@ void OLEDWidget::mouseReleaseEvent(QMouseEvent *event) {
         // --- 圆形工具：最终绘制 ---
         if (event->button() == Qt::LeftButton) {
             // 指挥引擎在起点和终点构成的矩形内，画一个 1 像素宽的椭圆
+            m_model.beginCommand();
             m_model.drawCircle(m_startPoint, m_endPoint, m_brushSize); // brushSize=1
+            commitCommand(OledEditCommand::Ellipse);
             updateImageFromModel();
         }
         break;
@@ -399,13 +479,7 @@ void OLEDWidget::mouseReleaseEvent(QMouseEvent *event) {
     }
     update();
 
-
-    QByteArray state = QByteArray(
-        reinterpret_cast<const char*>(getHardwareBuffer().data()),
-        getHardwareBuffer().size()
-        );
-    emit canvasStateChanged(state);  // 新增一個 signal
-    //oledwidget_Paint.cpp:407:10: Use of undeclared identifier 'canvasStateChanged'
+    // 不再于每次放开鼠标时序列化整个画布；操作已经由 commitCommand() 记录
 
     QWidget::mouseReleaseEvent(event);
 }
@@ -488,56 +562,41 @@ void OLEDWidget::keyPressEvent(QKeyEvent *event)
 
 //留下updateImageFromModel
 /**
- * @brief 根據資料模型（OledDataModel）的狀態，重新生成用於顯示的 QImage 緩衝區。
+ * @brief 根據資料模型（OledDataModel）的髒區域，重新整理用於顯示的 QImage 緩衝區。
  *
  * 此函數扮演著將資料模型層的邏輯狀態（像素的開/關）轉換為視圖層的視覺呈現（像素的顏色）的關鍵角色。
- * 它會遍歷顯示器上的每一個像素點，逐一向資料模型 `m_model` 查詢該點的狀態。
- * 根據查詢結果（true 為亮，false 為暗），在內部成員 `m_image` 的對應位置上設置預先定義的亮點或暗點顏色。
+ * 模型的每個繪圖操作都會累積一個髒區域 (dirty region)，這裡只取出該範圍，
+ * 交給 OledDataConverter::renderModelToIndexedImage() 直接寫入 `m_image` 的掃描線。
+ * `m_image` 是調色盤圖片，像素只存 0/1 索引，顏色由調色盤決定。
  *
- * 完成整個圖像的更新後，它會呼叫 `update()` 來觸發一次重繪請求（schedule a repaint）。
- * 這會告知 Qt 在下一個事件循環中呼叫此 Widget 的 `paintEvent()`，
- * `paintEvent()` 接著會將這個更新後的 `m_image` 繪製到螢幕上。
+ * 完成後只呼叫 `update(QRect)` 讓對應的縮放後螢幕範圍失效，
+ * 而不是整個 widget；在放大 20 倍時，畫筆拖曳只會重繪筆刷經過的那一小塊。
  *
- * @note 這是一個像素級別的操作。在模型數據發生任何改變後都應該呼叫此函數，以確保使用者介面與資料模型保持同步。
+ * @note 在模型數據發生任何改變後都應該呼叫此函數；若模型沒有任何變更則什麼都不做。
  * @see paintEvent(QPaintEvent*)
- * @see OledDataModel::getPixel(int, int) const
+ * @see OledDataModel::takeDirtyRegion()
  */
 void OLEDWidget::updateImageFromModel(){
 
-    const QColor pixelOnColor = QColor(135, 206, 250); // 淺藍色
-    const QColor pixelOffColor = Qt::black;
-
     // 安全检查：确保 m_image 已经被正确初始化
     // (虽然我们的构造函数保证了这一点，但这是一个好的防御性编程习惯)
     if (m_image.isNull()) {
-        m_image = QImage(OledConfig::DISPLAY_WIDTH, OledConfig::DISPLAY_HEIGHT, QImage::Format_RGB888);
+        m_image = OledDataConverter::createIndexedImage(m_pixelOnColor, m_pixelOffColor,
+                                                        QSize(m_model.width(), m_model.height()));
+        m_model.markAllDirty();
     }
 
-
-    // 使用两层 for 循环，遍历屏幕上的每一个像素坐标 (x, y)
-    for (int y = 0; y < OledConfig::DISPLAY_HEIGHT; ++y) {
-        for (int x = 0; x < OledConfig::DISPLAY_WIDTH; ++x) {
-
-            // 步骤 1: 从数据模型查询该点的状态 (是亮是暗？)
-            // m_model.getPixel(x, y) 返回一个 bool 值
-            bool isPixelOn = m_model.getPixel(x, y);
-
-            // 步骤 2: 根据查询结果，在 m_image 的相同坐标位置上设置颜色
-            if (isPixelOn) {
-                m_image.setPixelColor(x, y, pixelOnColor);
-            } else {
-                m_image.setPixelColor(x, y, pixelOffColor);
-            }
-
-            // 上面的 if/else 可以简化为一行三元表达式，效果完全相同:
-            // m_image.setPixelColor(x, y, isPixelOn ? pixelOnColor : pixelOffColor);
-        }
+    // 步骤 1: 取出自上次同步以来被修改过的范围
+    const QRect dirty = m_model.takeDirtyRegion();
+    if (!dirty.isValid()) {
+        return; // 没有任何变更，不需要重绘
     }
 
-    // 步骤 3: 请求重绘
-    // 在更新完 m_image 的所有像素后，调用 update() 来通知 Qt：
-    // “我的画面内容已经准备好了，请在下一个刷新周期调用我的 paintEvent()！”
-    update();
+    // 步骤 2: 以扫描线方式把髒區域写入调色盘索引 (不经过 QColor)
+    OledDataConverter::renderModelToIndexedImage(m_model, &m_image, dirty);
+
+    // 步骤 3: 只请求重绘对应的屏幕范围
+    update(convertToScreen(dirty));
 }
 
 
@@ -548,8 +607,10 @@ void OLEDWidget::updateImageFromModel(){
      */
 void OLEDWidget::updateOledFromImage(const QImage& image){
     // 步驟 1: 呼叫外部工具函式來處理資料模型的更新
-    // 我們把 m_model 的指標傳遞給它，讓它去操作
+    // 我們把 m_model 的指標傳遞給它，讓它去操作 (整個覆蓋記錄為一筆「匯入」操作)
+    m_model.beginCommand();
     OledDataConverter::updateModelFromImage(&m_model, image);
+    commitCommand(OledEditCommand::Import);
 
     // 步驟 2: 資料模型已經被外部工具更新了，
     //         現在我們只需要同步 View 的顯示即可。
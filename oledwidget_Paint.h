@@ -7,8 +7,9 @@
 #include "config.h"
 #include "oled_datamodel.h"
 #include "oled_dataconverter.h"
+#include "oled_font.h"
 #include "oledwidget_Paint.h"
-#include "historymanager.h"
+#include "commandhistory.h"
 
 
 /** @class OLEDWidget
@@ -17,7 +18,7 @@
                 * 此類別繼承自 QWidget，是整個畫板的核心。它結合了：
     * - 數據儲存 (OledDataModel)
     * - 影像轉換 (OledDataConverter)
-    * - 歷史管理 (HistoryManager)
+    * - 歷史管理 (CommandHistory)
     *
     * 它負責處理滑鼠繪圖、選取、複製貼上等操作，並將邏輯座標轉換為螢幕顯示。
         */
@@ -35,18 +36,34 @@ public:
 
     void setScale(int s);
 
+    // 切換面板 (會清空畫布與操作歷史)，目前的面板幾何
+    bool setPanel(const OledPanelProfile &profile);
+    const OledPanelGeometry &panelGeometry() const;
+
      QImage getCurrentImage() const;
 
     void setBrushSize(int size);
 
+    // 設定亮/暗像素的顯示顏色 (只修改調色盤，不需要重畫像素)
+    void setPixelColors(const QColor &onColor, const QColor &offColor);
+
     // setBuffer，用於未來載入檔案
     void setBuffer(const uint8_t *buffer);
 
+    // 載入一整個硬體格式的畫面，記錄成一筆可以 undo 的「匯入」操作 (例如硬體模擬器的結果)
+    void importBuffer(const uint8_t *buffer);
+
+    // 顯示動畫的某個影格：載入畫面並清除操作歷史 (每個影格各自 undo / redo)
+    void showFrame(const uint8_t *buffer);
+
     // getHardwareBuffer 用于导出内部逻辑模型到硬体格式
     std::vector<uint8_t> getHardwareBuffer() const;
 
     QByteArray getCanvasSnapshot() const;
 
+    // 操作歷史中每一步的畫面 (硬體格式，從最舊仍保留的狀態到目前)，例如匯出差異更新
+    std::vector<std::vector<uint8_t>> historyFrames();
+
     QImage copyRegionToImage(const QRect &region) const;
     QRect getSelectedRegion() const;
 
@@ -54,6 +71,8 @@ public:
     // --- 工具 & 状态查询 ---
     void setCurrentTool(ToolType tool);
     QRect selectedRegion() const { return m_selectedRegion;}
+    bool canUndo() const;
+    bool canRedo() const;
 
     /**
      * @brief 從一個邏輯格式的 QImage 更新整個 OLED 顯示內容。
@@ -63,6 +82,9 @@ public:
 
     void handleImportPreview(const QImage &image); // 對外公開
 
+    // 以點陣字型把文字畫到畫布 (pos 為第一行字元格的左上角，on 為 false 時擦掉)，可 undo
+    QRect drawText(const OledFont &font, const QPoint &pos, const QString &text, bool on = true);
+
 
 // --- 公开槽 (Public Slots, 响应 UI 信号) ---
 
@@ -72,6 +94,8 @@ public slots:
     void commitPaste();
     void handleCut();
     void handlePaste(); // <-- 新增這個槽
+    void undo();
+    void redo();
 
 
 
@@ -84,7 +108,7 @@ signals:
     // 現在 MOC 會看到並處理這個信號了
     void coordinatesChanged(const QPoint &pos);
     void paintingCommitted(const QByteArray& newCanvas);
-    void canvasStateChanged(const QByteArray &state);
+    void historyChanged(); // 操作歷史有變動 (新增 / undo / redo)
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -98,10 +122,18 @@ protected:
 
 private:
     OledDataModel m_model;      // [核心] 数据模型 (单一事实来源)
-    QImage m_image;         // 用于在屏幕上绘制的缓存图像
+    // [注意] 顏色必須宣告在 m_image 之前，建構子初始化 m_image 時會用到
+    QColor m_pixelOnColor = QColor(135, 206, 250); // 淺藍色
+    QColor m_pixelOffColor = Qt::black;
+
+    QImage m_image;         // 用于在屏幕上绘制的缓存图像 (Format_Indexed8，0=暗 1=亮)
 
     int scale = 7; // 放大倍率
 
+    // 边框 + 网格线的快取图层，只在 scale 改变时重建
+    QPixmap m_gridOverlay;
+    int m_gridOverlayScale = 0;
+
     //直接用 ToolType
     ToolType m_currentTool;
 
@@ -119,14 +151,18 @@ private:
     QPoint m_endPoint;
 
     // --- 私有辅助函式 ---
-    void updateImageFromModel(); // 从模型更新 QImage
+    void updateImageFromModel(); // 从模型更新 QImage (只更新髒區域)
     QPoint convertToOLED(const QPoint &pos);
+    QRect convertToScreen(const QRect &oledRect) const; // 逻辑矩形 -> widget 上的缩放矩形
+    void ensureGridOverlay();                // 重建 (必要时) 边框与网格的快取图层
+    QRect interactionOverlayRect() const;    // 目前预览/选取框在 widget 上的范围
 
     void handleSelectPress(QMouseEvent *event);
     void handleSelectMove(QMouseEvent *event);
     void handleSelectRelease(QMouseEvent *event);
     void startPastePreview(const QImage& logicalImage);
     QByteArray getCanvasByteArray() const;
+    void commitCommand(OledEditCommand::Type type); // 结束记录并放进操作历史
 
     //QImage m_clipboardImage; // <-- 【核心】新增這個成員變數，作為持久化的剪貼簿
     //QImage m_selectionBuffer;  //新增這個成員變數，作為持久化的buffer
@@ -152,7 +188,7 @@ private:
     QPoint m_dragStartPastePos;   // 拖曳開始時的貼上預覽位置
 
 
-    HistoryManager historyManager;
+    CommandHistory m_commandHistory; // 可逆操作记录 (undo / redo)
 
 
     //QByteArray canvasData;   // 畫布快照
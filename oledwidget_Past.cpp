@@ -14,6 +14,9 @@ void OLEDWidget::commitPaste()
 
     bool anyPixelSet = false; // 添加一个标志，检查是否有任何像素被设置
 
+    // 整个贴上动作记录为一笔可逆操作
+    m_model.beginCommand();
+
     // 步骤 2: 遍历预览图像的每一个像素
     // 我们需要将 m_pastePreviewImage 中的像素，一个一个地“复制”到 m_model 中。
     for (int y = 0; y < m_pastePreviewImage.height(); ++y) {
@@ -38,6 +41,8 @@ void OLEDWidget::commitPaste()
         }
     }
 
+    commitCommand(OledEditCommand::Paste);
+
     if (anyPixelSet) {
             qDebug() << "[commitPaste] anyPixelSet = true, updating image...";
         updateImageFromModel();
@@ -113,6 +118,7 @@ void OLEDWidget::handleCut() {
     // ================== 2. 刪除 (Delete) ==================
     // [優化!] 指揮 model 在原選區位置畫一個「熄滅的、實心的」矩形，
     // 這比逐點清除像素的效率高得多。
+    m_model.beginCommand();
     m_model.drawRectangle(
         m_selectedRegion.x(),
         m_selectedRegion.y(),
@@ -122,6 +128,8 @@ void OLEDWidget::handleCut() {
         true,  // fill = true 代表「實心」
         1      // 筆刷大小在此不重要
         );
+    commitCommand(OledEditCommand::Cut);
+    updateImageFromModel();
 
 
     startPastePreview(m_persistentBuffer);
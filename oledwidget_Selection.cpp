@@ -5,8 +5,8 @@ QPoint OLEDWidget::convertToOLED(const QPoint &pos)
 
     // 步骤 1: 计算 OLED 图像在 widget 中居中显示的几何信息
     // [注意] 这部分计算逻辑必须与 paintEvent() 中的完全一致！
-    const int scaled_width = OledConfig::DISPLAY_WIDTH * scale;
-    const int scaled_height = OledConfig::DISPLAY_HEIGHT * scale;
+    const int scaled_width = m_model.width() * scale;
+    const int scaled_height = m_model.height() * scale;
     const int x_offset = (width() - scaled_width) / 2;
     const int y_offset = (height() - scaled_height) / 2;
 
@@ -22,15 +22,38 @@ QPoint OLEDWidget::convertToOLED(const QPoint &pos)
 
     // 步骤 4: [重要] 边界限制 (Clamping)
     // 即使鼠标点击在灰色背景区域（绘图区之外），
-    // 我们也应该将坐标限制在有效的 OLED 范围内 (0-127, 0-63)。
+    // 我们也应该将坐标限制在有效的 OLED 范围内 (0 ~ 寬-1, 0 ~ 高-1，預設面板為 0-127, 0-63)。
     // 这可以防止后续的绘图操作访问到无效的坐标。
-    oled_x = std::clamp(oled_x, 0, OledConfig::DISPLAY_WIDTH - 1);
-    oled_y = std::clamp(oled_y, 0, OledConfig::DISPLAY_HEIGHT - 1);
+    oled_x = std::clamp(oled_x, 0, m_model.width() - 1);
+    oled_y = std::clamp(oled_y, 0, m_model.height() - 1);
 
     // 步骤 5: 返回计算出的逻辑坐标
     return QPoint(oled_x, oled_y);
 }
 
+/**
+ * @brief 將 OLED 邏輯座標的矩形轉換為 widget 上對應的縮放矩形。
+ *
+ * 這是 convertToOLED() 的反向運算，主要給 update(QRect) 使用，
+ * 讓只有被修改的像素所在的螢幕範圍被重繪。
+ *
+ * @param[in] oledRect 邏輯座標的矩形 (0~127, 0~63)。
+ * @return QRect widget 座標系中的矩形。
+ */
+QRect OLEDWidget::convertToScreen(const QRect &oledRect) const
+{
+    // [注意] 这部分计算逻辑必须与 paintEvent() 中的完全一致！
+    const int scaled_width = m_model.width() * scale;
+    const int scaled_height = m_model.height() * scale;
+    const int x_offset = (width() - scaled_width) / 2;
+    const int y_offset = (height() - scaled_height) / 2;
+
+    return QRect(x_offset + oledRect.x() * scale,
+                 y_offset + oledRect.y() * scale,
+                 oledRect.width() * scale,
+                 oledRect.height() * scale);
+}
+
 
 void OLEDWidget::handleSelectPress(QMouseEvent *event)
 {
@@ -90,6 +113,7 @@ void OLEDWidget::handleSelectMove(QMouseEvent *event)
     // 步骤 3: 更新选区的“结束点”
     // m_startPoint 在 handleSelectPress 时已经固定下来，我们不去动它。
     // 我们只需要不断地更新 m_endPoint 即可。
+    const QRect overlayBefore = interactionOverlayRect();
     m_endPoint = oled_pos;
 
     // 步骤 4: 请求重绘以更新预览
@@ -99,7 +123,8 @@ void OLEDWidget::handleSelectMove(QMouseEvent *event)
     // 然后它会使用最新的 m_startPoint 和 m_endPoint
     // 来绘制一个动态变化的黄色虚线矩形。
     // 这就为用户提供了实时的视觉反馈。
-    update();
+    // 只让选区框移动前后的范围失效，避免整个画布重绘。
+    update(overlayBefore.united(interactionOverlayRect()));
 
     // 步骤 5: 接受事件
     event->accept();
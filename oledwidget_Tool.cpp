@@ -1,5 +1,6 @@
 
 #include "oledwidget_Paint.h"
+#include "oled_carray.h"
 
 
 // ================== 新增的 SLOT ==================
@@ -48,7 +49,7 @@ void OLEDWidget::showBufferDataAsHeader()
 {
     // 步骤 1: 确定要导出的区域 (有选区就用选区，否则用整个屏幕)
     QRect region = m_selectedRegion.isValid() ? m_selectedRegion :
-                       QRect(0, 0, OledConfig::DISPLAY_WIDTH, OledConfig::DISPLAY_HEIGHT);
+                       QRect(0, 0, m_model.width(), m_model.height());
 
     // 步骤 2: [复用!] 调用 model 将该区域转换为逻辑图像 QImage
     QImage logicalData = m_model.copyRegionToLogicalFormat(region);
@@ -66,29 +67,16 @@ void OLEDWidget::showBufferDataAsHeader()
     // ------------------------------------------------------------------
 
 
-    // 步骤 4: 将打包好的 hardwareData 格式化成 C 阵列字符串
-    QString output;
-    output += QString("// Image Data (%1x%2 region at (%3, %4))\n")
-                  .arg(logicalData.width()).arg(logicalData.height())
-                  .arg(region.left()).arg(region.top());
-    output += QString("const uint8_t imageData[%1] = {\n    ").arg(hardwareData.size());
-
-    for (int i = 0; i < hardwareData.size(); ++i) {
-        //output += QString("0x%1, ").arg(hardwareData[i], 2, 16, QChar('0')).toUpper();
-
-        QString hexVal = QString::number(hardwareData[i], 16).toUpper().rightJustified(2, '0');
-        output += QString("0x%1, ").arg(hexVal);
-
-
-        if ((i + 1) % 16 == 0 && i < hardwareData.size() - 1) {
-            output += "\n    ";
-        }
-    }
-
-    if (output.endsWith(", ")) {
-        output.chop(2);
+    // 步骤 4: 将打包好的 hardwareData 格式化成 C 阵列字符串 (共用的 OledCArrayWriter，查表寫入)
+    QByteArray outputBytes;
+    {
+        OledCArrayWriter writer(&outputBytes);
+        writer.writeComment(QString("Image Data (%1x%2 region at (%3, %4))")
+                                .arg(logicalData.width()).arg(logicalData.height())
+                                .arg(region.left()).arg(region.top()).toUtf8());
+        writer.writeArray("imageData", hardwareData.constData(), static_cast<size_t>(hardwareData.size()));
     }
-    output += "\n};";
+    const QString output = QString::fromUtf8(outputBytes);
 
 
     // === 顯示在視窗中 ===
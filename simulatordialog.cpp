@@ -1,6 +1,13 @@
 #include "simulatordialog.h"
 
-#include <QRegularExpression>
+#include "oled_assetio.h"
+#include "oled_datamodel.h"
+
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QSignalBlocker>
+#include <QTableWidget>
 
 SimulatorDialog::SimulatorDialog(QWidget *parent) : QDialog(parent) {
     setupUi();
@@ -12,30 +19,103 @@ SimulatorDialog::~SimulatorDialog() {
 }
 
 void SimulatorDialog::setupUi() {
-    setWindowTitle("SH1106 硬體模擬器 (Hex Import)");
-    resize(600, 400);
+    resize(720, 560);
 
     // 使用垂直佈局
     QVBoxLayout *layout = new QVBoxLayout(this);
 
-    // 說明標籤
-    layout->addWidget(new QLabel("請貼上 C 語言陣列 (SH1106 垂直頁面格式, 1024 bytes):\n支援格式: 0xFF, 0xA1... 或純 hex 字串"));
+    // 輸入格式：畫面資料 (C 陣列) 或 I2C / SPI 擷取到的指令串流
+    m_modeComboBox = new QComboBox(this);
+    m_modeComboBox->addItem("畫面資料 (C 陣列)");
+    m_modeComboBox->addItem("指令串流 (I2C / SPI 紀錄)");
+    layout->addWidget(m_modeComboBox);
+
+    // 說明標籤 (內容依面板與輸入格式而定，見 setPanel / onModeChanged)
+    m_hintLabel = new QLabel(this);
+    layout->addWidget(m_hintLabel);
 
     // 文字輸入框
     inputText = new QTextEdit(this);
-    inputText->setPlaceholderText("例如: const unsigned char img[] = { 0xFF, 0x00, 0xA1, ... };");
     // 設定等寬字型，方便看對齊
     QFont font("Courier");
     font.setStyleHint(QFont::TypeWriter);
     inputText->setFont(font);
-    layout->addWidget(inputText);
+    layout->addWidget(inputText, 2);
+
+    m_rotatedCheckBox = new QCheckBox("模組上下顛倒安裝 (A1 + C8 為正向，多數 SH1106 模組)", this);
+    m_rotatedCheckBox->setChecked(true);
+    layout->addWidget(m_rotatedCheckBox);
 
     // 按鈕
     QPushButton *btn = new QPushButton("載入並模擬", this);
     layout->addWidget(btn);
 
+    // 指令串流模式的結果：每個畫面的匯流排 byte 數 + 選取畫面的預覽
+    m_frameTable = new QTableWidget(0, 7, this);
+    m_frameTable->setHorizontalHeaderLabels({"畫面", "匯流排", "指令", "資料", "改變", "多餘", "寫入的頁"});
+    m_frameTable->verticalHeader()->setVisible(false);
+    m_frameTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_frameTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_frameTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    m_previewLabel = new QLabel(this);
+    m_previewLabel->setAlignment(Qt::AlignCenter);
+    m_previewLabel->setMinimumSize(2 * OledConfig::DISPLAY_WIDTH + 4, 2 * OledConfig::DISPLAY_HEIGHT + 4);
+
+    QHBoxLayout *resultLayout = new QHBoxLayout();
+    resultLayout->addWidget(m_frameTable, 1);
+    resultLayout->addWidget(m_previewLabel);
+    layout->addLayout(resultLayout, 3);
+
+    m_summaryLabel = new QLabel(this);
+    layout->addWidget(m_summaryLabel);
+
+    m_applyButton = new QPushButton("把選取的畫面套用到畫布", this);
+    m_applyButton->setEnabled(false);
+    layout->addWidget(m_applyButton);
+
     // 連接信號
     connect(btn, &QPushButton::clicked, this, &SimulatorDialog::onSimulateClicked);
+    connect(m_modeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SimulatorDialog::onModeChanged);
+    connect(m_frameTable, &QTableWidget::itemSelectionChanged, this, &SimulatorDialog::onFrameSelected);
+    connect(m_rotatedCheckBox, &QCheckBox::toggled, this, &SimulatorDialog::onFrameSelected);
+    connect(m_applyButton, &QPushButton::clicked, this, &SimulatorDialog::onApplyClicked);
+
+    setPanel(m_panel);
+}
+
+void SimulatorDialog::setPanel(const OledPanelProfile &profile) {
+    m_panel = profile;
+    m_emulator = OledEmulator(profile.geometry);
+    m_frameTable->setRowCount(0);
+    onModeChanged();
+}
+
+bool SimulatorDialog::isTraceMode() const {
+    return m_modeComboBox->currentIndex() == 1;
+}
+
+void SimulatorDialog::onModeChanged() {
+    const QString name = QString::fromUtf8(m_panel.name);
+    const bool trace = isTraceMode();
+    if (trace) {
+        setWindowTitle(QString("%1 硬體模擬器 (指令串流)").arg(name));
+        m_hintLabel->setText("請貼上匯流排紀錄，一行一段傳輸 (hex)：\n"
+                             "C AE A1 C8 AF = SPI 指令、D 00 FF ... = SPI 資料、"
+                             "I 78 00 B0 02 10 = I2C 寫入 (位址、控制 byte...)、frame = 畫面分隔");
+        inputText->setPlaceholderText("C AE D5 80 A8 3F D3 00 40 A1 C8 DA 12 81 CF AF\nC B0 02 10\nD 00 FF 81 81 ...");
+    } else {
+        setWindowTitle(QString("%1 硬體模擬器 (Hex Import)").arg(name));
+        m_hintLabel->setText(QString("請貼上 C 語言陣列 (%1 垂直頁面格式, %2 bytes):\n支援格式: 0xFF, 0xA1... 或純 hex 字串")
+                                 .arg(name)
+                                 .arg(m_panel.geometry.visibleBufferSize()));
+        inputText->setPlaceholderText("例如: const unsigned char img[] = { 0xFF, 0x00, 0xA1, ... };");
+    }
+    m_rotatedCheckBox->setVisible(trace);
+    m_frameTable->setVisible(trace);
+    m_previewLabel->setVisible(trace);
+    m_summaryLabel->setVisible(trace);
+    m_applyButton->setVisible(trace);
 }
 
 std::vector<uint8_t> SimulatorDialog::getBuffer() const {
@@ -43,27 +123,20 @@ std::vector<uint8_t> SimulatorDialog::getBuffer() const {
 }
 
 void SimulatorDialog::onSimulateClicked() {
+    if (isTraceMode()) {
+        simulateTrace();
+        return;
+    }
+
     QString raw = inputText->toPlainText();
-    m_buffer.clear();
 
-    // 1. 強大的字串清洗與解析
-    // 使用 Regular Expression 找出所有的 hex 數值 (例如 0xFF, FF, 0xff)
-    QRegularExpression hexRegex("0x[0-9a-fA-F]+|[0-9a-fA-F]{2}");
-    auto matches = hexRegex.globalMatch(raw);
-
-    while (matches.hasNext()) {
-        auto match = matches.next();
-        bool ok;
-        // 轉成 hex 整數
-        int val = match.captured().toInt(&ok, 16);
-        if (ok) {
-            m_buffer.push_back(static_cast<uint8_t>(val));
-        }
-    }
+    // 1. 字串清洗與解析 (與匯入對話框、命令列工具共用 OledAssetIO)
+    // 有大括號時只解析括號內的內容，避免把陣列宣告裡的大小也當成資料
+    m_buffer = OledAssetIO::parseHexArray(raw);
 
     // 2. 關鍵：防止雪花雜訊的安全檢查
-    // SH1106 / SSD1306 128x64 解析度的標準緩衝區大小
-    const size_t requiredSize = 128 * 64 / 8; // 1024 bytes
+    // 目前面板的標準緩衝區大小 (寬 x 頁數，128x64 為 1024 bytes)
+    const size_t requiredSize = static_cast<size_t>(m_panel.geometry.visibleBufferSize());
 
     if (m_buffer.empty()) {
         QMessageBox::warning(this, "錯誤", "未偵測到有效的 Hex 數據！\n請檢查輸入內容。");
@@ -72,7 +145,9 @@ void SimulatorDialog::onSimulateClicked() {
 
     if (m_buffer.size() > requiredSize) {
         QMessageBox::information(this, "截斷警告",
-                                 QString("資料長度 (%1 bytes) 超過標準大小 (1024 bytes)。\n系統將自動截斷多餘部分。").arg(m_buffer.size()));
+                                 QString("資料長度 (%1 bytes) 超過標準大小 (%2 bytes)。\n系統將自動截斷多餘部分。")
+                                     .arg(m_buffer.size())
+                                     .arg(requiredSize));
         m_buffer.resize(requiredSize);
     }
     else if (m_buffer.size() < requiredSize) {
@@ -84,3 +159,100 @@ void SimulatorDialog::onSimulateClicked() {
     // 關閉視窗並回傳 Accepted 結果給 MainWindow
     accept();
 }
+
+void SimulatorDialog::simulateTrace() {
+    std::vector<OledEmulator::Transfer> transfers;
+    QString error;
+    if (!OledEmulator::parseTrace(inputText->toPlainText(), &transfers, &error)) {
+        QMessageBox::warning(this, "錯誤", QString("無法解析匯流排紀錄：\n%1").arg(error));
+        return;
+    }
+
+    m_emulator.reset();
+    m_emulator.run(transfers);
+    const std::vector<OledEmulator::Frame> &frames = m_emulator.frames();
+
+    // 每個畫面一列；多餘的 byte (寫入與原值相同) 就是可以省掉的重繪
+    const QSignalBlocker blocker(m_frameTable);
+    m_frameTable->setRowCount(static_cast<int>(frames.size()));
+    qint64 totalBus = 0;
+    qint64 totalRedundant = 0;
+    qint64 totalData = 0;
+    int unsupported = 0;
+    for (int row = 0; row < static_cast<int>(frames.size()); ++row) {
+        const OledEmulator::FrameStats &stats = frames[static_cast<size_t>(row)].stats;
+        QString pages;
+        for (int page = 0; page < m_panel.geometry.pageCount(); ++page) {
+            pages += (stats.pagesWritten >> page) & 1 ? QString::number(page, 16) : QStringLiteral("·");
+        }
+        const QStringList cells{QString::number(row), QString::number(stats.busBytes),
+                                QString::number(stats.commandBytes), QString::number(stats.dataBytes),
+                                QString::number(stats.changedBytes), QString::number(stats.redundantBytes), pages};
+        for (int column = 0; column < cells.size(); ++column) {
+            m_frameTable->setItem(row, column, new QTableWidgetItem(cells.at(column)));
+        }
+        totalBus += stats.busBytes;
+        totalRedundant += stats.redundantBytes;
+        totalData += stats.dataBytes;
+        unsupported += stats.unsupportedCommands;
+    }
+    m_frameTable->resizeColumnsToContents();
+
+    QString summary = QString("%1 個畫面，匯流排共 %2 bytes；資料 %3 bytes 中有 %4 bytes 沒有改變內容 (%5%)")
+                          .arg(frames.size())
+                          .arg(totalBus)
+                          .arg(totalData)
+                          .arg(totalRedundant)
+                          .arg(totalData > 0 ? 100.0 * double(totalRedundant) / double(totalData) : 0.0, 0, 'f', 1);
+    if (unsupported > 0) {
+        summary += QString("\n有 %1 個 SH1106 不支援的指令 (例如 SSD1306 的定址模式)，已略過").arg(unsupported);
+    }
+    m_summaryLabel->setText(summary);
+
+    if (!frames.empty()) {
+        m_frameTable->selectRow(static_cast<int>(frames.size()) - 1);
+    }
+    onFrameSelected();
+}
+
+std::vector<uint8_t> SimulatorDialog::renderFrame(int index) const {
+    const std::vector<OledEmulator::Frame> &frames = m_emulator.frames();
+    if (index < 0 || index >= static_cast<int>(frames.size())) {
+        return std::vector<uint8_t>();
+    }
+    const OledEmulator::Frame &frame = frames[static_cast<size_t>(index)];
+    return OledEmulator::render(m_emulator.geometry(), frame.ram, frame.state, m_rotatedCheckBox->isChecked());
+}
+
+void SimulatorDialog::onFrameSelected() {
+    const std::vector<uint8_t> display = renderFrame(m_frameTable->currentRow());
+    m_applyButton->setEnabled(!display.empty());
+    if (display.empty()) {
+        m_previewLabel->clear();
+        return;
+    }
+
+    OledDataModel model(m_panel.geometry);
+    model.setFromHardwareBuffer(display.data());
+    QImage preview = model.copyRegionToLogicalFormat(QRect(0, 0, model.width(), model.height()));
+    preview.setColor(0, qRgb(0, 0, 0));
+    preview.setColor(1, qRgb(135, 206, 250));
+    m_previewLabel->setPixmap(QPixmap::fromImage(preview.scaled(preview.size() * 2)));
+}
+
+void SimulatorDialog::onApplyClicked() {
+    const std::vector<uint8_t> display = renderFrame(m_frameTable->currentRow());
+    if (display.empty()) {
+        return;
+    }
+
+    // 去掉填充欄位，與「畫面資料」模式相同，只回傳可視區域 (寬 x 頁數)
+    const OledPanelGeometry &geometry = m_panel.geometry;
+    m_buffer.clear();
+    m_buffer.reserve(static_cast<size_t>(geometry.visibleBufferSize()));
+    for (int page = 0; page < geometry.pageCount(); ++page) {
+        const auto row = display.cbegin() + page * geometry.ramPageWidth + geometry.columnOffset;
+        m_buffer.insert(m_buffer.end(), row, row + geometry.width);
+    }
+    accept();
+}
@@ -2,12 +2,17 @@
 #define SIMULATORDIALOG_H
 
 #include "config.h"
+#include "oled_emulator.h"
+#include "oled_panel.h"
 #include <vector>
 #include <cstdint> // for uint8_t
 
 
 // 前置宣告，加快編譯速度
 class QTextEdit;
+class QLabel;
+class QComboBox;
+class QTableWidget;
 
 class SimulatorDialog : public QDialog {
     Q_OBJECT
@@ -17,14 +22,36 @@ public:
     ~SimulatorDialog(); // 記得要有解構子
 
     // 提供一個公開方法讓 MainWindow 拿資料
+    // 長度固定為面板的可視資料量 (寬 x 頁數，不含填充欄位；SH1106 為 1024 bytes)
     std::vector<uint8_t> getBuffer() const;
 
+    // 設定要模擬的面板，預設為 OledPanel::defaultProfile()
+    void setPanel(const OledPanelProfile &profile);
+
 private slots:
     void onSimulateClicked();
+    void onModeChanged();
+    void onFrameSelected();
+    void onApplyClicked();
 
 private:
     QTextEdit *inputText;
+    QLabel *m_hintLabel;
     std::vector<uint8_t> m_buffer;
+    OledPanelProfile m_panel = OledPanel::defaultProfile();
+
+    // --- 指令串流模式：執行 I2C / SPI 紀錄，逐畫面列出匯流排 byte 數並預覽 ---
+    QComboBox *m_modeComboBox;
+    QCheckBox *m_rotatedCheckBox;
+    QTableWidget *m_frameTable;
+    QLabel *m_previewLabel;
+    QLabel *m_summaryLabel;
+    QPushButton *m_applyButton;
+    OledEmulator m_emulator;
+
+    bool isTraceMode() const;
+    void simulateTrace();
+    std::vector<uint8_t> renderFrame(int index) const;  // 面板上看到的畫面 (bufferSize() bytes)
 
     // 初始化 UI 的 helper
     void setupUi();
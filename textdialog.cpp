@@ -0,0 +1,249 @@
+#include "textdialog.h"
+#include "oledwidget_Paint.h"
+#include "oled_carray.h"
+#include "oled_fontexport.h"
+
+#include <QComboBox>
+#include <QFontComboBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLineEdit>
+#include <QSpinBox>
+
+TextDialog::TextDialog(OLEDWidget *oled, QWidget *parent)
+    : QDialog(parent), m_oled(oled) {
+    setupUi();
+    onSourceChanged();
+}
+
+void TextDialog::setupUi() {
+    setWindowTitle("文字");
+    resize(420, 420);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    // 字型
+    QFormLayout *form = new QFormLayout();
+    m_sourceComboBox = new QComboBox(this);
+    m_sourceComboBox->addItem("內建 5x7", Builtin);
+    m_sourceComboBox->addItem("系統字型", System);
+    m_sourceComboBox->addItem("字型檔 (BDF / C 陣列)", File);
+    form->addRow("字型", m_sourceComboBox);
+
+    m_fontComboBox = new QFontComboBox(this);
+    form->addRow("系統字型", m_fontComboBox);
+
+    m_pixelSizeSpinBox = new QSpinBox(this);
+    m_pixelSizeSpinBox->setRange(6, 64);
+    m_pixelSizeSpinBox->setValue(12);
+    m_pixelSizeSpinBox->setSuffix(" px");
+    form->addRow("大小", m_pixelSizeSpinBox);
+
+    m_thresholdSpinBox = new QSpinBox(this);
+    m_thresholdSpinBox->setRange(1, 255);
+    m_thresholdSpinBox->setValue(128);
+    m_thresholdSpinBox->setToolTip("反鋸齒的灰階 >= 這個值的像素點亮；數值越小筆畫越粗");
+    form->addRow("門檻", m_thresholdSpinBox);
+
+    QHBoxLayout *fileLayout = new QHBoxLayout();
+    m_fileLineEdit = new QLineEdit(this);
+    m_fileLineEdit->setReadOnly(true);
+    m_browseButton = new QPushButton("選擇...", this);
+    fileLayout->addWidget(m_fileLineEdit, 1);
+    fileLayout->addWidget(m_browseButton);
+    form->addRow("字型檔", fileLayout);
+    layout->addLayout(form);
+
+    // 文字與位置
+    m_textEdit = new QTextEdit(this);
+    m_textEdit->setAcceptRichText(false);
+    m_textEdit->setPlainText("Hello");
+    m_textEdit->setMaximumHeight(80);
+    layout->addWidget(m_textEdit);
+
+    QHBoxLayout *positionLayout = new QHBoxLayout();
+    // 面板可能在對話框開著時切換，範圍以最大的面板為準 (超出畫布的部分會被裁切)
+    m_xSpinBox = new QSpinBox(this);
+    m_xSpinBox->setRange(-256, 256);
+    m_xSpinBox->setPrefix("X ");
+    m_ySpinBox = new QSpinBox(this);
+    m_ySpinBox->setRange(-256, 256);
+    m_ySpinBox->setPrefix("Y ");
+    m_ySpinBox->setToolTip("8 的倍數時每個字元整個 byte 直接寫入一頁，最快");
+    m_eraseCheckBox = new QCheckBox("擦除", this);
+    positionLayout->addWidget(m_xSpinBox);
+    positionLayout->addWidget(m_ySpinBox);
+    positionLayout->addWidget(m_eraseCheckBox);
+    positionLayout->addStretch(1);
+    layout->addLayout(positionLayout);
+
+    // 預覽 (放大 3 倍)
+    m_previewLabel = new QLabel(this);
+    m_previewLabel->setAlignment(Qt::AlignCenter);
+    m_previewLabel->setMinimumHeight(96);
+    m_previewLabel->setStyleSheet("background-color: black;");
+    layout->addWidget(m_previewLabel, 1);
+
+    m_infoLabel = new QLabel(this);
+    m_infoLabel->setWordWrap(true);
+    layout->addWidget(m_infoLabel);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    QPushButton *drawButton = new QPushButton("畫到畫布", this);
+    QPushButton *exportButton = new QPushButton("匯出字型...", this);
+    exportButton->setToolTip("匯出這個字型的 C 陣列與查找函式，只包含畫過的文字與輸入框中用到的字元");
+    buttonLayout->addWidget(drawButton, 1);
+    buttonLayout->addWidget(exportButton);
+    layout->addLayout(buttonLayout);
+
+    connect(m_sourceComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &TextDialog::onSourceChanged);
+    connect(m_fontComboBox, &QFontComboBox::currentFontChanged, this, &TextDialog::updatePreview);
+    connect(m_pixelSizeSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &TextDialog::updatePreview);
+    connect(m_thresholdSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &TextDialog::updatePreview);
+    connect(m_browseButton, &QPushButton::clicked, this, &TextDialog::onBrowseClicked);
+    connect(m_textEdit, &QTextEdit::textChanged, this, &TextDialog::updatePreview);
+    connect(m_ySpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &TextDialog::updatePreview);
+    connect(drawButton, &QPushButton::clicked, this, &TextDialog::onDrawClicked);
+    connect(exportButton, &QPushButton::clicked, this, &TextDialog::onExportClicked);
+}
+
+std::shared_ptr<const OledFont> TextDialog::currentFont(QString *errorMessage) const {
+    switch (m_sourceComboBox->currentData().toInt()) {
+    case System:
+        // 只二值化還沒畫過的字元；同一個字型、大小與門檻共用快取
+        return OledFontCache::system(m_fontComboBox->currentFont(), m_pixelSizeSpinBox->value(),
+                                     m_thresholdSpinBox->value(), m_textEdit->toPlainText());
+    case File:
+        if (!m_fileFont && errorMessage) {
+            *errorMessage = "請選擇字型檔";
+        }
+        return m_fileFont;
+    default:
+        // 內建字型是靜態物件，不需要釋放
+        return std::shared_ptr<const OledFont>(&OledFont::builtin(), [](const OledFont *) {});
+    }
+}
+
+QString TextDialog::fontKey() const {
+    switch (m_sourceComboBox->currentData().toInt()) {
+    case System:
+        return QString("system|%1|%2|%3").arg(m_fontComboBox->currentFont().key())
+            .arg(m_pixelSizeSpinBox->value()).arg(m_thresholdSpinBox->value());
+    case File:
+        return "file|" + m_fileLineEdit->text();
+    default:
+        return "builtin";
+    }
+}
+
+void TextDialog::onSourceChanged() {
+    const int source = m_sourceComboBox->currentData().toInt();
+    m_fontComboBox->setEnabled(source == System);
+    m_pixelSizeSpinBox->setEnabled(source == System);
+    m_thresholdSpinBox->setEnabled(source == System);
+    m_fileLineEdit->setEnabled(source == File);
+    m_browseButton->setEnabled(source == File);
+    updatePreview();
+}
+
+void TextDialog::onBrowseClicked() {
+    const QString filePath = QFileDialog::getOpenFileName(this, "選擇字型檔", QString(),
+                                                          "點陣字型 (*.bdf *.h *.c);;所有檔案 (*)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+    QString errorMessage;
+    std::shared_ptr<const OledFont> font = OledFontCache::file(filePath, &errorMessage);
+    if (!font) {
+        QMessageBox::warning(this, "错误", QString("无法读取字型:\n%1").arg(errorMessage));
+        return;
+    }
+    m_fileFont = font;
+    m_fileLineEdit->setText(filePath);
+    updatePreview();
+}
+
+void TextDialog::updatePreview() {
+    QString errorMessage;
+    const std::shared_ptr<const OledFont> font = currentFont(&errorMessage);
+    if (!font || !font->isValid()) {
+        m_previewLabel->clear();
+        m_infoLabel->setText(errorMessage);
+        return;
+    }
+
+    const QString text = m_textEdit->toPlainText();
+    const QImage image = font->render(text);
+    m_previewLabel->setPixmap(QPixmap::fromImage(image.scaled(image.size() * 3, Qt::IgnoreAspectRatio,
+                                                              Qt::FastTransformation)));
+
+    const QSize size = font->measure(text);
+    QString info = QString("%1：字高 %2 (%3 頁)，%4 個字元，文字 %5x%6")
+                       .arg(font->name()).arg(font->height()).arg(font->pageCount())
+                       .arg(font->glyphCount()).arg(size.width()).arg(size.height());
+    if (m_ySpinBox->value() % 8 != 0) {
+        info += "。Y 不是 8 的倍數，每個字元要拆成兩頁寫入";
+    }
+    m_infoLabel->setText(info);
+}
+
+void TextDialog::onDrawClicked() {
+    QString errorMessage;
+    const std::shared_ptr<const OledFont> font = currentFont(&errorMessage);
+    if (!font || !font->isValid()) {
+        QMessageBox::information(this, "提示", errorMessage.isEmpty() ? QString("字型中沒有任何字元。") : errorMessage);
+        return;
+    }
+    const QString text = m_textEdit->toPlainText();
+    m_oled->drawText(*font, QPoint(m_xSpinBox->value(), m_ySpinBox->value()), text, !m_eraseCheckBox->isChecked());
+    if (!m_eraseCheckBox->isChecked()) {
+        m_drawnTexts[fontKey()] << text;
+    }
+}
+
+void TextDialog::onExportClicked() {
+    // 畫過的文字加上輸入框 (例如貼上其他語言的標籤)；系統字型要先把這些字元都二值化
+    QStringList texts = m_drawnTexts.value(fontKey());
+    texts << m_textEdit->toPlainText();
+    const QString characters = OledFontExporter::usedCharacters(texts);
+    const std::shared_ptr<const OledFont> font =
+        m_sourceComboBox->currentData().toInt() == System
+            ? OledFontCache::system(m_fontComboBox->currentFont(), m_pixelSizeSpinBox->value(),
+                                    m_thresholdSpinBox->value(), characters)
+            : currentFont(nullptr);
+    OledFontExporter::Result result;
+    if (!font || characters.isEmpty() || !OledFontExporter::pack(*font, characters, &result)) {
+        QMessageBox::information(this, "提示", "沒有可以匯出的字元。");
+        return;
+    }
+
+    const QString filePath = QFileDialog::getSaveFileName(this, "匯出字型", "font.h", "C header (*.h)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::critical(this, "错误", QString("无法写入档案:\n%1").arg(filePath));
+        return;
+    }
+
+    OledCArrayWriter::Options writerOptions;
+    writerOptions.type = "const unsigned char";
+    writerOptions.upperCase = false;
+    OledCArrayWriter writer(&file, writerOptions);
+    writer.writeComment("File generated by OLED GUI Designer");
+    OledFontExporter::writeArrays(&writer, "font", result);
+
+    if (!writer.flush()) {
+        QMessageBox::critical(this, "错误", QString("无法写入档案:\n%1").arg(filePath));
+        return;
+    }
+    const OledFontExporter::Report &report = result.report;
+    QString message = QString("%1 個字元，flash %2 bytes (點陣 %3 + 表 %4)。\n完整 ASCII %5 bytes，整個字型 %6 bytes。")
+                          .arg(report.glyphs).arg(report.flashBytes()).arg(report.bitmapBytes)
+                          .arg(report.tableBytes).arg(report.asciiBytes).arg(report.fullBytes);
+    if (!report.missing.isEmpty()) {
+        message += QString("\n字型中沒有 (以 '?' 代替)：%1").arg(report.missing);
+    }
+    QMessageBox::information(this, "成功", QString("字型已匯出至:\n%1\n\n%2").arg(filePath, message));
+}
@@ -0,0 +1,65 @@
+#ifndef TEXTDIALOG_H
+#define TEXTDIALOG_H
+
+#include "config.h"
+#include "oled_font.h"
+#include <QHash>
+#include <QStringList>
+#include <memory>
+
+
+// 前置宣告，加快編譯速度
+class QComboBox;
+class QFontComboBox;
+class QLineEdit;
+class QSpinBox;
+class OLEDWidget;
+
+/**
+ * @brief 文字工具：選擇點陣字型 (內建 5x7、系統字型或 BDF / C 陣列字型檔)，預覽後畫到畫布。
+ *
+ * 系統字型經由 OledFontCache::system() 二值化，只有第一次用到的字元才會畫出；
+ * 字型檔經由 OledFontCache::file() 讀取。每次「畫到畫布」都是一筆可以 undo 的操作。
+ * 「匯出字型...」以 OledFontExporter 匯出目前的字型，只包含用這個字型畫過的文字與輸入框中的字元。
+ */
+class TextDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    TextDialog(OLEDWidget *oled, QWidget *parent = nullptr);
+
+private slots:
+    void onSourceChanged();
+    void onBrowseClicked();
+    void updatePreview();
+    void onDrawClicked();
+    void onExportClicked();
+
+private:
+    enum Source { Builtin, System, File };
+
+    OLEDWidget *m_oled;
+
+    QComboBox *m_sourceComboBox;
+    QFontComboBox *m_fontComboBox;
+    QSpinBox *m_pixelSizeSpinBox;
+    QSpinBox *m_thresholdSpinBox;
+    QLineEdit *m_fileLineEdit;
+    QPushButton *m_browseButton;
+    QTextEdit *m_textEdit;
+    QSpinBox *m_xSpinBox;
+    QSpinBox *m_ySpinBox;
+    QCheckBox *m_eraseCheckBox;
+    QLabel *m_previewLabel;
+    QLabel *m_infoLabel;
+
+    std::shared_ptr<const OledFont> m_fileFont;     // 目前選擇的字型檔
+    QHash<QString, QStringList> m_drawnTexts;       // 每個字型 (fontKey()) 畫到畫布的文字
+
+    // 初始化 UI 的 helper
+    void setupUi();
+    std::shared_ptr<const OledFont> currentFont(QString *errorMessage) const;
+    QString fontKey() const;                        // 目前的字型：來源、字型與大小 (畫過的文字依此分開)
+};
+
+#endif // TEXTDIALOG_H
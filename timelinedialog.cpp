@@ -0,0 +1,224 @@
+#include "timelinedialog.h"
+#include "animationexportdialog.h"
+#include "oled_timelineplayer.h"
+#include "oledwidget_Paint.h"
+
+#include <QHBoxLayout>
+#include <QSignalBlocker>
+#include <QSlider>
+#include <QSpinBox>
+#include <algorithm>
+
+TimelineDialog::TimelineDialog(OledTimeline *timeline, OLEDWidget *oled, QWidget *parent)
+    : QDialog(parent), m_timeline(timeline), m_oled(oled) {
+    m_player = new OledTimelinePlayer(this);
+    m_player->setTimeline(m_timeline);
+    setupUi();
+
+    connect(m_player, &OledTimelinePlayer::frameChanged, this, &TimelineDialog::onFrameChanged);
+    connect(m_player, &OledTimelinePlayer::playingChanged, this, &TimelineDialog::onPlayingChanged);
+    connect(m_oled, &OLEDWidget::historyChanged, this, &TimelineDialog::onCanvasChanged);
+    connect(this, &QDialog::finished, m_player, &OledTimelinePlayer::stop);
+
+    syncWithCanvas();
+}
+
+void TimelineDialog::setupUi() {
+    setWindowTitle("動畫時間軸");
+    resize(480, 180);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    // 影格位置
+    QHBoxLayout *frameLayout = new QHBoxLayout();
+    m_frameSlider = new QSlider(Qt::Horizontal, this);
+    m_frameSlider->setPageStep(1);
+    m_frameLabel = new QLabel(this);
+    m_frameLabel->setMinimumWidth(90);
+    frameLayout->addWidget(m_frameSlider, 1);
+    frameLayout->addWidget(m_frameLabel);
+    layout->addLayout(frameLayout);
+
+    // 編輯影格
+    QHBoxLayout *editLayout = new QHBoxLayout();
+    QPushButton *addButton = new QPushButton("新增影格", this);
+    addButton->setToolTip("在目前的影格後面加入一個相同的影格");
+    QPushButton *blankButton = new QPushButton("空白影格", this);
+    m_deleteButton = new QPushButton("刪除", this);
+    m_leftButton = new QPushButton("◀ 前移", this);
+    m_rightButton = new QPushButton("後移 ▶", this);
+    editLayout->addWidget(addButton);
+    editLayout->addWidget(blankButton);
+    editLayout->addWidget(m_deleteButton);
+    editLayout->addWidget(m_leftButton);
+    editLayout->addWidget(m_rightButton);
+    layout->addLayout(editLayout);
+
+    // 播放
+    QHBoxLayout *playLayout = new QHBoxLayout();
+    m_playButton = new QPushButton("播放", this);
+    m_fpsSpinBox = new QSpinBox(this);
+    m_fpsSpinBox->setRange(1, 60);
+    m_fpsSpinBox->setSuffix(" fps");
+    m_fpsSpinBox->setValue(12);
+    m_loopCheckBox = new QCheckBox("循環", this);
+    m_loopCheckBox->setChecked(true);
+    playLayout->addWidget(m_playButton);
+    playLayout->addWidget(m_fpsSpinBox);
+    playLayout->addWidget(m_loopCheckBox);
+    playLayout->addStretch(1);
+    m_exportButton = new QPushButton("匯出動畫...", this);
+    m_exportButton->setToolTip("比較各種動畫格式的 flash 大小與傳輸量，匯出成 C 陣列");
+    playLayout->addWidget(m_exportButton);
+    layout->addLayout(playLayout);
+
+    m_statsLabel = new QLabel(this);
+    layout->addWidget(m_statsLabel);
+
+    m_player->setFps(m_fpsSpinBox->value());
+    connect(m_frameSlider, &QSlider::valueChanged, this, [this](int index) { selectFrame(index); });
+    connect(addButton, &QPushButton::clicked, this, &TimelineDialog::onAddFrame);
+    connect(blankButton, &QPushButton::clicked, this, &TimelineDialog::onBlankFrame);
+    connect(m_deleteButton, &QPushButton::clicked, this, &TimelineDialog::onDeleteFrame);
+    connect(m_leftButton, &QPushButton::clicked, this, [this]() { onMoveFrame(-1); });
+    connect(m_rightButton, &QPushButton::clicked, this, [this]() { onMoveFrame(1); });
+    connect(m_playButton, &QPushButton::clicked, this, &TimelineDialog::onPlayClicked);
+    connect(m_exportButton, &QPushButton::clicked, this, &TimelineDialog::onExportClicked);
+    connect(m_fpsSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), m_player, &OledTimelinePlayer::setFps);
+    connect(m_loopCheckBox, &QCheckBox::toggled, m_player, &OledTimelinePlayer::setLooping);
+}
+
+int TimelineDialog::currentFrame() const {
+    return m_player->currentFrame();
+}
+
+void TimelineDialog::syncWithCanvas() {
+    if (m_timeline->geometry() != m_oled->panelGeometry()) {
+        // 可視尺寸相同時影格搬到新的欄位位置 (畫布也保留了畫面)，不同時重新開始 (MainWindow 已經詢問過)
+        m_player->stop();
+        if (!m_timeline->repad(m_oled->panelGeometry())) {
+            m_timeline->reset(m_oled->panelGeometry());
+        }
+    }
+    if (m_timeline->isEmpty()) {
+        const std::vector<uint8_t> canvas = m_oled->getHardwareBuffer();
+        selectFrame(m_timeline->appendFrame(canvas.data()), false);
+    } else if (m_player->currentFrame() < 0 || m_player->currentFrame() >= m_timeline->frameCount()) {
+        selectFrame(0);
+    }
+    refresh();
+}
+
+void TimelineDialog::selectFrame(int index, bool loadCanvas) {
+    if (index < 0 || index >= m_timeline->frameCount()) {
+        return;
+    }
+    m_loadCanvas = loadCanvas;
+    m_player->seek(index);
+    m_loadCanvas = true;
+}
+
+void TimelineDialog::onFrameChanged(int, const uint8_t *buffer) {
+    if (m_loadCanvas) {
+        // 載入影格時清除操作歷史會發出 historyChanged()，內容和影格相同，不用寫回
+        m_showingFrame = true;
+        m_oled->showFrame(buffer);
+        m_showingFrame = false;
+    }
+    refresh();
+}
+
+void TimelineDialog::onCanvasChanged() {
+    // 面板切換：可視尺寸不同時清空時間軸，相同時只搬移影格
+    if (m_timeline->geometry() != m_oled->panelGeometry()) {
+        syncWithCanvas();
+        return;
+    }
+    // 播放時畫布只是顯示影格；其他時候把編輯結果寫回目前的影格
+    const int index = m_player->currentFrame();
+    if (m_showingFrame || m_player->isPlaying() || index < 0 || index >= m_timeline->frameCount()) {
+        return;
+    }
+    const std::vector<uint8_t> canvas = m_oled->getHardwareBuffer();
+    m_timeline->setFrame(index, canvas.data());
+    refresh();
+}
+
+void TimelineDialog::onAddFrame() {
+    // 新的影格和畫布相同，不需要重新載入 (保留 undo / redo)
+    const std::vector<uint8_t> canvas = m_oled->getHardwareBuffer();
+    const int index = m_timeline->insertFrame(m_player->currentFrame() + 1, canvas.data());
+    selectFrame(index, false);
+}
+
+void TimelineDialog::onBlankFrame() {
+    const int index = m_timeline->insertFrame(m_player->currentFrame() + 1, nullptr);
+    selectFrame(index);
+}
+
+void TimelineDialog::onDeleteFrame() {
+    if (m_timeline->frameCount() < 2) {
+        return;
+    }
+    const int index = m_player->currentFrame();
+    m_timeline->removeFrame(index);
+    selectFrame(std::min(index, m_timeline->frameCount() - 1));
+}
+
+void TimelineDialog::onMoveFrame(int delta) {
+    const int from = m_player->currentFrame();
+    const int to = from + delta;
+    if (to < 0 || to >= m_timeline->frameCount()) {
+        return;
+    }
+    m_timeline->moveFrame(from, to);
+    selectFrame(to, false);
+}
+
+void TimelineDialog::onPlayClicked() {
+    if (m_player->isPlaying()) {
+        m_player->stop();
+    } else {
+        m_player->play();
+    }
+}
+
+void TimelineDialog::onExportClicked() {
+    m_player->stop();
+    std::vector<std::vector<uint8_t>> frames;
+    frames.reserve(static_cast<size_t>(m_timeline->frameCount()));
+    for (int i = 0; i < m_timeline->frameCount(); ++i) {
+        frames.push_back(m_timeline->frame(i));
+    }
+    AnimationExportDialog dialog(m_timeline->geometry(), std::move(frames), this);
+    dialog.exec();
+}
+
+void TimelineDialog::onPlayingChanged(bool playing) {
+    m_playButton->setText(playing ? "停止" : "播放");
+    refresh();
+}
+
+void TimelineDialog::refresh() {
+    const int count = m_timeline->frameCount();
+    const int index = m_player->currentFrame();
+    const bool playing = m_player->isPlaying();
+    {
+        const QSignalBlocker blocker(m_frameSlider);
+        m_frameSlider->setRange(0, std::max(0, count - 1));
+        m_frameSlider->setValue(std::max(0, index));
+    }
+    m_frameLabel->setText(QString("影格 %1 / %2").arg(index + 1).arg(count));
+    m_deleteButton->setEnabled(!playing && count > 1);
+    m_leftButton->setEnabled(!playing && index > 0);
+    m_rightButton->setEnabled(!playing && index < count - 1);
+    m_playButton->setEnabled(count > 1);
+
+    // 相同的頁面在所有影格中只存一份
+    const OledTimeline::Stats stats = m_timeline->stats();
+    m_statsLabel->setText(QString("%1 個影格，%2 個不同的頁面，%3 KB (不去除重複 %4 KB)")
+                              .arg(stats.frames)
+                              .arg(stats.uniquePages)
+                              .arg(stats.storedBytes / 1024.0, 0, 'f', 1)
+                              .arg(stats.rawBytes / 1024.0, 0, 'f', 1));
+}
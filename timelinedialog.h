@@ -0,0 +1,69 @@
+#ifndef TIMELINEDIALOG_H
+#define TIMELINEDIALOG_H
+
+#include "config.h"
+#include "oled_timeline.h"
+#include <cstdint> // for uint8_t
+
+
+// 前置宣告，加快編譯速度
+class QSlider;
+class QSpinBox;
+class QLabel;
+class OLEDWidget;
+class OledTimelinePlayer;
+
+/**
+ * @brief 動畫時間軸面板：新增 / 複製 / 刪除 / 移動影格，拖曳切換影格並以目標更新率播放。
+ *
+ * 畫布永遠是「目前的影格」：畫布每次改變 (繪圖、undo / redo) 都寫回時間軸，
+ * 切換影格時把該影格載入畫布 (OLEDWidget::showFrame())。影格存在 MainWindow 的 OledTimeline，
+ * 關閉面板不會遺失；切換面板時時間軸會清空並以新的畫布開始。
+ * 「匯出動畫...」以 AnimationExportDialog 比較格式並匯出整條時間軸。
+ */
+class TimelineDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    TimelineDialog(OledTimeline *timeline, OLEDWidget *oled, QWidget *parent = nullptr);
+
+    int currentFrame() const;
+
+private slots:
+    void onCanvasChanged();
+    void onFrameChanged(int index, const uint8_t *buffer);
+    void onPlayingChanged(bool playing);
+    void onAddFrame();
+    void onBlankFrame();
+    void onDeleteFrame();
+    void onMoveFrame(int delta);
+    void onPlayClicked();
+    void onExportClicked();
+
+private:
+    OledTimeline *m_timeline;
+    OLEDWidget *m_oled;
+    OledTimelinePlayer *m_player;
+
+    QSlider *m_frameSlider;
+    QLabel *m_frameLabel;
+    QLabel *m_statsLabel;
+    QSpinBox *m_fpsSpinBox;
+    QCheckBox *m_loopCheckBox;
+    QPushButton *m_playButton;
+    QPushButton *m_deleteButton;
+    QPushButton *m_leftButton;
+    QPushButton *m_rightButton;
+    QPushButton *m_exportButton;
+
+    bool m_loadCanvas = true;       // 切換影格時是否載入畫布 (影格內容就是畫布時不用)
+    bool m_showingFrame = false;    // 正在把影格載入畫布
+
+    // 初始化 UI 的 helper
+    void setupUi();
+    void syncWithCanvas();          // 面板改變或時間軸是空的時以目前的畫布開始
+    void selectFrame(int index, bool loadCanvas = true);
+    void refresh();                 // 時間軸範圍、按鈕狀態與統計
+};
+
+#endif // TIMELINEDIALOG_H